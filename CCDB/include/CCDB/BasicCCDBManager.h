@@ -25,6 +25,9 @@
 #include <map>
 #include <unordered_map>
 #include <memory>
+#include <future>
+#include <vector>
+#include <typeinfo>
 #include <cstdlib>
 
 class TGeoManager; // we need to forward-declare those classes which should not be cleaned up
@@ -41,6 +44,11 @@ namespace o2::ccdb
 ///
 /// In cases where caching is not needed or just 1 instance of the manager is enough, one case use
 /// a singleton version BasicCCDBManager
+///
+/// To avoid blocking the processing on a cache miss, objects can be prefetched asynchronously via the
+/// CCDBDownloader of the CcdbApi: with caching enabled, the prefetched object is consumed by the first query of its path it is valid for.
+/// With a non-0 prefetch margin the successor of a cached object is prefetched once the queried timestamp
+/// approaches the end of validity of the cached one.
 
 class CCDBManagerInstance
 {
@@ -81,6 +89,8 @@ class CCDBManagerInstance
     mCCDBAccessor.init(path);
     mDeplMode = o2::framework::DefaultsHelpers::deploymentMode();
   }
+  ~CCDBManagerInstance();
+
   /// set a URL to query from
   void setURL(const std::string& url);
 
@@ -129,6 +139,24 @@ class CCDBManagerInstance
     return getForTimeStamp<T>(path, mTimestamp);
   }
 
+  /// schedule asynchronous retrieval of the object stored under path for the timestamp and metaData.
+  /// The returned future is set (to true on success) only while the manager progresses the downloads, i.e. in
+  /// processPrefetches or in the queries, hence it must not be waited for by the thread owning the manager.
+  std::shared_future<bool> prefetch(std::string const& path, long timestamp, MD const& metaData = MD());
+
+  /// schedule asynchronous retrieval of several objects for the same timestamp
+  std::vector<std::shared_future<bool>> prefetchAll(std::vector<std::string> const& paths, long timestamp, MD const& metaData = MD());
+
+  /// progress the prefetches in flight without blocking or, if wait is true, until all of them are completed.
+  /// Returns the number of prefetches still in flight
+  size_t processPrefetches(bool wait = false);
+
+  /// prefetch the successor of a cached object if its validity ends within margin (ms) from the queried timestamp, 0 to disable
+  void setPrefetchMargin(long margin) { mPrefetchMargin = margin; }
+
+  /// query the prefetch margin
+  long getPrefetchMargin() const { return mPrefetchMargin; }
+
   bool isHostReachable() const { return mCCDBAccessor.isHostReachable(); }
 
   /// clear all entries in the cache
@@ -204,8 +232,18 @@ class CCDBManagerInstance
   void endOfStream();
 
  private:
+  struct PrefetchRequest; // defined in the source since it refers to the CcdbApi internals
+
   // method to print (fatal) error
   void reportFatal(std::string_view s);
+  // extract the prefetched object of the path if it is valid for the timestamp, the prefetch in flight is waited for
+  void* getPrefetched(std::type_info const& tinfo, std::string const& path, long timestamp);
+  template <typename T>
+  T* extractPrefetched(std::string const& path, long timestamp);
+  // prefetch the successor of the cached object if its validity is about to end
+  void checkPrefetchAhead(std::string const& path, long timestamp);
+  // finalize completed prefetches, return the number of those in flight
+  size_t updatePrefetches();
   // we access the CCDB via the CURL based C++ API
   o2::ccdb::CcdbApi mCCDBAccessor;
   std::unordered_map<std::string, CachedObject> mCache; //! map for {path, CachedObject} associations
@@ -224,6 +262,10 @@ class CCDBManagerInstance
   int mFetches = 0;                                     // total number of succesful fetches from CCDB
   int mFailures = 0;                                    // total number of failed fetches
   o2::framework::DeploymentMode mDeplMode;              // O2 deployment mode
+  std::unordered_map<std::string, std::shared_ptr<PrefetchRequest>> mPrefetches; //! prefetched or in flight objects
+  long mPrefetchMargin = 0;                                                       // prefetch-ahead margin in ms, 0: disabled
+  int mNPrefetches = 0;                                                           // total number of scheduled prefetches
+  int mPrefetchHits = 0;                                                          // total number of queries served by prefetches
   ClassDefNV(CCDBManagerInstance, 1);
 };
 
@@ -254,11 +296,15 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
     auto& cached = mCache[path];
     cached.queries++;
     if ((!isOnline() && cached.isCacheValid(timestamp)) || (mCheckObjValidityEnabled && cached.isValid(timestamp))) {
+      checkPrefetchAhead(path, timestamp);
       return reinterpret_cast<T*>(cached.noCleanupPtr ? cached.noCleanupPtr : cached.objPtr.get());
     }
-    ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached.uuid,
-                                                mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
-                                                mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
+    ptr = extractPrefetched<T>(path, timestamp);
+    if (!ptr) {
+      ptr = mCCDBAccessor.retrieveFromTFileAny<T>(path, mMetaData, timestamp, &mHeaders, cached.uuid,
+                                                  mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "",
+                                                  mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "");
+    }
     if (ptr) { // new object was shipped, old one (if any) is not valid anymore
       cached.fetches++;
       mFetches++;
@@ -305,6 +351,7 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
     } else {
       cached.cacheValidUntil = -1;
     }
+    checkPrefetchAhead(path, timestamp);
     mHeaders.clear();
     mMetaData.clear();
     if (!ptr) {
@@ -319,6 +366,20 @@ T* CCDBManagerInstance::getForTimeStamp(std::string const& path, long timestamp)
   return ptr;
 }
 
+template <typename T>
+T* CCDBManagerInstance::extractPrefetched(std::string const& path, long timestamp)
+{
+  auto obj = getPrefetched(typeid(T), path, timestamp);
+  if constexpr (std::is_base_of<o2::conf::ConfigurableParam, T>::value) {
+    if (obj) {
+      auto& param = const_cast<typename std::remove_const<T&>::type>(T::Instance());
+      param.syncCCDBandRegistry(obj);
+      return &param;
+    }
+  }
+  return static_cast<T*>(obj);
+}
+
 template <typename T>
 T* CCDBManagerInstance::getForRun(std::string const& path, int runNumber, bool setRunMetadata)
 {
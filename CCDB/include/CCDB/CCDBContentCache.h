@@ -0,0 +1,126 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBContentCache.h
+/// \brief  Node-local persistent cache of CCDB objects addressed by their ETag
+///
+/// The cache directory contains
+///   blobs/<etag> : images of the objects as received from the server, written once and renamed in place
+///   index        : validity intervals of the cached objects per path, with their size, checksum and headers
+///   lock         : file locked (flock) for reading (shared) or modifying (exclusive) the index
+/// The index is replaced atomically on every modification, processes reload it when it changes.
+/// The locks are released by the kernel when a process dies, so nothing has to be cleaned up after crashes.
+/// When the total size exceeds the limit, the least recently used objects (by the modification time of the blob,
+/// refreshed on every hit) are evicted.
+///
+
+#ifndef O2_CCDB_CCDBCONTENTCACHE_H
+#define O2_CCDB_CCDBCONTENTCACHE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <cstdint>
+
+namespace o2::ccdb
+{
+
+class CCDBContentCache
+{
+ public:
+  using MD = std::map<std::string, std::string>;
+  static constexpr size_t DefaultMaxSize = 10ul << 30; // 10 GB
+
+  struct Entry {
+    std::string etag; // ETag sanitized to be used as file name
+    long validFrom = 0;  // from the Cache-Valid-From header
+    long validUntil = 0; // from the Cache-Valid-Until header, exclusive
+    uint64_t size = 0;
+    uint64_t checksum = 0;
+    MD headers;
+  };
+
+  CCDBContentCache(std::string const& dir, size_t maxSize = DefaultMaxSize);
+  ~CCDBContentCache();
+  CCDBContentCache(const CCDBContentCache&) = delete;
+  CCDBContentCache& operator=(const CCDBContentCache&) = delete;
+
+  /// find the cached object of the path valid for the timestamp
+  std::optional<Entry> find(std::string const& path, long timestamp);
+
+  /// read the image of the cached object, returns false (and invalidates the entry) if it was evicted or is corrupted
+  template <typename C>
+  bool read(Entry const& entry, C& dest)
+  {
+    dest.resize(entry.size);
+    if (!readBlob(entry, dest.data())) {
+      dest.clear();
+      return false;
+    }
+    return true;
+  }
+
+  /// store the image of the object retrieved for the path with the headers of the server reply.
+  /// Objects w/o ETag or Cache-Valid-From/Until headers cannot be cached, objects with overlapping validity are superseded.
+  bool store(std::string const& path, const char* data, size_t size, MD const& headers);
+
+  /// remove the entries of the object from the index and its blob
+  void invalidate(std::string const& etag);
+
+  /// evict least recently used objects until the total size is below the limit
+  void evict();
+
+  const std::string& getDirectory() const { return mDir; }
+  size_t getMaxSize() const { return mMaxSize; }
+  size_t getSize();
+  size_t getNEntries();
+
+  static uint64_t checksum(const char* data, size_t size);
+
+ private:
+  using Index = std::unordered_map<std::string, std::vector<Entry>>; // per path, sorted by validity start
+
+  class FileLock
+  {
+   public:
+    FileLock(int fd, bool exclusive);
+    ~FileLock();
+
+   private:
+    int mFD = -1;
+  };
+
+  bool readBlob(Entry const& entry, char* dest);
+  // the methods below require the mutex and the file lock (exclusive for modifications) to be held
+  void reloadIndex(); // read the index if it was replaced since the last reading
+  bool writeIndex();  // replace the index by the current content
+  void evictLRU();
+  size_t getSizeLocked() const;
+  void removeEntries(std::string const& etag);
+  void removeBlobIfUnused(std::string const& etag);
+  std::string blobPath(std::string const& etag) const { return mDir + "/blobs/" + etag; }
+  static std::string etagToKey(std::string const& etag);
+
+  std::string mDir;
+  size_t mMaxSize = DefaultMaxSize;
+  int mLockFD = -1;
+  Index mIndex;
+  uint64_t mGeneration = 0; // version of the loaded index, 0 if none
+  std::mutex mMutex;        // in-process serialization, the file lock serializes between processes
+};
+
+} // namespace o2::ccdb
+
+#endif
@@ -47,6 +47,7 @@ namespace ccdb
 {
 
 class CCDBQuery;
+class CCDBContentCache;
 
 /**
  * Interface to the CCDB.
@@ -413,12 +414,23 @@ class CcdbApi //: public DatabaseInterface
     }
     return obj;
   }
+  // type-erased version of the above, the ConfigurableParam registry is not synchronized
+  static void* extractFromMemoryBlob(o2::pmr::vector<char>& blob, std::type_info const& tinfo)
+  {
+    return blob.empty() ? nullptr : interpretAsTMemFileAndExtract(blob.data(), blob.size(), tinfo);
+  }
+
+  // Serves the request from the content cache, if enabled and the object is cached. Returns false otherwise.
+  bool loadFromContentCache(RequestContext& requestContext) const;
+
+  // Stores the retrieved object in the content cache, if enabled.
+  void storeInContentCache(RequestContext& requestContext) const;
 
   /**
    * Retrieves files either as snapshot or schedules them to be downloaded via CCDBDownloader.
    *
    * @param requestContext Structure giving details about the transfer.
-   * @param fromSnapshot After navigateSourcesAndLoadFile returns signals whether file was retrieved from snapshot.
+   * @param fromSnapshot After navigateSourcesAndLoadFile returns signals whether file was retrieved from snapshot (3: from the content cache).
    * @param requestCounter Pointer to the variable storing the number of requests to be done.
    */
   void navigateSourcesAndLoadFile(RequestContext& requestContext, int& fromSnapshot, size_t* requestCounter) const;
@@ -628,6 +640,9 @@ class CcdbApi //: public DatabaseInterface
     return hsize;
   }
 
+  // check if the object of the query can be served from or stored in the content cache
+  bool isContentCacheable(long timestamp, std::map<std::string, std::string> const& metadata, const std::string& createdNotAfter, const std::string& createdNotBefore) const;
+
   // tmp helper and single point of entry for a CURL perform call
   // helps to switch between easy handle perform and multi handles in a single place
   CURLcode CURL_perform(CURL* handle) const;
@@ -642,6 +657,7 @@ class CcdbApi //: public DatabaseInterface
   std::string mSnapshotCachePath{};  // root of the local snapshot (to fill or impose, even if not in the snapshot backend mode)
   bool mPreferSnapshotCache = false; // if snapshot is available, don't try to query its validity even in non-snapshot backend mode
   bool mInSnapshotMode = false;
+  std::shared_ptr<CCDBContentCache> mContentCache; //! node-local cache of objects addressed by ETag, see ALICEO2_CCDB_CONTENT_CACHE
   mutable TGrid* mAlienInstance = nullptr;                       // a cached connection to TGrid (needed for Alien locations)
   bool mNeedAlienToken = true;                                   // On EPN and FLP we use a local cache and don't need the alien token
   static std::unique_ptr<TJAlienCredentials> mJAlienCredentials; // access JAliEn credentials
@@ -15,6 +15,7 @@
 #include "CCDB/BasicCCDBManager.h"
 #include <boost/lexical_cast.hpp>
 #include <fairlogger/Logger.h>
+#include <limits>
 #include <string>
 
 namespace o2
@@ -22,11 +23,166 @@ namespace o2
 namespace ccdb
 {
 
+struct CCDBManagerInstance::PrefetchRequest {
+  PrefetchRequest(std::string const& path, long timestamp, MD const& md) : metaData(md), context(blob, metaData, headers)
+  {
+    context.path = path;
+    context.timestamp = timestamp;
+    context.considerSnapshot = true;
+    future = promise.get_future().share();
+  }
+  o2::pmr::vector<char> blob;
+  MD metaData;
+  MD headers;
+  CcdbApi::RequestContext context; // refers to the blob, metaData and headers above
+  size_t requestCounter = 0;       // decremented by the CCDBDownloader when the transfer is finished
+  int fromSnapshot = 0;
+  bool done = false;
+  bool ok = false;
+  std::promise<bool> promise;
+  std::shared_future<bool> future;
+};
+
+CCDBManagerInstance::~CCDBManagerInstance()
+{
+  // the transfers in flight write to the buffers of the prefetch requests
+  if (auto nInFlight = processPrefetches()) {
+    LOGP(info, "Waiting for {} CCDB prefetches in flight", nInFlight);
+    processPrefetches(true);
+  }
+}
+
 void CCDBManagerInstance::setURL(std::string const& url)
 {
   mCCDBAccessor.init(url);
 }
 
+std::shared_future<bool> CCDBManagerInstance::prefetch(std::string const& path, long timestamp, MD const& metaData)
+{
+  auto& req = mPrefetches[path];
+  if (req && (!req->done || (req->context.timestamp == timestamp && req->metaData == metaData))) {
+    if (req->context.timestamp != timestamp) {
+      LOGP(debug, "Prefetch of {} for {} is in flight, ignoring the request for {}", path, req->context.timestamp, timestamp);
+    }
+    return req->future;
+  }
+  req = std::make_shared<PrefetchRequest>(path, timestamp, metaData);
+  req->context.createdNotAfter = mCreatedNotAfter ? std::to_string(mCreatedNotAfter) : "";
+  req->context.createdNotBefore = mCreatedNotBefore ? std::to_string(mCreatedNotBefore) : "";
+  mNPrefetches++;
+  auto future = req->future;
+  mCCDBAccessor.navigateSourcesAndLoadFile(req->context, req->fromSnapshot, &req->requestCounter);
+  processPrefetches(); // start the transfer
+  return future;
+}
+
+std::vector<std::shared_future<bool>> CCDBManagerInstance::prefetchAll(std::vector<std::string> const& paths, long timestamp, MD const& metaData)
+{
+  std::vector<std::shared_future<bool>> futures;
+  futures.reserve(paths.size());
+  for (const auto& path : paths) {
+    futures.push_back(prefetch(path, timestamp, metaData));
+  }
+  return futures;
+}
+
+size_t CCDBManagerInstance::updatePrefetches()
+{
+  size_t nInFlight = 0;
+  for (auto& [path, req] : mPrefetches) {
+    if (req->done) {
+      continue;
+    }
+    if (req->requestCounter) {
+      nInFlight++;
+      continue;
+    }
+    req->done = true;
+    req->ok = !req->blob.empty() && req->headers.find("Error") == req->headers.end();
+    if (req->ok && req->fromSnapshot == 0) {
+      mCCDBAccessor.storeInContentCache(req->context);
+    }
+    if (req->ok && req->fromSnapshot != 2) {
+      mCCDBAccessor.saveSnapshot(req->context);
+    }
+    LOGP(debug, "Prefetch of {} for {} {}", path, req->context.timestamp, req->ok ? "succeeded" : "failed");
+    req->promise.set_value(req->ok);
+  }
+  return nInFlight;
+}
+
+size_t CCDBManagerInstance::processPrefetches(bool wait)
+{
+  if (mPrefetches.empty()) {
+    return 0;
+  }
+  auto nInFlight = updatePrefetches();
+  if (nInFlight) {
+    mCCDBAccessor.runDownloaderLoop(true);
+    nInFlight = updatePrefetches();
+  }
+  while (wait && nInFlight) {
+    mCCDBAccessor.runDownloaderLoop(false);
+    nInFlight = updatePrefetches();
+  }
+  return nInFlight;
+}
+
+void* CCDBManagerInstance::getPrefetched(std::type_info const& tinfo, std::string const& path, long timestamp)
+{
+  auto it = mPrefetches.find(path);
+  if (it == mPrefetches.end() || it->second->metaData != mMetaData) {
+    return nullptr;
+  }
+  auto req = it->second;
+  updatePrefetches();
+  while (!req->done) { // waiting for the transfer in flight is still cheaper than a synchronous retrieval
+    mCCDBAccessor.runDownloaderLoop(false);
+    updatePrefetches();
+  }
+  long validFrom = 0, validUntil = std::numeric_limits<long>::max();
+  try {
+    if (auto h = req->headers.find("Valid-From"); h != req->headers.end()) {
+      validFrom = std::stol(h->second);
+    }
+    if (auto h = req->headers.find("Valid-Until"); h != req->headers.end()) {
+      validUntil = std::stol(h->second);
+    }
+  } catch (std::exception const&) {
+    req->ok = false;
+  }
+  if (req->ok && timestamp < validFrom) { // prefetched ahead, keep it for later queries
+    return nullptr;
+  }
+  mPrefetches.erase(it);
+  if (!req->ok || timestamp >= validUntil) {
+    return nullptr;
+  }
+  auto obj = CcdbApi::extractFromMemoryBlob(req->blob, tinfo);
+  if (obj) {
+    mHeaders = std::move(req->headers);
+    mPrefetchHits++;
+  }
+  return obj;
+}
+
+void CCDBManagerInstance::checkPrefetchAhead(std::string const& path, long timestamp)
+{
+  processPrefetches();
+  if (mPrefetchMargin <= 0 || mPrefetches.find(path) != mPrefetches.end()) {
+    return;
+  }
+  auto cached = mCache.find(path);
+  if (cached == mCache.end()) {
+    return;
+  }
+  auto endvalidity = cached->second.endvalidity;
+  if (endvalidity > timestamp && endvalidity != std::numeric_limits<long>::max() && endvalidity - timestamp <= mPrefetchMargin) {
+    LOGP(debug, "Validity of {} ends at {}, prefetching its successor", path, endvalidity);
+    prefetch(path, endvalidity, mMetaData);
+  }
+}
+
 void CCDBManagerInstance::reportFatal(std::string_view err)
 {
   LOG(fatal) << err;
@@ -113,7 +269,11 @@ std::string CCDBManagerInstance::getSummaryString() const
     }
     res += fmt::format(" for {} objects", nfailObj);
   }
-  res += fmt::format(") in {} ms, instance: {}", fmt::group_digits(mTimerMS), mCCDBAccessor.getUniqueAgentID());
+  res += ")";
+  if (mNPrefetches) {
+    res += fmt::format(", {} prefetches ({} used)", mNPrefetches, mPrefetchHits);
+  }
+  res += fmt::format(" in {} ms, instance: {}", fmt::group_digits(mTimerMS), mCCDBAccessor.getUniqueAgentID());
   return res;
 }
 
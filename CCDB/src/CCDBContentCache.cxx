@@ -0,0 +1,450 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   CCDBContentCache.cxx
+/// \brief  Node-local persistent cache of CCDB objects addressed by their ETag
+///
+
+#include "CCDB/CCDBContentCache.h"
+#include <fairlogger/Logger.h>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <unordered_set>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+namespace o2::ccdb
+{
+
+namespace
+{
+constexpr uint64_t IndexMagic = 0x5844494244434341; // "ACCDBIDX"
+constexpr uint32_t IndexVersion = 1;
+
+template <typename T>
+void writePOD(std::ostream& out, T v)
+{
+  out.write(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+template <typename T>
+T readPOD(std::istream& in)
+{
+  T v{};
+  in.read(reinterpret_cast<char*>(&v), sizeof(T));
+  return v;
+}
+
+void writeString(std::ostream& out, std::string const& s)
+{
+  writePOD<uint32_t>(out, s.size());
+  out.write(s.data(), s.size());
+}
+
+std::string readString(std::istream& in)
+{
+  std::string s(readPOD<uint32_t>(in), '\0');
+  in.read(s.data(), s.size());
+  return s;
+}
+} // namespace
+
+CCDBContentCache::FileLock::FileLock(int fd, bool exclusive) : mFD(fd)
+{
+  while (::flock(mFD, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+    if (errno != EINTR) {
+      throw std::runtime_error(fmt::format("failed to lock CCDB content cache: {}", std::strerror(errno)));
+    }
+  }
+}
+
+CCDBContentCache::FileLock::~FileLock()
+{
+  ::flock(mFD, LOCK_UN);
+}
+
+CCDBContentCache::CCDBContentCache(std::string const& dir, size_t maxSize) : mDir(dir), mMaxSize(maxSize)
+{
+  std::error_code ec;
+  std::filesystem::create_directories(mDir + "/blobs", ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("failed to create CCDB content cache directory {}: {}", mDir, ec.message()));
+  }
+  mLockFD = ::open((mDir + "/lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0664);
+  if (mLockFD < 0) {
+    throw std::runtime_error(fmt::format("failed to open the lock of CCDB content cache {}: {}", mDir, std::strerror(errno)));
+  }
+}
+
+CCDBContentCache::~CCDBContentCache()
+{
+  if (mLockFD >= 0) {
+    ::close(mLockFD);
+  }
+}
+
+uint64_t CCDBContentCache::checksum(const char* data, size_t size)
+{
+  // FNV-1a on 64 bit words: we only need to detect truncated or damaged files
+  constexpr uint64_t Prime = 0x100000001b3ul;
+  uint64_t h = 0xcbf29ce484222325ul ^ size;
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+    uint64_t w;
+    std::memcpy(&w, data + i, sizeof(w));
+    h = (h ^ w) * Prime;
+  }
+  for (; i < size; i++) {
+    h = (h ^ uint8_t(data[i])) * Prime;
+  }
+  return h;
+}
+
+std::string CCDBContentCache::etagToKey(std::string const& etag)
+{
+  std::string key;
+  for (char c : etag) {
+    if (std::isalnum(static_cast<unsigned char>(c)) || c == '-' || c == '_') {
+      key += c;
+    } else if (c != '"') {
+      key += '_';
+    }
+  }
+  return key;
+}
+
+std::optional<CCDBContentCache::Entry> CCDBContentCache::find(std::string const& path, long timestamp)
+{
+  std::lock_guard<std::mutex> guard(mMutex);
+  FileLock lock(mLockFD, false);
+  reloadIndex();
+  auto it = mIndex.find(path);
+  if (it == mIndex.end()) {
+    return std::nullopt;
+  }
+  const auto& entries = it->second;
+  auto entry = std::upper_bound(entries.begin(), entries.end(), timestamp, [](long ts, Entry const& e) { return ts < e.validFrom; });
+  if (entry == entries.begin() || timestamp >= (--entry)->validUntil) {
+    return std::nullopt;
+  }
+  return *entry;
+}
+
+bool CCDBContentCache::readBlob(Entry const& entry, char* dest)
+{
+  // blobs are immutable once renamed in place, no lock is needed to read them
+  int fd = ::open(blobPath(entry.etag).c_str(), O_RDONLY | O_CLOEXEC);
+  bool ok = fd >= 0;
+  size_t nread = 0;
+  while (ok && nread < entry.size) {
+    auto n = ::read(fd, dest + nread, entry.size - nread);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      ok = false;
+      break;
+    }
+    nread += n;
+  }
+  if (fd >= 0) {
+    if (ok) {
+      ::futimens(fd, nullptr); // mark as recently used
+    }
+    ::close(fd);
+  }
+  if (ok && checksum(dest, entry.size) != entry.checksum) {
+    LOGP(warn, "CCDB content cache object {} in {} is corrupted, dropping it", entry.etag, mDir);
+    ok = false;
+  }
+  if (!ok) {
+    invalidate(entry.etag);
+  }
+  return ok;
+}
+
+bool CCDBContentCache::store(std::string const& path, const char* data, size_t size, MD const& headers)
+{
+  Entry entry;
+  try {
+    auto etag = headers.find("ETag");
+    // the interval in which the server guarantees this object to be the one returned, as for the BasicCCDBManager cache
+    auto validFrom = headers.find("Cache-Valid-From");
+    auto validUntil = headers.find("Cache-Valid-Until");
+    if (etag == headers.end() || validFrom == headers.end() || validUntil == headers.end()) {
+      return false;
+    }
+    entry.etag = etagToKey(etag->second);
+    entry.validFrom = std::stol(validFrom->second);
+    entry.validUntil = std::stol(validUntil->second);
+  } catch (std::exception const&) {
+    return false;
+  }
+  if (entry.etag.empty() || entry.validUntil <= entry.validFrom || !size || size > mMaxSize) {
+    return false;
+  }
+  entry.size = size;
+  entry.checksum = checksum(data, size);
+  entry.headers = headers;
+
+  std::lock_guard<std::mutex> guard(mMutex);
+  auto fname = blobPath(entry.etag);
+  if (!std::filesystem::exists(fname)) { // write the blob first, it is never modified afterwards
+    auto tmpname = fmt::format("{}.{}.tmp", fname, ::getpid());
+    {
+      std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+      out.write(data, size);
+      if (!out) {
+        LOGP(warn, "Failed to write {} to CCDB content cache {}", path, mDir);
+        out.close();
+        std::filesystem::remove(tmpname);
+        return false;
+      }
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpname, fname, ec);
+    if (ec) {
+      std::filesystem::remove(tmpname, ec);
+      return false;
+    }
+  }
+
+  FileLock lock(mLockFD, true);
+  reloadIndex();
+  auto& entries = mIndex[path];
+  std::vector<std::string> superseded;
+  entries.erase(std::remove_if(entries.begin(), entries.end(), [&entry, &superseded](Entry const& e) {
+                  bool overlaps = e.validFrom < entry.validUntil && entry.validFrom < e.validUntil;
+                  if (overlaps && e.etag != entry.etag) {
+                    superseded.push_back(e.etag);
+                  }
+                  return overlaps;
+                }),
+                entries.end());
+  auto pos = std::upper_bound(entries.begin(), entries.end(), entry.validFrom, [](long ts, Entry const& e) { return ts < e.validFrom; });
+  entries.insert(pos, std::move(entry));
+  for (const auto& etag : superseded) {
+    removeBlobIfUnused(etag);
+  }
+  if (getSizeLocked() > mMaxSize) {
+    evictLRU();
+  }
+  return writeIndex();
+}
+
+void CCDBContentCache::invalidate(std::string const& etag)
+{
+  std::lock_guard<std::mutex> guard(mMutex);
+  FileLock lock(mLockFD, true);
+  reloadIndex();
+  removeEntries(etag);
+  std::error_code ec;
+  std::filesystem::remove(blobPath(etag), ec);
+  writeIndex();
+}
+
+void CCDBContentCache::evict()
+{
+  std::lock_guard<std::mutex> guard(mMutex);
+  FileLock lock(mLockFD, true);
+  reloadIndex();
+  if (getSizeLocked() > mMaxSize) {
+    evictLRU();
+    writeIndex();
+  }
+}
+
+size_t CCDBContentCache::getSize()
+{
+  std::lock_guard<std::mutex> guard(mMutex);
+  FileLock lock(mLockFD, false);
+  reloadIndex();
+  return getSizeLocked();
+}
+
+size_t CCDBContentCache::getNEntries()
+{
+  std::lock_guard<std::mutex> guard(mMutex);
+  FileLock lock(mLockFD, false);
+  reloadIndex();
+  size_t n = 0;
+  for (const auto& [path, entries] : mIndex) {
+    n += entries.size();
+  }
+  return n;
+}
+
+size_t CCDBContentCache::getSizeLocked() const
+{
+  std::unordered_set<std::string> counted;
+  size_t size = 0;
+  for (const auto& [path, entries] : mIndex) {
+    for (const auto& e : entries) {
+      if (counted.insert(e.etag).second) {
+        size += e.size;
+      }
+    }
+  }
+  return size;
+}
+
+void CCDBContentCache::evictLRU()
+{
+  std::unordered_map<std::string, std::pair<int64_t, size_t>> blobs; // last use and size
+  for (const auto& [path, entries] : mIndex) {
+    for (const auto& e : entries) {
+      if (blobs.find(e.etag) == blobs.end()) {
+        struct stat st;
+        int64_t lastUse = ::stat(blobPath(e.etag).c_str(), &st) == 0 ? st.st_mtim.tv_sec * 1000000000L + st.st_mtim.tv_nsec : -1;
+        blobs.emplace(e.etag, std::make_pair(lastUse, size_t(e.size)));
+      }
+    }
+  }
+  std::vector<std::pair<int64_t, std::string>> order;
+  size_t size = 0;
+  for (const auto& [etag, use] : blobs) {
+    order.emplace_back(use.first, etag);
+    size += use.second;
+  }
+  std::sort(order.begin(), order.end());
+  for (const auto& [lastUse, etag] : order) {
+    if (size <= mMaxSize) {
+      break;
+    }
+    LOGP(debug, "Evicting {} from CCDB content cache {}", etag, mDir);
+    size -= blobs[etag].second;
+    removeEntries(etag);
+    std::error_code ec;
+    std::filesystem::remove(blobPath(etag), ec);
+  }
+}
+
+void CCDBContentCache::removeEntries(std::string const& etag)
+{
+  for (auto it = mIndex.begin(); it != mIndex.end();) {
+    auto& entries = it->second;
+    entries.erase(std::remove_if(entries.begin(), entries.end(), [&etag](Entry const& e) { return e.etag == etag; }), entries.end());
+    it = entries.empty() ? mIndex.erase(it) : std::next(it);
+  }
+}
+
+void CCDBContentCache::removeBlobIfUnused(std::string const& etag)
+{
+  for (const auto& [path, entries] : mIndex) {
+    for (const auto& e : entries) {
+      if (e.etag == etag) {
+        return;
+      }
+    }
+  }
+  std::error_code ec;
+  std::filesystem::remove(blobPath(etag), ec);
+}
+
+void CCDBContentCache::reloadIndex()
+{
+  std::ifstream in(mDir + "/index", std::ios::binary);
+  if (!in) {
+    mIndex.clear();
+    mGeneration = 0;
+    return;
+  }
+  auto magic = readPOD<uint64_t>(in);
+  auto version = readPOD<uint32_t>(in);
+  auto generation = readPOD<uint64_t>(in);
+  if (!in || magic != IndexMagic || version != IndexVersion) {
+    LOGP(warn, "Index of CCDB content cache {} is not valid, ignoring it", mDir);
+    mIndex.clear();
+    mGeneration = 0;
+    return;
+  }
+  if (generation == mGeneration) {
+    return;
+  }
+  Index index;
+  auto nPaths = readPOD<uint32_t>(in);
+  for (uint32_t ip = 0; ip < nPaths && in; ip++) {
+    auto& entries = index[readString(in)];
+    entries.resize(readPOD<uint32_t>(in));
+    for (auto& e : entries) {
+      e.etag = readString(in);
+      e.validFrom = readPOD<int64_t>(in);
+      e.validUntil = readPOD<int64_t>(in);
+      e.size = readPOD<uint64_t>(in);
+      e.checksum = readPOD<uint64_t>(in);
+      auto nHeaders = readPOD<uint32_t>(in);
+      for (uint32_t ih = 0; ih < nHeaders && in; ih++) {
+        auto key = readString(in);
+        e.headers[key] = readString(in);
+      }
+    }
+  }
+  if (!in) {
+    LOGP(warn, "Index of CCDB content cache {} is truncated, ignoring it", mDir);
+    index.clear();
+  }
+  mIndex = std::move(index);
+  mGeneration = generation;
+}
+
+bool CCDBContentCache::writeIndex()
+{
+  auto fname = mDir + "/index";
+  auto tmpname = fmt::format("{}.{}.tmp", fname, ::getpid());
+  {
+    std::ofstream out(tmpname, std::ios::binary | std::ios::trunc);
+    writePOD<uint64_t>(out, IndexMagic);
+    writePOD<uint32_t>(out, IndexVersion);
+    writePOD<uint64_t>(out, mGeneration + 1);
+    writePOD<uint32_t>(out, mIndex.size());
+    for (const auto& [path, entries] : mIndex) {
+      writeString(out, path);
+      writePOD<uint32_t>(out, entries.size());
+      for (const auto& e : entries) {
+        writeString(out, e.etag);
+        writePOD<int64_t>(out, e.validFrom);
+        writePOD<int64_t>(out, e.validUntil);
+        writePOD<uint64_t>(out, e.size);
+        writePOD<uint64_t>(out, e.checksum);
+        writePOD<uint32_t>(out, e.headers.size());
+        for (const auto& [key, value] : e.headers) {
+          writeString(out, key);
+          writeString(out, value);
+        }
+      }
+    }
+    if (!out) {
+      LOGP(warn, "Failed to write the index of CCDB content cache {}", mDir);
+      out.close();
+      std::filesystem::remove(tmpname);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpname, fname, ec);
+  if (ec) {
+    LOGP(warn, "Failed to replace the index of CCDB content cache {}: {}", mDir, ec.message());
+    std::filesystem::remove(tmpname, ec);
+    return false;
+  }
+  mGeneration++;
+  return true;
+}
+
+} // namespace o2::ccdb
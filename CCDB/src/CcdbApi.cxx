@@ -16,6 +16,7 @@
 
 #include "CCDB/CcdbApi.h"
 #include "CCDB/CCDBQuery.h"
+#include "CCDB/CCDBContentCache.h"
 
 #include "CommonUtils/StringUtils.h"
 #include "CommonUtils/FileSystemUtils.h"
@@ -214,6 +215,30 @@ void CcdbApi::init(std::string const& host)
     snapshotReport += ')';
   }
 
+  // The environment option ALICEO2_CCDB_CONTENT_CACHE=<dir> enables a node-local cache of the objects addressed
+  // by their ETag, shared by all processes using the same directory. Objects retrieved for an explicit timestamp w/o
+  // metadata and time-machine constraints are served from it if their cache validity (Cache-Valid-From/Until headers)
+  // covers the queried timestamp. The size of the cache in MB can be limited with ALICEO2_CCDB_CONTENT_CACHE_SIZE,
+  // the least recently used objects are evicted. Online the objects may be updated at any time, the cache is not used.
+  mContentCache.reset();
+  const char* contentCacheDir = getenv("ALICEO2_CCDB_CONTENT_CACHE");
+  auto deplMode = o2::framework::DefaultsHelpers::deploymentMode();
+  bool online = deplMode == o2::framework::DeploymentMode::OnlineDDS || deplMode == o2::framework::DeploymentMode::OnlineAUX || deplMode == o2::framework::DeploymentMode::OnlineECS;
+  if (contentCacheDir && online) {
+    LOGP(info, "Ignoring ALICEO2_CCDB_CONTENT_CACHE in online deployment mode");
+  } else if (contentCacheDir && !mInSnapshotMode) {
+    size_t maxSize = CCDBContentCache::DefaultMaxSize;
+    if (getenv("ALICEO2_CCDB_CONTENT_CACHE_SIZE")) {
+      maxSize = size_t(atol(getenv("ALICEO2_CCDB_CONTENT_CACHE_SIZE"))) << 20;
+    }
+    try {
+      mContentCache = std::make_shared<CCDBContentCache>(fs::weakly_canonical(fs::absolute(contentCacheDir[0] ? contentCacheDir : ".")), maxSize);
+      snapshotReport += fmt::format("(content cache dir={}, max {} MB)", mContentCache->getDirectory(), maxSize >> 20);
+    } catch (std::exception const& e) {
+      LOGP(error, "Failed to set up the CCDB content cache, continuing without: {}", e.what());
+    }
+  }
+
   mNeedAlienToken = (host.find("https://") != std::string::npos) || (host.find("alice-ccdb.cern.ch") != std::string::npos);
 
   // Set the curl timeout. It can be forced with an env var or it has different defaults based on the deployment mode.
@@ -1143,6 +1168,14 @@ void* CcdbApi::retrieveFromTFile(std::type_info const& tinfo, std::string const&
     return res;
   }
 
+  if (mContentCache && isContentCacheable(timestamp, metadata, createdNotAfter, createdNotBefore)) {
+    // the memory path serves from and fills the content cache
+    o2::pmr::vector<char> blob;
+    std::map<std::string, std::string> localHeaders;
+    loadFileToMemory(blob, path, metadata, timestamp, headers ? headers : &localHeaders, etag, createdNotAfter, createdNotBefore, false);
+    return blob.empty() ? nullptr : interpretAsTMemFileAndExtract(blob.data(), blob.size(), tinfo);
+  }
+
   // normal mode follows
 
   CURL* curl_handle = curl_easy_init();
@@ -1933,11 +1966,48 @@ void CcdbApi::navigateSourcesAndLoadFile(RequestContext& requestContext, int& fr
     // if we are in snapshot mode we can simply open the file, unless the etag is non-empty:
     // this would mean that the object was is already fetched and in this mode we don't to validity checks!
     getFromSnapshot(createSnapshot, requestContext.path, requestContext.timestamp, requestContext.headers, snapshotpath, requestContext.dest, fromSnapshot, requestContext.etag);
+  } else if (loadFromContentCache(requestContext)) {
+    fromSnapshot = 3;
   } else { // look on the server
     scheduleDownload(requestContext, requestCounter);
   }
 }
 
+bool CcdbApi::isContentCacheable(long timestamp, std::map<std::string, std::string> const& metadata, const std::string& createdNotAfter, const std::string& createdNotBefore) const
+{
+  // the index is per path only, objects selected by metadata or by their creation time cannot be cached.
+  // Queries for the current time must reach the server, a newer object may have been uploaded.
+  return timestamp >= 0 && metadata.empty() && createdNotAfter.empty() && createdNotBefore.empty();
+}
+
+bool CcdbApi::loadFromContentCache(RequestContext& requestContext) const
+{
+  if (!mContentCache || !isContentCacheable(requestContext.timestamp, requestContext.metadata, requestContext.createdNotAfter, requestContext.createdNotBefore)) {
+    return false;
+  }
+  auto entry = mContentCache->find(requestContext.path, requestContext.timestamp);
+  if (entry) {
+    auto etag = entry->headers.find("ETag");
+    // if the caller has the same object already, leave the destination empty as for the 304 reply of the server
+    bool notModified = !requestContext.etag.empty() && etag != entry->headers.end() && etag->second == requestContext.etag;
+    if (notModified || mContentCache->read(*entry, requestContext.dest)) {
+      for (const auto& [key, value] : entry->headers) {
+        requestContext.headers[key] = value;
+      }
+      return true;
+    }
+  }
+  return false;
+}
+
+void CcdbApi::storeInContentCache(RequestContext& requestContext) const
+{
+  if (mContentCache && !requestContext.dest.empty() && requestContext.headers.find("Error") == requestContext.headers.end() &&
+      isContentCacheable(requestContext.timestamp, requestContext.metadata, requestContext.createdNotAfter, requestContext.createdNotBefore)) {
+    mContentCache->store(requestContext.path, requestContext.dest.data(), requestContext.dest.size(), requestContext.headers);
+  }
+}
+
 void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requestContexts) const
 {
   std::vector<int> fromSnapshots(requestContexts.size());
@@ -1959,8 +2029,12 @@ void CcdbApi::vectoredLoadFileToMemory(std::vector<RequestContext>& requestConte
   for (int i = 0; i < requestContexts.size(); i++) {
     auto& requestContext = requestContexts.at(i);
     if (!requestContext.dest.empty()) {
+      if (fromSnapshots.at(i) == 0) {
+        storeInContentCache(requestContext);
+      }
       logReading(requestContext.path, requestContext.timestamp, &requestContext.headers,
-                 fmt::format("{}{}", requestContext.considerSnapshot ? "load to memory" : "retrieve", fromSnapshots.at(i) ? " from snapshot" : ""));
+                 fmt::format("{}{}", requestContext.considerSnapshot ? "load to memory" : "retrieve",
+                             fromSnapshots.at(i) == 3 ? " from content cache" : (fromSnapshots.at(i) ? " from snapshot" : "")));
       if (requestContext.considerSnapshot && fromSnapshots.at(i) != 2) {
         saveSnapshot(requestContext);
       }
@@ -157,3 +157,47 @@ BOOST_AUTO_TEST_CASE(TestBasicCCDBManager)
   LOG(info) << "Reading A again, it should not be cached: " << *objA;
   BOOST_CHECK(objA && (*objA) != hack); // make sure correct object is loaded
 }
+
+BOOST_AUTO_TEST_CASE(TestCCDBManagerPrefetch)
+{
+  CcdbApi api;
+  api.init(ccdbUrl);
+  if (!api.isHostReachable()) {
+    LOG(warning) << "Host " << ccdbUrl << " is not reacheable, abandoning the test";
+    return;
+  }
+  //
+  std::string pathA = basePath + "PrefetchA";
+  std::string pathB = basePath + "PrefetchB";
+  std::string ccdbObjO = "testObjectO";
+  std::string ccdbObjN = "testObjectN";
+  std::map<std::string, std::string> md;
+  long start = 1000, stop = 2000;
+  api.storeAsTFileAny(&ccdbObjO, pathA, md, start, stop);
+  api.storeAsTFileAny(&ccdbObjN, pathA, md, stop, stop + (stop - start)); // extra slot
+  api.storeAsTFileAny(&ccdbObjO, pathB, md, start, stop);
+
+  CCDBManagerInstance cdb(ccdbUrl);
+  cdb.setCaching(true);
+  auto futures = cdb.prefetchAll({pathA, pathB}, start);
+  cdb.processPrefetches(true);
+  for (auto& f : futures) {
+    BOOST_CHECK(f.wait_for(std::chrono::seconds(0)) == std::future_status::ready && f.get());
+  }
+  auto* objA = cdb.getForTimeStamp<std::string>(pathA, start + 1); // served by the prefetch
+  BOOST_CHECK(objA && (*objA) == ccdbObjO);
+  auto* objB = cdb.getForTimeStamp<std::string>(pathB, start + 1);
+  BOOST_CHECK(objB && (*objB) == ccdbObjO);
+
+  // the successor of A should be prefetched when approaching the end of validity
+  cdb.setPrefetchMargin(100);
+  cdb.setLocalObjectValidityChecking(true);
+  objA = cdb.getForTimeStamp<std::string>(pathA, stop - 50); // cached, triggers prefetch of the next slot
+  BOOST_CHECK(objA && (*objA) == ccdbObjO);
+  auto next = cdb.prefetch(pathA, stop); // already in flight or done, the same request is returned
+  cdb.processPrefetches(true);
+  BOOST_CHECK(next.get());
+  objA = cdb.getForTimeStamp<std::string>(pathA, stop + 1);
+  BOOST_CHECK(objA && (*objA) == ccdbObjN);
+  LOG(info) << cdb.getSummaryString();
+}
@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   testCCDBContentCache.cxx
+/// \brief  Test the node-local content addressed CCDB cache
+///
+
+#define BOOST_TEST_MODULE CCDB
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include "CCDB/CCDBContentCache.h"
+#include <boost/test/unit_test.hpp>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+using namespace o2::ccdb;
+
+namespace
+{
+std::map<std::string, std::string> makeHeaders(std::string const& etag, long from, long until)
+{
+  // the object validity is wider than the interval in which the server guarantees it to be the one returned
+  return {{"ETag", "\"" + etag + "\""}, {"Valid-From", std::to_string(from - 50)}, {"Valid-Until", std::to_string(until + 50)},
+          {"Cache-Valid-From", std::to_string(from)}, {"Cache-Valid-Until", std::to_string(until)}, {"Content-Type", "application/octet-stream"}};
+}
+
+struct CacheDir {
+  std::string path = std::filesystem::temp_directory_path().string() + "/ccdb-content-cache-test-" + std::to_string(getpid());
+  CacheDir() { std::filesystem::remove_all(path); }
+  ~CacheDir() { std::filesystem::remove_all(path); }
+};
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestStoreAndFind)
+{
+  CacheDir dir;
+  CCDBContentCache cache(dir.path);
+  std::string objA(1000, 'a'), objB(2000, 'b');
+  BOOST_CHECK(cache.store("Test/Path", objA.data(), objA.size(), makeHeaders("uuid-a", 100, 200)));
+  BOOST_CHECK(cache.store("Test/Path", objB.data(), objB.size(), makeHeaders("uuid-b", 200, 300)));
+  BOOST_CHECK(!cache.store("Test/Path", objB.data(), objB.size(), {{"ETag", "\"uuid-c\""}})); // no validity
+  BOOST_CHECK(!cache.store("Test/Path", objB.data(), objB.size(), {{"ETag", "\"uuid-c\""}, {"Valid-From", "100"}, {"Valid-Until", "300"}})); // no cache validity
+  BOOST_CHECK(cache.getNEntries() == 2);
+  BOOST_CHECK(cache.getSize() == objA.size() + objB.size());
+
+  BOOST_CHECK(!cache.find("Test/Path", 99));
+  BOOST_CHECK(!cache.find("Test/Path", 300));
+  BOOST_CHECK(!cache.find("Test/Other", 150));
+  auto entry = cache.find("Test/Path", 199);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->etag == "uuid-a" && entry->validFrom == 100 && entry->validUntil == 200);
+  BOOST_CHECK(entry->headers.at("Content-Type") == "application/octet-stream");
+  std::vector<char> blob;
+  BOOST_CHECK(cache.read(*entry, blob));
+  BOOST_CHECK(std::string(blob.begin(), blob.end()) == objA);
+  entry = cache.find("Test/Path", 200);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(cache.read(*entry, blob));
+  BOOST_CHECK(std::string(blob.begin(), blob.end()) == objB);
+
+  // the index is shared with other instances (processes) using the same directory
+  CCDBContentCache other(dir.path);
+  BOOST_CHECK(other.getNEntries() == 2);
+  std::string objC(500, 'c');
+  BOOST_CHECK(other.store("Test/Path", objC.data(), objC.size(), makeHeaders("uuid-c", 150, 250))); // supersedes both
+  BOOST_CHECK(cache.getNEntries() == 1);
+  BOOST_CHECK(!cache.find("Test/Path", 120));
+  entry = cache.find("Test/Path", 240);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(entry->etag == "uuid-c");
+  BOOST_CHECK(!std::filesystem::exists(dir.path + "/blobs/uuid-a"));
+}
+
+BOOST_AUTO_TEST_CASE(TestIntegrity)
+{
+  CacheDir dir;
+  CCDBContentCache cache(dir.path);
+  std::string objA(1000, 'a');
+  BOOST_CHECK(cache.store("Test/Path", objA.data(), objA.size(), makeHeaders("uuid-a", 100, 200)));
+  {
+    std::fstream blobFile(dir.path + "/blobs/uuid-a", std::ios::in | std::ios::out | std::ios::binary);
+    blobFile.seekp(10);
+    blobFile.put('x');
+  }
+  auto entry = cache.find("Test/Path", 150);
+  BOOST_REQUIRE(entry);
+  std::vector<char> blob;
+  BOOST_CHECK(!cache.read(*entry, blob)); // corrupted blob is detected and dropped
+  BOOST_CHECK(blob.empty());
+  BOOST_CHECK(!cache.find("Test/Path", 150));
+
+  BOOST_CHECK(cache.store("Test/Path", objA.data(), objA.size(), makeHeaders("uuid-a", 100, 200)));
+  std::filesystem::remove(dir.path + "/blobs/uuid-a"); // e.g. evicted by another process
+  entry = cache.find("Test/Path", 150);
+  BOOST_REQUIRE(entry);
+  BOOST_CHECK(!cache.read(*entry, blob));
+  BOOST_CHECK(cache.getNEntries() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(TestEviction)
+{
+  CacheDir dir;
+  CCDBContentCache cache(dir.path, 3000);
+  std::string obj(1000, 'o');
+  for (int i = 0; i < 3; i++) {
+    BOOST_CHECK(cache.store("Test/Path" + std::to_string(i), obj.data(), obj.size(), makeHeaders("uuid-" + std::to_string(i), 100, 200)));
+    usleep(10000); // make the modification times distinct
+  }
+  // use the oldest object, the 2nd one becomes the least recently used
+  auto entry = cache.find("Test/Path0", 150);
+  BOOST_REQUIRE(entry);
+  std::vector<char> blob;
+  BOOST_CHECK(cache.read(*entry, blob));
+  BOOST_CHECK(cache.store("Test/Path3", obj.data(), obj.size(), makeHeaders("uuid-3", 100, 200)));
+  BOOST_CHECK(cache.getSize() <= cache.getMaxSize());
+  BOOST_CHECK(cache.find("Test/Path0", 150));
+  BOOST_CHECK(!cache.find("Test/Path1", 150));
+  BOOST_CHECK(cache.find("Test/Path2", 150));
+  BOOST_CHECK(cache.find("Test/Path3", 150));
+  BOOST_CHECK(!std::filesystem::exists(dir.path + "/blobs/uuid-1"));
+}
@@ -92,9 +92,14 @@ struct LogLogThrottler {
   GPUdi() void clear() { evCount = evCountPrev = logCount = 0; }
 };
 
+template <int N, typename... Args>
+class DCAFitterNBatch;
+
 template <int N, typename... Args>
 class DCAFitterN
 {
+  friend class DCAFitterNBatch<N, Args...>;
+
   static constexpr double NMin = 2;
   static constexpr double NMax = 4;
   static constexpr double NInv = 1. / N;
@@ -266,7 +271,13 @@ class DCAFitterN
   GPUd() double calcChi2NoErr() const;
   GPUd() bool correctTracks(const VecND& corrX);
   GPUd() bool minimizeChi2();
+  GPUd() bool setupChi2Minimization(float& chi2);
+  GPUd() bool iterateChi2Minimization(float chi2);
   GPUd() bool minimizeChi2NoErr();
+  GPUd() bool setupCrossings();
+  GPUd() bool setupHypothesis(int ic);
+  GPUd() void finalizeHypothesis(bool minimized);
+  GPUd() void finalizeCandidates();
   GPUd() bool roughDZCut() const;
   GPUd() bool closerToAlternative() const;
   GPUd() bool propagateToX(o2::track::TrackParCov& t, float x);
@@ -402,12 +413,30 @@ GPUd() int DCAFitterN<N, Args...>::process(const Tr&... args)
   mCallID++;
   static_assert(sizeof...(args) == N, "incorrect number of input tracks");
   assign(0, args...);
+  if (!setupCrossings()) {
+    return 0; // no crossing
+  }
+  // check all crossings
+  for (int ic = 0; ic < mCrossings.nDCA; ic++) {
+    if (setupHypothesis(ic)) {
+      finalizeHypothesis(mUseAbsDCA ? minimizeChi2NoErr() : minimizeChi2());
+    }
+  }
+  finalizeCandidates();
+  return mCurHyp;
+}
+
+//__________________________________________________________________________
+template <int N, typename... Args>
+GPUd() bool DCAFitterN<N, Args...>::setupCrossings()
+{
+  // find the seeds for the tracks assigned to mOrigTrPtr, return false if there is none
   clear();
   for (int i = 0; i < N; i++) {
     mTrAux[i].set(*mOrigTrPtr[i], mBz);
   }
   if (!mCrossings.set(mTrAux[0], *mOrigTrPtr[0], mTrAux[1], *mOrigTrPtr[1], mMaxDXYIni, mIsCollinear)) { // even for N>2 it should be enough to test just 1 loop
-    return 0;                                                                                            // no crossing
+    return false;                                                                                        // no crossing
   }
   for (int ih = 0; ih < MAXHYP; ih++) {
     mPropFailed[ih] = false;
@@ -424,29 +453,46 @@ GPUd() int DCAFitterN<N, Args...>::process(const Tr&... args)
       mCrossings.yDCA[0] = 0.5 * (mCrossings.yDCA[0] + mCrossings.yDCA[1]);
     }
   }
-  // check all crossings
-  for (int ic = 0; ic < mCrossings.nDCA; ic++) {
-    // check if radius is acceptable
-    if (mCrossings.xDCA[ic] * mCrossings.xDCA[ic] + mCrossings.yDCA[ic] * mCrossings.yDCA[ic] > mMaxR2) {
-      continue;
-    }
-    mCrossIDCur = ic;
-    mCrossIDAlt = (mCrossings.nDCA == 2 && mAllowAltPreference) ? 1 - ic : -1; // works for max 2 crossings
-    mNIters[mCurHyp] = 0;
-    mTrPropDone[mCurHyp] = false;
-    mChi2[mCurHyp] = -1.;
-    mPCA[mCurHyp][0] = mCrossings.xDCA[ic];
-    mPCA[mCurHyp][1] = mCrossings.yDCA[ic];
-
-    if (mUseAbsDCA ? minimizeChi2NoErr() : minimizeChi2()) {
-      mOrder[mCurHyp] = mCurHyp;
-      if (mPropagateToPCA && !propagateTracksToVertex(mCurHyp)) {
-        continue; // discard candidate if failed to propagate to it
-      }
-      mCurHyp++;
+  return true;
+}
+
+//__________________________________________________________________________
+template <int N, typename... Args>
+GPUd() bool DCAFitterN<N, Args...>::setupHypothesis(int ic)
+{
+  // prepare the current hypothesis slot for the minimization starting from the crossing ic
+  // check if radius is acceptable
+  if (mCrossings.xDCA[ic] * mCrossings.xDCA[ic] + mCrossings.yDCA[ic] * mCrossings.yDCA[ic] > mMaxR2) {
+    return false;
+  }
+  mCrossIDCur = ic;
+  mCrossIDAlt = (mCrossings.nDCA == 2 && mAllowAltPreference) ? 1 - ic : -1; // works for max 2 crossings
+  mNIters[mCurHyp] = 0;
+  mTrPropDone[mCurHyp] = false;
+  mChi2[mCurHyp] = -1.;
+  mPCA[mCurHyp][0] = mCrossings.xDCA[ic];
+  mPCA[mCurHyp][1] = mCrossings.yDCA[ic];
+  return true;
+}
+
+//__________________________________________________________________________
+template <int N, typename... Args>
+GPUd() void DCAFitterN<N, Args...>::finalizeHypothesis(bool minimized)
+{
+  // accept the current hypothesis if it was successfully minimized
+  if (minimized) {
+    mOrder[mCurHyp] = mCurHyp;
+    if (mPropagateToPCA && !propagateTracksToVertex(mCurHyp)) {
+      return; // discard candidate if failed to propagate to it
     }
+    mCurHyp++;
   }
+}
 
+//__________________________________________________________________________
+template <int N, typename... Args>
+GPUd() void DCAFitterN<N, Args...>::finalizeCandidates()
+{
   for (int i = mCurHyp; i--;) { // order in quality
     for (int j = i; j--;) {
       if (mChi2[mOrder[i]] < mChi2[mOrder[j]]) {
@@ -459,7 +505,6 @@ GPUd() int DCAFitterN<N, Args...>::process(const Tr&... args)
       recalculatePCAWithErrors(i);
     }
   }
-  return mCurHyp;
 }
 
 //__________________________________________________________________________
@@ -932,6 +977,15 @@ template <int N, typename... Args>
 GPUd() bool DCAFitterN<N, Args...>::minimizeChi2()
 {
   // find best chi2 (weighted DCA) of N tracks in the vicinity of the seed PCA
+  float chi2 = 0;
+  return setupChi2Minimization(chi2) && iterateChi2Minimization(chi2);
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+GPUd() bool DCAFitterN<N, Args...>::setupChi2Minimization(float& chi2)
+{
+  // propagate the tracks to the seed PCA and calculate the initial PCA and chi2
   for (int i = N; i--;) {
     mCandTr[mCurHyp][i] = *mOrigTrPtr[i];
     auto x = mTrAux[i].c * mPCA[mCurHyp][0] + mTrAux[i].s * mPCA[mCurHyp][1]; // X of PCA in the track frame
@@ -967,7 +1021,16 @@ GPUd() bool DCAFitterN<N, Args...>::minimizeChi2()
   }
   calcPCA();            // current PCA
   calcTrackResiduals(); // current track residuals
-  float chi2Upd, chi2 = calcChi2();
+  chi2 = calcChi2();
+  return true;
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+GPUd() bool DCAFitterN<N, Args...>::iterateChi2Minimization(float chi2)
+{
+  // Newton iterations of the weighted DCA minimization, starting from the current PCA with given chi2
+  float chi2Upd;
   do {
     calcTrackDerivatives(); // current track derivatives (1st and 2nd)
     calcResidDerivatives(); // current residals derivatives (1st and 2nd)
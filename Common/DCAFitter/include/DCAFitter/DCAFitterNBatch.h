@@ -0,0 +1,431 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file DCAFitterNBatch.h
+/// \brief Batched processing of N-prong candidates with the DCAFitterN
+
+#ifndef _ALICEO2_DCA_FITTERN_BATCH_
+#define _ALICEO2_DCA_FITTERN_BATCH_
+
+#include "DCAFitter/DCAFitterN.h"
+#include <gsl/span>
+#include <array>
+#include <cmath>
+
+namespace o2
+{
+namespace vertexing
+{
+
+///< Fits many candidates with the configuration of a DCAFitterN.
+///  The candidates are processed in groups of NLanes: the seeding, the propagations and the final
+///  propagation to the vertex are done per candidate by the DCAFitterN code, while the Newton
+///  iterations of the weighted DCA minimization run for all candidates of the group together
+///  on structure-of-arrays data, in loops over the lanes which the compiler can vectorize.
+///  Lanes with a (nearly) singular chi2 hessian and the last few lanes still iterating when
+///  the others have converged are finished by the scalar DCAFitterN code.
+///  The results are the same as of DCAFitterN::process up to the floating point rounding.
+///  The absolute DCA minimization mode is processed candidate by candidate.
+template <int N, typename... Args>
+class DCAFitterNBatch
+{
+ public:
+  using Fitter = DCAFitterN<N, Args...>;
+  using Track = o2::track::TrackParCov;
+  using Candidate = std::array<const Track*, N>;
+  static constexpr int NLanes = 8; // candidates minimized together
+
+  DCAFitterNBatch() { resetLanes(); }
+  DCAFitterNBatch(const Fitter& cfg)
+  {
+    resetLanes();
+    setFitter(cfg);
+  }
+
+  ///< take the settings of the fitter for all lanes
+  void setFitter(const Fitter& cfg)
+  {
+    for (auto& ft : mFitters) {
+      ft = cfg;
+    }
+  }
+
+  ///< fitter of the lane, holding the results of the last candidate processed in it
+  Fitter& getFitter(int lane = 0) { return mFitters[lane]; }
+
+  ///< scalar code finishes the iterations once fewer lanes remain active
+  void setMinActiveLanes(int n) { mMinActiveLanes = n > 1 ? n : 1; }
+  int getMinActiveLanes() const { return mMinActiveLanes; }
+
+  ///< fit all candidates, f(icand, nVtx, fitter) is called for each of them in the input order,
+  ///  with the fitter in the state DCAFitterN::process would leave it after fitting the candidate.
+  ///  Returns the total number of vertex candidates found.
+  template <typename F>
+  int process(gsl::span<const Candidate> cands, F&& f)
+  {
+    int nTot = 0;
+    for (size_t i0 = 0; i0 < cands.size(); i0 += NLanes) {
+      int n = cands.size() - i0 < NLanes ? cands.size() - i0 : NLanes;
+      processGroup(cands.data() + i0, n);
+      for (int l = 0; l < n; l++) {
+        int nv = mFitters[l].getNCandidates();
+        nTot += nv;
+        f(i0 + l, nv, mFitters[l]);
+      }
+    }
+    return nTot;
+  }
+
+ private:
+  template <typename T>
+  using LaneArr = T[NLanes];
+
+  ///< state of the weighted DCA minimization of all lanes, see DCAFitterN::iterateChi2Minimization
+  struct Lanes {
+    alignas(64) LaneArr<double> pos[N][3];     // track positions
+    alignas(64) LaneArr<double> res[N][3];     // track residuals
+    alignas(64) LaneArr<double> pca[3];        // current PCA
+    alignas(64) LaneArr<double> coef[N][3][3]; // TrackCoefVtx matrices
+    alignas(64) LaneArr<double> sn[N], cs[N];  // sin and cos of tracks alpha
+    alignas(64) LaneArr<double> covI[N][4];    // inverse cov.matrices: sxx, syy, syz, szz
+    alignas(64) LaneArr<double> der[N][4];     // track derivatives: dydx, dzdx, d2ydx2, d2zdx2
+    alignas(64) LaneArr<double> dr1[N][N][3];  // residuals 1st derivatives
+    alignas(64) LaneArr<double> dr2[N][N][3];  // residuals 2nd derivatives
+    alignas(64) LaneArr<double> xCur, yCur;    // current seed
+    alignas(64) LaneArr<double> xAlt, yAlt;    // alternative seed
+    alignas(64) LaneArr<float> chi2;           // current chi2
+    LaneArr<int> nIter;                        // iterations done
+    LaneArr<bool> active;                      // lane is being minimized
+    LaneArr<bool> useAlt;                      // check the alternative seed
+    LaneArr<bool> scalar;                      // lane is left to the scalar code
+    LaneArr<bool> ok;                          // minimization result
+  };
+
+  void resetLanes();
+  void processGroup(const Candidate* cands, int n);
+  void loadLane(int l);
+  void storeLane(int l);
+  bool iterateLanes();
+
+  std::array<Fitter, NLanes> mFitters;
+  Lanes mLanes;
+  int mMinActiveLanes = 2;
+};
+
+//___________________________________________________________________
+template <int N, typename... Args>
+void DCAFitterNBatch<N, Args...>::resetLanes()
+{
+  // lanes which are not loaded are computed as well: give them a regular hessian
+  mLanes = Lanes{};
+  for (int i = 0; i < N; i++) {
+    for (int l = 0; l < NLanes; l++) {
+      mLanes.covI[i][0][l] = 1.;
+      mLanes.dr1[i][i][0][l] = 1.;
+    }
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+void DCAFitterNBatch<N, Args...>::processGroup(const Candidate* cands, int n)
+{
+  bool hasCrossing[NLanes] = {false};
+  for (int l = 0; l < n; l++) {
+    auto& ft = mFitters[l];
+    ft.mCallID++;
+    for (int i = 0; i < N; i++) {
+      ft.mOrigTrPtr[i] = cands[l][i];
+    }
+    hasCrossing[l] = ft.setupCrossings();
+  }
+  if (mFitters[0].mUseAbsDCA) {
+    for (int l = 0; l < n; l++) {
+      auto& ft = mFitters[l];
+      for (int ic = 0; hasCrossing[l] && ic < ft.mCrossings.nDCA; ic++) {
+        if (ft.setupHypothesis(ic)) {
+          ft.finalizeHypothesis(ft.minimizeChi2NoErr());
+        }
+      }
+    }
+  } else {
+    // process the 1st seeds of all lanes, then the 2nd ones, since the latter depend on the result of the former
+    for (int ic = 0; ic < Fitter::MAXHYP; ic++) {
+      int nActive = 0;
+      for (int l = 0; l < NLanes; l++) {
+        auto& ft = mFitters[l];
+        mLanes.active[l] = mLanes.scalar[l] = mLanes.ok[l] = false;
+        float chi2 = 0;
+        if (l < n && hasCrossing[l] && ic < ft.mCrossings.nDCA && ft.setupHypothesis(ic) && ft.setupChi2Minimization(chi2)) {
+          mLanes.chi2[l] = chi2;
+          loadLane(l);
+          nActive++;
+        }
+      }
+      while (nActive >= mMinActiveLanes && iterateLanes()) {
+        nActive = 0;
+        for (int l = 0; l < NLanes; l++) {
+          nActive += mLanes.active[l];
+        }
+      }
+      for (int l = 0; l < n; l++) {
+        auto& ft = mFitters[l];
+        if (mLanes.active[l] || mLanes.scalar[l]) {
+          storeLane(l);
+          mLanes.ok[l] = ft.iterateChi2Minimization(mLanes.chi2[l]);
+        }
+        ft.finalizeHypothesis(mLanes.ok[l]);
+        mLanes.ok[l] = false;
+      }
+    }
+  }
+  for (int l = 0; l < n; l++) {
+    mFitters[l].finalizeCandidates();
+  }
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+void DCAFitterNBatch<N, Args...>::loadLane(int l)
+{
+  // copy the state of the minimization set up by the fitter of the lane
+  auto& ft = mFitters[l];
+  auto& ln = mLanes;
+  int h = ft.mCurHyp;
+  ft.calcTrackDerivatives(); // do not change during the iterations
+  ft.calcResidDerivatives();
+  for (int i = 0; i < N; i++) {
+    const auto& covI = ft.mTrcEInv[h][i];
+    const auto& der = ft.mTrDer[h][i];
+    const auto& coef = ft.mTrCFVT[h][i];
+    for (int k = 0; k < 3; k++) {
+      ln.pos[i][k][l] = ft.mTrPos[h][i][k];
+      ln.res[i][k][l] = ft.mTrRes[h][i][k];
+      for (int m = 0; m < 3; m++) {
+        ln.coef[i][k][m][l] = coef(k, m);
+      }
+    }
+    ln.sn[i][l] = ft.mTrAux[i].s;
+    ln.cs[i][l] = ft.mTrAux[i].c;
+    ln.covI[i][0][l] = covI.sxx;
+    ln.covI[i][1][l] = covI.syy;
+    ln.covI[i][2][l] = covI.syz;
+    ln.covI[i][3][l] = covI.szz;
+    ln.der[i][0][l] = der.dydx;
+    ln.der[i][1][l] = der.dzdx;
+    ln.der[i][2][l] = der.d2ydx2;
+    ln.der[i][3][l] = der.d2zdx2;
+    for (int j = 0; j < N; j++) {
+      for (int k = 0; k < 3; k++) {
+        ln.dr1[i][j][k][l] = ft.mDResidDx[i][j][k];
+        ln.dr2[i][j][k][l] = ft.mD2ResidDx2[i][j][k];
+      }
+    }
+  }
+  for (int k = 0; k < 3; k++) {
+    ln.pca[k][l] = ft.mPCA[h][k];
+  }
+  ln.useAlt[l] = ft.mCrossIDAlt >= 0;
+  ln.xCur[l] = ft.mCrossings.xDCA[ft.mCrossIDCur];
+  ln.yCur[l] = ft.mCrossings.yDCA[ft.mCrossIDCur];
+  ln.xAlt[l] = ln.useAlt[l] ? ft.mCrossings.xDCA[ft.mCrossIDAlt] : 0.;
+  ln.yAlt[l] = ln.useAlt[l] ? ft.mCrossings.yDCA[ft.mCrossIDAlt] : 0.;
+  ln.nIter[l] = ft.mNIters[h];
+  ln.active[l] = true;
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+void DCAFitterNBatch<N, Args...>::storeLane(int l)
+{
+  // copy the state of the minimization back to the fitter of the lane
+  auto& ft = mFitters[l];
+  const auto& ln = mLanes;
+  int h = ft.mCurHyp;
+  for (int i = 0; i < N; i++) {
+    for (int k = 0; k < 3; k++) {
+      ft.mTrPos[h][i][k] = ln.pos[i][k][l];
+      ft.mTrRes[h][i][k] = ln.res[i][k][l];
+    }
+  }
+  for (int k = 0; k < 3; k++) {
+    ft.mPCA[h][k] = ln.pca[k][l];
+  }
+  ft.mNIters[h] = ln.nIter[l];
+}
+
+//___________________________________________________________________
+template <int N, typename... Args>
+bool DCAFitterNBatch<N, Args...>::iterateLanes()
+{
+  // one Newton iteration for all active lanes, see DCAFitterN::iterateChi2Minimization.
+  // All lanes are computed, the new state is committed only for the active ones.
+  // Return false if no lane remains active
+  auto& ln = mLanes;
+  const auto& cfg = mFitters[0];
+  const float minParamChange = cfg.mMinParamChange, minRelChi2Change = cfg.mMinRelChi2Change, maxChi2 = cfg.mMaxChi2;
+  const int maxIter = cfg.mMaxIter;
+
+  // chi2 1st and 2nd derivatives
+  alignas(64) LaneArr<double> dchi[N], d2chi[N][N], cidr[N][N][3];
+  for (int i = 0; i < N; i++) {
+    for (int l = 0; l < NLanes; l++) {
+      dchi[i][l] = 0.;
+    }
+    for (int j = N; j--;) {
+      for (int l = 0; l < NLanes; l++) {
+        cidr[i][j][0][l] = ln.covI[j][0][l] * ln.dr1[j][i][0][l];
+        cidr[i][j][1][l] = ln.covI[j][1][l] * ln.dr1[j][i][1][l] + ln.covI[j][2][l] * ln.dr1[j][i][2][l];
+        cidr[i][j][2][l] = ln.covI[j][2][l] * ln.dr1[j][i][1][l] + ln.covI[j][3][l] * ln.dr1[j][i][2][l];
+        dchi[i][l] += ln.res[j][0][l] * cidr[i][j][0][l] + ln.res[j][1][l] * cidr[i][j][1][l] + ln.res[j][2][l] * cidr[i][j][2][l];
+      }
+    }
+  }
+  for (int i = 0; i < N; i++) {
+    for (int j = 0; j <= i; j++) {
+      for (int l = 0; l < NLanes; l++) {
+        double sum = 0.;
+        for (int k = N; k--;) {
+          sum += ln.dr1[k][j][0][l] * cidr[i][k][0][l] + ln.dr1[k][j][1][l] * cidr[i][k][1][l] + ln.dr1[k][j][2][l] * cidr[i][k][2][l];
+        }
+        const auto* dr2 = ln.dr2[j][j];
+        sum += ln.res[j][0][l] * ln.covI[j][0][l] * dr2[0][l] +
+               ln.res[j][1][l] * (ln.covI[j][1][l] * dr2[1][l] + ln.covI[j][2][l] * dr2[2][l]) +
+               ln.res[j][2][l] * (ln.covI[j][2][l] * dr2[1][l] + ln.covI[j][3][l] * dr2[2][l]);
+        d2chi[i][j][l] = d2chi[j][i][l] = sum;
+      }
+    }
+  }
+
+  // solve d2chi * dx = dchi by Gaussian elimination, lanes with tiny pivots are left to the scalar code with pivoting
+  alignas(64) LaneArr<double> dx[N];
+  alignas(64) LaneArr<bool> singular;
+  for (int l = 0; l < NLanes; l++) {
+    singular[l] = false;
+  }
+  for (int k = 0; k < N; k++) {
+    for (int l = 0; l < NLanes; l++) {
+      double diag = d2chi[k][k][l];
+      singular[l] |= !(std::abs(diag) > 1e-12 * std::abs(d2chi[0][0][l]));
+      double inv = 1. / diag;
+      for (int i = k + 1; i < N; i++) {
+        double f = d2chi[i][k][l] * inv;
+        for (int j = k + 1; j < N; j++) {
+          d2chi[i][j][l] -= f * d2chi[k][j][l];
+        }
+        dchi[i][l] -= f * dchi[k][l];
+      }
+    }
+  }
+  for (int k = N; k--;) {
+    for (int l = 0; l < NLanes; l++) {
+      double sum = dchi[k][l];
+      for (int j = k + 1; j < N; j++) {
+        sum -= d2chi[k][j][l] * dx[j][l];
+      }
+      dx[k][l] = sum / d2chi[k][k][l];
+    }
+  }
+
+  // corrected positions, PCA and residuals
+  alignas(64) LaneArr<double> pos[N][3], pca[3], res[N][3];
+  alignas(64) LaneArr<double> dxMax;
+  alignas(64) LaneArr<float> chi2Upd;
+  for (int l = 0; l < NLanes; l++) {
+    dxMax[l] = -1.;
+    chi2Upd[l] = 0.;
+  }
+  for (int i = 0; i < N; i++) {
+    for (int l = 0; l < NLanes; l++) {
+      double corr = dx[i][l], dx2h = 0.5 * corr * corr;
+      pos[i][0][l] = ln.pos[i][0][l] - corr;
+      pos[i][1][l] = ln.pos[i][1][l] - (ln.der[i][0][l] * corr - dx2h * ln.der[i][2][l]);
+      pos[i][2][l] = ln.pos[i][2][l] - (ln.der[i][1][l] * corr - dx2h * ln.der[i][3][l]);
+      dxMax[l] = std::abs(corr) > dxMax[l] ? std::abs(corr) : dxMax[l];
+    }
+  }
+  for (int k = 0; k < 3; k++) {
+    for (int l = 0; l < NLanes; l++) {
+      pca[k][l] = 0.;
+    }
+    for (int i = N; i--;) {
+      for (int l = 0; l < NLanes; l++) {
+        pca[k][l] += ln.coef[i][k][0][l] * pos[i][0][l] + ln.coef[i][k][1][l] * pos[i][1][l] + ln.coef[i][k][2][l] * pos[i][2][l];
+      }
+    }
+  }
+  alignas(64) LaneArr<double> chi2;
+  for (int l = 0; l < NLanes; l++) {
+    chi2[l] = 0.;
+  }
+  for (int i = N; i--;) {
+    for (int l = 0; l < NLanes; l++) {
+      double xLoc = pca[0][l] * ln.cs[i][l] + pca[1][l] * ln.sn[i][l];
+      double yLoc = -pca[0][l] * ln.sn[i][l] + pca[1][l] * ln.cs[i][l];
+      res[i][0][l] = pos[i][0][l] - xLoc;
+      res[i][1][l] = pos[i][1][l] - yLoc;
+      res[i][2][l] = pos[i][2][l] - pca[2][l];
+      chi2[l] += res[i][0][l] * res[i][0][l] * ln.covI[i][0][l] + res[i][1][l] * res[i][1][l] * ln.covI[i][1][l] +
+                 res[i][2][l] * res[i][2][l] * ln.covI[i][3][l] + 2. * res[i][1][l] * res[i][2][l] * ln.covI[i][2][l];
+    }
+  }
+  for (int l = 0; l < NLanes; l++) {
+    chi2Upd[l] = chi2[l];
+  }
+
+  // commit the iteration for the active lanes
+  bool anyActive = false;
+  for (int l = 0; l < NLanes; l++) {
+    if (!ln.active[l]) {
+      continue;
+    }
+    if (singular[l]) {
+      ln.active[l] = false;
+      ln.scalar[l] = true; // will redo this iteration
+      continue;
+    }
+    for (int i = 0; i < N; i++) {
+      for (int k = 0; k < 3; k++) {
+        ln.pos[i][k][l] = pos[i][k][l];
+        ln.res[i][k][l] = res[i][k][l];
+      }
+    }
+    for (int k = 0; k < 3; k++) {
+      ln.pca[k][l] = pca[k][l];
+    }
+    if (ln.useAlt[l]) {
+      double dxCur = pca[0][l] - ln.xCur[l], dyCur = pca[1][l] - ln.yCur[l];
+      double dxAlt = pca[0][l] - ln.xAlt[l], dyAlt = pca[1][l] - ln.yAlt[l];
+      if (dxCur * dxCur + dyCur * dyCur > dxAlt * dxAlt + dyAlt * dyAlt) {
+        mFitters[l].mAllowAltPreference = false;
+        ln.active[l] = false;
+        ln.ok[l] = false;
+        continue;
+      }
+    }
+    bool converged = dxMax[l] < minParamChange || chi2Upd[l] > ln.chi2[l] * minRelChi2Change;
+    ln.chi2[l] = chi2Upd[l];
+    if (converged || ++ln.nIter[l] >= maxIter) {
+      auto& ft = mFitters[l];
+      ft.mChi2[ft.mCurHyp] = ln.chi2[l] * Fitter::NInv;
+      ln.ok[l] = ft.mChi2[ft.mCurHyp] < maxChi2;
+      ln.active[l] = false;
+      storeLane(l);
+      continue;
+    }
+    anyActive = true;
+  }
+  return anyActive;
+}
+
+} // namespace vertexing
+} // namespace o2
+#endif // _ALICEO2_DCA_FITTERN_BATCH_
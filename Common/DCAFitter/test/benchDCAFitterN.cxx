@@ -0,0 +1,160 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchDCAFitterN.cxx
+/// \brief Benchmark of the batched DCAFitterN processing against the candidate by candidate one
+///
+/// The candidates are N tracks from random decay points. Every benchmark reports the number of
+/// candidates whose results differ from the DCAFitterN::process ones and the largest PCA difference.
+
+#include "benchmark/benchmark.h"
+#include "DCAFitter/DCAFitterNBatch.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+using namespace o2::vertexing;
+using Track = o2::track::TrackParCov;
+
+namespace
+{
+constexpr float Bz = 5.f;
+constexpr int NCandidates = 20000;
+
+template <int N>
+struct Sample {
+  std::vector<Track> tracks;
+  std::vector<std::array<const Track*, N>> candidates;
+  std::vector<int> nVtx;                     // reference number of vertices
+  std::vector<std::array<double, 4>> result; // reference PCA and chi2 of the best vertex
+};
+
+template <int N>
+DCAFitterN<N> getFitter(bool propagateToPCA)
+{
+  DCAFitterN<N> ft;
+  ft.setBz(Bz);
+  ft.setPropagateToPCA(propagateToPCA);
+  ft.setMaxR(200);
+  ft.setMaxDZIni(4);
+  ft.setMaxDXYIni(4);
+  ft.setMinParamChange(1e-3);
+  ft.setMinRelChi2Change(0.9);
+  return ft;
+}
+
+template <int N>
+const Sample<N>& getSample(bool propagateToPCA)
+{
+  static std::map<bool, Sample<N>> samples;
+  auto& smp = samples[propagateToPCA];
+  if (smp.tracks.empty()) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> rnd(0.f, 1.f);
+    std::normal_distribution<float> gaus(0.f, 1.f);
+    const float errYZ = 1e-2, errSlp = 1e-3, errQPT = 2e-2;
+    smp.tracks.reserve(N * NCandidates);
+    for (int ic = 0; ic < NCandidates; ic++) {
+      float phi = rnd(rng) * 2 * M_PI, r = 1.f + rnd(rng) * 30.f, z = (rnd(rng) - 0.5f) * 20.f;
+      float vx = r * std::cos(phi), vy = r * std::sin(phi);
+      for (int i = 0; i < N; i++) {
+        float alp = phi + (rnd(rng) - 0.5f) * 0.6f, pt = 0.2f + rnd(rng) * 3.f;
+        float sn = std::sin(alp), cs = std::cos(alp);
+        std::array<float, 5> par = {-vx * sn + vy * cs + gaus(rng) * errYZ, z + gaus(rng) * errYZ, gaus(rng) * errSlp,
+                                    rnd(rng) - 0.5f + gaus(rng) * errSlp, (i % 2 ? -1.f : 1.f) / pt};
+        std::array<float, 15> cov = {errYZ * errYZ, 0., errYZ * errYZ, 0., 0., errSlp * errSlp, 0., 0., 0., errSlp * errSlp,
+                                     0., 0., 0., 0., errQPT * errQPT * par[4] * par[4]};
+        auto& trc = smp.tracks.emplace_back(vx * cs + vy * sn, alp, par, cov);
+        trc.propagateTo(trc.getX() + (rnd(rng) - 0.5f) * 10.f, Bz);
+        trc.rotate(trc.getAlpha() + (rnd(rng) - 0.5f) * 0.2f);
+      }
+    }
+    auto ft = getFitter<N>(propagateToPCA);
+    for (int ic = 0; ic < NCandidates; ic++) {
+      auto& cand = smp.candidates.emplace_back();
+      for (int i = 0; i < N; i++) {
+        cand[i] = &smp.tracks[N * ic + i];
+      }
+      int nv = std::apply([&ft](auto... trc) { return ft.process(*trc...); }, cand);
+      smp.nVtx.push_back(nv);
+      auto& res = smp.result.emplace_back();
+      if (nv) {
+        res = {ft.getPCACandidate()[0], ft.getPCACandidate()[1], ft.getPCACandidate()[2], ft.getChi2AtPCACandidate()};
+      }
+    }
+  }
+  return smp;
+}
+} // namespace
+
+// Args: batched processing, propagation of the tracks to the PCA
+template <int N>
+static void BM_DCAFitterN(benchmark::State& state)
+{
+  bool batch = state.range(0), propagateToPCA = state.range(1);
+  const auto& smp = getSample<N>(propagateToPCA);
+  auto ft = getFitter<N>(propagateToPCA);
+  DCAFitterNBatch<N> bft(ft);
+  std::vector<int> nVtx(NCandidates);
+  std::vector<std::array<double, 4>> result(NCandidates);
+  auto store = [&nVtx, &result](int ic, int nv, const DCAFitterN<N>& fitter) {
+    nVtx[ic] = nv;
+    if (nv) {
+      result[ic] = {fitter.getPCACandidate()[0], fitter.getPCACandidate()[1], fitter.getPCACandidate()[2], fitter.getChi2AtPCACandidate()};
+    }
+  };
+  for (auto _ : state) {
+    if (batch) {
+      bft.process(gsl::span<const std::array<const Track*, N>>(smp.candidates), store);
+    } else {
+      for (int ic = 0; ic < NCandidates; ic++) {
+        store(ic, std::apply([&ft](auto... trc) { return ft.process(*trc...); }, smp.candidates[ic]), ft);
+      }
+    }
+    benchmark::DoNotOptimize(result.data());
+  }
+  size_t nDiff = 0;
+  double maxPCADiff = 0.;
+  for (int ic = 0; ic < NCandidates; ic++) {
+    if (nVtx[ic] != smp.nVtx[ic]) {
+      nDiff++;
+      continue;
+    }
+    if (nVtx[ic]) {
+      for (int k = 0; k < 3; k++) {
+        maxPCADiff = std::max(maxPCADiff, std::abs(result[ic][k] - smp.result[ic][k]));
+      }
+      if (std::abs(result[ic][3] - smp.result[ic][3]) > 1e-3 * (1e-3 + smp.result[ic][3])) {
+        nDiff++;
+      }
+    }
+  }
+  state.counters["candidates"] = benchmark::Counter(NCandidates * state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["diffFrac"] = double(nDiff) / NCandidates;
+  state.counters["maxPCADiff"] = maxPCADiff;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int propagateToPCA : {0, 1}) {
+    bench->Args({0, propagateToPCA});
+    bench->Args({1, propagateToPCA});
+  }
+}
+
+BENCHMARK_TEMPLATE(BM_DCAFitterN, 2)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_DCAFitterN, 3)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -15,6 +15,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include "DCAFitter/DCAFitterN.h"
+#include "DCAFitter/DCAFitterNBatch.h"
 #include "CommonUtils/TreeStreamRedirector.h"
 #include <TRandom.h>
 #include <TGenPhaseSpace.h>
@@ -556,5 +557,62 @@ BOOST_AUTO_TEST_CASE(DCAFitterNProngs)
   outStream.Close();
 }
 
+template <int N>
+void checkBatch(const std::vector<double>& dtMass, double parMass, bool useAbsDCA)
+{
+  constexpr int NTest = 2000;
+  constexpr double bz = 5.0;
+  TGenPhaseSpace genPHS;
+  Vec3D vtxGen;
+  std::vector<int> forceQ(N, 1);
+  std::vector<o2::track::TrackParCov> vctracks, tracks;
+  for (int iev = 0; iev < NTest; iev++) {
+    generate(vtxGen, vctracks, bz, genPHS, parMass, dtMass, forceQ);
+    tracks.insert(tracks.end(), vctracks.begin(), vctracks.end());
+  }
+  std::vector<std::array<const o2::track::TrackParCov*, N>> cands(NTest);
+  for (int iev = 0; iev < NTest; iev++) {
+    for (int i = 0; i < N; i++) {
+      cands[iev][i] = &tracks[iev * N + i];
+    }
+  }
+  DCAFitterN<N> ft;
+  ft.setBz(bz);
+  ft.setUseAbsDCA(useAbsDCA);
+  DCAFitterNBatch<N> bft(ft);
+  int nDiff = 0, nProcessed = 0;
+  int nFound = bft.process(gsl::span<const std::array<const o2::track::TrackParCov*, N>>(cands), [&](int iev, int nc, DCAFitterN<N>& bfit) {
+    BOOST_CHECK(iev == nProcessed++);
+    int ncRef = std::apply([&ft](auto... trc) { return ft.process(*trc...); }, cands[iev]);
+    if (nc != ncRef) {
+      nDiff++;
+      return;
+    }
+    for (int ic = 0; ic < nc; ic++) {
+      const auto &vtx = bfit.getPCACandidate(ic), &vtxRef = ft.getPCACandidate(ic);
+      if (std::abs(vtx[0] - vtxRef[0]) > 1e-6 || std::abs(vtx[1] - vtxRef[1]) > 1e-6 || std::abs(vtx[2] - vtxRef[2]) > 1e-6 || bfit.getNIterations(ic) != ft.getNIterations(ic) ||
+          std::abs(bfit.getChi2AtPCACandidate(ic) - ft.getChi2AtPCACandidate(ic)) > 1e-4 * (1. + ft.getChi2AtPCACandidate(ic)) ||
+          std::abs(bfit.getTrack(0, ic).getSnp() - ft.getTrack(0, ic).getSnp()) > 1e-5) {
+        nDiff++;
+      }
+    }
+  });
+  LOG(info) << "Batched " << N << "-prong fit " << (useAbsDCA ? "abs.dist" : "wgh.dist") << ": " << nFound << " vertices, " << nDiff << " differ from the scalar fit";
+  BOOST_CHECK(nProcessed == NTest);
+  BOOST_CHECK(nFound > 0.99 * NTest);
+  BOOST_CHECK(nDiff < 0.001 * NTest);
+}
+
+BOOST_AUTO_TEST_CASE(DCAFitterNBatchProcessing)
+{
+  constexpr double pion = 0.13957;
+  constexpr double k0 = 0.49761;
+  constexpr double kch = 0.49368;
+  constexpr double dch = 1.86965;
+  checkBatch<2>({pion, pion}, k0, false);
+  checkBatch<2>({pion, pion}, k0, true);
+  checkBatch<3>({pion, kch, pion}, dch, false);
+}
+
 } // namespace vertexing
 } // namespace o2
@@ -53,6 +53,12 @@ struct ANSHeader {
 inline constexpr ANSHeader ANSVersionUnspecified{0, 0};
 inline constexpr ANSHeader ANSVersionCompat{0, 1};
 inline constexpr ANSHeader ANSVersion1{1, 0};
+inline constexpr ANSHeader ANSVersion1Chunked{1, 1}; // ANSVersion1 with Metadata::OptStore::EENCODE_CHUNKED blocks, rejected by readers knowing only 1.0
+
+inline constexpr bool isANSVersion1(const ANSHeader& ansVersion) noexcept
+{
+  return ansVersion == ANSVersion1 || ansVersion == ANSVersion1Chunked;
+}
 
 inline ANSHeader ansVersionFromString(const std::string& ansVersionString)
 {
@@ -34,6 +34,7 @@
 #ifndef __CLING__
 #include "DetectorsCommonDataFormats/internal/ExternalEntropyCoder.h"
 #include "DetectorsCommonDataFormats/internal/InplaceEntropyCoder.h"
+#include "rANS/chunked.h"
 #include "rANS/compat.h"
 #include "rANS/histogram.h"
 #include "rANS/serialize.h"
@@ -66,17 +67,19 @@ inline constexpr bool is_iterator_v = is_iterator<T>::value;
 
 inline constexpr bool mayEEncode(Metadata::OptStore opt) noexcept
 {
-  return (opt == Metadata::OptStore::EENCODE) || (opt == Metadata::OptStore::EENCODE_OR_PACK);
+  return (opt == Metadata::OptStore::EENCODE) || (opt == Metadata::OptStore::EENCODE_OR_PACK) || (opt == Metadata::OptStore::EENCODE_CHUNKED);
 }
 
 inline constexpr bool mayPack(Metadata::OptStore opt) noexcept
 {
-  return (opt == Metadata::OptStore::PACK) || (opt == Metadata::OptStore::EENCODE_OR_PACK);
+  return (opt == Metadata::OptStore::PACK) || (opt == Metadata::OptStore::EENCODE_OR_PACK) || (opt == Metadata::OptStore::EENCODE_CHUNKED);
 }
 
 } // namespace detail
 constexpr size_t PackingThreshold = 512;
 
+constexpr size_t ChunkedEncodingChunkSize = 1 << 22; // N samples per chunk of blocks stored as Metadata::OptStore::EENCODE_CHUNKED
+
 constexpr size_t Alignment = 16;
 
 constexpr int WrappersSplitLevel = 99;
@@ -399,7 +402,7 @@ class EncodedBlocks
     if (ansVersion == ANSVersionCompat) {
       rans::DenseHistogram<source_T> histogram{block.getDict(), block.getDict() + block.getNDict(), metadata.min};
       return rans::compat::renorm(std::move(histogram), metadata.probabilityBits);
-    } else if (ansVersion == ANSVersion1) {
+    } else if (isANSVersion1(ansVersion)) {
       // dictionary is loaded from an explicit dict file and is stored densly
       if (getANSHeader() == ANSVersionUnspecified) {
         rans::DenseHistogram<source_T> histogram{block.getDict(), block.getDict() + block.getNDict(), metadata.min};
@@ -492,24 +495,45 @@ class EncodedBlocks
   template <typename VD>
   static void readFromTree(VD& vec, TTree& tree, const std::string& name, int ev = 0);
 
-  /// encode vector src to bloc at provided slot
+  /// encode vector src to bloc at provided slot, nThreads is used for the chunks of Metadata::OptStore::EENCODE_CHUNKED blocks
   template <typename VE, typename buffer_T>
-  inline o2::ctf::CTFIOSize encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f)
+  inline o2::ctf::CTFIOSize encode(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f, int nThreads = 1)
   {
-    return encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc);
+    return encode(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, buffer, encoderExt, memfc, nThreads);
   }
 
-  /// encode vector src to bloc at provided slot
+  /// encode vector src to bloc at provided slot, nThreads is used for the chunks of Metadata::OptStore::EENCODE_CHUNKED blocks
+  template <typename input_IT, typename buffer_T>
+  o2::ctf::CTFIOSize encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f, int nThreads = 1);
+
+  /// encode source range to a detached container created in the scratch buffer, holding only the block of provided slot.
+  /// This container is not modified, so different slots can be encoded concurrently and appended later with adoptBlock
   template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize encode(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f);
+  o2::ctf::CTFIOSize encodeDetached(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, buffer_T& scratch, const std::any& encoderExt = {}, float memfc = 1.f, int nThreads = 1) const;
+
+  /// append block and metadata of provided slot of the detached container (see encodeDetached) to this container
+  template <typename buffer_T>
+  void adoptBlock(const EncodedBlocks& src, int slot, buffer_T* buffer = nullptr);
 
   /// decode block at provided slot to destination vector (will be resized as needed)
   template <class container_T, class container_IT = typename container_T::iterator>
-  o2::ctf::CTFIOSize decode(container_T& dest, int slot, const std::any& decoderExt = {}) const;
+  o2::ctf::CTFIOSize decode(container_T& dest, int slot, const std::any& decoderExt = {}, int nThreads = 1) const;
 
   /// decode block at provided slot to destination pointer, the needed space assumed to be available
   template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
-  o2::ctf::CTFIOSize decode(D_IT dest, int slot, const std::any& decoderExt = {}) const;
+  o2::ctf::CTFIOSize decode(D_IT dest, int slot, const std::any& decoderExt = {}, int nThreads = 1) const;
+
+  /// number of independently decodable chunks of the block at provided slot, 0 if the block is not stored in chunks
+  size_t getNChunks(int slot) const
+  {
+    // the chunk index (see rans::ChunkIndexView) starts with the number of chunks
+    return (mMetadata[slot].opt == Metadata::OptStore::EENCODE_CHUNKED && mBlocks[slot].getNData()) ? mBlocks[slot].getData()[0] : 0;
+  }
+
+  /// decode only the chunk of the Metadata::OptStore::EENCODE_CHUNKED block at provided slot to destination pointer,
+  /// the chunk covers the samples [chunk * ChunkSize, min((chunk + 1) * ChunkSize, messageLength)) of the block
+  template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool> = true>
+  o2::ctf::CTFIOSize decodeChunk(D_IT dest, int slot, size_t chunk, const std::any& decoderExt = {}) const;
 
 #ifndef __CLING__
   /// create a special EncodedBlocks containing only dictionaries made from provided vector of frequency tables
@@ -592,13 +616,13 @@ class EncodedBlocks
   o2::ctf::CTFIOSize entropyCodeRANSCompat(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f);
 
   template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize entropyCodeRANSV1(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f);
+  o2::ctf::CTFIOSize entropyCodeRANSV1(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, const std::any& encoderExt = {}, float memfc = 1.f, int nThreads = 1);
 
   template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const std::any& encoderExt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1);
+  o2::ctf::CTFIOSize encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, const std::any& encoderExt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1, int nThreads = 1);
 
   template <typename input_IT, typename buffer_T>
-  o2::ctf::CTFIOSize encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1);
+  o2::ctf::CTFIOSize encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer = nullptr, double_t sizeEstimateSafetyFactor = 1, int nThreads = 1);
 
 #ifndef __CLING__
   template <typename input_IT, typename buffer_T>
@@ -635,7 +659,7 @@ class EncodedBlocks
   CTFIOSize decodeCompatImpl(dst_IT dest, int slot, const std::any& decoderExt) const;
 
   template <typename dst_IT>
-  CTFIOSize decodeRansV1Impl(dst_IT dest, int slot, const std::any& decoderExt) const;
+  CTFIOSize decodeRansV1Impl(dst_IT dest, int slot, const std::any& decoderExt, int nThreads = 1, int chunk = -1) const;
 
   template <typename dst_IT>
   CTFIOSize decodeUnpackImpl(dst_IT dest, int slot) const;
@@ -907,20 +931,22 @@ void EncodedBlocks<H, N, W>::print(const std::string& prefix, int verbosity) con
 ///_____________________________________________________________________________
 template <typename H, int N, typename W>
 template <class container_T, class container_IT>
-inline o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::decode(container_T& dest,                // destination container
-                                                         int slot,                         // slot of the block to decode
-                                                         const std::any& decoderExt) const // optional externally provided decoder
+inline o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::decode(container_T& dest,              // destination container
+                                                         int slot,                       // slot of the block to decode
+                                                         const std::any& decoderExt,     // optional externally provided decoder
+                                                         int nThreads) const             // number of threads for chunked blocks
 {
   dest.resize(mMetadata[slot].messageLength); // allocate output buffer
-  return decode(std::begin(dest), slot, decoderExt);
+  return decode(std::begin(dest), slot, decoderExt, nThreads);
 }
 
 ///_____________________________________________________________________________
 template <typename H, int N, typename W>
 template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
-CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,                        // iterator to destination
-                                         int slot,                         // slot of the block to decode
-                                         const std::any& decoderExt) const // optional externally provided decoder
+CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,                    // iterator to destination
+                                         int slot,                     // slot of the block to decode
+                                         const std::any& decoderExt,   // optional externally provided decoder
+                                         int nThreads) const           // number of threads for chunked blocks
 {
 
   // get references to the right data
@@ -935,26 +961,44 @@ CTFIOSize EncodedBlocks<H, N, W>::decode(D_IT dest,                        // it
     }
     if (md.opt == Metadata::OptStore::EENCODE) {
       return decodeCompatImpl(dest, slot, decoderExt);
+    } else if (md.opt == Metadata::OptStore::EENCODE_CHUNKED) {
+      throw std::runtime_error(fmt::format("Slot {}: chunked storage is not supported by ANS Version {}", slot, static_cast<std::string>(ansVersion)));
     } else {
       return decodeCopyImpl(dest, slot);
     }
-  } else if (ansVersion == ANSVersion1) {
+  } else if (isANSVersion1(ansVersion)) {
     if (md.opt == Metadata::OptStore::PACK) {
       return decodeUnpackImpl(dest, slot);
     }
     if (!block.getNStored()) {
       return {0, md.getUncompressedSize(), md.getCompressedSize()};
     }
-    if (md.opt == Metadata::OptStore::EENCODE) {
-      return decodeRansV1Impl(dest, slot, decoderExt);
-    } else {
+    if (md.opt == Metadata::OptStore::EENCODE || (md.opt == Metadata::OptStore::EENCODE_CHUNKED && ansVersion == ANSVersion1Chunked)) {
+      return decodeRansV1Impl(dest, slot, decoderExt, nThreads);
+    } else if (md.opt == Metadata::OptStore::NONE || md.opt == Metadata::OptStore::ROOTCompression) {
       return decodeCopyImpl(dest, slot);
+    } else {
+      throw std::runtime_error(fmt::format("Slot {}: unsupported storage option {} for ANS Version {}", slot, (int)md.opt, static_cast<std::string>(ansVersion)));
     }
   } else {
     throw std::runtime_error("unsupported ANS Version");
   }
 };
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename D_IT, std::enable_if_t<detail::is_iterator_v<D_IT>, bool>>
+CTFIOSize EncodedBlocks<H, N, W>::decodeChunk(D_IT dest,                        // iterator to destination of the chunk
+                                              int slot,                         // slot of the block to decode
+                                              size_t chunk,                     // chunk to decode
+                                              const std::any& decoderExt) const // optional externally provided decoder
+{
+  if (chunk >= getNChunks(slot)) {
+    throw std::runtime_error(fmt::format("Slot {} has no chunk {}, number of chunks: {}", slot, chunk, getNChunks(slot)));
+  }
+  return decodeRansV1Impl(dest, slot, decoderExt, 1, int(chunk));
+}
+
 #ifndef __CLING__
 template <typename H, int N, typename W>
 template <typename dst_IT>
@@ -996,7 +1040,7 @@ CTFIOSize EncodedBlocks<H, N, W>::decodeCompatImpl(dst_IT dstBegin, int slot, co
 
 template <typename H, int N, typename W>
 template <typename dst_IT>
-CTFIOSize EncodedBlocks<H, N, W>::decodeRansV1Impl(dst_IT dstBegin, int slot, const std::any& decoderExt) const
+CTFIOSize EncodedBlocks<H, N, W>::decodeRansV1Impl(dst_IT dstBegin, int slot, const std::any& decoderExt, int nThreads, int chunk) const
 {
 
   // get references to the right data
@@ -1037,6 +1081,28 @@ CTFIOSize EncodedBlocks<H, N, W>::decodeRansV1Impl(dst_IT dstBegin, int slot, co
     }
   }();
 
+  if (md.opt == Metadata::OptStore::EENCODE_CHUNKED) {
+    const rans::ChunkedDecoder<decoder_type> chunkedDecoder{getDecoder(), static_cast<size_t>(nThreads)};
+    const rans::ChunkIndexView<W> index{block.getData()};
+    if (chunk >= 0) {
+      // literals of the chunks are stored consecutively, unpack only up to the end of the requested chunk
+      const size_t nLiterals = block.getNLiterals() ? index.getChunkLiteralsEnd(chunk) : 0;
+      std::vector<dst_type> literals(nLiterals);
+      if (nLiterals) {
+        rans::unpack(block.getLiterals(), nLiterals, literals.data(), md.literalsPackingWidth, md.literalsPackingOffset);
+      }
+      chunkedDecoder.processChunk(block.getData(), chunk, dstBegin, md.messageLength, md.nStreams, literals.data());
+      const size_t chunkLength = index.getChunkMessageLength(chunk, md.messageLength);
+      return {0, chunkLength * md.messageWordSize, md.getCompressedSize()};
+    }
+    std::vector<dst_type> literals(md.nLiterals);
+    if (block.getNLiterals()) {
+      rans::unpack(block.getLiterals(), md.nLiterals, literals.data(), md.literalsPackingWidth, md.literalsPackingOffset);
+    }
+    chunkedDecoder.process(block.getData(), dstBegin, md.messageLength, md.nStreams, literals.data());
+    return {0, md.getUncompressedSize(), md.getCompressedSize()};
+  }
+
   // do the actual decoding
   if (block.getNLiterals()) {
     std::vector<dst_type> literals(md.nLiterals);
@@ -1111,7 +1177,8 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
                                                   Metadata::OptStore opt,       // option for data compression
                                                   buffer_T* buffer,             // optional buffer (vector) providing memory for encoded blocks
                                                   const std::any& encoderExt,   // optional external encoder
-                                                  float memfc)                  // memory allocation margin factor
+                                                  float memfc,                  // memory allocation margin factor
+                                                  int nThreads)                 // number of threads for chunked encoding
 {
   // fill a new block
   assert(slot == mRegistry.nFilledBlocks);
@@ -1133,8 +1200,8 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
     const ANSHeader& ansVersion = getANSHeader();
     if (ansVersion == ANSVersionCompat) {
       return entropyCodeRANSCompat(srcBegin, srcEnd, slot, symbolTablePrecision, buffer, encoderExt, memfc);
-    } else if (ansVersion == ANSVersion1) {
-      return entropyCodeRANSV1(srcBegin, srcEnd, slot, opt, buffer, encoderExt, memfc);
+    } else if (isANSVersion1(ansVersion)) {
+      return entropyCodeRANSV1(srcBegin, srcEnd, slot, opt, buffer, encoderExt, memfc, nThreads);
     } else {
       throw std::runtime_error(fmt::format("Unsupported ANS Coder Version: {}.{}", ansVersion.majorVersion, ansVersion.minorVersion));
     }
@@ -1145,6 +1212,49 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encode(const input_IT srcBegin,
   }
 };
 
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename input_IT, typename buffer_T>
+o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::encodeDetached(const input_IT srcBegin,      // iterator begin of source message
+                                                          const input_IT srcEnd,        // iterator end of source message
+                                                          int slot,                     // slot in encoded data to fill
+                                                          uint8_t symbolTablePrecision, // encoding into
+                                                          Metadata::OptStore opt,       // option for data compression
+                                                          buffer_T& scratch,            // buffer (vector) providing memory for the detached container
+                                                          const std::any& encoderExt,   // optional external encoder
+                                                          float memfc,                  // memory allocation margin factor
+                                                          int nThreads) const           // number of threads for chunked encoding
+{
+  auto* detached = create(scratch);
+  detached->setHeader(mHeader);
+  detached->setANSHeader(mANSHeader);
+  detached->mRegistry.nFilledBlocks = slot; // only the requested slot will be filled
+  return detached->encode(srcBegin, srcEnd, slot, symbolTablePrecision, opt, &scratch, encoderExt, memfc, nThreads);
+}
+
+///_____________________________________________________________________________
+template <typename H, int N, typename W>
+template <typename buffer_T>
+void EncodedBlocks<H, N, W>::adoptBlock(const EncodedBlocks& src, int slot, buffer_T* buffer)
+{
+  // fill a new block
+  assert(slot == mRegistry.nFilledBlocks);
+  mRegistry.nFilledBlocks++;
+
+  const auto& srcBlock = src.mBlocks[slot];
+  if (!srcBlock.getNStored()) { // nothing was stored, the metadata is sufficient
+    mMetadata[slot] = src.mMetadata[slot];
+    return;
+  }
+  if (src.mMetadata[slot].opt == Metadata::OptStore::EENCODE_CHUNKED) {
+    mANSHeader = src.mANSHeader;
+  }
+  // note: "this" might be not valid after expandStorage call!!!
+  auto [thisBlock, thisMetadata] = expandStorage(slot, srcBlock.getNStored(), buffer);
+  thisBlock->store(srcBlock.getNDict(), srcBlock.getNData(), srcBlock.getNLiterals(), srcBlock.getDict(), srcBlock.getData(), srcBlock.getLiterals());
+  *thisMetadata = src.mMetadata[slot];
+}
+
 template <typename H, int N, typename W>
 template <typename T>
 [[nodiscard]] auto EncodedBlocks<H, N, W>::expandStorage(size_t slot, size_t nElements, T* buffer) -> decltype(auto)
@@ -1273,7 +1383,7 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSCompat(const input_IT
 
 template <typename H, int N, typename W>
 template <typename input_IT, typename buffer_T>
-o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, const std::any& encoderExt, float memfc)
+o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, const std::any& encoderExt, float memfc, int nThreads)
 {
   CTFIOSize encoderStatistics{};
 
@@ -1283,9 +1393,9 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcB
   } else {
 
     if (encoderExt.has_value()) {
-      encoderStatistics = encodeRANSV1External(srcBegin, srcEnd, slot, encoderExt, buffer, memfc);
+      encoderStatistics = encodeRANSV1External(srcBegin, srcEnd, slot, opt, encoderExt, buffer, memfc, nThreads);
     } else {
-      encoderStatistics = encodeRANSV1Inplace(srcBegin, srcEnd, slot, opt, buffer, memfc);
+      encoderStatistics = encodeRANSV1Inplace(srcBegin, srcEnd, slot, opt, buffer, memfc, nThreads);
     }
   }
   return encoderStatistics;
@@ -1293,7 +1403,7 @@ o2::ctf::CTFIOSize EncodedBlocks<H, N, W>::entropyCodeRANSV1(const input_IT srcB
 
 template <typename H, int N, typename W>
 template <typename input_IT, typename buffer_T>
-CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, const std::any& encoderExt, buffer_T* buffer, double_t sizeEstimateSafetyFactor)
+CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, const std::any& encoderExt, buffer_T* buffer, double_t sizeEstimateSafetyFactor, int nThreads)
 {
   using storageBuffer_t = W;
   using input_t = typename std::iterator_traits<input_IT>::value_type;
@@ -1310,12 +1420,20 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin,
 
   const size_t messageLength = std::distance(srcBegin, srcEnd);
   internal::ExternalEntropyCoder<input_t> encoder{std::any_cast<const ransEncoder_t&>(encoderExt)};
+  const bool chunked = (opt == Metadata::OptStore::EENCODE_CHUNKED) && (messageLength > ChunkedEncodingChunkSize);
+  if (chunked) {
+    mANSHeader = ANSVersion1Chunked; // "this" is still valid before the expandStorage call
+  }
 
-  const size_t payloadSizeWords = encoder.template computePayloadSizeEstimate<storageBuffer_t>(messageLength);
+  size_t payloadSizeWords = encoder.template computePayloadSizeEstimate<storageBuffer_t>(messageLength);
+  if (chunked) {
+    payloadSizeWords += rans::ChunkedEncoder{encoder.getEncoder(), ChunkedEncodingChunkSize}.getChunkingOverhead(messageLength);
+  }
   std::tie(thisBlock, thisMetadata) = expandStorage(slot, payloadSizeWords, buffer);
 
   // encode payload
-  auto encodedMessageEnd = encoder.encode(srcBegin, srcEnd, thisBlock->getCreateData(), thisBlock->getEndOfBlock());
+  auto encodedMessageEnd = chunked ? encoder.encodeChunked(srcBegin, srcEnd, thisBlock->getCreateData(), thisBlock->getEndOfBlock(), ChunkedEncodingChunkSize, nThreads)
+                                   : encoder.encode(srcBegin, srcEnd, thisBlock->getCreateData(), thisBlock->getEndOfBlock());
   const size_t dataSize = std::distance(thisBlock->getCreateData(), encodedMessageEnd);
   thisBlock->setNData(dataSize);
   thisBlock->realignBlock();
@@ -1348,13 +1466,16 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1External(const input_IT srcBegin,
                                                                                  0,
                                                                                  dataSize,
                                                                                  literalsSize);
+  if (chunked) {
+    thisMetadata->opt = Metadata::OptStore::EENCODE_CHUNKED;
+  }
 
   return {0, thisMetadata->getUncompressedSize(), thisMetadata->getCompressedSize()};
 };
 
 template <typename H, int N, typename W>
 template <typename input_IT, typename buffer_T>
-CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, double_t sizeEstimateSafetyFactor)
+CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, const input_IT srcEnd, int slot, Metadata::OptStore opt, buffer_T* buffer, double_t sizeEstimateSafetyFactor, int nThreads)
 {
   using storageBuffer_t = W;
   using input_t = typename std::iterator_traits<input_IT>::value_type;
@@ -1407,11 +1528,21 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
 
   encoder.makeEncoder();
 
+  const size_t messageLength = std::distance(srcBegin, srcEnd);
+  const bool chunked = (opt == Metadata::OptStore::EENCODE_CHUNKED) && (messageLength > ChunkedEncodingChunkSize);
+  if (chunked) {
+    mANSHeader = ANSVersion1Chunked; // "this" is still valid before the expandStorage call
+  }
+
   const rans::SizeEstimate sizeEstimate = metrics.getSizeEstimate();
-  const size_t bufferSizeWords = rans::utils::nBytesTo<storageBuffer_t>((sizeEstimate.getCompressedDictionarySize() +
-                                                                         sizeEstimate.getCompressedDatasetSize() +
-                                                                         sizeEstimate.getIncompressibleSize()) *
-                                                                        sizeEstimateSafetyFactor);
+  size_t bufferSizeWords = rans::utils::nBytesTo<storageBuffer_t>((sizeEstimate.getCompressedDictionarySize() +
+                                                                   sizeEstimate.getCompressedDatasetSize() +
+                                                                   sizeEstimate.getIncompressibleSize()) *
+                                                                  sizeEstimateSafetyFactor);
+  if (chunked) {
+    const size_t nChunks = rans::ChunkIndexView<storageBuffer_t>::getNChunks(messageLength, ChunkedEncodingChunkSize);
+    bufferSizeWords += rans::ChunkIndexView<storageBuffer_t>::getIndexSize(nChunks) + nChunks * 2 * encoder.getNStreams();
+  }
   std::tie(thisBlock, thisMetadata) = expandStorage(slot, bufferSizeWords, buffer);
 
   // encode dict
@@ -1423,7 +1554,13 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
 
   // encode payload
   auto encodedMessageEnd = thisBlock->getCreateData();
-  if (proxy.isCached()) {
+  if (chunked) {
+    if (proxy.isCached()) {
+      encodedMessageEnd = encoder.encodeChunked(proxy.beginCache(), proxy.endCache(), thisBlock->getCreateData(), thisBlock->getEndOfBlock(), ChunkedEncodingChunkSize, nThreads);
+    } else {
+      encodedMessageEnd = encoder.encodeChunked(proxy.beginIter(), proxy.endIter(), thisBlock->getCreateData(), thisBlock->getEndOfBlock(), ChunkedEncodingChunkSize, nThreads);
+    }
+  } else if (proxy.isCached()) {
     encodedMessageEnd = encoder.encode(proxy.beginCache(), proxy.endCache(), thisBlock->getCreateData(), thisBlock->getEndOfBlock());
   } else {
     encodedMessageEnd = encoder.encode(proxy.beginIter(), proxy.endIter(), thisBlock->getCreateData(), thisBlock->getEndOfBlock());
@@ -1447,7 +1584,7 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
   // write metadata
   *thisMetadata = detail::makeMetadataRansV1<input_t, ransState_t, ransStream_t>(encoder.getNStreams(),
                                                                                  rans::utils::getStreamingLowerBound_v<typename ransEncoder_t::coder_type>,
-                                                                                 std::distance(srcBegin, srcEnd),
+                                                                                 messageLength,
                                                                                  encoder.getNIncompressibleSamples(),
                                                                                  encoder.getSymbolTablePrecision(),
                                                                                  *metrics.getCoderProperties().min,
@@ -1457,6 +1594,9 @@ CTFIOSize EncodedBlocks<H, N, W>::encodeRANSV1Inplace(const input_IT srcBegin, c
                                                                                  dictSize,
                                                                                  dataSize,
                                                                                  literalsSize);
+  if (chunked) {
+    thisMetadata->opt = Metadata::OptStore::EENCODE_CHUNKED;
+  }
 
   return {0, thisMetadata->getUncompressedSize(), thisMetadata->getCompressedSize()};
 }; // namespace ctf
@@ -30,7 +30,8 @@ struct Metadata {
     NONE,                         // original data repacked to array with slot-size = streamSize and saved w/o compression
     NODATA,                       // no data was provided
     PACK,                         // use Bitpacking
-    EENCODE_OR_PACK               // decide at runtime if to encode or pack
+    EENCODE_OR_PACK,              // decide at runtime if to encode or pack
+    EENCODE_CHUNKED               // entropy encoding of large blocks in independent chunks sharing the dictionary, otherwise as EENCODE_OR_PACK. only used by rANS version >=1.
   };
   uint8_t nStreams = 0;              // Amount of concurrent Streams used by the encoder. only used by rANS version >=1.
   size_t messageLength = 0;          // Message length (multiply with messageWordSize to get size in Bytes).
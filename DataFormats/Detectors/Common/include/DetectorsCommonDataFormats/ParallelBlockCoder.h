@@ -0,0 +1,229 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file ParallelBlockCoder.h
+/// \brief Concurrent entropy encoding / decoding of independent blocks of the EncodedBlocks container
+
+///  The blocks of the CTF are independent: the encoder collects the (source, slot) pairs of the detector CTFCoder,
+///  encodes every slot into its own detached container and appends the results to the output buffer in the slot order,
+///  so that the produced CTF is identical to the one of the sequential EncodedBlocks::encode calls.
+///  The decoder collects (destination, slot) pairs and decodes them concurrently from the const container.
+
+#ifndef ALICEO2_PARALLEL_BLOCK_CODER_H
+#define ALICEO2_PARALLEL_BLOCK_CODER_H
+
+#include <algorithm>
+#include <any>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFIOSize.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+namespace internal
+{
+
+/// execute task(i) for i in [0, nTasks) on up to nThreads threads (including the calling one), rethrow the 1st caught exception
+template <typename F>
+void runBlockTasks(size_t nTasks, size_t nThreads, F&& task)
+{
+  nThreads = std::min(nThreads, nTasks);
+  if (nThreads < 2) {
+    for (size_t i = 0; i < nTasks; i++) {
+      task(i);
+    }
+    return;
+  }
+  std::atomic<size_t> next{0};
+  std::exception_ptr error{};
+  std::mutex errorMutex;
+  auto worker = [&]() {
+    size_t i;
+    while ((i = next.fetch_add(1, std::memory_order_relaxed)) < nTasks) {
+      try {
+        task(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+      }
+    }
+  };
+  std::vector<std::thread> threads;
+  threads.reserve(nThreads - 1);
+  for (size_t it = 1; it < nThreads; it++) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+} // namespace internal
+
+/// Collects the blocks to encode and encodes them, concurrently if more than 1 thread is requested.
+/// The sources and external encoders must stay alive until the encode call.
+template <typename CTF, typename VEC>
+class ParallelBlockEncoder
+{
+ public:
+  using base = typename CTF::base;
+  using scratch_type = std::vector<BufferType>;
+
+  ParallelBlockEncoder(VEC& buffer, int nThreads = 1, float memfc = 1.f) : mBuffer(buffer), mNThreads(nThreads > 1 ? nThreads : 1), mMemFactor(memfc) {}
+
+  /// register source range for the slot, the slots must be added in increasing order
+  template <typename input_IT>
+  void add(const input_IT srcBegin, const input_IT srcEnd, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, const std::any& encoderExt = {})
+  {
+    using input_t = typename std::iterator_traits<input_IT>::value_type;
+    assert(mTasks.empty() || mTasks.back().slot < slot);
+    const float memfc = mMemFactor;
+    const int nThreads = mNThreads; // used by the chunks of EENCODE_CHUNKED blocks
+    mTasks.push_back(Task{slot, std::distance(srcBegin, srcEnd) * sizeof(input_t),
+                          [srcBegin, srcEnd, slot, symbolTablePrecision, opt, &encoderExt, memfc, nThreads](VEC& buff, scratch_type* scratch) {
+                            return scratch ? base::get(buff.data())->encodeDetached(srcBegin, srcEnd, slot, symbolTablePrecision, opt, *scratch, encoderExt, memfc, nThreads)
+                                           : base::get(buff.data())->encode(srcBegin, srcEnd, slot, symbolTablePrecision, opt, &buff, encoderExt, memfc, nThreads);
+                          }});
+  }
+
+  /// register source container for the slot
+  template <typename VE>
+  void add(const VE& src, int slot, uint8_t symbolTablePrecision, Metadata::OptStore opt, const std::any& encoderExt = {})
+  {
+    add(std::begin(src), std::end(src), slot, symbolTablePrecision, opt, encoderExt);
+  }
+
+  /// encode all registered blocks to the buffer, return the accumulated IO sizes
+  CTFIOSize encode();
+
+  int getNThreads() const { return mNThreads; }
+
+ private:
+  struct Task {
+    int slot = 0;
+    size_t inputSize = 0; // in bytes, used to balance the load
+    std::function<CTFIOSize(VEC&, scratch_type*)> process;
+  };
+
+  VEC& mBuffer;
+  int mNThreads = 1;
+  float mMemFactor = 1.f;
+  std::vector<Task> mTasks;
+};
+
+///_____________________________________________________________________________
+template <typename CTF, typename VEC>
+CTFIOSize ParallelBlockEncoder<CTF, VEC>::encode()
+{
+  CTFIOSize iosize;
+  if (mNThreads == 1 || mTasks.size() < 2) { // plain sequential encoding directly into the output buffer
+    for (auto& task : mTasks) {
+      iosize += task.process(mBuffer, nullptr);
+    }
+    mTasks.clear();
+    return iosize;
+  }
+  // process largest inputs first for better load balancing
+  std::vector<size_t> order(mTasks.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return mTasks[a].inputSize > mTasks[b].inputSize; });
+
+  std::vector<scratch_type> scratch(mTasks.size());
+  std::vector<CTFIOSize> sizes(mTasks.size());
+  internal::runBlockTasks(mTasks.size(), mNThreads, [&](size_t i) {
+    auto it = order[i];
+    sizes[it] = mTasks[it].process(mBuffer, &scratch[it]);
+  });
+
+  // book the space for all blocks at once, then append them in the slot order
+  size_t needed = base::get(mBuffer.data())->size() - base::get(mBuffer.data())->getFreeSize();
+  for (size_t it = 0; it < mTasks.size(); it++) {
+    needed += base::estimateBlockSize(base::get(scratch[it].data())->getBlock(mTasks[it].slot).getNStored());
+  }
+  if (needed + Alignment > base::get(mBuffer.data())->size()) {
+    base::expand(mBuffer, needed + Alignment);
+  }
+  for (size_t it = 0; it < mTasks.size(); it++) {
+    base::get(mBuffer.data())->adoptBlock(*base::get(scratch[it].data()), mTasks[it].slot, &mBuffer);
+    iosize += sizes[it];
+  }
+  mTasks.clear();
+  return iosize;
+}
+
+/// Collects the blocks to decode and decodes them, concurrently if more than 1 thread is requested.
+/// The destinations and external decoders must stay alive until the decode call.
+template <typename CTF>
+class ParallelBlockDecoder
+{
+ public:
+  using base = typename CTF::base;
+
+  ParallelBlockDecoder(const base& ec, int nThreads = 1) : mEC(ec), mNThreads(nThreads > 1 ? nThreads : 1) {}
+
+  /// register destination container (will be resized as needed) for the slot
+  template <class container_T>
+  void add(container_T& dest, int slot, const std::any& decoderExt = {})
+  {
+    const auto& md = mEC.getMetadata(slot);
+    const int nThreads = mNThreads; // used by the chunks of EENCODE_CHUNKED blocks
+    mTasks.push_back(Task{size_t(md.messageLength) * md.messageWordSize,
+                          [&dest, slot, &decoderExt, nThreads](const base& ec) { return ec.decode(dest, slot, decoderExt, nThreads); }});
+  }
+
+  /// decode all registered blocks, return the accumulated IO sizes
+  CTFIOSize decode()
+  {
+    std::vector<size_t> order(mTasks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) { return mTasks[a].outputSize > mTasks[b].outputSize; });
+    std::vector<CTFIOSize> sizes(mTasks.size());
+    internal::runBlockTasks(mTasks.size(), mNThreads, [&](size_t i) {
+      auto it = order[i];
+      sizes[it] = mTasks[it].process(mEC);
+    });
+    mTasks.clear();
+    return std::accumulate(sizes.begin(), sizes.end(), CTFIOSize{});
+  }
+
+  int getNThreads() const { return mNThreads; }
+
+ private:
+  struct Task {
+    size_t outputSize = 0; // in bytes, used to balance the load
+    std::function<CTFIOSize(const base&)> process;
+  };
+
+  const base& mEC;
+  int mNThreads = 1;
+  std::vector<Task> mTasks;
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
@@ -20,6 +20,7 @@
 
 #include "DetectorsCommonDataFormats/internal/Packer.h"
 
+#include "rANS/chunked.h"
 #include "rANS/encode.h"
 #include "rANS/factory.h"
 #include "rANS/histogram.h"
@@ -46,6 +47,10 @@ class ExternalEntropyCoder
   template <typename src_IT, typename dst_IT>
   [[nodiscard]] dst_IT encode(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd);
 
+  // encode chunks of chunkSize samples into independent streams, see rans::ChunkIndexView for the layout
+  template <typename src_IT, typename dst_IT>
+  [[nodiscard]] dst_IT encodeChunked(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd, size_t chunkSize, size_t nThreads = 1);
+
   [[nodiscard]] inline size_t getNIncompressibleSamples() const noexcept { return mIncompressibleBuffer.size(); };
 
   [[nodiscard]] inline source_type getIncompressibleSymbolOffset() const noexcept { return mIncompressiblePacker.getOffset(); };
@@ -100,6 +105,18 @@ template <typename src_IT, typename dst_IT>
   return encodedMessageEnd;
 };
 
+template <typename source_T>
+template <typename src_IT, typename dst_IT>
+[[nodiscard]] dst_IT ExternalEntropyCoder<source_T>::encodeChunked(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd, size_t chunkSize, size_t nThreads)
+{
+  const rans::ChunkedEncoder chunkedEncoder{*mEncoder, chunkSize, nThreads};
+  auto [encodedMessageEnd, literalsEnd] = chunkedEncoder.process(srcBegin, srcEnd, dstBegin, std::back_inserter(mIncompressibleBuffer));
+  rans::utils::checkBounds(encodedMessageEnd, dstEnd);
+  mIncompressiblePacker = Packer<source_type>{mIncompressibleBuffer.data(), mIncompressibleBuffer.data() + mIncompressibleBuffer.size()};
+
+  return encodedMessageEnd;
+};
+
 template <typename source_T>
 template <typename dst_T>
 [[nodiscard]] inline size_t ExternalEntropyCoder<source_T>::computePackedIncompressibleSize() const noexcept
@@ -22,6 +22,7 @@
 
 #include "DetectorsCommonDataFormats/internal/Packer.h"
 
+#include "rANS/chunked.h"
 #include "rANS/encode.h"
 #include "rANS/factory.h"
 #include "rANS/histogram.h"
@@ -79,6 +80,10 @@ class InplaceEntropyCoder
   template <typename src_IT, typename dst_IT>
   [[nodiscard]] dst_IT encode(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd);
 
+  // encode chunks of chunkSize samples into independent streams, see rans::ChunkIndexView for the layout
+  template <typename src_IT, typename dst_IT>
+  [[nodiscard]] dst_IT encodeChunked(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd, size_t chunkSize, size_t nThreads = 1);
+
   template <typename dst_IT>
   [[nodiscard]] dst_IT writeDictionary(dst_IT dstBegin, dst_IT dstEnd);
 
@@ -205,6 +210,26 @@ template <typename src_IT, typename dst_IT>
   return messageEnd;
 };
 
+template <typename source_T>
+template <typename src_IT, typename dst_IT>
+[[nodiscard]] dst_IT InplaceEntropyCoder<source_T>::encodeChunked(src_IT srcBegin, src_IT srcEnd, dst_IT dstBegin, dst_IT dstEnd, size_t chunkSize, size_t nThreads)
+{
+  static_assert(std::is_same_v<source_T, typename std::iterator_traits<src_IT>::value_type>);
+
+  dst_IT messageEnd = dstBegin;
+
+  std::visit([&, this](auto&& encoder) {
+    const rans::ChunkedEncoder chunkedEncoder{encoder, chunkSize, nThreads};
+    mIncompressibleBuffer.reserve(*mMetrics.getCoderProperties().nIncompressibleSamples);
+    auto [encodedMessageEnd, literalsEnd] = chunkedEncoder.process(srcBegin, srcEnd, dstBegin, std::back_inserter(mIncompressibleBuffer));
+    messageEnd = encodedMessageEnd;
+    rans::utils::checkBounds(messageEnd, dstEnd);
+  },
+             *mEncoder);
+
+  return messageEnd;
+};
+
 template <typename source_T>
 template <typename dst_IT>
 [[nodiscard]] inline dst_IT InplaceEntropyCoder<source_T>::writeDictionary(dst_IT dstBegin, dst_IT dstEnd)
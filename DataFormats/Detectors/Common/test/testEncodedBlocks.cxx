@@ -0,0 +1,99 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   testEncodedBlocks.cxx
+/// @brief  Test the chunked entropy coding of EncodedBlocks
+
+#define BOOST_TEST_MODULE Test EncodedBlocks class
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#include <vector>
+#include <cstring>
+#include <random>
+#include <algorithm>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/data/test_case.hpp>
+#include <boost/test/data/monomorphic.hpp>
+
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+#include "DetectorsCommonDataFormats/CTFDictHeader.h"
+
+using namespace o2::ctf;
+namespace boost_data = boost::unit_test::data;
+
+using TestBlocks = EncodedBlocks<CTFDictHeader, 2, uint32_t>;
+
+// a multiple of the chunk size and a message with a short last chunk
+inline std::vector<size_t> MessageLengths{3 * ChunkedEncodingChunkSize, 2 * ChunkedEncodingChunkSize + 12345};
+
+std::vector<int16_t> makeMessage(size_t length)
+{
+  std::mt19937 mt(0); // same seed we want always the same message
+  std::binomial_distribution<int> dist(1000, 0.5);
+  std::vector<int16_t> message(length);
+  std::generate(message.begin(), message.end(), [&dist, &mt]() -> int16_t { return dist(mt) - 500; });
+  return message;
+}
+
+/// encode the message to slot 0 and a message shorter than a chunk, which is stored without chunks, to slot 1
+std::vector<BufferType> encode(const std::vector<int16_t>& message, const std::vector<int16_t>& shortMessage, int nThreads)
+{
+  std::vector<BufferType> buffer;
+  TestBlocks::create(buffer)->setANSHeader(ANSVersion1);
+  // at every encoding the buffer might be autoexpanded, so we don't work with a fixed pointer
+  TestBlocks::get(buffer.data())->encode(message, 0, 0, Metadata::OptStore::EENCODE_CHUNKED, &buffer, {}, 1.f, nThreads);
+  TestBlocks::get(buffer.data())->encode(shortMessage, 1, 0, Metadata::OptStore::EENCODE_CHUNKED, &buffer, {}, 1.f, nThreads);
+  return buffer;
+}
+
+BOOST_DATA_TEST_CASE(ChunkedRoundTrip, boost_data::make(MessageLengths), messageLength)
+{
+  const auto message = makeMessage(messageLength);
+  const auto shortMessage = makeMessage(1000);
+  const size_t nChunks = (messageLength + ChunkedEncodingChunkSize - 1) / ChunkedEncodingChunkSize;
+
+  auto buffer = encode(message, shortMessage, 1);
+  const auto blocks = TestBlocks::getImage(buffer.data());
+  BOOST_CHECK(blocks.getANSHeader() == ANSVersion1Chunked);
+  BOOST_CHECK(blocks.getMetadata(0).opt == Metadata::OptStore::EENCODE_CHUNKED);
+  BOOST_CHECK_EQUAL(blocks.getNChunks(0), nChunks);
+  BOOST_CHECK_EQUAL(blocks.getNChunks(1), 0);
+
+  // the chunks are independent of the number of threads encoding them
+  auto bufferMT = encode(message, shortMessage, 4);
+  const auto blocksMT = TestBlocks::getImage(bufferMT.data());
+  for (int slot = 0; slot < 2; slot++) {
+    const auto& block = blocks.getBlock(slot);
+    const auto& blockMT = blocksMT.getBlock(slot);
+    BOOST_REQUIRE_EQUAL(block.getNData(), blockMT.getNData());
+    BOOST_CHECK(std::memcmp(block.getData(), blockMT.getData(), block.getNData() * sizeof(uint32_t)) == 0);
+  }
+
+  for (int nThreads : {1, 4}) {
+    std::vector<int16_t> decoded, decodedShort;
+    blocks.decode(decoded, 0, {}, nThreads);
+    blocks.decode(decodedShort, 1, {}, nThreads);
+    BOOST_CHECK(decoded == message);
+    BOOST_CHECK(decodedShort == shortMessage);
+  }
+
+  // every chunk can be decoded on its own, the last one may be shorter
+  std::vector<int16_t> decoded(messageLength);
+  for (size_t chunk = 0; chunk < nChunks; chunk++) {
+    auto iosize = blocks.decodeChunk(decoded.data() + chunk * ChunkedEncodingChunkSize, 0, chunk);
+    const size_t chunkLength = std::min(ChunkedEncodingChunkSize, messageLength - chunk * ChunkedEncodingChunkSize);
+    BOOST_CHECK_EQUAL(iosize.ctfIn, chunkLength * sizeof(int16_t));
+  }
+  BOOST_CHECK(decoded == message);
+  BOOST_CHECK_THROW(blocks.decodeChunk(decoded.data(), 0, nChunks), std::runtime_error);
+}
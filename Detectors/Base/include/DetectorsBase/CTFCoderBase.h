@@ -27,6 +27,7 @@
 #include "DetectorsCommonDataFormats/CTFIOSize.h"
 #include "DataFormatsCTP/TriggerOffsetsParam.h"
 #include "DetectorsCommonDataFormats/ANSHeader.h"
+#include "DetectorsCommonDataFormats/ParallelBlockCoder.h"
 #include "rANS/factory.h"
 #include "rANS/compat.h"
 #include "rANS/histogram.h"
@@ -118,6 +119,12 @@ class CTFCoderBase
   void setMemMarginFactor(float v) { mMemMarginFactor = v > 1.f ? v : 1.f; }
   float getMemMarginFactor() const { return mMemMarginFactor; }
 
+  void setNThreads(int n) { mNThreads = n > 1 ? n : 1; }
+  int getNThreads() const { return mNThreads; }
+
+  void setChunkedEncoding(bool v) { mChunkedEncoding = v; }
+  bool getChunkedEncoding() const { return mChunkedEncoding; }
+
   void setVerbosity(int v) { mVerbosity = v; }
   int getVerbosity() const { return mVerbosity; }
 
@@ -204,6 +211,8 @@ class CTFCoderBase
   size_t mIRFrameSelMarginFwd = 0; // margin in BC to add to the IRFrame upper boundary when selection is requested
   long mIRFrameSelShift = 0;       // Global shift of the IRFrames, to account for e.g. detector latency
   int mVerbosity = 0;
+  int mNThreads = 1;             // number of threads for concurrent encoding/decoding of CTF blocks
+  bool mChunkedEncoding = false; // encode large blocks in independent chunks (Metadata::OptStore::EENCODE_CHUNKED)
 };
 
 ///________________________________
@@ -304,6 +313,12 @@ void CTFCoderBase::init(o2::framework::InitContext& ic)
   if (ic.options().hasOption("mem-factor")) {
     setMemMarginFactor(ic.options().get<float>("mem-factor"));
   }
+  if (ic.options().hasOption("ctf-threads")) {
+    setNThreads(ic.options().get<int>("ctf-threads"));
+  }
+  if (ic.options().hasOption("ctf-chunked-encoding")) {
+    setChunkedEncoding(ic.options().get<bool>("ctf-chunked-encoding"));
+  }
   if (ic.options().hasOption("irframe-margin-bwd")) {
     mIRFrameSelMarginBwd = ic.options().get<uint32_t>("irframe-margin-bwd");
   }
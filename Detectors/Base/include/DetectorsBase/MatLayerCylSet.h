@@ -124,6 +124,16 @@ class MatLayerCylSet : public o2::gpu::FlatObject
   static constexpr size_t getClassAlignmentBytes() { return 8; }
   /// Gives minimal alignment in bytes required for the flat buffer
   static constexpr size_t getBufferAlignmentBytes() { return 8; }
+
+  /// Host-only speed-ups of getMatBudget:
+  /// the crossings of the ray with the circles of all candidate layers are calculated at once (on by default),
+  /// every thread caches the last cells reached by the rays, so that a ray contained in one of them does not
+  /// need the traversal (off by default). Both give the same result as the plain traversal, up to the rounding
+  /// for the points on the cell boundaries.
+  static void setUseLayersBatch(bool v);
+  static void setUseCellCache(bool v);
+  static bool getUseLayersBatch();
+  static bool getUseCellCache();
 #endif // !GPUCA_GPUCODE
 
   static constexpr float LayerRMax = 500;    // maximum value of R lookup (corresponds to last layer of MatLUT)
@@ -138,6 +148,15 @@ class MatLayerCylSet : public o2::gpu::FlatObject
 };
 
 } // namespace base
+
+namespace gpu
+{
+/// the layers and the R intervals are in the flat buffer, the voxel lookup is a plain array
+template <>
+struct FlatObjectSelfContained<o2::base::MatLayerCylSet> {
+  static constexpr bool value = true;
+};
+} // namespace gpu
 } // namespace o2
 
 #endif
@@ -27,6 +27,9 @@
 #ifndef GPUCA_GPUCODE
 #include <string>
 #endif
+#ifndef GPUCA_ALIGPUCODE
+#include <gsl/span>
+#endif
 
 namespace o2
 {
@@ -119,6 +122,26 @@ class PropagatorImpl
                                    gpu::gpustd::array<value_type, 2>* dca = nullptr, track::TrackLTIntegral* tofInfo = nullptr,
                                    int signCorr = 0, value_type maxD = 999.f) const;
 
+#ifndef GPUCA_ALIGPUCODE
+  // Batched versions of propagateToX for the tracks with covariance: the transport of parameters and covariance
+  // in every step is done simultaneously for a group of tracks, in SoA layout. The results are identical to those
+  // of propagateToX applied to every track (up to the FMA contraction by the compiler). Either a common X or the X for every track can be provided.
+  // If not empty, status[i] is set to the propagation result for tracks[i] and tofInfo[i] is updated for it.
+  // Returns the number of successfully propagated tracks.
+  int propagateBatchToX(gsl::span<TrackParCov_t> tracks, value_type x, value_type bZ, gsl::span<uint8_t> status = {},
+                        value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                        gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+
+  int propagateBatchToX(gsl::span<TrackParCov_t> tracks, gsl::span<const value_type> x, value_type bZ, gsl::span<uint8_t> status = {},
+                        value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                        gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+
+  // batched propagateTo: with bzOnly propagateBatchToX is used, otherwise PropagateToXBxByBz for every track
+  int propagateBatchTo(gsl::span<TrackParCov_t> tracks, value_type x, bool bzOnly = false, gsl::span<uint8_t> status = {},
+                       value_type maxSnp = MAX_SIN_PHI, value_type maxStep = MAX_STEP, MatCorrType matCorr = MatCorrType::USEMatCorrLUT,
+                       gsl::span<track::TrackLTIntegral> tofInfo = {}, int signCorr = 0) const;
+#endif
+
   PropagatorImpl(PropagatorImpl const&) = delete;
   PropagatorImpl(PropagatorImpl&&) = delete;
   PropagatorImpl& operator=(PropagatorImpl const&) = delete;
@@ -165,6 +188,10 @@ class PropagatorImpl
   static constexpr value_type Epsilon = 0.00001; // precision of propagation to X
   template <typename T>
   GPUd() void getFieldXYZImpl(const math_utils::Point3D<T> xyz, T* bxyz) const;
+#ifndef GPUCA_ALIGPUCODE
+  int propagateBatchToXImpl(gsl::span<TrackParCov_t> tracks, const value_type* xToGo, size_t xStride, value_type bZ, gsl::span<uint8_t> status,
+                            value_type maxSnp, value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const;
+#endif
 
   const o2::field::MagFieldFast* mFieldFast = nullptr; ///< External fast field map (barrel only for the moment)
   o2::field::MagneticField* mField = nullptr;          ///< External nominal field map
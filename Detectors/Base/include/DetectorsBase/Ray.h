@@ -56,6 +56,10 @@ class Ray
 #endif // !GPUCA_ALIGPUCODE
   GPUd() Ray(float x0, float y0, float z0, float x1, float y1, float z1);
   GPUd() int crossLayer(const MatLayerCyl& lr);
+  GPUd() int crossLayer(const MatLayerCyl& lr, float tCross0Max, float tCross0Min, float tCross1Max, float tCross1Min);
+#ifndef GPUCA_GPUCODE
+  void crossCirclesR(const float* r2, int n, float* cross1, float* cross2) const;
+#endif // !GPUCA_GPUCODE
   GPUd() bool crossCircleR(float r2, float& cross1, float& cross2) const;
 
   GPUd() float crossRadial(const MatLayerCyl& lr, int sliceID) const;
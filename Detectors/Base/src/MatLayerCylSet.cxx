@@ -21,11 +21,104 @@
 //#define _DBG_LOC_ // for local debugging only
 
 #endif // !GPUCA_ALIGPUCODE
+#ifndef GPUCA_GPUCODE
+#include <atomic>
+#endif // !GPUCA_GPUCODE
 #undef NDEBUG
 using namespace o2::base;
 
 using flatObject = o2::gpu::FlatObject;
 
+#ifndef GPUCA_GPUCODE
+namespace
+{
+constexpr int MaxLayersBatch = 64; // max number of layers for which the crossings are calculated at once
+constexpr int MinLayersBatch = 8;  // below this number of candidate layers the crossings are calculated layer by layer
+
+std::atomic<bool> gUseLayersBatch{true}; // read by all threads querying the LUT
+std::atomic<bool> gUseCellCache{false};
+std::atomic<unsigned int> gCellCacheGeneration{0}; // incremented when a layer set is (re)located, invalidating cached cells
+
+/// material cell with its boundaries, for the check that a ray is contained in it
+struct CachedCell {
+  const MatLayerCylSet* set = nullptr;
+  unsigned int generation = 0;
+  int zBin = 0;
+  float rMin2 = 0.f, rMax2 = 0.f;
+  float csMin = 0.f, snMin = 0.f, csMax = 0.f, snMax = 0.f; // phi slice boundaries
+  bool fullCircle = false;                                   // layer has a single phi slice
+  const MatLayerCyl* layer = nullptr;
+  MatCell cell;
+
+  bool containsPoint(float x, float y, float z) const
+  {
+    return layer->isZOutside(z) == MatLayerCyl::Within && layer->getZBinID(z) == zBin &&
+           (fullCircle || (csMin * y - snMin * x >= 0.f && csMax * y - snMax * x < 0.f));
+  }
+
+  bool contains(const MatLayerCylSet* lutSet, const Ray& ray) const
+  {
+    if (set != lutSet || generation != gCellCacheGeneration.load(std::memory_order_relaxed)) {
+      return false;
+    }
+    float rmin2, rmax2;
+    ray.getMinMaxR2(rmin2, rmax2); // the cell is convex in phi and z, the chord must not go below its rmin
+    return rmin2 > rMin2 && rmax2 < rMax2 &&
+           containsPoint(ray.getPos(0.f, 0), ray.getPos(0.f, 1), ray.getZ(0.f)) &&
+           containsPoint(ray.getPos(1.f, 0), ray.getPos(1.f, 1), ray.getZ(1.f));
+  }
+};
+
+/// per-thread cache of the last cells reached by the rays: consecutive steps of a track are likely to stay in them
+struct CellCache {
+  static constexpr int Size = 4;
+  CachedCell cells[Size];
+  int last = 0;
+
+  const CachedCell* find(const MatLayerCylSet* set, const Ray& ray) const
+  {
+    for (int i = 0; i < Size; i++) { // starting from the most recent
+      const auto& c = cells[(last + Size - i) % Size];
+      if (c.contains(set, ray)) {
+        return &c;
+      }
+    }
+    return nullptr;
+  }
+
+  void store(const MatLayerCylSet* set, int lrID, int slice, int zBin)
+  {
+    const auto& lr = set->getLayer(lrID);
+    int nSlices = lr.getNPhiSlices();
+    CachedCell c;
+    c.fullCircle = nSlices == 1;
+    c.csMin = lr.getSliceCos(slice);
+    c.snMin = lr.getSliceSin(slice);
+    c.csMax = lr.getSliceCos((slice + 1) % nSlices);
+    c.snMax = lr.getSliceSin((slice + 1) % nSlices);
+    if (!c.fullCircle && c.csMin * c.snMax - c.snMin * c.csMax <= 0.f) {
+      return; // slice spanning more than pi is not convex
+    }
+    c.set = set;
+    c.generation = gCellCacheGeneration.load(std::memory_order_relaxed);
+    c.layer = &lr;
+    c.zBin = zBin;
+    c.rMin2 = lr.getRMin2();
+    c.rMax2 = lr.getRMax2();
+    c.cell = lr.getCell(slice, zBin);
+    last = (last + 1) % Size;
+    cells[last] = c;
+  }
+};
+thread_local CellCache gCellCache;
+} // namespace
+
+void MatLayerCylSet::setUseLayersBatch(bool v) { gUseLayersBatch.store(v, std::memory_order_relaxed); }
+void MatLayerCylSet::setUseCellCache(bool v) { gUseCellCache.store(v, std::memory_order_relaxed); }
+bool MatLayerCylSet::getUseLayersBatch() { return gUseLayersBatch.load(std::memory_order_relaxed); }
+bool MatLayerCylSet::getUseCellCache() { return gUseCellCache.load(std::memory_order_relaxed); }
+#endif // !GPUCA_GPUCODE
+
 #ifndef GPUCA_ALIGPUCODE // this part is unvisible on GPU version
 
 //________________________________________________________________________________
@@ -282,15 +375,56 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
   MatBudget rval;
   Ray ray(x0, y0, z0, x1, y1, z1);
   short lmin, lmax; // get innermost and outermost relevant layer
-  if (ray.isTooShort() || !getLayersRange(ray, lmin, lmax)) {
+  if (ray.isTooShort()) {
+    rval.length = ray.getDist();
+    return rval;
+  }
+#ifndef GPUCA_GPUCODE
+  const bool useCellCache = gUseCellCache.load(std::memory_order_relaxed);
+  if (useCellCache) {
+    if (const auto* c = gCellCache.find(this, ray)) { // same result as the traversal of a single cell
+      rval.meanRho = c->cell.meanRho;
+      rval.meanX2X0 = c->cell.meanX2X0 * ray.getDist();
+      rval.length = ray.getDist();
+      return rval;
+    }
+  }
+#endif
+  if (!getLayersRange(ray, lmin, lmax)) {
     rval.length = ray.getDist();
     return rval;
   }
+#ifndef GPUCA_GPUCODE
+  int lastLrID = -1, lastSlice = 0, lastZID = 0; // cell containing the end point, to be cached
+  bool useBatch = gUseLayersBatch.load(std::memory_order_relaxed) && lmax - lmin + 1 >= MinLayersBatch;
+  int batchMin = lmax + 1; // crossings with the circles of layers batchMin:lrID are already calculated
+  float rOuter2[MaxLayersBatch], rInner2[MaxLayersBatch];
+  float tOuter1[MaxLayersBatch], tOuter2[MaxLayersBatch], tInner1[MaxLayersBatch], tInner2[MaxLayersBatch];
+#endif
   short lrID = lmax;
   while (lrID >= lmin) { // go from outside to inside
     const auto& lr = getLayer(lrID);
     int nphiSlices = lr.getNPhiSlices();
+#ifndef GPUCA_GPUCODE
+    int nc = 0;
+    if (useBatch) {
+      if (lrID < batchMin) { // calculate crossings with the circles of next batch of layers at once
+        batchMin = lrID - MaxLayersBatch + 1 > lmin ? lrID - MaxLayersBatch + 1 : lmin;
+        for (int il = batchMin; il <= lrID; il++) {
+          rOuter2[il - batchMin] = getLayer(il).getRMax2();
+          rInner2[il - batchMin] = getLayer(il).getRMin2();
+        }
+        ray.crossCirclesR(rOuter2, lrID - batchMin + 1, tOuter1, tOuter2);
+        ray.crossCirclesR(rInner2, lrID - batchMin + 1, tInner1, tInner2);
+      }
+      int ib = lrID - batchMin;
+      nc = ray.crossLayer(lr, tOuter1[ib], tOuter2[ib], tInner1[ib], tInner2[ib]);
+    } else {
+      nc = ray.crossLayer(lr);
+    }
+#else
     int nc = ray.crossLayer(lr); // determines how many crossings this ray has with this tubular layer
+#endif
     for (int ic = nc; ic--;) {
       float cross1, cross2;
       ray.getCrossParams(ic, cross1, cross2); // tmax,tmin of crossing the layer
@@ -350,6 +484,13 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
             rval.meanRho += cell.meanRho * step;
             rval.meanX2X0 += cell.meanX2X0 * step;
             rval.length += step;
+#ifndef GPUCA_GPUCODE
+            if (tStartZ == 1.f || tEndZ == 1.f) {
+              lastLrID = lrID;
+              lastSlice = phiID % nphiSlices;
+              lastZID = zID;
+            }
+#endif
 
 #ifdef _DBG_LOC_
             float pos0[3] = {ray.getPos(tStartZ, 0), ray.getPos(tStartZ, 1), ray.getPos(tStartZ, 2)};
@@ -370,6 +511,13 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
           rval.meanRho += cell.meanRho * step;
           rval.meanX2X0 += cell.meanX2X0 * step;
           rval.length += step;
+#ifndef GPUCA_GPUCODE
+          if (tStartPhi == 1.f || tEndPhi == 1.f) {
+            lastLrID = lrID;
+            lastSlice = phiID % nphiSlices;
+            lastZID = zID;
+          }
+#endif
 
 #ifdef _DBG_LOC_
           float pos0[3] = {ray.getPos(tStartPhi, 0), ray.getPos(tStartPhi, 1), ray.getPos(tStartPhi, 2)};
@@ -395,6 +543,11 @@ GPUd() MatBudget MatLayerCylSet::getMatBudget(float x0, float y0, float z0, floa
     rval.meanX2X0 *= ray.getDist();                                    // normalize
   }
   rval.length = ray.getDist();
+#ifndef GPUCA_GPUCODE
+  if (useCellCache && lastLrID >= 0) {
+    gCellCache.store(this, lastLrID, lastSlice, lastZID);
+  }
+#endif
 
 #ifdef _DBG_LOC_
   printf("<rho> = %e, x2X0 = %e  | step = %e\n", rval.meanRho, rval.meanX2X0, rval.length);
@@ -510,6 +663,7 @@ void MatLayerCylSet::flatten()
     offs = alignSize(offs + lr.getFlatBufferSize(), getBufferAlignmentBytes()); // account for the alignment
   }
   mConstructionMask = Constructed;
+  gCellCacheGeneration++;
 }
 
 //______________________________________________
@@ -559,6 +713,7 @@ void MatLayerCylSet::fixPointers(char* newBasePtr)
   char* newPtr = mFlatBufferPtr + offs;                                           // correct pointer on MatLayerCyl*
   char* oldPtr = reinterpret_cast<char*>(get()->mLayers);                         // old pointer read from the file
   fixPointers(oldPtr, newPtr);
+  gCellCacheGeneration++;
 }
 
 //______________________________________________
@@ -24,6 +24,11 @@ using namespace o2::gpu;
 #include "Field/MagFieldFast.h" // Don't use this on the GPU
 #endif
 
+#ifndef GPUCA_ALIGPUCODE
+#include <algorithm>
+#include <fmt/format.h>
+#endif
+
 #if !defined(GPUCA_STANDALONE) && !defined(GPUCA_GPUCODE)
 #include "Field/MagneticField.h"
 #include "DataFormatsParameters/GRPObject.h"
@@ -784,6 +789,296 @@ GPUd() void PropagatorImpl<value_T>::getFieldXYZ(const math_utils::Point3D<doubl
   getFieldXYZImpl<double>(xyz, bxyz);
 }
 
+#ifndef GPUCA_ALIGPUCODE
+namespace
+{
+/// SoA state of a group of tracks propagated together in constant Bz. The transport reproduces
+/// TrackParametrizationWithError::propagateTo(x, b) operation by operation, but the branches are replaced
+/// by selections so that the loop over the tracks can be vectorized. The rare steps with large dx/R, needing
+/// the arc length for Z increment, are not applied but flagged to be done by the track itself, as well as the
+/// limitation of the covariance elements exceeding the allowed values. The tracks are updated from the state
+/// only when a per-track operation (e.g. material correction) is needed.
+template <typename value_T>
+struct BatchState {
+  using Track = o2::track::TrackParametrizationWithError<value_T>;
+  static constexpr int Size = 32;
+  int n = 0;
+  value_T x[Size], y[Size], z[Size], snp[Size], tgl[Size], q2pt[Size]; // track parameters
+  value_T c[o2::track::kCovMatSize][Size];                              // covariance matrix
+  value_T xTo[Size];                                                    // X of the current step
+  bool charged[Size], act[Size], ok[Size], arc[Size], big[Size];
+
+  void load(int l, const Track& trc)
+  {
+    x[l] = trc.getX();
+    y[l] = trc.getY();
+    z[l] = trc.getZ();
+    snp[l] = trc.getSnp();
+    tgl[l] = trc.getTgl();
+    q2pt[l] = trc.getQ2Pt();
+    charged[l] = trc.getAbsCharge() != 0;
+    for (int i = 0; i < o2::track::kCovMatSize; i++) {
+      c[i][l] = trc.getCov()[i];
+    }
+  }
+
+  void save(int l, Track& trc) const
+  {
+    trc.setX(x[l]);
+    trc.setY(y[l]);
+    trc.setZ(z[l]);
+    trc.setSnp(snp[l]);
+    trc.setQ2Pt(q2pt[l]);
+    for (int i = 0; i < o2::track::kCovMatSize; i++) {
+      trc.setCov(c[i][l], i);
+    }
+  }
+
+  void transport(value_T b)
+  {
+    using namespace o2::constants::math;
+    using namespace o2::track;
+    value_T *c00 = c[kSigY2], *c10 = c[kSigZY], *c11 = c[kSigZ2], *c20 = c[kSigSnpY], *c21 = c[kSigSnpZ],
+            *c22 = c[kSigSnp2], *c30 = c[kSigTglY], *c31 = c[kSigTglZ], *c32 = c[kSigTglSnp], *c33 = c[kSigTgl2],
+            *c40 = c[kSigQ2PtY], *c41 = c[kSigQ2PtZ], *c42 = c[kSigQ2PtSnp], *c43 = c[kSigQ2PtTgl], *c44 = c[kSigQ2Pt2];
+    for (int l = 0; l < n; l++) {
+      value_T dx = xTo[l] - x[l];
+      value_T crv = charged[l] ? value_T(q2pt[l] * b * B2C) : 0.f;
+      value_T x2r = crv * dx;
+      value_T f1 = snp[l], f2 = f1 + x2r;
+      bool good = act[l] && o2::gpu::CAMath::Abs(f1) <= Almost1 && o2::gpu::CAMath::Abs(f2) <= Almost1;
+      value_T r1 = o2::gpu::CAMath::Sqrt(good ? (1.f - f1) * (1.f + f1) : 1.f);
+      value_T r2 = o2::gpu::CAMath::Sqrt(good ? (1.f - f2) * (1.f + f2) : 1.f);
+      good = good && o2::gpu::CAMath::Abs(r1) >= Almost0 && o2::gpu::CAMath::Abs(r2) >= Almost0;
+      double dy2dx = (f1 + f2) / (r1 + r2);
+      bool arcz = o2::gpu::CAMath::Abs(x2r) > 0.05f; // large dx/R: Z increment is calculated separately along the arc
+      ok[l] = good;
+      arc[l] = good && arcz;
+      value_T dz = dx * (r2 + f2 * dy2dx) * tgl[l];
+
+      // evaluate matrix in double prec.
+      double rinv = 1. / r1;
+      double r3inv = rinv * rinv * rinv;
+      double f24 = dx * b * B2C; // x2r/mP[kQ2Pt];
+      double f02 = dx * r3inv;
+      double f04 = 0.5 * f24 * f02;
+      double f12 = f02 * tgl[l] * f1;
+      double f14 = 0.5 * f24 * f12;
+      double f13 = dx * rinv;
+
+      // b = C*ft
+      double b00 = f02 * c20[l] + f04 * c40[l], b01 = f12 * c20[l] + f14 * c40[l] + f13 * c30[l];
+      double b02 = f24 * c40[l];
+      double b10 = f02 * c21[l] + f04 * c41[l], b11 = f12 * c21[l] + f14 * c41[l] + f13 * c31[l];
+      double b12 = f24 * c41[l];
+      double b20 = f02 * c22[l] + f04 * c42[l], b21 = f12 * c22[l] + f14 * c42[l] + f13 * c32[l];
+      double b22 = f24 * c42[l];
+      double b40 = f02 * c42[l] + f04 * c44[l], b41 = f12 * c42[l] + f14 * c44[l] + f13 * c43[l];
+      double b42 = f24 * c44[l];
+      double b30 = f02 * c32[l] + f04 * c43[l], b31 = f12 * c32[l] + f14 * c43[l] + f13 * c33[l];
+      double b32 = f24 * c43[l];
+
+      // a = f*b = f*C*ft
+      double a00 = f02 * b20 + f04 * b40, a01 = f02 * b21 + f04 * b41, a02 = f02 * b22 + f04 * b42;
+      double a11 = f12 * b21 + f14 * b41 + f13 * b31, a12 = f12 * b22 + f14 * b42 + f13 * b32;
+      double a22 = f24 * b42;
+
+      // F*C*Ft = C + (b + bt + a), then the diagonal elements are forced to be positive as in checkCovariance
+      value_T n00 = o2::gpu::CAMath::Abs(value_T(c00[l] + (b00 + b00 + a00)));
+      value_T n10 = c10[l] + (b10 + b01 + a01);
+      value_T n20 = c20[l] + (b20 + b02 + a02);
+      value_T n30 = c30[l] + b30;
+      value_T n40 = c40[l] + b40;
+      value_T n11 = o2::gpu::CAMath::Abs(value_T(c11[l] + (b11 + b11 + a11)));
+      value_T n21 = c21[l] + (b21 + b12 + a12);
+      value_T n31 = c31[l] + b31;
+      value_T n41 = c41[l] + b41;
+      value_T n22 = o2::gpu::CAMath::Abs(value_T(c22[l] + (b22 + b22 + a22)));
+      value_T n32 = c32[l] + b32;
+      value_T n42 = c42[l] + b42;
+      value_T n33 = o2::gpu::CAMath::Abs(c33[l]);
+      value_T n44 = o2::gpu::CAMath::Abs(c44[l]);
+      big[l] = good && (n00 > kCY2max || n11 > kCZ2max || n22 > kCSnp2max || n33 > kCTgl2max || n44 > kC1Pt2max);
+
+      // parameters update as in updateParams
+      good = good && !arcz;
+      value_T nsnp = snp[l] + x2r;
+      nsnp = nsnp > Almost1 ? Almost1 : (nsnp < -Almost1 ? -Almost1 : nsnp);
+      y[l] = good ? value_T(y[l] + value_T(dx * dy2dx)) : y[l];
+      z[l] = good ? value_T(z[l] + dz) : z[l];
+      snp[l] = good ? nsnp : snp[l];
+      x[l] = good ? xTo[l] : x[l];
+      c00[l] = good ? n00 : c00[l];
+      c10[l] = good ? n10 : c10[l];
+      c20[l] = good ? n20 : c20[l];
+      c30[l] = good ? n30 : c30[l];
+      c40[l] = good ? n40 : c40[l];
+      c11[l] = good ? n11 : c11[l];
+      c21[l] = good ? n21 : c21[l];
+      c31[l] = good ? n31 : c31[l];
+      c41[l] = good ? n41 : c41[l];
+      c22[l] = good ? n22 : c22[l];
+      c32[l] = good ? n32 : c32[l];
+      c42[l] = good ? n42 : c42[l];
+      c33[l] = good ? n33 : c33[l];
+      c44[l] = good ? n44 : c44[l];
+    }
+  }
+};
+} // namespace
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateBatchToX(gsl::span<TrackParCov_t> tracks, value_type x, value_type bZ, gsl::span<uint8_t> status,
+                                               value_type maxSnp, value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  return propagateBatchToXImpl(tracks, &x, 0, bZ, status, maxSnp, maxStep, matCorr, tofInfo, signCorr);
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateBatchToX(gsl::span<TrackParCov_t> tracks, gsl::span<const value_type> x, value_type bZ, gsl::span<uint8_t> status,
+                                               value_type maxSnp, value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  if (x.size() != tracks.size()) {
+    throw std::runtime_error(fmt::format("number of X values {} differs from number of tracks {}", x.size(), tracks.size()));
+  }
+  return propagateBatchToXImpl(tracks, x.data(), 1, bZ, status, maxSnp, maxStep, matCorr, tofInfo, signCorr);
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateBatchTo(gsl::span<TrackParCov_t> tracks, value_type x, bool bzOnly, gsl::span<uint8_t> status,
+                                              value_type maxSnp, value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  if (bzOnly) {
+    return propagateBatchToX(tracks, x, getNominalBz(), status, maxSnp, maxStep, matCorr, tofInfo, signCorr);
+  }
+  int nOK = 0;
+  for (size_t i = 0; i < tracks.size(); i++) {
+    bool res = PropagateToXBxByBz(tracks[i], x, maxSnp, maxStep, matCorr, tofInfo.empty() ? nullptr : &tofInfo[i], signCorr);
+    if (!status.empty()) {
+      status[i] = res;
+    }
+    nOK += res;
+  }
+  return nOK;
+}
+
+//_______________________________________________________________________
+template <typename value_T>
+int PropagatorImpl<value_T>::propagateBatchToXImpl(gsl::span<TrackParCov_t> tracks, const value_type* xToGo, size_t xStride, value_type bZ, gsl::span<uint8_t> status,
+                                                   value_type maxSnp, value_type maxStep, MatCorrType matCorr, gsl::span<track::TrackLTIntegral> tofInfo, int signCorr) const
+{
+  // Same algorithm as propagateToX, but the tracks of the group are propagated step by step together:
+  // at every step the still active tracks are transported by BatchState and then corrected for material one by one
+  using Batch = BatchState<value_type>;
+  if ((!status.empty() && status.size() != tracks.size()) || (!tofInfo.empty() && tofInfo.size() != tracks.size())) {
+    throw std::runtime_error(fmt::format("status ({}) or tofInfo ({}) size differs from number of tracks {}", status.size(), tofInfo.size(), tracks.size()));
+  }
+  bool perTrack = matCorr != MatCorrType::USEMatCorrNONE || !tofInfo.empty();
+  Batch batch;
+  int nOK = 0;
+  int dirs[Batch::Size], signCorrs[Batch::Size];
+  bool result[Batch::Size];
+  math_utils::Point3D<value_type> xyz0[Batch::Size];
+  for (size_t i0 = 0; i0 < tracks.size(); i0 += Batch::Size) {
+    batch.n = std::min(tracks.size() - i0, size_t(Batch::Size));
+    for (int l = 0; l < batch.n; l++) {
+      const auto& track = tracks[i0 + l];
+      batch.load(l, track);
+      dirs[l] = xToGo[(i0 + l) * xStride] - track.getX() > 0.f ? 1 : -1;
+      signCorrs[l] = signCorr ? signCorr : -dirs[l]; // sign of eloss correction is not imposed
+      result[l] = true;
+      if (perTrack) {
+        xyz0[l] = track.getXYZGlo();
+      }
+    }
+    while (true) {
+      int nAct = 0;
+      for (int l = 0; l < batch.n; l++) {
+        batch.act[l] = false;
+        if (!result[l]) {
+          continue;
+        }
+        auto xk = xToGo[(i0 + l) * xStride];
+        auto dx = xk - batch.x[l];
+        if (math_utils::detail::abs<value_type>(dx) <= Epsilon) {
+          batch.x[l] = xk;
+          continue;
+        }
+        auto step = math_utils::detail::min<value_type>(math_utils::detail::abs<value_type>(dx), maxStep);
+        batch.xTo[l] = batch.x[l] + (dirs[l] < 0 ? -step : step);
+        batch.act[l] = true;
+        nAct++;
+      }
+      if (!nAct) {
+        break;
+      }
+      batch.transport(bZ);
+      for (int l = 0; l < batch.n; l++) {
+        if (!batch.act[l]) {
+          continue;
+        }
+        auto& track = tracks[i0 + l];
+        if (batch.arc[l] || batch.big[l]) { // rare cases left to the track
+          batch.save(l, track);
+          if (batch.arc[l]) {
+            batch.ok[l] = track.propagateTo(batch.xTo[l], bZ);
+          } else {
+            track.checkCovariance();
+          }
+          batch.load(l, track);
+        }
+        if (!batch.ok[l]) {
+          result[l] = false;
+          continue;
+        }
+        auto* tofI = tofInfo.empty() ? nullptr : &tofInfo[i0 + l];
+        auto correct = [&batch, &track, &xyz0 = xyz0[l], l, tofI, matCorr, signC = signCorrs[l], this]() {
+          bool res = true;
+          batch.save(l, track);
+          auto xyz1 = track.getXYZGlo();
+          if (matCorr != MatCorrType::USEMatCorrNONE) {
+            auto mb = this->getMatBudget(matCorr, xyz0, xyz1);
+            if (!track.correctForMaterial(mb.meanX2X0, mb.getXRho(signC))) {
+              res = false;
+            }
+            if (tofI) {
+              tofI->addStep(mb.length, track.getP2Inv()); // fill L,ToF info using already calculated step length
+              tofI->addX2X0(mb.meanX2X0);
+              tofI->addXRho(mb.getXRho(signC));
+            }
+            batch.load(l, track);
+          } else if (tofI) { // if tofInfo filling was requested w/o material correction, we need to calculate the step lenght
+            math_utils::Vector3D<value_type> stepV(xyz1.X() - xyz0.X(), xyz1.Y() - xyz0.Y(), xyz1.Z() - xyz0.Z());
+            tofI->addStep(stepV.R(), track.getP2Inv());
+          }
+          xyz0 = xyz1;
+          return res;
+        };
+        if (maxSnp > 0 && math_utils::detail::abs<value_type>(batch.snp[l]) >= maxSnp) {
+          if (perTrack) {
+            correct();
+          }
+          result[l] = false;
+        } else if (perTrack && !correct()) {
+          result[l] = false;
+        }
+      }
+    }
+    for (int l = 0; l < batch.n; l++) {
+      batch.save(l, tracks[i0 + l]);
+      if (!status.empty()) {
+        status[i0 + l] = result[l];
+      }
+      nOK += result[l];
+    }
+  }
+  return nOK;
+}
+#endif
+
 namespace o2::base
 {
 #if !defined(GPUCA_GPUCODE) || defined(GPUCA_GPUCODE_DEVICE) // FIXME: DR: WORKAROUND to avoid CUDA bug creating host symbols for device code.
@@ -43,15 +43,26 @@ GPUd() int Ray::crossLayer(const MatLayerCyl& lr)
   }
   float detMin = mXDxPlusYDy2 - mDistXY2 * (mR02 - lr.getRMin2());
   if (detMin < 0) { // does not reach inner R -> just 1 tangential crossing
+    return crossLayer(lr, tCross0Max, tCross0Min, InvalidT, InvalidT);
+  }
+  float detMinRed = CAMath::Sqrt(detMin) * mDistXY2i;
+  return crossLayer(lr, tCross0Max, tCross0Min, mXDxPlusYDyRed + detMinRed, mXDxPlusYDyRed - detMinRed);
+}
+
+//______________________________________________________
+GPUd() int Ray::crossLayer(const MatLayerCyl& lr, float tCross0Max, float tCross0Min, float tCross1Max, float tCross1Min)
+{
+  // Same as crossLayer(lr) with provided parameters t of intersection with circles of rmax (tCross0...)
+  // and rmin (tCross1...), InvalidT if there is no intersection
+  if (tCross0Max < 0 || tCross0Min > 1.f) { // no crossing with outer R or both crossings outside of the limiting points
+    return 0;
+  }
+  if (tCross1Max == InvalidT) { // does not reach inner R -> just 1 tangential crossing
     mCrossParams1[0] = tCross0Min > 0.f ? tCross0Min : 0.f;
     mCrossParams2[0] = tCross0Max < 1.f ? tCross0Max : 1.f;
     return validateZRange(mCrossParams1[0], mCrossParams2[0], lr);
   }
   int nCross = 0;
-  float detMinRed = CAMath::Sqrt(detMin) * mDistXY2i;
-  float tCross1Max = mXDxPlusYDyRed + detMinRed;
-  float tCross1Min = mXDxPlusYDyRed - detMinRed;
-
   if (tCross1Max < 1.f) {
     mCrossParams1[0] = tCross0Max < 1.f ? tCross0Max : 1.f;
     mCrossParams2[0] = tCross1Max > 0.f ? tCross1Max : 0.f;
@@ -69,3 +80,18 @@ GPUd() int Ray::crossLayer(const MatLayerCyl& lr)
   }
   return nCross;
 }
+
+#ifndef GPUCA_GPUCODE
+//______________________________________________________
+void Ray::crossCirclesR(const float* r2, int n, float* cross1, float* cross2) const
+{
+  // calculate at once the parameters t of intersection with n circles of radii^2 r2, as in crossCircleR.
+  // InvalidT is assigned if there is no intersection
+  for (int i = 0; i < n; i++) {
+    float det = mXDxPlusYDy2 - mDistXY2 * (mR02 - r2[i]);
+    float detRed = CAMath::Sqrt(det < 0.f ? 0.f : det) * mDistXY2i;
+    cross1[i] = det < 0.f ? InvalidT : mXDxPlusYDyRed + detRed;
+    cross2[i] = det < 0.f ? InvalidT : mXDxPlusYDyRed - detRed;
+  }
+}
+#endif // !GPUCA_GPUCODE
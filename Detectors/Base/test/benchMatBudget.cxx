@@ -0,0 +1,137 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchMatBudget.cxx
+/// \brief Benchmark of the material budget queries on the production LUT
+///
+/// The LUT is taken from the file given by the O2_MATLUT_FILE environment variable or,
+/// if not set, from the CCDB (GLO/Param/MatLUT). The queries are the steps of straight
+/// and curved tracks from the beam pipe outwards. Every benchmark reports the fraction of
+/// queries differing from the plain traversal and the maximal relative difference.
+
+#include "benchmark/benchmark.h"
+#include "CCDB/BasicCCDBManager.h"
+#include "DetectorsBase/MatLayerCylSet.h"
+#include "Framework/Logger.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace o2::base;
+
+namespace
+{
+const MatLayerCylSet* getLUT()
+{
+  static const MatLayerCylSet* lut = []() {
+    const char* fname = std::getenv("O2_MATLUT_FILE");
+    if (fname) {
+      return (const MatLayerCylSet*)MatLayerCylSet::loadFromFile(fname);
+    }
+    auto& mgr = o2::ccdb::BasicCCDBManager::instance();
+    return (const MatLayerCylSet*)MatLayerCylSet::rectifyPtrFromFile(mgr.get<MatLayerCylSet>("GLO/Param/MatLUT"));
+  }();
+  if (!lut) {
+    LOG(fatal) << "Failed to load material LUT";
+  }
+  return lut;
+}
+
+using Segment = std::array<float, 6>;
+
+/// consecutive steps of tracks with random direction, curvature and step size within [minStep, 2*minStep]
+const std::vector<Segment>& getSegments(int minStep)
+{
+  static std::map<int, std::vector<Segment>> segments;
+  auto& segs = segments[minStep];
+  if (segs.empty()) {
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> rnd(-1.f, 1.f);
+    float rMax = getLUT()->getRMax(), zMax = getLUT()->getZMax();
+    for (int itr = 0; itr < 2000; itr++) {
+      float phi = rnd(rng) * M_PI, tgl = rnd(rng), crv = rnd(rng) * 2e-3f, step = minStep * (1.5f + 0.5f * rnd(rng));
+      float x = 0.f, y = 0.f, z = 5.f * rnd(rng);
+      while (x * x + y * y < rMax * rMax && std::abs(z) < zMax) {
+        phi += crv * step;
+        float x1 = x + step * std::cos(phi), y1 = y + step * std::sin(phi), z1 = z + step * tgl;
+        segs.push_back({x, y, z, x1, y1, z1});
+        x = x1;
+        y = y1;
+        z = z1;
+      }
+    }
+  }
+  return segs;
+}
+
+/// reference budgets, from the plain traversal
+const std::vector<MatBudget>& getReference(int minStep)
+{
+  static std::map<int, std::vector<MatBudget>> references;
+  auto& ref = references[minStep];
+  if (ref.empty()) {
+    MatLayerCylSet::setUseLayersBatch(false);
+    MatLayerCylSet::setUseCellCache(false);
+    for (const auto& s : getSegments(minStep)) {
+      ref.push_back(getLUT()->getMatBudget(s[0], s[1], s[2], s[3], s[4], s[5]));
+    }
+  }
+  return ref;
+}
+} // namespace
+
+// Args: minimal step in cm, crossings with all layers at once, cell cache
+static void BM_MatBudget(benchmark::State& state)
+{
+  const auto* lut = getLUT();
+  const auto& segs = getSegments(state.range(0));
+  const auto& ref = getReference(state.range(0));
+  MatLayerCylSet::setUseLayersBatch(state.range(1));
+  MatLayerCylSet::setUseCellCache(state.range(2));
+  std::vector<MatBudget> res(segs.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < segs.size(); i++) {
+      const auto& s = segs[i];
+      res[i] = lut->getMatBudget(s[0], s[1], s[2], s[3], s[4], s[5]);
+    }
+    benchmark::DoNotOptimize(res.data());
+  }
+  size_t nDiff = 0;
+  double maxRelDiff = 0.;
+  for (size_t i = 0; i < segs.size(); i++) {
+    if (res[i].meanX2X0 != ref[i].meanX2X0 || res[i].meanRho != ref[i].meanRho || res[i].length != ref[i].length) {
+      nDiff++;
+      maxRelDiff = std::max(maxRelDiff, std::abs(double(res[i].meanX2X0) - ref[i].meanX2X0) / std::max(1e-12, double(ref[i].meanX2X0)));
+      maxRelDiff = std::max(maxRelDiff, std::abs(double(res[i].meanRho) - ref[i].meanRho) / std::max(1e-12, double(ref[i].meanRho)));
+    }
+  }
+  state.counters["queries"] = benchmark::Counter(segs.size() * state.iterations(), benchmark::Counter::kIsRate);
+  state.counters["diffFrac"] = double(nDiff) / segs.size();
+  state.counters["maxRelDiff"] = maxRelDiff;
+}
+
+static void CustomArguments(benchmark::internal::Benchmark* bench)
+{
+  for (int step : {1, 2, 10, 50}) {
+    bench->Args({step, 0, 0});
+    bench->Args({step, 1, 0});
+    bench->Args({step, 0, 1});
+    bench->Args({step, 1, 1});
+  }
+}
+
+BENCHMARK(BM_MatBudget)->Apply(CustomArguments)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,111 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test material budget cell cache
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "DetectorsBase/MatLayerCylSet.h"
+
+namespace o2
+{
+using Segment = std::array<float, 6>;
+
+/// fill the cells of the LUT with values varying in z and in groups of phi bins, which become the phi slices
+void fillCells(base::MatLayerCylSet& lut, float scale)
+{
+  for (int il = 0; il < lut.getNLayers(); il++) {
+    auto& lr = lut.getLayer(il);
+    for (int ip = 0; ip < lr.getNPhiBins(); ip++) {
+      for (int iz = 0; iz < lr.getNZBins(); iz++) {
+        auto& cell = lr.getCellPhiBin(ip, iz);
+        cell.meanRho = scale * (0.1f + 0.05f * il + 0.01f * ((ip / 4 + iz) % 7));
+        cell.meanX2X0 = 0.01f * cell.meanRho;
+      }
+    }
+  }
+}
+
+/// consecutive short steps of straight tracks from the beam line outwards
+std::vector<Segment> makeSegments(float rMax, float zMax)
+{
+  std::vector<Segment> segs;
+  std::mt19937 rng(12345);
+  std::uniform_real_distribution<float> rnd(-1.f, 1.f);
+  for (int itr = 0; itr < 500; itr++) {
+    float phi = rnd(rng) * M_PI, tgl = rnd(rng), step = 1.f + 0.5f * rnd(rng);
+    float x = 0.f, y = 0.f, z = 5.f * rnd(rng);
+    while (x * x + y * y < rMax * rMax && std::abs(z) < zMax) {
+      float x1 = x + step * std::cos(phi), y1 = y + step * std::sin(phi), z1 = z + step * tgl;
+      segs.push_back({x, y, z, x1, y1, z1});
+      x = x1;
+      y = y1;
+      z = z1;
+    }
+  }
+  return segs;
+}
+
+std::vector<base::MatBudget> getBudgets(const base::MatLayerCylSet& lut, const std::vector<Segment>& segs, bool useCellCache)
+{
+  base::MatLayerCylSet::setUseCellCache(useCellCache);
+  std::vector<base::MatBudget> budgets;
+  for (const auto& s : segs) {
+    budgets.push_back(lut.getMatBudget(s[0], s[1], s[2], s[3], s[4], s[5]));
+  }
+  return budgets;
+}
+
+void compareBudgets(const std::vector<base::MatBudget>& ref, const std::vector<base::MatBudget>& cached)
+{
+  BOOST_REQUIRE(ref.size() == cached.size());
+  for (size_t i = 0; i < ref.size(); i++) {
+    BOOST_CHECK(ref[i].length == cached[i].length);
+    BOOST_CHECK_CLOSE(ref[i].meanRho, cached[i].meanRho, 1e-3);
+    BOOST_CHECK_CLOSE(ref[i].meanX2X0, cached[i].meanX2X0, 1e-3);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(MatBudgetCellCache)
+{
+  std::unique_ptr<char[]> buffer;
+  base::MatLayerCylSet lut;
+  for (int il = 0; il < 10; il++) { // with gaps between the layers
+    lut.addLayer(2.f + 5.f * il, 6.f + 5.f * il, 40.f, 2.f, 1.5f);
+  }
+  fillCells(lut, 1.f);
+  lut.finalizeStructures();
+  lut.optimizePhiSlices();
+  lut.flatten();
+  lut.initLayerVoxelLU();
+
+  const auto segs = makeSegments(lut.getRMax(), lut.getZMax());
+  for (bool useBatch : {false, true}) {
+    base::MatLayerCylSet::setUseLayersBatch(useBatch);
+    compareBudgets(getBudgets(lut, segs, false), getBudgets(lut, segs, true));
+  }
+
+  // relocation of the LUT invalidates the cached cells, the cells changed in the new buffer must be seen
+  buffer.reset(new char[lut.getFlatBufferSize()]);
+  lut.moveBufferTo(buffer.get());
+  fillCells(lut, 2.f);
+  compareBudgets(getBudgets(lut, segs, false), getBudgets(lut, segs, true));
+
+  base::MatLayerCylSet::setUseCellCache(false);
+  base::MatLayerCylSet::setUseLayersBatch(true);
+}
+} // namespace o2
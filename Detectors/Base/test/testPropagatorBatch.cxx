@@ -0,0 +1,72 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test batched propagation
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+#include <random>
+#include <vector>
+
+#include "DetectorsBase/Propagator.h"
+
+namespace o2
+{
+template <typename value_T>
+void compareBatchWithScalar()
+{
+  using Prop = base::PropagatorImpl<value_T>;
+  using Track = typename Prop::TrackParCov_t;
+  const auto* prop = Prop::Instance(true);
+  const value_T bZ = 5.;
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<value_T> rnd(-1., 1.);
+  std::vector<Track> tracks;
+  std::vector<value_T> xs;
+  for (int i = 0; i < 1000; i++) {
+    std::array<value_T, 5> par{rnd(rng) * 5, rnd(rng) * 20, rnd(rng) * 0.7f, rnd(rng), rnd(rng) * 25}; // includes loopers needing arc Z
+    std::array<value_T, 15> cov{1e-2, 0., 2e-2, 1e-5, 0., 1e-4, 0., 0., 0., 1e-4, 0., 0., 1e-5, 0., 1e-2};
+    tracks.emplace_back(2.f + rnd(rng), rnd(rng) * 3, par, cov);
+    xs.push_back(i % 3 ? 60 + 20 * rnd(rng) : 1 + rnd(rng)); // some tracks propagated inwards
+  }
+  for (int perTrackX = 0; perTrackX < 2; perTrackX++) {
+    auto scalar = tracks, batch = tracks;
+    std::vector<uint8_t> status(tracks.size());
+    std::vector<track::TrackLTIntegral> ltScalar(tracks.size()), ltBatch(tracks.size());
+    int nOK = 0;
+    for (size_t i = 0; i < tracks.size(); i++) {
+      nOK += prop->propagateToX(scalar[i], perTrackX ? xs[i] : value_T(50), bZ, Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE, &ltScalar[i]);
+    }
+    int nOKBatch = perTrackX ? prop->propagateBatchToX(batch, xs, bZ, status, Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE, ltBatch)
+                             : prop->propagateBatchToX(batch, value_T(50), bZ, status, Prop::MAX_SIN_PHI, Prop::MAX_STEP, Prop::MatCorrType::USEMatCorrNONE, ltBatch);
+    BOOST_CHECK(nOK == nOKBatch);
+    BOOST_CHECK(nOK > 0 && nOK < int(tracks.size()));
+    for (size_t i = 0; i < tracks.size(); i++) {
+      BOOST_CHECK(scalar[i].getX() == batch[i].getX());
+      for (int ip = 0; ip < track::kNParams; ip++) {
+        BOOST_CHECK_CLOSE(scalar[i].getParam(ip), batch[i].getParam(ip), 1e-3);
+      }
+      for (int ic = 0; ic < track::kCovMatSize; ic++) {
+        BOOST_CHECK_CLOSE(scalar[i].getCov()[ic], batch[i].getCov()[ic], 1e-3);
+      }
+      BOOST_CHECK_CLOSE(ltScalar[i].getL(), ltBatch[i].getL(), 1e-3);
+    }
+  }
+  std::vector<value_T> wrongSize(2);
+  BOOST_CHECK_THROW(prop->propagateBatchToX(tracks, wrongSize, bZ), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(PropagatorBatch)
+{
+  compareBatchWithScalar<float>();
+  compareBatchWithScalar<double>();
+}
+} // namespace o2
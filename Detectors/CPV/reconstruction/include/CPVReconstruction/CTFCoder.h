@@ -108,17 +108,19 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODECPV(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODECPV(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODECPV(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODECPV(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODECPV(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
-
-  iosize += ENCODECPV(helper.begin_posX(),        helper.end_posX(),           CTF::BLC_posX,         0);
-  iosize += ENCODECPV(helper.begin_posZ(),        helper.end_posZ(),           CTF::BLC_posZ,         0);
-  iosize += ENCODECPV(helper.begin_energy(),      helper.end_energy(),         CTF::BLC_energy,       0);
-  iosize += ENCODECPV(helper.begin_status(),      helper.end_status(),         CTF::BLC_status,       0);
+  ENCODECPV(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODECPV(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODECPV(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
+
+  ENCODECPV(helper.begin_posX(),        helper.end_posX(),           CTF::BLC_posX,         0);
+  ENCODECPV(helper.begin_posZ(),        helper.end_posZ(),           CTF::BLC_posZ,         0);
+  ENCODECPV(helper.begin_energy(),      helper.end_energy(),         CTF::BLC_energy,       0);
+  ENCODECPV(helper.begin_status(),      helper.end_status(),         CTF::BLC_status,       0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = trigData.size() * sizeof(TriggerRecord) + cluData.size() * sizeof(Cluster);
@@ -138,16 +140,18 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCLUSTER
   std::vector<uint8_t> energy, status;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODECPV(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODECPV(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODECPV(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODECPV(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODECPV(entries,     CTF::BLC_entriesTrig);
-  iosize += DECODECPV(posX,        CTF::BLC_posX);
-  iosize += DECODECPV(posZ,        CTF::BLC_posZ);
-  iosize += DECODECPV(energy,      CTF::BLC_energy);
-  iosize += DECODECPV(status,      CTF::BLC_status);
+  DECODECPV(bcInc,       CTF::BLC_bcIncTrig);
+  DECODECPV(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODECPV(entries,     CTF::BLC_entriesTrig);
+  DECODECPV(posX,        CTF::BLC_posX);
+  DECODECPV(posZ,        CTF::BLC_posZ);
+  DECODECPV(energy,      CTF::BLC_energy);
+  DECODECPV(status,      CTF::BLC_status);
   // clang-format on
+  iosize += decoder.decode();
   //
   trigVec.clear();
   cluVec.clear();
@@ -0,0 +1,308 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchmark_ctf_coders.cxx
+/// \brief Throughput of the detector CTF encoders/decoders vs number of threads used for the block coding
+
+#include <benchmark/benchmark.h>
+
+#include "DataFormatsITSMFT/CompCluster.h"
+#include "DataFormatsITSMFT/CTF.h"
+#include "DataFormatsITSMFT/ROFRecord.h"
+#include "ITSMFTReconstruction/CTFCoder.h"
+#include "ITSMFTReconstruction/LookUp.h"
+#include "DataFormatsZDC/CTF.h"
+#include "ZDCReconstruction/CTFCoder.h"
+#include "DataFormatsTPC/CompressedClusters.h"
+#include "DataFormatsTPC/ZeroSuppression.h"
+#include "DataFormatsTPC/CTF.h"
+#include "TPCReconstruction/CTFCoder.h"
+#include <TRandom.h>
+
+namespace
+{
+
+struct ITSData {
+  std::vector<o2::itsmft::ROFRecord> rofs;
+  std::vector<o2::itsmft::CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  o2::itsmft::LookUp lookup;
+
+  ITSData()
+  {
+    gRandom->SetSeed(1);
+    for (int irof = 0; irof < 500; irof++) {
+      auto& rofr = rofs.emplace_back();
+      rofr.getBCData().orbit = irof / 10;
+      rofr.getBCData().bc = irof % 10;
+      rofr.setFirstEntry(clusters.size());
+      int chipID = 0;
+      for (int i = 0; i < 200; i++) {
+        int nhits = gRandom->Poisson(20);
+        for (int ih = 0; ih < nhits; ih++) {
+          auto& cl = clusters.emplace_back(gRandom->Integer(512), ih * 50 + gRandom->Integer(50), gRandom->Integer(1000), chipID);
+          if (cl.getPatternID() > 900) {
+            patterns.push_back(char(gRandom->Integer(256)));
+          }
+        }
+        chipID += 1 + gRandom->Poisson(10);
+      }
+      rofr.setNEntries(int(clusters.size()) - rofr.getFirstEntry());
+    }
+  }
+  size_t size() const { return rofs.size() * sizeof(o2::itsmft::ROFRecord) + clusters.size() * sizeof(o2::itsmft::CompClusterExt) + patterns.size(); }
+};
+
+struct ZDCData {
+  std::vector<o2::zdc::BCData> bcdata;
+  std::vector<o2::zdc::ChannelData> chandata;
+  std::vector<o2::zdc::OrbitData> pedsdata;
+
+  ZDCData()
+  {
+    gRandom->SetSeed(1);
+    o2::InteractionRecord ir(0, 0);
+    std::array<float, o2::zdc::NTimeBinsPerBC> chanVals;
+    for (int irof = 0; irof < 50000; irof++) {
+      ir += 1 + gRandom->Integer(100);
+      uint32_t channPatt = 0, triggers = 0;
+      int8_t ich = -1;
+      int firstChEntry = chandata.size();
+      while ((ich += 1 + gRandom->Poisson(2.)) < o2::zdc::NDigiChannels) {
+        channPatt |= 0x1 << ich;
+        for (int i = 0; i < o2::zdc::NTimeBinsPerBC; i++) {
+          chanVals[i] = gRandom->Integer(0xffff);
+        }
+        if (gRandom->Rndm() > 0.4) {
+          triggers |= 0x1 << ich;
+        }
+        chandata.emplace_back(ich, chanVals);
+      }
+      bcdata.emplace_back(firstChEntry, chandata.size() - firstChEntry, ir, channPatt, triggers, gRandom->Integer(0xff));
+    }
+    const auto &irFirst = bcdata.front().ir, irLast = bcdata.back().ir;
+    o2::InteractionRecord irPed(o2::constants::lhc::LHCMaxBunches - 1, irFirst.orbit);
+    pedsdata.resize(irLast.orbit - irFirst.orbit + 1);
+    for (auto& ped : pedsdata) {
+      ped.ir = irPed;
+      for (int ic = 0; ic < o2::zdc::NChannels; ic++) {
+        ped.data[ic] = gRandom->Integer(0xffff);
+      }
+      irPed.orbit++;
+    }
+  }
+  size_t size() const { return bcdata.size() * sizeof(o2::zdc::BCData) + chandata.size() * sizeof(o2::zdc::ChannelData) + pedsdata.size() * sizeof(o2::zdc::OrbitData); }
+};
+
+// TPC: 26 blocks, the largest ones span several chunks of Metadata::OptStore::EENCODE_CHUNKED encoding
+struct TPCData {
+  std::vector<char> flat;
+  o2::tpc::CompressedClusters c;
+  o2::tpc::detail::TriggerInfo trigComp;
+
+  TPCData()
+  {
+    gRandom->SetSeed(1);
+    c.nAttachedClusters = 1 << 22;
+    c.nUnattachedClusters = 3 << 22;
+    c.nAttachedClustersReduced = c.nAttachedClusters - (1 << 18);
+    c.nTracks = 1 << 18;
+    c.nSliceRows = 36 * 152;
+    o2::tpc::CompressedClustersFlat* ccFlat = nullptr;
+    size_t sizeCFlatBody = o2::tpc::CTFCoder::alignSize(ccFlat);
+    size_t sz = sizeCFlatBody + o2::tpc::CTFCoder::estimateSize(c);
+    flat.resize(sz);
+    ccFlat = reinterpret_cast<o2::tpc::CompressedClustersFlat*>(flat.data());
+    auto buff = reinterpret_cast<void*>(flat.data() + sizeCFlatBody);
+    o2::tpc::CTFCoder::setCompClusAddresses(c, buff);
+    ccFlat->set(sz, c);
+    for (unsigned int i = 0; i < c.nUnattachedClusters; i++) {
+      c.qTotU[i] = gRandom->Poisson(60);
+      c.qMaxU[i] = gRandom->Poisson(15);
+      c.flagsU[i] = gRandom->Integer(4);
+      c.padDiffU[i] = gRandom->Integer(100);
+      c.timeDiffU[i] = gRandom->Integer(400);
+      c.sigmaPadU[i] = gRandom->Poisson(20);
+      c.sigmaTimeU[i] = gRandom->Poisson(20);
+    }
+    for (unsigned int i = 0; i < c.nAttachedClusters; i++) {
+      c.qTotA[i] = gRandom->Poisson(60);
+      c.qMaxA[i] = gRandom->Poisson(15);
+      c.flagsA[i] = gRandom->Integer(4);
+      c.sigmaPadA[i] = gRandom->Poisson(20);
+      c.sigmaTimeA[i] = gRandom->Poisson(20);
+    }
+    for (unsigned int i = 0; i < c.nAttachedClustersReduced; i++) {
+      c.rowDiffA[i] = gRandom->Integer(4);
+      c.sliceLegDiffA[i] = gRandom->Integer(2);
+      c.padResA[i] = gRandom->Integer(40);
+      c.timeResA[i] = gRandom->Integer(200);
+    }
+    for (unsigned int i = 0; i < c.nTracks; i++) {
+      c.qPtA[i] = gRandom->Integer(128);
+      c.rowA[i] = gRandom->Integer(152);
+      c.sliceA[i] = gRandom->Integer(36);
+      c.timeA[i] = gRandom->Integer(1 << 20);
+      c.padA[i] = gRandom->Integer(140);
+      c.nTrackClusters[i] = 16;
+    }
+    for (unsigned int i = 0; i < c.nSliceRows; i++) {
+      c.nSliceRowClusters[i] = c.nUnattachedClusters / c.nSliceRows;
+    }
+  }
+  size_t size() const { return flat.size(); }
+};
+
+const ITSData& getITSData()
+{
+  static ITSData data;
+  return data;
+}
+
+const ZDCData& getZDCData()
+{
+  static ZDCData data;
+  return data;
+}
+
+const TPCData& getTPCData()
+{
+  static TPCData data;
+  return data;
+}
+
+} // namespace
+
+static void BM_ITSEncode(benchmark::State& state)
+{
+  const auto& data = getITSData();
+  o2::itsmft::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder, o2::detectors::DetID::ITS);
+  coder.setANSVersion(o2::ctf::ANSVersion1);
+  coder.setNThreads(state.range(0));
+  std::vector<o2::ctf::BufferType> vec;
+  for (auto _ : state) {
+    vec.clear();
+    coder.encode(vec, data.rofs, data.clusters, data.patterns, data.lookup, 0);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+static void BM_ITSDecode(benchmark::State& state)
+{
+  const auto& data = getITSData();
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    o2::itsmft::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder, o2::detectors::DetID::ITS);
+    coder.setANSVersion(o2::ctf::ANSVersion1);
+    coder.encode(vec, data.rofs, data.clusters, data.patterns, data.lookup, 0);
+  }
+  const auto ctfImage = o2::itsmft::CTF::getImage(vec.data());
+  o2::itsmft::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder, o2::detectors::DetID::ITS);
+  coder.setNThreads(state.range(0));
+  std::vector<o2::itsmft::ROFRecord> rofs;
+  std::vector<o2::itsmft::CompClusterExt> clusters;
+  std::vector<unsigned char> patterns;
+  for (auto _ : state) {
+    coder.decode(ctfImage, rofs, clusters, patterns, nullptr, data.lookup);
+    benchmark::DoNotOptimize(clusters.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+static void BM_ZDCEncode(benchmark::State& state)
+{
+  const auto& data = getZDCData();
+  o2::zdc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+  coder.setANSVersion(o2::ctf::ANSVersion1);
+  coder.setNThreads(state.range(0));
+  std::vector<o2::ctf::BufferType> vec;
+  for (auto _ : state) {
+    vec.clear();
+    coder.encode(vec, data.bcdata, data.chandata, data.pedsdata);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+static void BM_ZDCDecode(benchmark::State& state)
+{
+  const auto& data = getZDCData();
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    o2::zdc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.setANSVersion(o2::ctf::ANSVersion1);
+    coder.encode(vec, data.bcdata, data.chandata, data.pedsdata);
+  }
+  const auto ctfImage = o2::zdc::CTF::getImage(vec.data());
+  o2::zdc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+  coder.setNThreads(state.range(0));
+  std::vector<o2::zdc::BCData> bcdata;
+  std::vector<o2::zdc::ChannelData> chandata;
+  std::vector<o2::zdc::OrbitData> pedsdata;
+  for (auto _ : state) {
+    coder.decode(ctfImage, bcdata, chandata, pedsdata);
+    benchmark::DoNotOptimize(chandata.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+static void BM_TPCEncode(benchmark::State& state)
+{
+  const auto& data = getTPCData();
+  o2::tpc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+  coder.setANSVersion(o2::ctf::ANSVersion1);
+  coder.setCombineColumns(true);
+  coder.setChunkedEncoding(true);
+  coder.setNThreads(state.range(0));
+  std::vector<o2::ctf::BufferType> vec;
+  for (auto _ : state) {
+    vec.clear();
+    coder.encode(vec, data.c, data.c, data.trigComp);
+    benchmark::DoNotOptimize(vec.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+static void BM_TPCDecode(benchmark::State& state)
+{
+  const auto& data = getTPCData();
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    o2::tpc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.setANSVersion(o2::ctf::ANSVersion1);
+    coder.setCombineColumns(true);
+    coder.setChunkedEncoding(true);
+    coder.encode(vec, data.c, data.c, data.trigComp);
+  }
+  const auto ctfImage = o2::tpc::CTF::getImage(vec.data());
+  o2::tpc::CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+  coder.setCombineColumns(true);
+  coder.setNThreads(state.range(0));
+  std::vector<char> flat;
+  std::vector<o2::tpc::TriggerInfoDLBZS> triggers;
+  for (auto _ : state) {
+    coder.decode(ctfImage, flat, triggers);
+    benchmark::DoNotOptimize(flat.data());
+  }
+  state.SetBytesProcessed(int64_t(state.iterations()) * data.size());
+}
+
+#define BENCHMARK_RANGE_THREADS RangeMultiplier(2)->Range(1, 16)->UseRealTime()->Unit(benchmark::kMillisecond)
+
+BENCHMARK(BM_ITSEncode)->BENCHMARK_RANGE_THREADS;
+BENCHMARK(BM_ITSDecode)->BENCHMARK_RANGE_THREADS;
+BENCHMARK(BM_ZDCEncode)->BENCHMARK_RANGE_THREADS;
+BENCHMARK(BM_ZDCDecode)->BENCHMARK_RANGE_THREADS;
+BENCHMARK(BM_TPCEncode)->BENCHMARK_RANGE_THREADS;
+BENCHMARK(BM_TPCDecode)->BENCHMARK_RANGE_THREADS;
+
+BENCHMARK_MAIN();
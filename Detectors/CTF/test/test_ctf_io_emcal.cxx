@@ -29,19 +29,15 @@
 #include <TStopwatch.h>
 #include <TSystem.h>
 #include <cstring>
+#include <type_traits>
 
 using namespace o2::emcal;
 namespace boost_data = boost::unit_test::data;
 
 inline std::vector<o2::ctf::ANSHeader> ANSVersions{o2::ctf::ANSVersionCompat, o2::ctf::ANSVersion1};
 
-BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
+void generateData(std::vector<TriggerRecord>& triggers, std::vector<Cell>& cells)
 {
-  std::vector<TriggerRecord> triggers;
-  std::vector<Cell> cells;
-  //  gSystem->Load("libO2DetectorsCommonDataFormats");
-  TStopwatch sw;
-  sw.Start();
   o2::InteractionRecord ir(0, 0);
   for (int irof = 0; irof < 1000; irof++) {
     ir += 1 + gRandom->Integer(200);
@@ -83,6 +79,16 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
     uint32_t trigBits = gRandom->Integer(0xFFFFFFFF); // will be converted internally to uint16_t by the coder
     triggers.emplace_back(ir, trigBits, start, cells.size() - start);
   }
+}
+
+BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
+{
+  std::vector<TriggerRecord> triggers;
+  std::vector<Cell> cells;
+  //  gSystem->Load("libO2DetectorsCommonDataFormats");
+  TStopwatch sw;
+  sw.Start();
+  generateData(triggers, cells);
 
   sw.Start();
   std::vector<o2::ctf::BufferType> vec;
@@ -168,3 +174,47 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
     BOOST_CHECK_EQUAL(cor.getCellTypeEncoded(), cdc.getCellTypeEncoded());
   }
 }
+
+// emulate a CTF written before the slot was added: it has neither metadata nor data for it
+void dropBlock(CTF& ctf, int slot)
+{
+  const_cast<o2::ctf::Metadata&>(ctf.getMetadata(slot)).clear();
+  const_cast<std::remove_cvref_t<decltype(ctf.getBlock(slot))>&>(ctf.getBlock(slot)).clear();
+}
+
+// the trigger slot was added later, the trigger bits of old CTFs are 0
+BOOST_DATA_TEST_CASE(CTFTestNoTriggerBlock, boost_data::make(std::vector<int>{1, 4}), nThreads)
+{
+  std::vector<TriggerRecord> triggers;
+  std::vector<Cell> cells;
+  generateData(triggers, cells);
+
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(vec, triggers, cells); // compress
+  }
+  dropBlock(*o2::emcal::CTF::get(vec.data()), CTF::BLC_trigger);
+
+  std::vector<TriggerRecord> triggersD;
+  std::vector<Cell> cellsD;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.setNThreads(nThreads);
+    coder.decode(o2::emcal::CTF::getImage(vec.data()), triggersD, cellsD); // decompress
+  }
+
+  BOOST_REQUIRE_EQUAL(triggersD.size(), triggers.size());
+  BOOST_REQUIRE_EQUAL(cellsD.size(), cells.size());
+  for (size_t i = 0; i < triggers.size(); i++) {
+    BOOST_CHECK_EQUAL(triggers[i].getBCData(), triggersD[i].getBCData());
+    BOOST_CHECK_EQUAL(triggers[i].getNumberOfObjects(), triggersD[i].getNumberOfObjects());
+    BOOST_CHECK_EQUAL(triggers[i].getFirstEntry(), triggersD[i].getFirstEntry());
+    BOOST_CHECK_EQUAL(triggersD[i].getTriggerBitsCompressed(), 0);
+  }
+  for (size_t i = 0; i < cells.size(); i++) {
+    BOOST_CHECK_EQUAL(cells[i].getTowerIDEncoded(), cellsD[i].getTowerIDEncoded());
+    BOOST_CHECK_EQUAL(cells[i].getTimeStampEncoded(), cellsD[i].getTimeStampEncoded());
+    BOOST_CHECK_EQUAL(cells[i].getEnergyEncoded(), cellsD[i].getEnergyEncoded());
+  }
+}
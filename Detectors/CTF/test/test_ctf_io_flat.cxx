@@ -0,0 +1,105 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#define BOOST_TEST_MODULE Test FlatCTFIO
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#undef NDEBUG
+#include <cassert>
+
+#include <boost/test/unit_test.hpp>
+#include "CTFWorkflow/FlatCTFFile.h"
+#include "FDDReconstruction/CTFCoder.h"
+#include "FDDBase/Constants.h"
+#include "Framework/Logger.h"
+#include <TRandom.h>
+#include <filesystem>
+
+using namespace o2::fdd;
+using DetID = o2::detectors::DetID;
+
+void generate(std::vector<Digit>& digits, std::vector<ChannelData>& channels)
+{
+  o2::InteractionRecord ir(0, 0);
+  for (int idig = 0; idig < 1000; idig++) {
+    ir += 1 + gRandom->Integer(200);
+    auto start = channels.size();
+    for (uint8_t ich = gRandom->Poisson(4); ich < Nchannels; ich += 1 + gRandom->Poisson(4)) {
+      channels.emplace_back(ich, -2048 + gRandom->Integer(2048 * 2), gRandom->Integer(4096), gRandom->Rndm() > 0.5 ? 0 : 1);
+    }
+    Triggers trig;
+    trig.setTriggers(gRandom->Integer(128), 0, 0, o2::fit::Triggers::DEFAULT_AMP, o2::fit::Triggers::DEFAULT_AMP, o2::fit::Triggers::DEFAULT_TIME, o2::fit::Triggers::DEFAULT_TIME);
+    digits.emplace_back(start, channels.size() - start, ir, trig);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(FlatCTFTest)
+{
+  constexpr int NTF = 3;
+  const std::string flname = "test_ctf_flat.ctf";
+  std::vector<std::vector<Digit>> digits(NTF);
+  std::vector<std::vector<ChannelData>> channels(NTF);
+  {
+    o2::ctf::FlatCTFWriter writer(flname + ".part");
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    for (int itf = 0; itf < NTF; itf++) {
+      generate(digits[itf], channels[itf]);
+      std::vector<o2::ctf::BufferType> vec;
+      coder.encode(vec, digits[itf], channels[itf]);
+      o2::ctf::CTFHeader header{123456, 1000u + itf, 32u * itf, uint32_t(itf)};
+      BOOST_CHECK(writer.addDetector(DetID::FDD, vec) == vec.size());
+      header.detectors.set(DetID::FDD);
+      auto recSize = writer.writeTF(header);
+      BOOST_CHECK(recSize % o2::ctf::FlatCTFFile::Alignment == 0);
+    }
+    writer.addDetector(DetID::FDD, {}); // incomplete TF must not be stored
+    writer.close();
+    BOOST_CHECK(writer.getNTFs() == NTF);
+  }
+  std::filesystem::rename(flname + ".part", flname);
+
+  BOOST_CHECK(o2::ctf::FlatCTFFile::isFlatCTF(flname));
+  {
+    o2::ctf::FlatCTFReader reader(flname);
+    BOOST_CHECK(reader.getNTFs() == NTF);
+    for (int itf = 0; itf < NTF; itf++) {
+      reader.prefetch(itf);
+      const auto header = reader.getCTFHeader(itf);
+      BOOST_CHECK(header.run == 123456 && header.creationTime == 1000u + itf && header.firstTForbit == 32u * itf && header.tfCounter == uint32_t(itf));
+      BOOST_CHECK(header.detectors[DetID::FDD] && !header.detectors[DetID::ITS]);
+      BOOST_CHECK(reader.getImage(itf, DetID::ITS).empty());
+      auto image = reader.getImage(itf, DetID::FDD);
+      BOOST_CHECK(reinterpret_cast<uintptr_t>(image.data()) % o2::ctf::FlatCTFFile::Alignment == 0);
+
+      // decode directly from the mapped memory
+      std::vector<Digit> digitsD;
+      std::vector<ChannelData> channelsD;
+      CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+      coder.decode(o2::fdd::CTF::getImage(image.data()), digitsD, channelsD);
+      BOOST_REQUIRE(digitsD.size() == digits[itf].size());
+      BOOST_REQUIRE(channelsD.size() == channels[itf].size());
+      for (size_t i = 0; i < digitsD.size(); i++) {
+        BOOST_CHECK(digitsD[i].mIntRecord == digits[itf][i].mIntRecord);
+        BOOST_CHECK(digitsD[i].ref == digits[itf][i].ref);
+        BOOST_CHECK(digitsD[i].mTriggers.getTriggersignals() == digits[itf][i].mTriggers.getTriggersignals());
+      }
+      for (size_t i = 0; i < channelsD.size(); i++) {
+        BOOST_CHECK(channelsD[i].mPMNumber == channels[itf][i].mPMNumber);
+        BOOST_CHECK(channelsD[i].mTime == channels[itf][i].mTime);
+        BOOST_CHECK(channelsD[i].mChargeADC == channels[itf][i].mChargeADC);
+        BOOST_CHECK(channelsD[i].mFEEBits == channels[itf][i].mFEEBits);
+      }
+    }
+    BOOST_CHECK_THROW(reader.getCTFHeader(NTF), std::runtime_error);
+  }
+  std::filesystem::remove(flname);
+}
@@ -27,18 +27,15 @@
 #include <TRandom.h>
 #include <TStopwatch.h>
 #include <cstring>
+#include <type_traits>
 
 using namespace o2::fv0;
 namespace boost_data = boost::unit_test::data;
 
 inline std::vector<o2::ctf::ANSHeader> ANSVersions{o2::ctf::ANSVersionCompat, o2::ctf::ANSVersion1};
 
-BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
+void generateData(std::vector<Digit>& digits, std::vector<ChannelData>& channels)
 {
-  std::vector<Digit> digits;
-  std::vector<ChannelData> channels;
-  TStopwatch sw;
-  sw.Start();
   o2::InteractionRecord ir(0, 0);
 
   constexpr int MAXChan = Constants::nChannelsPerPm * Constants::nPms;
@@ -61,6 +58,15 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
     auto end = channels.size();
     digits.emplace_back(start, end - start, ir, trig, idig);
   }
+}
+
+BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
+{
+  std::vector<Digit> digits;
+  std::vector<ChannelData> channels;
+  TStopwatch sw;
+  sw.Start();
+  generateData(digits, channels);
 
   LOG(info) << "Generated " << channels.size() << " channels in " << digits.size() << " digits " << sw.CpuTime() << " s";
 
@@ -134,3 +140,47 @@ BOOST_DATA_TEST_CASE(CTFTest, boost_data::make(ANSVersions), ansVersion)
     //    BOOST_CHECK(channels[i] == channelsD[i]);
   }
 }
+
+// emulate a CTF written before the slot was added: it has neither metadata nor data for it
+void dropBlock(CTF& ctf, int slot)
+{
+  const_cast<o2::ctf::Metadata&>(ctf.getMetadata(slot)).clear();
+  const_cast<std::remove_cvref_t<decltype(ctf.getBlock(slot))>&>(ctf.getBlock(slot)).clear();
+}
+
+// the trigger and qtcChain slots were added later, they are 0 for old CTFs
+BOOST_DATA_TEST_CASE(CTFTestNoTriggerBlocks, boost_data::make(std::vector<int>{1, 4}), nThreads)
+{
+  std::vector<Digit> digits;
+  std::vector<ChannelData> channels;
+  generateData(digits, channels);
+
+  std::vector<o2::ctf::BufferType> vec;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder);
+    coder.encode(vec, digits, channels); // compress
+  }
+  dropBlock(*o2::fv0::CTF::get(vec.data()), CTF::BLC_trigger);
+  dropBlock(*o2::fv0::CTF::get(vec.data()), CTF::BLC_qtcChain);
+
+  std::vector<Digit> digitsD;
+  std::vector<ChannelData> channelsD;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder);
+    coder.setNThreads(nThreads);
+    coder.decode(o2::fv0::CTF::getImage(vec.data()), digitsD, channelsD); // decompress
+  }
+
+  BOOST_REQUIRE_EQUAL(digitsD.size(), digits.size());
+  BOOST_REQUIRE_EQUAL(channelsD.size(), channels.size());
+  for (size_t i = 0; i < digits.size(); i++) {
+    BOOST_CHECK(digits[i].mIntRecord == digitsD[i].mIntRecord);
+    BOOST_CHECK_EQUAL(digitsD[i].mTriggers.getTriggersignals(), 0);
+  }
+  for (size_t i = 0; i < channels.size(); i++) {
+    BOOST_CHECK(channels[i].ChId == channelsD[i].ChId);
+    BOOST_CHECK(channels[i].CFDTime == channelsD[i].CFDTime);
+    BOOST_CHECK(channels[i].QTCAmpl == channelsD[i].QTCAmpl);
+    BOOST_CHECK_EQUAL(channelsD[i].ChainQTC, 0);
+  }
+}
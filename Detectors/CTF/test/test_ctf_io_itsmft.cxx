@@ -152,3 +152,69 @@ BOOST_DATA_TEST_CASE(CompressedClustersTest, boost_data::make(ANSVersions), ansV
     BOOST_CHECK(pattVecD[i] == pattVec[i]);
   }
 }
+
+BOOST_DATA_TEST_CASE(ParallelBlockCodingTest, boost_data::make(ANSVersions), ansVersion)
+{
+  std::vector<ROFRecord> rofRecVec;
+  std::vector<CompClusterExt> cclusVec;
+  std::vector<unsigned char> pattVec;
+  LookUp pattIdConverter;
+  for (int irof = 0; irof < 50; irof++) {
+    auto& rofr = rofRecVec.emplace_back();
+    rofr.getBCData().orbit = irof / 10;
+    rofr.getBCData().bc = irof % 10;
+    rofr.setFirstEntry(cclusVec.size());
+    int chipID = irof;
+    for (int i = 0; i < 3 * irof; i++) {
+      int nhits = gRandom->Poisson(50);
+      for (int ih = 0; ih < nhits; ih++) {
+        auto& cl = cclusVec.emplace_back(gRandom->Integer(512), ih, gRandom->Integer(1000), chipID);
+        if (cl.getPatternID() > 900) {
+          pattVec.push_back(char(gRandom->Integer(256)));
+        }
+      }
+      chipID += 1 + gRandom->Poisson(10);
+    }
+    rofr.setNEntries(int(cclusVec.size()) - rofr.getFirstEntry());
+  }
+
+  // the concurrent encoding must produce exactly the same blocks as the sequential one
+  std::vector<o2::ctf::BufferType> vecSeq, vecPar;
+  for (auto [vec, nThreads] : {std::make_pair(&vecSeq, 1), std::make_pair(&vecPar, 4)}) {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Encoder, o2::detectors::DetID::ITS);
+    coder.setANSVersion(ansVersion);
+    coder.setNThreads(nThreads);
+    coder.encode(*vec, rofRecVec, cclusVec, pattVec, pattIdConverter, 0);
+  }
+  const auto ctfSeq = o2::itsmft::CTF::getImage(vecSeq.data());
+  const auto ctfPar = o2::itsmft::CTF::getImage(vecPar.data());
+  for (int ib = 0; ib < o2::itsmft::CTF::getNBlocks(); ib++) {
+    const auto &blSeq = ctfSeq.getBlock(ib), &blPar = ctfPar.getBlock(ib);
+    BOOST_CHECK(ctfSeq.getMetadata(ib).messageLength == ctfPar.getMetadata(ib).messageLength);
+    BOOST_CHECK(ctfSeq.getMetadata(ib).opt == ctfPar.getMetadata(ib).opt);
+    BOOST_CHECK(blSeq.getNStored() == blPar.getNStored());
+    BOOST_CHECK(blSeq.getNDict() == blPar.getNDict());
+    BOOST_CHECK(blSeq.getNData() == blPar.getNData());
+    BOOST_CHECK(blSeq.getNLiterals() == blPar.getNLiterals());
+    if (blSeq.getNStored() && blSeq.getNStored() == blPar.getNStored()) {
+      BOOST_CHECK(std::memcmp(blSeq.payload, blPar.payload, blSeq.getNStored() * sizeof(*blSeq.payload)) == 0);
+    }
+  }
+
+  std::vector<ROFRecord> rofRecVecD;
+  std::vector<CompClusterExt> cclusVecD;
+  std::vector<unsigned char> pattVecD;
+  {
+    CTFCoder coder(o2::ctf::CTFCoderBase::OpType::Decoder, o2::detectors::DetID::ITS);
+    coder.setNThreads(4);
+    coder.decode(ctfPar, rofRecVecD, cclusVecD, pattVecD, nullptr, pattIdConverter);
+  }
+  BOOST_CHECK(rofRecVecD.size() == rofRecVec.size());
+  BOOST_CHECK(cclusVecD.size() == cclusVec.size());
+  BOOST_CHECK(pattVecD.size() == pattVec.size());
+  for (size_t i = 0; i < cclusVec.size() && i < cclusVecD.size(); i++) {
+    BOOST_CHECK(cclusVecD[i].getChipID() == cclusVec[i].getChipID());
+    BOOST_CHECK(cclusVecD[i].getRow() == cclusVec[i].getRow());
+    BOOST_CHECK(cclusVecD[i].getCol() == cclusVec[i].getCol());
+  }
+}
@@ -0,0 +1,128 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   FlatCTFFile.h
+/// @brief  Flat memory-mappable container of CTFs
+///
+/// The file starts with a FileHeader followed by one record per TF. Every record starts with a TFHeader
+/// describing the CTFHeader of the TF and the location of the flat EncodedBlocks image of every stored detector.
+/// The TFHeader and every image are aligned to FlatCTFFile::Alignment, so that the images of the mmap-ed file
+/// can be used in place by EncodedBlocks::getImage and prefetched per TF.
+
+#ifndef O2_CTF_FLATCTFFILE_H
+#define O2_CTF_FLATCTFFILE_H
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <gsl/span>
+#include "DetectorsCommonDataFormats/DetID.h"
+#include "DetectorsCommonDataFormats/CTFHeader.h"
+#include "DetectorsCommonDataFormats/EncodedBlocks.h"
+
+namespace o2
+{
+namespace ctf
+{
+
+struct FlatCTFFile {
+  static constexpr uint64_t Magic = 0x3146544346324f41; // "AO2FCTF1"
+  static constexpr uint64_t TFMagic = 0x4654434654414c46; // "FLATFCTF"
+  static constexpr uint32_t Version = 1;
+  static constexpr size_t Alignment = 4096;
+
+  struct FileHeader {
+    uint64_t magic = Magic;
+    uint32_t version = Version;
+    uint32_t alignment = Alignment;
+  };
+
+  struct TFHeader {
+    uint64_t magic = TFMagic;
+    uint64_t recordSize = 0; // size of the record including the TFHeader and the padding
+    uint64_t run = 0;
+    uint64_t creationTime = 0;
+    uint32_t firstTForbit = 0;
+    uint32_t tfCounter = 0;
+    uint64_t detectors = 0;
+    std::array<uint64_t, o2::detectors::DetID::nDetectors> offset{}; // image offsets wrt the record start
+    std::array<uint64_t, o2::detectors::DetID::nDetectors> size{};   // image sizes
+  };
+  static_assert(sizeof(FileHeader) <= Alignment && sizeof(TFHeader) <= Alignment);
+
+  static constexpr size_t alignSize(size_t sz) { return (sz + Alignment - 1) / Alignment * Alignment; }
+
+  /// check if the file starts with the flat CTF file magic word
+  static bool isFlatCTF(const std::string& fname);
+};
+
+/// sequential writer of flat CTF files, images are written directly to the file, no buffering is done
+class FlatCTFWriter
+{
+ public:
+  explicit FlatCTFWriter(const std::string& fname);
+  ~FlatCTFWriter();
+  FlatCTFWriter(const FlatCTFWriter&) = delete;
+  FlatCTFWriter& operator=(const FlatCTFWriter&) = delete;
+
+  /// add EncodedBlocks image of the detector to the current TF
+  size_t addDetector(o2::detectors::DetID det, gsl::span<const BufferType> image);
+  /// finalize current TF record with its header, return the size of the record
+  size_t writeTF(const CTFHeader& header);
+  void close();
+
+  const std::string& getFileName() const { return mFileName; }
+  size_t getSize() const { return mTFStart; }
+  size_t getNTFs() const { return mNTFs; }
+
+ private:
+  void writeAt(const void* data, size_t sz, size_t offset);
+
+  std::string mFileName{};
+  int mFD = -1;
+  size_t mNTFs = 0;
+  size_t mTFStart = 0;  // offset of the current TF record
+  size_t mTFOffset = 0; // next free offset wrt the current TF record start
+  FlatCTFFile::TFHeader mTFHeader{};
+};
+
+/// reader of flat CTF files: the file is mmap-ed, the detector images point directly to the mapped memory
+class FlatCTFReader
+{
+ public:
+  explicit FlatCTFReader(const std::string& fname);
+  ~FlatCTFReader();
+  FlatCTFReader(const FlatCTFReader&) = delete;
+  FlatCTFReader& operator=(const FlatCTFReader&) = delete;
+
+  size_t getNTFs() const { return mTFOffsets.size(); }
+  CTFHeader getCTFHeader(size_t tf) const;
+  /// EncodedBlocks image of the detector in the TF, empty if the detector is absent
+  gsl::span<const BufferType> getImage(size_t tf, o2::detectors::DetID det) const;
+  /// advise the kernel to read ahead the record of the TF
+  void prefetch(size_t tf) const;
+  const std::string& getFileName() const { return mFileName; }
+
+ private:
+  const FlatCTFFile::TFHeader& getTFHeader(size_t tf) const;
+
+  std::string mFileName{};
+  int mFD = -1;
+  const BufferType* mData = nullptr;
+  size_t mSize = 0;
+  std::vector<size_t> mTFOffsets{};
+};
+
+} // namespace ctf
+} // namespace o2
+
+#endif
@@ -26,6 +26,7 @@
 #include "CommonUtils/IRFrameSelector.h"
 #include "DetectorsRaw/HBFUtils.h"
 #include "CTFWorkflow/CTFReaderSpec.h"
+#include "CTFWorkflow/FlatCTFFile.h"
 #include "DetectorsCommonDataFormats/EncodedBlocks.h"
 #include "CommonUtils/NameConf.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
@@ -89,7 +90,11 @@ class CTFReaderSpec : public o2::framework::Task
   void openCTFFile(const std::string& flname);
   bool processTF(ProcessingContext& pc);
   void checkTreeEntries();
+  void closeCTFFile();
   void stopReader();
+  bool isCTFFileOpen() const { return mCTFTree || mFlatCTF; }
+  long getNEntries() const { return mFlatCTF ? long(mFlatCTF->getNTFs()) : mCTFTree->GetEntries(); }
+  std::string getCTFFileName() const { return mFlatCTF ? mFlatCTF->getFileName() : mCTFFile->GetName(); }
   template <typename C>
   void processDetector(DetID det, const CTFHeader& ctfHeader, ProcessingContext& pc) const;
   void setMessageHeader(ProcessingContext& pc, const CTFHeader& ctfHeader, const std::string& lbl, unsigned subspec) const; // keep just for the reference
@@ -100,6 +105,7 @@ class CTFReaderSpec : public o2::framework::Task
   std::unique_ptr<o2::utils::FileFetcher> mFileFetcher;
   std::unique_ptr<TFile> mCTFFile;
   std::unique_ptr<TTree> mCTFTree;
+  std::shared_ptr<FlatCTFReader> mFlatCTF; // mmap-ed flat CTF file, shared with the messages adopting its memory
   bool mRunning = false;
   bool mUseLocalTFCounter = false;
   bool mIFRamesOut = false;
@@ -144,11 +150,18 @@ void CTFReaderSpec::stopReader()
   mRunning = false;
   mFileFetcher->stop();
   mFileFetcher.reset();
+  closeCTFFile();
+}
+
+///_______________________________________
+void CTFReaderSpec::closeCTFFile()
+{
   mCTFTree.reset();
   if (mCTFFile) {
     mCTFFile->Close();
   }
   mCTFFile.reset();
+  mFlatCTF.reset(); // the mapping is released once all messages pointing to it are sent
 }
 
 ///_______________________________________
@@ -288,21 +301,30 @@ void CTFReaderSpec::openCTFFile(const std::string& flname)
 {
   try {
     mFilesRead++;
-    mCTFFile.reset(TFile::Open(flname.c_str()));
-    if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
-      throw std::runtime_error(fmt::format("failed to open CTF file {}, skipping", flname));
-    }
-    mCTFTree.reset((TTree*)mCTFFile->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
-    if (!mCTFTree) {
-      throw std::runtime_error(fmt::format("failed to load CTF tree from {}, skipping", flname));
-    }
-    if (mCTFTree->GetEntries() < 1) {
-      throw std::runtime_error(fmt::format("CTF tree in {} has 0 entries, skipping", flname));
+    if (FlatCTFFile::isFlatCTF(flname)) {
+      mFlatCTF = std::make_shared<FlatCTFReader>(flname);
+      if (mFlatCTF->getNTFs() < 1) {
+        throw std::runtime_error(fmt::format("flat CTF file {} has 0 entries, skipping", flname));
+      }
+      mFlatCTF->prefetch(0);
+    } else {
+      mCTFFile.reset(TFile::Open(flname.c_str()));
+      if (!mCTFFile || !mCTFFile->IsOpen() || mCTFFile->IsZombie()) {
+        throw std::runtime_error(fmt::format("failed to open CTF file {}, skipping", flname));
+      }
+      mCTFTree.reset((TTree*)mCTFFile->Get(std::string(o2::base::NameConf::CTFTREENAME).c_str()));
+      if (!mCTFTree) {
+        throw std::runtime_error(fmt::format("failed to load CTF tree from {}, skipping", flname));
+      }
+      if (mCTFTree->GetEntries() < 1) {
+        throw std::runtime_error(fmt::format("CTF tree in {} has 0 entries, skipping", flname));
+      }
     }
   } catch (const std::exception& e) {
     LOG(error) << "Cannot process " << flname << ", reason: " << e.what();
     mCTFTree.reset();
     mCTFFile.reset();
+    mFlatCTF.reset();
     mNFailedFiles++;
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
@@ -322,7 +344,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   long startWait = 0;
 
   while (mRunning) {
-    if (mCTFTree) { // there is a tree open with multiple CTF
+    if (isCTFFileOpen()) { // there is a tree open with multiple CTF
       if (mInput.ctfIDs.empty() || mInput.ctfIDs[mSelIDEntry] == mCTFCounter) { // no selection requested or matching CTF ID is found
         LOG(debug) << "TF " << mCTFCounter << " of " << mInput.maxTFs << " loop " << mFileFetcher->getNLoops();
         mSelIDEntry++;
@@ -331,7 +353,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
         }
       }
       // explict CTF ID selection list or IRFrame was provided and current entry is not selected
-      LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+      LOGP(info, "Skipping CTF#{} ({} of {} in {})", mCTFCounter, mCurrTreeEntry, getNEntries(), getCTFFileName());
       checkTreeEntries();
       mCTFCounter++;
       continue;
@@ -365,7 +387,7 @@ void CTFReaderSpec::run(ProcessingContext& pc)
   if (mCTFCounter >= mInput.maxTFs || (!mInput.ctfIDs.empty() && mSelIDEntry >= mInput.ctfIDs.size())) { // done
     LOGP(info, "All CTFs from selected range were injected, stopping");
     mRunning = false;
-  } else if (mRunning && !mCTFTree && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
+  } else if (mRunning && !isCTFFileOpen() && mFileFetcher->getNextFileInQueue().empty() && !mFileFetcher->isRunning()) { // previous tree was done, can we read more?
     mRunning = false;
   }
 
@@ -395,7 +417,10 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
 
   static RateLimiter limiter;
   CTFHeader ctfHeader;
-  if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
+  if (mFlatCTF) {
+    ctfHeader = mFlatCTF->getCTFHeader(mCurrTreeEntry);
+    mFlatCTF->prefetch(mCurrTreeEntry + 1); // read ahead the next TF while this one is processed
+  } else if (!readFromTree(*(mCTFTree.get()), "CTFHeader", ctfHeader, mCurrTreeEntry)) {
     throw std::runtime_error("did not find CTFHeader");
   }
   if (mImposeRunStartMS > 0) {
@@ -475,7 +500,7 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
     stfDist.runNumber = uint32_t(ctfHeader.run);
   }
 
-  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, mCTFTree->GetEntries(), mCTFFile->GetName());
+  auto entryStr = fmt::format("({} of {} in {})", mCurrTreeEntry, getNEntries(), getCTFFileName());
   checkTreeEntries();
   mTimer.Stop();
 
@@ -501,10 +526,8 @@ bool CTFReaderSpec::processTF(ProcessingContext& pc)
 void CTFReaderSpec::checkTreeEntries()
 {
   // check if the tree has entries left, if needed, close current tree/file
-  if (++mCurrTreeEntry >= mCTFTree->GetEntries() || (mInput.maxTFsPerFile > 0 && mCurrTreeEntry >= mInput.maxTFsPerFile)) { // this file is done, check if there are other files
-    mCTFTree.reset();
-    mCTFFile->Close();
-    mCTFFile.reset();
+  if (++mCurrTreeEntry >= getNEntries() || (mInput.maxTFsPerFile > 0 && mCurrTreeEntry >= mInput.maxTFsPerFile)) { // this file is done, check if there are other files
+    closeCTFFile();
     if (mFileFetcher) {
       mFileFetcher->popFromQueue(mInput.maxLoops < 1);
     }
@@ -532,6 +555,13 @@ void CTFReaderSpec::processDetector(DetID det, const CTFHeader& ctfHeader, Proce
 {
   if (mInput.detMask[det]) {
     const auto lbl = det.getName();
+    if (mFlatCTF && ctfHeader.detectors[det]) { // create the message over the mapped image, the message keeps the mapping alive
+      auto image = mFlatCTF->getImage(mCurrTreeEntry, det);
+      auto freefn = [](void* data, void* hint) { delete static_cast<std::shared_ptr<FlatCTFReader>*>(hint); };
+      pc.outputs().adoptChunk(Output{det.getDataOrigin(), "CTFDATA", mInput.subspec}, reinterpret_cast<char*>(const_cast<BufferType*>(image.data())), image.size(),
+                              freefn, new std::shared_ptr<FlatCTFReader>(mFlatCTF));
+      return;
+    }
     auto& bufVec = pc.outputs().make<std::vector<o2::ctf::BufferType>>({lbl, mInput.subspec}, ctfHeader.detectors[det] ? sizeof(C) : 0);
     if (ctfHeader.detectors[det]) {
       C::readFromTree(bufVec, *(mCTFTree.get()), lbl, mCurrTreeEntry);
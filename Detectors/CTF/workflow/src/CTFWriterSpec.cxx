@@ -23,6 +23,7 @@
 
 #include "DataFormatsParameters/GRPECSObject.h"
 #include "CTFWorkflow/CTFWriterSpec.h"
+#include "CTFWorkflow/FlatCTFFile.h"
 #include "DetectorsCommonDataFormats/CTFHeader.h"
 #include "CommonUtils/NameConf.h"
 #include "CommonUtils/FileSystemUtils.h"
@@ -130,6 +131,7 @@ class CTFWriterSpec : public o2::framework::Task
   bool mRejectCurrentTF = false;
   bool mFallBackDirUsed = false;
   bool mFallBackDirProvided = false;
+  bool mFlatCTF = false; // write flat memory-mappable CTF files instead of ROOT trees
   int mReportInterval = -1;
   int mVerbosity = 0;
   int mSaveDictAfter = 0;          // if positive and mWriteCTF==true, save dictionary after each mSaveDictAfter TFs processed
@@ -170,6 +172,7 @@ class CTFWriterSpec : public o2::framework::Task
   int mLockFD = -1;
   std::unique_ptr<TFile> mCTFFileOut;
   std::unique_ptr<TTree> mCTFTreeOut;
+  std::unique_ptr<FlatCTFWriter> mFlatCTFOut;
 
   std::unique_ptr<TFile> mDictFileOut; // file to store dictionary
   std::unique_ptr<TTree> mDictTreeOut; // tree to store dictionary
@@ -222,6 +225,7 @@ void CTFWriterSpec::init(InitContext& ic)
   mSaveDictAfter = ic.options().get<int>("save-dict-after");
   mCTFAutoSave = ic.options().get<long>("save-ctf-after");
   mCTFFileCompression = ic.options().get<int>("ctf-file-compression");
+  mFlatCTF = ic.options().get<bool>("flat-ctf");
   mCTFMetaFileDir = ic.options().get<std::string>("meta-output-dir");
   if (mCTFMetaFileDir != "/dev/null") {
     mCTFMetaFileDir = o2::utils::Str::rectifyDirectory(mCTFMetaFileDir);
@@ -314,7 +318,7 @@ size_t CTFWriterSpec::processDet(o2::framework::ProcessingContext& pc, DetID det
     const auto ctfImage = C::getImage(bdata);
     ctfImage.print(o2::utils::Str::concat_string(det.getName(), ": "), mVerbosity);
     if (mWriteCTF && !mRejectCurrentTF) {
-      sz = ctfImage.appendToTree(*tree, det.getName());
+      sz = mFlatCTFOut ? mFlatCTFOut->addDetector(det, ctfBuffer) : ctfImage.appendToTree(*tree, det.getName());
       header.detectors.set(det);
     } else {
       sz = ctfBuffer.size();
@@ -445,7 +449,7 @@ void CTFWriterSpec::run(ProcessingContext& pc)
       constexpr size_t MB = 1024 * 1024;
       constexpr int showFirstN = 10, prsecaleWarnings = 50;
       try {
-        const auto si = std::filesystem::space(mCTFFileOut->GetName());
+        const auto si = std::filesystem::space(mFlatCTFOut ? mFlatCTFOut->getFileName() : mCTFFileOut->GetName());
         std::string wmsg{};
         if (mCheckDiskFull > 0.f && si.available < mCheckDiskFull) {
           nwaitCycles++;
@@ -503,10 +507,17 @@ void CTFWriterSpec::run(ProcessingContext& pc)
   mTimer.Stop();
 
   if (mWriteCTF && !mRejectCurrentTF) {
-    szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+    if (mFlatCTFOut) {
+      szCTF = mFlatCTFOut->writeTF(header); // including the alignment padding
+    } else {
+      szCTF += appendToTree(*mCTFTreeOut.get(), "CTFHeader", header);
+    }
     size_t prevSizeMB = mAccCTFSize / (1 << 20);
     mAccCTFSize += szCTF;
-    mCTFTreeOut->SetEntries(++mNAccCTF);
+    ++mNAccCTF;
+    if (mCTFTreeOut) {
+      mCTFTreeOut->SetEntries(mNAccCTF);
+    }
     mTFOrbits.push_back(mTimingInfo.firstTForbit);
     LOG(info) << "TF#" << mNCTF << ": wrote CTF{" << header << "} of size " << szCTF << " to " << mCurrentCTFFileNameFull << " in " << mTimer.CpuTime() - cput << " s";
     if (mNAccCTF > 1) {
@@ -522,7 +533,7 @@ void CTFWriterSpec::run(ProcessingContext& pc)
 
     if (mAccCTFSize >= mMinSize || (mMaxCTFPerFile > 0 && mNAccCTF >= mMaxCTFPerFile)) {
       closeTFTreeAndFile();
-    } else if ((mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) || (mCTFAutoSave < 0 && int(prevSizeMB / (-mCTFAutoSave)) != size_t(mAccCTFSize / (1 << 20)) / (-mCTFAutoSave))) {
+    } else if (mCTFTreeOut && ((mCTFAutoSave > 0 && mNAccCTF % mCTFAutoSave == 0) || (mCTFAutoSave < 0 && int(prevSizeMB / (-mCTFAutoSave)) != size_t(mAccCTFSize / (1 << 20)) / (-mCTFAutoSave)))) { // flat CTF file is complete after every TF
       mCTFTreeOut->AutoSave("override");
     }
   } else {
@@ -564,7 +575,7 @@ void CTFWriterSpec::prepareTFTreeAndFile()
     return;
   }
   bool needToOpen = false;
-  if (!mCTFTreeOut) {
+  if (!mCTFTreeOut && !mFlatCTFOut) {
     needToOpen = true;
   } else {
     if ((mAccCTFSize >= mMinSize) ||                                                         // min size exceeded, may close the file.
@@ -596,12 +607,19 @@ void CTFWriterSpec::prepareTFTreeAndFile()
       }
     }
     mCurrentCTFFileName = o2::base::NameConf::getCTFFileName(mTimingInfo.runNumber, mTimingInfo.firstTForbit, mTimingInfo.tfCounter, mHostName);
+    if (mFlatCTF) {
+      mCurrentCTFFileName = std::filesystem::path(mCurrentCTFFileName).replace_extension(".ctf").string();
+    }
     mCurrentCTFFileNameFull = fmt::format("{}{}", ctfDir, mCurrentCTFFileName);
-    mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
-    if (mCTFFileCompression >= 0) {
-      mCTFFileOut->SetCompressionLevel(mCTFFileCompression);
+    if (mFlatCTF) {
+      mFlatCTFOut = std::make_unique<FlatCTFWriter>(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding)); // to prevent premature external usage, use temporary name
+    } else {
+      mCTFFileOut.reset(TFile::Open(fmt::format("{}{}", mCurrentCTFFileNameFull, TMPFileEnding).c_str(), "recreate")); // to prevent premature external usage, use temporary name
+      if (mCTFFileCompression >= 0) {
+        mCTFFileOut->SetCompressionLevel(mCTFFileCompression);
+      }
+      mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
     }
-    mCTFTreeOut = std::make_unique<TTree>(std::string(o2::base::NameConf::CTFTREENAME).c_str(), "O2 CTF tree");
 
     mNCTFFiles++;
   }
@@ -610,13 +628,18 @@ void CTFWriterSpec::prepareTFTreeAndFile()
 //___________________________________________________________________
 void CTFWriterSpec::closeTFTreeAndFile()
 {
-  if (mCTFTreeOut) {
+  if (mCTFTreeOut || mFlatCTFOut) {
     try {
-      mCTFFileOut->cd();
-      mCTFTreeOut->Write();
-      mCTFTreeOut.reset();
-      mCTFFileOut->Close();
-      mCTFFileOut.reset();
+      if (mFlatCTFOut) {
+        mFlatCTFOut->close();
+        mFlatCTFOut.reset();
+      } else {
+        mCTFFileOut->cd();
+        mCTFTreeOut->Write();
+        mCTFTreeOut.reset();
+        mCTFFileOut->Close();
+        mCTFFileOut.reset();
+      }
       // write CTF file metaFile data
       auto actualFileName = TMPFileEnding.empty() ? mCurrentCTFFileNameFull : o2::utils::Str::concat_string(mCurrentCTFFileNameFull, TMPFileEnding);
       if (mStoreMetaFile) {
@@ -817,6 +840,7 @@ DataProcessorSpec getCTFWriterSpec(DetID::mask_t dets, const std::string& outTyp
             {"max-ctf-per-file", VariantType::Int, 0, {"if > 0, avoid storing more than requested CTFs per file"}},
             {"ctf-rejection", VariantType::Int, 0, {">0: percentage to reject randomly, <0: reject if timeslice%|value|!=0"}},
             {"ctf-file-compression", VariantType::Int, 0, {"if >= 0: impose CTF file compression level"}},
+            {"flat-ctf", VariantType::Bool, false, {"write CTFs to flat memory-mappable .ctf files instead of ROOT trees"}},
             {"require-free-disk", VariantType::Float, 0.f, {"pause writing op. if available disk space is below this margin, in bytes if >0, as a fraction of total if <0"}},
             {"wait-for-free-disk", VariantType::Float, 10.f, {"if paused due to the low disk space, recheck after this time (in s)"}},
             {"max-wait-for-free-disk", VariantType::Float, 60.f, {"produce fatal if paused due to the low disk space for more than this amount in s."}},
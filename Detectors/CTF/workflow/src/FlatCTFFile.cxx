@@ -0,0 +1,238 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   FlatCTFFile.cxx
+
+#include "CTFWorkflow/FlatCTFFile.h"
+#include "Framework/Logger.h"
+#include <fstream>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace o2::ctf;
+using DetID = o2::detectors::DetID;
+
+///_______________________________________
+bool FlatCTFFile::isFlatCTF(const std::string& fname)
+{
+  std::ifstream inp(fname, std::ios::binary);
+  uint64_t magic = 0;
+  return inp.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == Magic;
+}
+
+///_______________________________________
+FlatCTFWriter::FlatCTFWriter(const std::string& fname) : mFileName(fname)
+{
+  mFD = ::open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (mFD < 0) {
+    throw std::runtime_error(fmt::format("failed to create flat CTF file {}: {}", fname, std::strerror(errno)));
+  }
+  FlatCTFFile::FileHeader fileHeader;
+  writeAt(&fileHeader, sizeof(fileHeader), 0);
+  mTFStart = FlatCTFFile::alignSize(sizeof(FlatCTFFile::FileHeader));
+  mTFOffset = FlatCTFFile::alignSize(sizeof(FlatCTFFile::TFHeader));
+}
+
+///_______________________________________
+FlatCTFWriter::~FlatCTFWriter()
+{
+  try {
+    close();
+  } catch (const std::exception& e) {
+    LOGP(error, "Failed to close flat CTF file {}: {}", mFileName, e.what());
+  }
+}
+
+///_______________________________________
+void FlatCTFWriter::writeAt(const void* data, size_t sz, size_t offset)
+{
+  auto ptr = static_cast<const char*>(data);
+  while (sz) {
+    auto nwr = ::pwrite(mFD, ptr, sz, offset);
+    if (nwr < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error(fmt::format("failed to write to flat CTF file {}: {}", mFileName, std::strerror(errno)));
+    }
+    ptr += nwr;
+    offset += nwr;
+    sz -= nwr;
+  }
+}
+
+///_______________________________________
+size_t FlatCTFWriter::addDetector(DetID det, gsl::span<const BufferType> image)
+{
+  if (mFD < 0) {
+    throw std::runtime_error(fmt::format("flat CTF file {} is closed", mFileName));
+  }
+  if (image.empty()) {
+    return 0;
+  }
+  writeAt(image.data(), image.size(), mTFStart + mTFOffset);
+  mTFHeader.offset[det] = mTFOffset;
+  mTFHeader.size[det] = image.size();
+  mTFOffset += FlatCTFFile::alignSize(image.size());
+  return image.size();
+}
+
+///_______________________________________
+size_t FlatCTFWriter::writeTF(const CTFHeader& header)
+{
+  if (mFD < 0) {
+    throw std::runtime_error(fmt::format("flat CTF file {} is closed", mFileName));
+  }
+  mTFHeader.recordSize = mTFOffset;
+  mTFHeader.run = header.run;
+  mTFHeader.creationTime = header.creationTime;
+  mTFHeader.firstTForbit = header.firstTForbit;
+  mTFHeader.tfCounter = header.tfCounter;
+  mTFHeader.detectors = header.detectors.to_ulong();
+  writeAt(&mTFHeader, sizeof(mTFHeader), mTFStart);
+  auto recordSize = mTFOffset;
+  mTFStart += recordSize;
+  if (::ftruncate(mFD, mTFStart) != 0) { // materialize the padding of the last image
+    throw std::runtime_error(fmt::format("failed to extend flat CTF file {}: {}", mFileName, std::strerror(errno)));
+  }
+  mNTFs++;
+  mTFHeader = FlatCTFFile::TFHeader{};
+  mTFOffset = FlatCTFFile::alignSize(sizeof(FlatCTFFile::TFHeader));
+  return recordSize;
+}
+
+///_______________________________________
+void FlatCTFWriter::close()
+{
+  if (mFD < 0) {
+    return;
+  }
+  // drop images of the TF which was not finalized
+  auto res = ::ftruncate(mFD, mTFStart);
+  ::close(mFD);
+  mFD = -1;
+  if (res != 0) {
+    throw std::runtime_error(fmt::format("failed to truncate flat CTF file {}: {}", mFileName, std::strerror(errno)));
+  }
+}
+
+///_______________________________________
+FlatCTFReader::FlatCTFReader(const std::string& fname) : mFileName(fname)
+{
+  auto cleanup = [this]() {
+    if (mData) {
+      ::munmap(const_cast<BufferType*>(mData), mSize);
+      mData = nullptr;
+    }
+    if (mFD >= 0) {
+      ::close(mFD);
+      mFD = -1;
+    }
+  };
+  try {
+    mFD = ::open(fname.c_str(), O_RDONLY);
+    if (mFD < 0) {
+      throw std::runtime_error(fmt::format("failed to open flat CTF file {}: {}", fname, std::strerror(errno)));
+    }
+    struct stat st;
+    if (::fstat(mFD, &st) != 0) {
+      throw std::runtime_error(fmt::format("failed to stat flat CTF file {}: {}", fname, std::strerror(errno)));
+    }
+    mSize = st.st_size;
+    size_t offset = FlatCTFFile::alignSize(sizeof(FlatCTFFile::FileHeader));
+    if (mSize < offset) {
+      throw std::runtime_error(fmt::format("flat CTF file {} is too short: {} bytes", fname, mSize));
+    }
+    auto ptr = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, mFD, 0);
+    if (ptr == MAP_FAILED) {
+      throw std::runtime_error(fmt::format("failed to mmap flat CTF file {}: {}", fname, std::strerror(errno)));
+    }
+    mData = static_cast<const BufferType*>(ptr);
+    const auto& fileHeader = *reinterpret_cast<const FlatCTFFile::FileHeader*>(mData);
+    if (fileHeader.magic != FlatCTFFile::Magic || fileHeader.version != FlatCTFFile::Version || fileHeader.alignment != FlatCTFFile::Alignment) {
+      throw std::runtime_error(fmt::format("{} is not a flat CTF file of version {}", fname, FlatCTFFile::Version));
+    }
+    // index the TF records
+    while (offset + sizeof(FlatCTFFile::TFHeader) <= mSize) {
+      const auto& tfHeader = *reinterpret_cast<const FlatCTFFile::TFHeader*>(mData + offset);
+      if (tfHeader.magic != FlatCTFFile::TFMagic || tfHeader.recordSize < sizeof(FlatCTFFile::TFHeader) || offset + tfHeader.recordSize > mSize) {
+        LOGP(error, "Corrupted or truncated TF record at offset {} of {}, ignoring the rest of the file", offset, fname);
+        break;
+      }
+      mTFOffsets.push_back(offset);
+      offset += tfHeader.recordSize;
+    }
+  } catch (...) {
+    cleanup();
+    throw;
+  }
+}
+
+///_______________________________________
+FlatCTFReader::~FlatCTFReader()
+{
+  if (mData) {
+    ::munmap(const_cast<BufferType*>(mData), mSize);
+  }
+  if (mFD >= 0) {
+    ::close(mFD);
+  }
+}
+
+///_______________________________________
+const FlatCTFFile::TFHeader& FlatCTFReader::getTFHeader(size_t tf) const
+{
+  if (tf >= mTFOffsets.size()) {
+    throw std::runtime_error(fmt::format("TF {} is out of range, flat CTF file {} has {} TFs", tf, mFileName, mTFOffsets.size()));
+  }
+  return *reinterpret_cast<const FlatCTFFile::TFHeader*>(mData + mTFOffsets[tf]);
+}
+
+///_______________________________________
+CTFHeader FlatCTFReader::getCTFHeader(size_t tf) const
+{
+  const auto& tfHeader = getTFHeader(tf);
+  CTFHeader header{tfHeader.run, tfHeader.creationTime, tfHeader.firstTForbit, tfHeader.tfCounter};
+  header.detectors = DetID::mask_t(uint32_t(tfHeader.detectors));
+  return header;
+}
+
+///_______________________________________
+gsl::span<const BufferType> FlatCTFReader::getImage(size_t tf, DetID det) const
+{
+  const auto& tfHeader = getTFHeader(tf);
+  if (!tfHeader.size[det]) {
+    return {};
+  }
+  if (tfHeader.offset[det] + tfHeader.size[det] > tfHeader.recordSize) {
+    throw std::runtime_error(fmt::format("image of {} exceeds TF {} record in flat CTF file {}", det.getName(), tf, mFileName));
+  }
+  return {mData + mTFOffsets[tf] + tfHeader.offset[det], size_t(tfHeader.size[det])};
+}
+
+///_______________________________________
+void FlatCTFReader::prefetch(size_t tf) const
+{
+  if (tf >= mTFOffsets.size()) {
+    return;
+  }
+  static const size_t pageSize = ::sysconf(_SC_PAGESIZE);
+  size_t start = mTFOffsets[tf] / pageSize * pageSize; // page size may exceed the file alignment
+  size_t end = mTFOffsets[tf] + getTFHeader(tf).recordSize;
+  if (::madvise(const_cast<BufferType*>(mData) + start, end - start, MADV_WILLNEED) != 0) {
+    LOGP(debug, "madvise failed for TF {} of {}: {}", tf, mFileName, std::strerror(errno));
+  }
+}
@@ -113,13 +113,15 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const CTPDig
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODECTP(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODECTP(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODECTP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODECTP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODECTP(helper.begin_bytesInput(),  helper.end_bytesInput(),     CTF::BLC_bytesInput,   0);
-  iosize += ENCODECTP(helper.begin_bytesClass(),  helper.end_bytesClass(),     CTF::BLC_bytesClass,   0);
+  ENCODECTP(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODECTP(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODECTP(helper.begin_bytesInput(),  helper.end_bytesInput(),     CTF::BLC_bytesInput,   0);
+  ENCODECTP(helper.begin_bytesClass(),  helper.end_bytesClass(),     CTF::BLC_bytesClass,   0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = data.size() * sizeof(CTPDigit);
@@ -138,13 +140,15 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& data, LumiInfo& l
   std::vector<uint8_t> bytesInput, bytesClass;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODECTP(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODECTP(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODECTP(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODECTP(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODECTP(bytesInput,  CTF::BLC_bytesInput);
-  iosize += DECODECTP(bytesClass,  CTF::BLC_bytesClass);
+  DECODECTP(bcInc,       CTF::BLC_bcIncTrig);
+  DECODECTP(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODECTP(bytesInput,  CTF::BLC_bytesInput);
+  DECODECTP(bytesClass,  CTF::BLC_bytesClass);
   // clang-format on
+  iosize += decoder.decode();
   //
   data.clear();
   std::map<o2::InteractionRecord, CTPDigit> digitsMap;
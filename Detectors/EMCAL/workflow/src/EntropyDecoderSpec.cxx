@@ -92,6 +92,7 @@ DataProcessorSpec getEntropyDecoderSpec(int verbosity, unsigned int sspecInp, un
     outputs,
     AlgorithmSpec{adaptFromTask<EntropyDecoderSpec>(verbosity, sspecOut)},
     Options{{"ctf-dict", VariantType::String, "ccdb", {"CTF dictionary: empty or ccdb=CCDB, none=no external dictionary otherwise: local filename"}},
+            {"ctf-threads", VariantType::Int, 1, {"number of threads for concurrent (de)coding of the CTF blocks"}},
             {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
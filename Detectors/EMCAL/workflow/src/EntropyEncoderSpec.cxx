@@ -91,6 +91,7 @@ DataProcessorSpec getEntropyEncoderSpec(bool selIR)
       {"irframe-margin-bwd", VariantType::UInt32, 0u, {"margin in BC to add to the IRFrame lower boundary when selection is requested"}},
       {"irframe-margin-fwd", VariantType::UInt32, 0u, {"margin in BC to add to the IRFrame upper boundary when selection is requested"}},
       {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
+      {"ctf-threads", VariantType::Int, 1, {"number of threads for concurrent (de)coding of the CTF blocks"}},
       {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
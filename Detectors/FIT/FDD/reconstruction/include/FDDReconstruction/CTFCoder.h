@@ -104,18 +104,20 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFDD(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEFDD(part, slot, bits) encoder.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEFDD(cd.trigger,   CTF::BLC_trigger,  0);
-  iosize += ENCODEFDD(cd.bcInc,     CTF::BLC_bcInc,    0);
-  iosize += ENCODEFDD(cd.orbitInc,  CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFDD(cd.nChan,     CTF::BLC_nChan,    0);
+  ENCODEFDD(cd.trigger,   CTF::BLC_trigger,  0);
+  ENCODEFDD(cd.bcInc,     CTF::BLC_bcInc,    0);
+  ENCODEFDD(cd.orbitInc,  CTF::BLC_orbitInc, 0);
+  ENCODEFDD(cd.nChan,     CTF::BLC_nChan,    0);
 
-  iosize += ENCODEFDD(cd.idChan ,   CTF::BLC_idChan,   0);
-  iosize += ENCODEFDD(cd.time,      CTF::BLC_time,     0);
-  iosize += ENCODEFDD(cd.charge,    CTF::BLC_charge,   0);
-  iosize += ENCODEFDD(cd.feeBits,   CTF::BLC_feeBits,  0);
+  ENCODEFDD(cd.idChan ,   CTF::BLC_idChan,   0);
+  ENCODEFDD(cd.time,      CTF::BLC_time,     0);
+  ENCODEFDD(cd.charge,    CTF::BLC_charge,   0);
+  ENCODEFDD(cd.feeBits,   CTF::BLC_feeBits,  0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -132,18 +134,20 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFDD(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEFDD(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEFDD(cd.trigger,   CTF::BLC_trigger);
-  iosize += DECODEFDD(cd.bcInc,     CTF::BLC_bcInc);
-  iosize += DECODEFDD(cd.orbitInc,  CTF::BLC_orbitInc);
-  iosize += DECODEFDD(cd.nChan,     CTF::BLC_nChan);
+  DECODEFDD(cd.trigger,   CTF::BLC_trigger);
+  DECODEFDD(cd.bcInc,     CTF::BLC_bcInc);
+  DECODEFDD(cd.orbitInc,  CTF::BLC_orbitInc);
+  DECODEFDD(cd.nChan,     CTF::BLC_nChan);
 
-  iosize += DECODEFDD(cd.idChan,    CTF::BLC_idChan);
-  iosize += DECODEFDD(cd.time,      CTF::BLC_time);
-  iosize += DECODEFDD(cd.charge,    CTF::BLC_charge);
-  iosize += DECODEFDD(cd.feeBits,   CTF::BLC_feeBits);
+  DECODEFDD(cd.idChan,    CTF::BLC_idChan);
+  DECODEFDD(cd.time,      CTF::BLC_time);
+  DECODEFDD(cd.charge,    CTF::BLC_charge);
+  DECODEFDD(cd.feeBits,   CTF::BLC_feeBits);
   // clang-format on
+  iosize += decoder.decode();
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
     decompress<1, 0>(cd, digitVec, channelVec);
@@ -104,18 +104,20 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFT0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEFT0(part, slot, bits) encoder.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEFT0(cd.trigger,     CTF::BLC_trigger,  0);
-  iosize += ENCODEFT0(cd.bcInc,       CTF::BLC_bcInc,    0);
-  iosize += ENCODEFT0(cd.orbitInc,    CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFT0(cd.nChan,       CTF::BLC_nChan,    0);
-  iosize += ENCODEFT0(cd.eventStatus, CTF::BLC_status,   0);
-  iosize += ENCODEFT0(cd.idChan ,     CTF::BLC_idChan,   0);
-  iosize += ENCODEFT0(cd.qtcChain,    CTF::BLC_qtcChain, 0);
-  iosize += ENCODEFT0(cd.cfdTime,     CTF::BLC_cfdTime,  0);
-  iosize += ENCODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl,  0);
+  ENCODEFT0(cd.trigger,     CTF::BLC_trigger,  0);
+  ENCODEFT0(cd.bcInc,       CTF::BLC_bcInc,    0);
+  ENCODEFT0(cd.orbitInc,    CTF::BLC_orbitInc, 0);
+  ENCODEFT0(cd.nChan,       CTF::BLC_nChan,    0);
+  ENCODEFT0(cd.eventStatus, CTF::BLC_status,   0);
+  ENCODEFT0(cd.idChan ,     CTF::BLC_idChan,   0);
+  ENCODEFT0(cd.qtcChain,    CTF::BLC_qtcChain, 0);
+  ENCODEFT0(cd.cfdTime,     CTF::BLC_cfdTime,  0);
+  ENCODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl,  0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -132,18 +134,20 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFT0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEFT0(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEFT0(cd.trigger,     CTF::BLC_trigger);
-  iosize += DECODEFT0(cd.bcInc,       CTF::BLC_bcInc);
-  iosize += DECODEFT0(cd.orbitInc,    CTF::BLC_orbitInc);
-  iosize += DECODEFT0(cd.nChan,       CTF::BLC_nChan);
-  iosize += DECODEFT0(cd.eventStatus, CTF::BLC_status);
-  iosize += DECODEFT0(cd.idChan,      CTF::BLC_idChan);
-  iosize += DECODEFT0(cd.qtcChain,    CTF::BLC_qtcChain);
-  iosize += DECODEFT0(cd.cfdTime,     CTF::BLC_cfdTime);
-  iosize += DECODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl);
+  DECODEFT0(cd.trigger,     CTF::BLC_trigger);
+  DECODEFT0(cd.bcInc,       CTF::BLC_bcInc);
+  DECODEFT0(cd.orbitInc,    CTF::BLC_orbitInc);
+  DECODEFT0(cd.nChan,       CTF::BLC_nChan);
+  DECODEFT0(cd.eventStatus, CTF::BLC_status);
+  DECODEFT0(cd.idChan,      CTF::BLC_idChan);
+  DECODEFT0(cd.qtcChain,    CTF::BLC_qtcChain);
+  DECODEFT0(cd.cfdTime,     CTF::BLC_cfdTime);
+  DECODEFT0(cd.qtcAmpl,     CTF::BLC_qtcAmpl);
   // clang-format on
+  iosize += decoder.decode();
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
     decompress<1, 0>(cd, digitVec, channelVec);
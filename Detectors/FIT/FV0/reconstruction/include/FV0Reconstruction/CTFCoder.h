@@ -100,18 +100,20 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const Digit>& dig
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEFV0(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEFV0(part, slot, bits) encoder.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEFV0(cd.bcInc,     CTF::BLC_bcInc,    0);
-  iosize += ENCODEFV0(cd.orbitInc,  CTF::BLC_orbitInc, 0);
-  iosize += ENCODEFV0(cd.nChan,     CTF::BLC_nChan,    0);
-  iosize += ENCODEFV0(cd.idChan ,   CTF::BLC_idChan,   0);
-  iosize += ENCODEFV0(cd.cfdTime,   CTF::BLC_cfdTime,  0);
-  iosize += ENCODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl,  0);
+  ENCODEFV0(cd.bcInc,     CTF::BLC_bcInc,    0);
+  ENCODEFV0(cd.orbitInc,  CTF::BLC_orbitInc, 0);
+  ENCODEFV0(cd.nChan,     CTF::BLC_nChan,    0);
+  ENCODEFV0(cd.idChan ,   CTF::BLC_idChan,   0);
+  ENCODEFV0(cd.cfdTime,   CTF::BLC_cfdTime,  0);
+  ENCODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl,  0);
   // extra slot was added in the end
-  iosize += ENCODEFV0(cd.trigger,   CTF::BLC_trigger,  0);
-  iosize += ENCODEFV0(cd.qtcChain,  CTF::BLC_qtcChain, 0);
+  ENCODEFV0(cd.trigger,   CTF::BLC_trigger,  0);
+  ENCODEFV0(cd.qtcChain,  CTF::BLC_qtcChain, 0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(Digit) * digitVec.size() + sizeof(ChannelData) * channelVec.size();
@@ -128,17 +130,20 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   checkDictVersion(hd);
   ec.print(getPrefix(), mVerbosity);
   o2::ctf::CTFIOSize iosize;
-#define DECODEFV0(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEFV0(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEFV0(cd.bcInc,     CTF::BLC_bcInc);
-  iosize += DECODEFV0(cd.orbitInc,  CTF::BLC_orbitInc);
-  iosize += DECODEFV0(cd.nChan,     CTF::BLC_nChan);
-  iosize += DECODEFV0(cd.idChan,    CTF::BLC_idChan);
-  iosize += DECODEFV0(cd.cfdTime,   CTF::BLC_cfdTime);
-  iosize += DECODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl);
+  DECODEFV0(cd.bcInc,     CTF::BLC_bcInc);
+  DECODEFV0(cd.orbitInc,  CTF::BLC_orbitInc);
+  DECODEFV0(cd.nChan,     CTF::BLC_nChan);
+  DECODEFV0(cd.idChan,    CTF::BLC_idChan);
+  DECODEFV0(cd.cfdTime,   CTF::BLC_cfdTime);
+  DECODEFV0(cd.qtcAmpl,   CTF::BLC_qtcAmpl);
   // extra slot was added in the end
-  iosize += DECODEFV0(cd.trigger,   CTF::BLC_trigger);
-  iosize += DECODEFV0(cd.qtcChain,  CTF::BLC_qtcChain);
+  DECODEFV0(cd.trigger,   CTF::BLC_trigger);
+  DECODEFV0(cd.qtcChain,  CTF::BLC_qtcChain);
+  // clang-format on
+  iosize += decoder.decode();
   // triggers and qtcChain were added later, in old data they are absent:
   if (cd.trigger.empty()) {
     cd.trigger.resize(cd.header.nTriggers);
@@ -146,7 +151,6 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VDIG& digitVec, VCHAN&
   if (cd.qtcChain.empty()) {
     cd.qtcChain.resize(cd.cfdTime.size());
   }
-  // clang-format on
   //
   if (hd.minorVersion == 0 && hd.majorVersion == 1) {
     decompress<1, 0>(cd, digitVec, channelVec);
@@ -116,20 +116,22 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const gsl::span<const ROFRecord>&
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEITSMFT(part, slot, bits) CTF::get(buff.data())->encode(part, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEITSMFT(part, slot, bits) encoder.add(part, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
-  iosize += ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
-  iosize += ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
-  iosize += ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
+  ENCODEITSMFT(compCl.firstChipROF, CTF::BLCfirstChipROF, 0);
+  ENCODEITSMFT(compCl.bcIncROF, CTF::BLCbcIncROF, 0);
+  ENCODEITSMFT(compCl.orbitIncROF, CTF::BLCorbitIncROF, 0);
+  ENCODEITSMFT(compCl.nclusROF, CTF::BLCnclusROF, 0);
   //
-  iosize += ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
-  iosize += ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
-  iosize += ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
-  iosize += ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
-  iosize += ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
-  iosize += ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
+  ENCODEITSMFT(compCl.chipInc, CTF::BLCchipInc, 0);
+  ENCODEITSMFT(compCl.chipMul, CTF::BLCchipMul, 0);
+  ENCODEITSMFT(compCl.row, CTF::BLCrow, 0);
+  ENCODEITSMFT(compCl.colInc, CTF::BLCcolInc, 0);
+  ENCODEITSMFT(compCl.pattID, CTF::BLCpattID, 0);
+  ENCODEITSMFT(compCl.pattMap, CTF::BLCpattMap, 0);
   // clang-format on
+  iosize += encoder.encode();
   //CTF::get(buff.data())->print(getPrefix());
   iosize.rawIn = rofRecVec.size() * sizeof(ROFRecord) + cclusVec.size() * sizeof(CompClusterExt) + pattVec.size() * sizeof(unsigned char);
   return iosize;
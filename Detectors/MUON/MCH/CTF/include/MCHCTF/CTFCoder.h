@@ -110,19 +110,21 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const ROFRec
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEMCH(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEMCH(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEMCH(helper.begin_bcIncROF(),    helper.end_bcIncROF(),     CTF::BLC_bcIncROF,     0);
-  iosize += ENCODEMCH(helper.begin_orbitIncROF(), helper.end_orbitIncROF(),  CTF::BLC_orbitIncROF,  0);
-  iosize += ENCODEMCH(helper.begin_nDigitsROF(),  helper.end_nDigitsROF(),   CTF::BLC_nDigitsROF,   0);
-
-  iosize += ENCODEMCH(helper.begin_tfTime(),      helper.end_tfTime(),       CTF::BLC_tfTime,       0);
-  iosize += ENCODEMCH(helper.begin_nSamples(),    helper.end_nSamples(),     CTF::BLC_nSamples,     0);
-  iosize += ENCODEMCH(helper.begin_isSaturated(), helper.end_isSaturated(),  CTF::BLC_isSaturated,  0);
-  iosize += ENCODEMCH(helper.begin_detID(),       helper.end_detID(),        CTF::BLC_detID,        0);
-  iosize += ENCODEMCH(helper.begin_padID(),       helper.end_padID(),        CTF::BLC_padID,        0);
-  iosize += ENCODEMCH(helper.begin_ADC()  ,       helper.end_ADC(),          CTF::BLC_ADC,          0);
+  ENCODEMCH(helper.begin_bcIncROF(),    helper.end_bcIncROF(),     CTF::BLC_bcIncROF,     0);
+  ENCODEMCH(helper.begin_orbitIncROF(), helper.end_orbitIncROF(),  CTF::BLC_orbitIncROF,  0);
+  ENCODEMCH(helper.begin_nDigitsROF(),  helper.end_nDigitsROF(),   CTF::BLC_nDigitsROF,   0);
+
+  ENCODEMCH(helper.begin_tfTime(),      helper.end_tfTime(),       CTF::BLC_tfTime,       0);
+  ENCODEMCH(helper.begin_nSamples(),    helper.end_nSamples(),     CTF::BLC_nSamples,     0);
+  ENCODEMCH(helper.begin_isSaturated(), helper.end_isSaturated(),  CTF::BLC_isSaturated,  0);
+  ENCODEMCH(helper.begin_detID(),       helper.end_detID(),        CTF::BLC_detID,        0);
+  ENCODEMCH(helper.begin_padID(),       helper.end_padID(),        CTF::BLC_padID,        0);
+  ENCODEMCH(helper.begin_ADC()  ,       helper.end_ADC(),          CTF::BLC_ADC,          0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(ROFRecord) * rofData.size() + sizeof(Digit) * digData.size();
@@ -145,19 +147,21 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VROF& rofVec, VCOL& dig
   std::vector<uint8_t> isSaturated;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEMCH(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEMCH(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEMCH(bcInc,       CTF::BLC_bcIncROF);
-  iosize += DECODEMCH(orbitInc,    CTF::BLC_orbitIncROF);
-  iosize += DECODEMCH(nDigits,     CTF::BLC_nDigitsROF);
-
-  iosize += DECODEMCH(tfTime,      CTF::BLC_tfTime);
-  iosize += DECODEMCH(nSamples,    CTF::BLC_nSamples);
-  iosize += DECODEMCH(isSaturated, CTF::BLC_isSaturated);
-  iosize += DECODEMCH(detID,       CTF::BLC_detID);
-  iosize += DECODEMCH(padID,       CTF::BLC_padID);
-  iosize += DECODEMCH(ADC,         CTF::BLC_ADC);
+  DECODEMCH(bcInc,       CTF::BLC_bcIncROF);
+  DECODEMCH(orbitInc,    CTF::BLC_orbitIncROF);
+  DECODEMCH(nDigits,     CTF::BLC_nDigitsROF);
+
+  DECODEMCH(tfTime,      CTF::BLC_tfTime);
+  DECODEMCH(nSamples,    CTF::BLC_nSamples);
+  DECODEMCH(isSaturated, CTF::BLC_isSaturated);
+  DECODEMCH(detID,       CTF::BLC_detID);
+  DECODEMCH(padID,       CTF::BLC_padID);
+  DECODEMCH(ADC,         CTF::BLC_ADC);
   // clang-format on
+  iosize += decoder.decode();
   //
   rofVec.clear();
   digVec.clear();
@@ -84,17 +84,19 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CTFHelper::TFData& tfData)
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEMID(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEMID(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEMID(helper.begin_bcIncROF(),    helper.end_bcIncROF(),     CTF::BLC_bcIncROF,    0);
-  iosize += ENCODEMID(helper.begin_orbitIncROF(), helper.end_orbitIncROF(),  CTF::BLC_orbitIncROF, 0);
-  iosize += ENCODEMID(helper.begin_entriesROF(),  helper.end_entriesROF(),   CTF::BLC_entriesROF,  0);
-  iosize += ENCODEMID(helper.begin_evtypeROF(),   helper.end_evtypeROF(),    CTF::BLC_evtypeROF,   0);
-
-  iosize += ENCODEMID(helper.begin_pattern(),     helper.end_pattern(),      CTF::BLC_pattern,     0);
-  iosize += ENCODEMID(helper.begin_deId(),        helper.end_deId(),         CTF::BLC_deId,        0);
-  iosize += ENCODEMID(helper.begin_colId(),       helper.end_colId(),        CTF::BLC_colId,       0);
+  ENCODEMID(helper.begin_bcIncROF(),    helper.end_bcIncROF(),     CTF::BLC_bcIncROF,    0);
+  ENCODEMID(helper.begin_orbitIncROF(), helper.end_orbitIncROF(),  CTF::BLC_orbitIncROF, 0);
+  ENCODEMID(helper.begin_entriesROF(),  helper.end_entriesROF(),   CTF::BLC_entriesROF,  0);
+  ENCODEMID(helper.begin_evtypeROF(),   helper.end_evtypeROF(),    CTF::BLC_evtypeROF,   0);
+
+  ENCODEMID(helper.begin_pattern(),     helper.end_pattern(),      CTF::BLC_pattern,     0);
+  ENCODEMID(helper.begin_deId(),        helper.end_deId(),         CTF::BLC_deId,        0);
+  ENCODEMID(helper.begin_colId(),       helper.end_colId(),        CTF::BLC_colId,       0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = iosize.ctfIn;
@@ -114,17 +116,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, std::array<VROF, NEvTyp
   std::vector<uint8_t> evType, deId, colId;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEMID(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEMID(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEMID(bcInc,       CTF::BLC_bcIncROF);
-  iosize += DECODEMID(orbitInc,    CTF::BLC_orbitIncROF);
-  iosize += DECODEMID(entries,     CTF::BLC_entriesROF);
-  iosize += DECODEMID(evType,      CTF::BLC_evtypeROF);
-
-  iosize += DECODEMID(pattern,     CTF::BLC_pattern);
-  iosize += DECODEMID(deId,        CTF::BLC_deId);
-  iosize += DECODEMID(colId,       CTF::BLC_colId);
+  DECODEMID(bcInc,       CTF::BLC_bcIncROF);
+  DECODEMID(orbitInc,    CTF::BLC_orbitIncROF);
+  DECODEMID(entries,     CTF::BLC_entriesROF);
+  DECODEMID(evType,      CTF::BLC_evtypeROF);
+
+  DECODEMID(pattern,     CTF::BLC_pattern);
+  DECODEMID(deId,        CTF::BLC_deId);
+  DECODEMID(colId,       CTF::BLC_colId);
   // clang-format on
+  iosize += decoder.decode();
   //
   for (uint32_t i = 0; i < NEvTypes; i++) {
     rofVec[i].clear();
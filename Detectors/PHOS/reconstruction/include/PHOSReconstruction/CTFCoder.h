@@ -107,17 +107,19 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const Trigge
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEPHS(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEPHS(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEPHS(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODEPHS(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODEPHS(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
-
-  iosize += ENCODEPHS(helper.begin_packedID(),    helper.end_packedID(),     CTF::BLC_packedID,    0);
-  iosize += ENCODEPHS(helper.begin_time(),        helper.end_time(),         CTF::BLC_time,        0);
-  iosize += ENCODEPHS(helper.begin_energy(),      helper.end_energy(),       CTF::BLC_energy,      0);
-  iosize += ENCODEPHS(helper.begin_status(),      helper.end_status(),       CTF::BLC_status,      0);
+  ENCODEPHS(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODEPHS(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODEPHS(helper.begin_entriesTrig(),  helper.end_entriesTrig(),   CTF::BLC_entriesTrig,  0);
+
+  ENCODEPHS(helper.begin_packedID(),    helper.end_packedID(),     CTF::BLC_packedID,    0);
+  ENCODEPHS(helper.begin_time(),        helper.end_time(),         CTF::BLC_time,        0);
+  ENCODEPHS(helper.begin_energy(),      helper.end_energy(),       CTF::BLC_energy,      0);
+  ENCODEPHS(helper.begin_status(),      helper.end_status(),       CTF::BLC_status,      0);
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = trigData.size() * sizeof(TriggerRecord) + cellData.size() * sizeof(Cell);
@@ -137,17 +139,19 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCELL& c
   std::vector<uint8_t> status;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEPHOS(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEPHOS(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEPHOS(bcInc,       CTF::BLC_bcIncTrig);
-  iosize += DECODEPHOS(orbitInc,    CTF::BLC_orbitIncTrig);
-  iosize += DECODEPHOS(entries,     CTF::BLC_entriesTrig);
-  iosize += DECODEPHOS(packedID,    CTF::BLC_packedID);
-
-  iosize += DECODEPHOS(cellTime,    CTF::BLC_time);
-  iosize += DECODEPHOS(energy,      CTF::BLC_energy);
-  iosize += DECODEPHOS(status,      CTF::BLC_status);
+  DECODEPHOS(bcInc,       CTF::BLC_bcIncTrig);
+  DECODEPHOS(orbitInc,    CTF::BLC_orbitIncTrig);
+  DECODEPHOS(entries,     CTF::BLC_entriesTrig);
+  DECODEPHOS(packedID,    CTF::BLC_packedID);
+
+  DECODEPHOS(cellTime,    CTF::BLC_time);
+  DECODEPHOS(energy,      CTF::BLC_energy);
+  DECODEPHOS(status,      CTF::BLC_status);
   // clang-format on
+  iosize += decoder.decode();
   //
   trigVec.clear();
   cellVec.clear();
@@ -19,6 +19,7 @@
 #include <cstdio>
 #include <unordered_map>
 #include <map>
+#include <memory>
 #include <tuple>
 #include <vector>
 #include <string>
@@ -43,6 +44,7 @@ struct ReaderInp {
   std::string dropTF{};
   std::string metricChannel{};
   std::string onlyDet{};
+  std::string indexFile{};
   size_t spSize = 1024L * 1024L;
   size_t bufferSize = 1024L * 1024L;
   size_t minSHM = 0;
@@ -54,6 +56,8 @@ struct ReaderInp {
   uint32_t maxTF = 0xffffffff;
   bool partPerSP = true;
   bool cache = false;
+  bool mmap = false;
+  int nThreads = 1;
   bool autodetectTF0 = false;
   bool preferCalcTF = false;
   bool sup0xccdb = false;
@@ -142,6 +146,16 @@ class RawFileReader
     int nBlocks; // number of consecutive LinkBlock objects
   };
 
+  // read-only memory mapping of the input file
+  struct FileMap {
+    const char* data = nullptr;
+    size_t size = 0;
+    FileMap(int fd, size_t sz);
+    ~FileMap();
+    FileMap(const FileMap&) = delete;
+    FileMap& operator=(const FileMap&) = delete;
+  };
+
   // info on the smallest block of data to be read when fetching the HBF
   struct LinkBlock {
     enum { StartTF = 0x1,
@@ -204,11 +218,13 @@ class RawFileReader
     size_t getNextHBFSize() const;
     size_t getNextTFSize() const;
     size_t getNextTFSuperPagesStat(std::vector<PartStat>& parts) const;
+    size_t getNextTFHBFStat(std::vector<PartStat>& parts) const;
     int getNHBFinTF() const;
 
     size_t readNextHBF(char* buff);
     size_t readNextTF(char* buff);
     size_t readNextSuperPage(char* buff, const PartStat* pstat = nullptr);
+    size_t mapNextSuperPage(const char*& ptr, const PartStat* pstat = nullptr);
     size_t skipNextHBF();
     size_t skipNextTF();
 
@@ -272,6 +288,14 @@ class RawFileReader
   bool getCacheData() const { return mCacheData; }
   void setCacheData(bool v) { mCacheData = v; }
 
+  bool getMapFiles() const { return mMapFiles; }
+  void setMapFiles(bool v) { mMapFiles = v; }
+  std::shared_ptr<const FileMap> getFileMap(int fileID) const { return fileID < int(mFileMaps.size()) ? mFileMaps[fileID] : nullptr; }
+
+  const std::string& getIndexFile() const { return mIndexFile; }
+  void setIndexFile(const std::string& s) { mIndexFile = s; }
+  bool isIndexLoaded() const { return mIndexLoaded; }
+
   o2::header::DataOrigin getDefaultDataOrigin() const { return mDefDataOrigin; }
   o2::header::DataDescription getDefaultDataSpecification() const { return mDefDataDescription; }
   ReadoutCardType getDefaultReadoutCardType() const { return mDefCardType; }
@@ -292,6 +316,10 @@ class RawFileReader
  private:
   int getLinkLocalID(const RDHAny& rdh, int fileID);
   bool preprocessFile(int ifl);
+  bool readFromFile(char* buff, int fileID, size_t offset, size_t size) const;
+  std::string getIndexKey() const;
+  bool loadIndex(const std::string& key);
+  bool storeIndex(const std::string& key) const;
   static LinkSpec_t createSpec(o2::header::DataOrigin orig, LinkSubSpec_t ss) { return (LinkSpec_t(orig) << 32) | ss; }
 
   static constexpr o2::header::DataOrigin DEFDataOrigin = o2::header::gDataOriginFLP;
@@ -303,9 +331,12 @@ class RawFileReader
   std::vector<std::string> mFileNames;                                  //! input file names
   std::vector<FILE*> mFiles;                                            //! input file handlers
   std::vector<std::unique_ptr<char[]>> mFileBuffers;                    //! buffers for input files
+  std::vector<std::shared_ptr<const FileMap>> mFileMaps;                //! memory mapped input files (if requested)
   std::vector<OrigDescCard> mDataSpecs;                                 //! data origin and description for every input file + readout card type
+  std::string mIndexFile{};                                             //! optional file to store/load the preprocessing results
   bool mInitDone = false;
   bool mEmpty = true;
+  bool mIndexLoaded = false;
   std::unordered_map<LinkSpec_t, int> mLinkEntries;                 //! mapping between RDH specs and link entry in the mLinksData
   std::vector<LinkData> mLinksData;                                 //! info on links data in the files
   std::vector<int> mOrderedIDs;                                     //! links entries ordered in Specs
@@ -320,6 +351,7 @@ class RawFileReader
   long int mPosInFile = 0;                                          //! current position in the file
   bool mMultiLinkFile = false;                                      //! was > than 1 link seen in the file?
   bool mCacheData = false;                                          //! cache data to block after 1st scan (may require excessive memory, use with care)
+  bool mMapFiles = false;                                           //! access input files via memory mapping instead of reading them
   bool mStopProcessing = false;                                     //! stop processing after error
   uint32_t mCheckErrors = 0;                                        //! mask for errors to check
   FirstTFDetection mFirstTFAutodetect = FirstTFDetection::Disabled; //!
@@ -15,10 +15,14 @@
 
 #include <algorithm>
 #include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
 #include <iomanip>
 #include <memory>
 #include <sstream>
+#include <type_traits>
+#include <utility>
 #include <iostream>
 #include "DetectorsRaw/RawFileReader.h"
 #include "Headers/DAQID.h"
@@ -29,11 +33,64 @@
 
 #include <Common/Configuration.h>
 #include <TStopwatch.h>
+#include <fmt/format.h>
 #include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace o2::raw;
 namespace o2h = o2::header;
 
+namespace
+{
+constexpr uint64_t IndexMagic = 0x3158444957415232; // "2RAWIDX1", change the last digit when the format changes
+
+template <typename T>
+void idxPut(std::string& buf, const T& v)
+{
+  static_assert(std::is_trivially_copyable_v<T>);
+  buf.append(reinterpret_cast<const char*>(&v), sizeof(T));
+}
+
+struct IndexInput {
+  const char* ptr = nullptr;
+  const char* end = nullptr;
+  template <typename T>
+  bool get(T& v)
+  {
+    static_assert(std::is_trivially_copyable_v<T>);
+    if (end - ptr < long(sizeof(T))) {
+      return false;
+    }
+    memcpy(reinterpret_cast<char*>(&v), ptr, sizeof(T));
+    ptr += sizeof(T);
+    return true;
+  }
+};
+} // namespace
+
+//====================== methods of FileMap ==========================
+//____________________________________________
+RawFileReader::FileMap::FileMap(int fd, size_t sz)
+{
+  if (sz) {
+    void* ptr = mmap(nullptr, sz, PROT_READ, MAP_SHARED, fd, 0);
+    if (ptr != MAP_FAILED) {
+      data = reinterpret_cast<const char*>(ptr);
+      size = sz;
+    }
+  }
+}
+
+//____________________________________________
+RawFileReader::FileMap::~FileMap()
+{
+  if (data) {
+    munmap(const_cast<char*>(data), size);
+  }
+}
+
 //====================== methods of LinkBlock ========================
 //____________________________________________
 void RawFileReader::LinkBlock::print(const std::string& pref) const
@@ -99,6 +156,25 @@ size_t RawFileReader::LinkData::getNextTFSuperPagesStat(std::vector<RawFileReade
   return parts.size();
 }
 
+//____________________________________________
+size_t RawFileReader::LinkData::getNextTFHBFStat(std::vector<RawFileReader::PartStat>& parts) const
+{
+  // get stat. of HBFs for this link in this TF, i.e. the sizes which readNextHBF will return
+  parts.clear();
+  if (nextBlock2Read >= 0) { // negative nextBlock2Read signals absence of data
+    int ibl = nextBlock2Read, nbl = blocks.size();
+    while (ibl < nbl && (blocks[ibl].tfID == blocks[nextBlock2Read].tfID)) {
+      if (parts.empty() || blocks[ibl].ir != blocks[ibl - 1].ir) {
+        parts.emplace_back(RawFileReader::PartStat{0, 0});
+      }
+      parts.back().size += blocks[ibl].size;
+      parts.back().nBlocks++;
+      ibl++;
+    }
+  }
+  return parts.size();
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getNextHBFSize() const
 {
@@ -134,8 +210,7 @@ size_t RawFileReader::LinkData::readNextHBF(char* buff)
     if (blc.dataCache) {
       memcpy(buff + sz, blc.dataCache.get(), blc.size);
     } else {
-      auto fl = reader->mFiles[blc.fileID];
-      if (fseek(fl, blc.offset, SEEK_SET) || fread(buff + sz, 1, blc.size, fl) != blc.size) {
+      if (!reader->readFromFile(buff + sz, blc.fileID, blc.offset, blc.size)) {
         LOGF(error, "Failed to read for the %s a bloc:", describe());
         blc.print();
         error = true;
@@ -288,8 +363,7 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
     if (reader->mCacheData && blocks[nextBlock2Read].dataCache) {
       memcpy(buff, blocks[nextBlock2Read].dataCache.get(), sz);
     } else {
-      auto fl = reader->mFiles[blocks[nextBlock2Read].fileID];
-      if (fseek(fl, blocks[nextBlock2Read].offset, SEEK_SET) || fread(buff, 1, sz, fl) != sz) {
+      if (!reader->readFromFile(buff, blocks[nextBlock2Read].fileID, blocks[nextBlock2Read].offset, sz)) {
         LOGF(error, "Failed to read for the %s a bloc:", describe());
         blocks[nextBlock2Read].print();
         error = true;
@@ -303,6 +377,40 @@ size_t RawFileReader::LinkData::readNextSuperPage(char* buff, const RawFileReade
   return error ? 0 : sz; // in case of the error we ignore the data
 }
 
+//____________________________________________
+size_t RawFileReader::LinkData::mapNextSuperPage(const char*& ptr, const RawFileReader::PartStat* pstat)
+{
+  // provide the pointer on the next superpage in the mapped file instead of reading it.
+  // If the file is not mapped, nothing is done and 0 is returned.
+  ptr = nullptr;
+  if (nextBlock2Read < 0) { // negative nextBlock2Read signals absence of data
+    return 0;
+  }
+  const auto& blc = blocks[nextBlock2Read];
+  const auto fmap = reader->getFileMap(blc.fileID);
+  if (!fmap || !fmap->data) {
+    return 0;
+  }
+  PartStat part{};
+  if (pstat) {
+    part = *pstat;
+  } else {
+    std::vector<PartStat> parts;
+    if (!getNextTFSuperPagesStat(parts)) {
+      return 0;
+    }
+    part = parts[0];
+  }
+  if (blc.offset + part.size > fmap->size) {
+    LOGF(error, "Superpage of the %s exceeds the file size:", describe());
+    blc.print();
+    return 0;
+  }
+  ptr = fmap->data + blc.offset; // superpage is contiguous in the file
+  nextBlock2Read += part.nBlocks;
+  return part.size;
+}
+
 //____________________________________________
 size_t RawFileReader::LinkData::getLargestSuperPage() const
 {
@@ -573,7 +681,11 @@ int RawFileReader::getLinkLocalID(const RDHAny& rdh, int fileID)
 bool RawFileReader::preprocessFile(int ifl)
 {
   // preprocess file, check RDH data, build statistics
-  std::unique_ptr<char[]> buffer = std::make_unique<char[]>(mBufferSize);
+  // when the file is mapped, the RDHs are accessed in place, otherwise it is read by chunks of mBufferSize
+  const auto fmap = getFileMap(ifl);
+  const bool mapped = fmap && fmap->data;
+  std::unique_ptr<char[]> buffer = mapped ? nullptr : std::make_unique<char[]>(mBufferSize);
+  const char* bufPtr = mapped ? fmap->data : buffer.get();
   FILE* fl = mFiles[ifl];
   mCurrentFileID = ifl;
   LinkSpec_t specPrev = 0xffffffffffffffff;
@@ -586,10 +698,15 @@ bool RawFileReader::preprocessFile(int ifl)
   mPosInFile = 0;
   size_t nRDHread = 0, boffs;
   bool readMore = true;
-  while (readMore && (nr = fread(buffer.get(), 1, mBufferSize, fl))) {
+  long int mapRemaining = 0;
+  if (mapped) {
+    madvise(const_cast<char*>(fmap->data), fmap->size, MADV_SEQUENTIAL);
+    mapRemaining = fileSize; // whole file is a single chunk
+  }
+  while (readMore && (nr = mapped ? std::exchange(mapRemaining, 0) : fread(buffer.get(), 1, mBufferSize, fl))) {
     boffs = 0;
     while (1) {
-      auto& rdh = *reinterpret_cast<RDHUtils::RDHAny*>(&buffer[boffs]);
+      auto& rdh = *reinterpret_cast<const RDHUtils::RDHAny*>(&bufPtr[boffs]);
       if ((mPosInFile + RDHUtils::getOffsetToNext(rdh)) > fileSize) {
         LOGP(warning, "File {} truncated current file pos {} + offsetToNext {} > fileSize {}", ifl, mPosInFile, RDHUtils::getOffsetToNext(rdh), fileSize);
         readMore = false;
@@ -630,6 +747,13 @@ bool RawFileReader::preprocessFile(int ifl)
       boffs += RDHUtils::getOffsetToNext(rdh);
       mPosInFile += RDHUtils::getOffsetToNext(rdh);
       lIDPrev = lID;
+      if (mapped) {
+        if (boffs + sizeof(RDHUtils::RDHAny) > nr) { // a trailing page with the RDH only (e.g. CRU stop page) is still scanned
+          readMore = false;
+          break;
+        }
+        continue;
+      }
       if (boffs + sizeof(RDHUtils::RDHAny) >= nr) {
         if (fseek(fl, mPosInFile, SEEK_SET)) {
           readMore = false;
@@ -639,11 +763,206 @@ bool RawFileReader::preprocessFile(int ifl)
       }
     }
   }
-  LOGF(info, "File %3d : %9li bytes scanned, %6d RDH read for %4d links from %s",
-       mCurrentFileID, mPosInFile, nRDHread, int(mLinkEntries.size()), mFileNames[mCurrentFileID]);
+  if (mapped) {
+    madvise(const_cast<char*>(fmap->data), fmap->size, MADV_NORMAL);
+  }
+  LOGF(info, "File %3d : %9li bytes scanned%s, %6d RDH read for %4d links from %s",
+       mCurrentFileID, mPosInFile, mapped ? " in place" : "", nRDHread, int(mLinkEntries.size()), mFileNames[mCurrentFileID]);
   return nRDHread > 0;
 }
 
+//_____________________________________________________________________
+bool RawFileReader::readFromFile(char* buff, int fileID, size_t offset, size_t size) const
+{
+  // read the data from the mapped file or with positioned read, which can be done concurrently for different links
+  const auto& fmap = fileID < int(mFileMaps.size()) ? mFileMaps[fileID] : nullptr;
+  if (fmap && fmap->data) {
+    if (offset + size > fmap->size) {
+      return false;
+    }
+    memcpy(buff, fmap->data + offset, size);
+    return true;
+  }
+  int fd = fileno(mFiles[fileID]);
+  size_t nread = 0;
+  while (nread < size) {
+    auto nr = pread(fd, buff + nread, size - nread, offset + nread);
+    if (nr <= 0) {
+      return false;
+    }
+    nread += nr;
+  }
+  return true;
+}
+
+//_____________________________________________________________________
+std::string RawFileReader::getIndexKey() const
+{
+  // serialized description of everything the preprocessing results depend on:
+  // input files with their size and modification time, their data specs and the preprocessing settings
+  std::string key;
+  const auto& hbu = HBFUtils::Instance();
+  bool detectTF0 = mFirstTFAutodetect == FirstTFDetection::Pending;
+  idxPut(key, uint32_t(mFiles.size()));
+  for (int i = 0; i < int(mFiles.size()); i++) {
+    std::error_code ec;
+    auto path = std::filesystem::weakly_canonical(mFileNames[i], ec).string();
+    auto size = std::filesystem::file_size(mFileNames[i], ec);
+    auto mtime = std::filesystem::last_write_time(mFileNames[i], ec).time_since_epoch().count();
+    if (ec) {
+      LOGP(warning, "Cannot use preprocessing index, failed to stat {}: {}", mFileNames[i], ec.message());
+      return {};
+    }
+    idxPut(key, uint32_t(path.size()));
+    key += path;
+    idxPut(key, uint64_t(size));
+    idxPut(key, int64_t(mtime));
+    idxPut(key, std::get<0>(mDataSpecs[i]));
+    idxPut(key, std::get<1>(mDataSpecs[i]));
+    idxPut(key, int32_t(std::get<2>(mDataSpecs[i])));
+  }
+  idxPut(key, mCheckErrors);
+  idxPut(key, mMaxTFToRead);
+  idxPut(key, mPreferCalculatedTFStart);
+  idxPut(key, detectTF0);
+  idxPut(key, detectTF0 ? uint32_t(0) : uint32_t(hbu.orbitFirst)); // detected from the data otherwise
+  idxPut(key, int32_t(hbu.getNOrbitsPerTF()));
+  return key;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::storeIndex(const std::string& key) const
+{
+  // store the preprocessing results, to be used instead of the scan of the same files with the same settings
+  std::string buf;
+  idxPut(buf, IndexMagic);
+  idxPut(buf, uint64_t(key.size()));
+  buf += key;
+  idxPut(buf, uint32_t(HBFUtils::Instance().orbitFirst)); // possibly imposed during the scan
+  idxPut(buf, uint32_t(mLinksData.size()));
+  size_t nBlocks = 0;
+  for (const auto& link : mLinksData) {
+    idxPut(buf, link.rdhl);
+    idxPut(buf, link.irOfSOX.orbit);
+    idxPut(buf, link.irOfSOX.bc);
+    idxPut(buf, link.spec);
+    idxPut(buf, link.subspec);
+    idxPut(buf, link.nTimeFrames);
+    idxPut(buf, link.nHBFrames);
+    idxPut(buf, link.nSPages);
+    idxPut(buf, link.nCRUPages);
+    idxPut(buf, link.cruDetector);
+    idxPut(buf, link.continuousRO);
+    idxPut(buf, link.origin);
+    idxPut(buf, link.description);
+    idxPut(buf, int32_t(link.nErrors));
+    idxPut(buf, uint32_t(link.blocks.size()));
+    for (const auto& bl : link.blocks) {
+      idxPut(buf, uint64_t(bl.offset));
+      idxPut(buf, bl.size);
+      idxPut(buf, bl.tfID);
+      idxPut(buf, bl.ir.orbit);
+      idxPut(buf, bl.ir.bc);
+      idxPut(buf, bl.fileID);
+      idxPut(buf, bl.flags);
+    }
+    idxPut(buf, uint32_t(link.tfStartBlock.size()));
+    for (const auto& tfs : link.tfStartBlock) {
+      idxPut(buf, int32_t(tfs.first));
+      idxPut(buf, tfs.second);
+    }
+    nBlocks += link.blocks.size();
+  }
+  // write to a temporary file and rename it, so that concurrent readers never see a partial index
+  auto tmpName = fmt::format("{}.{}.tmp", mIndexFile, getpid());
+  {
+    std::ofstream out(tmpName, std::ios::binary | std::ios::trunc);
+    out.write(buf.data(), buf.size());
+    if (!out.good()) {
+      LOGP(warning, "Failed to write preprocessing index {}", tmpName);
+      out.close();
+      std::filesystem::remove(tmpName);
+      return false;
+    }
+  }
+  std::error_code ec;
+  std::filesystem::rename(tmpName, mIndexFile, ec);
+  if (ec) {
+    LOGP(warning, "Failed to store preprocessing index {}: {}", mIndexFile, ec.message());
+    std::filesystem::remove(tmpName, ec);
+    return false;
+  }
+  LOGP(info, "Stored preprocessing index {} with {} blocks of {} links", mIndexFile, nBlocks, mLinksData.size());
+  return true;
+}
+
+//_____________________________________________________________________
+bool RawFileReader::loadIndex(const std::string& key)
+{
+  // load the preprocessing results if the index was produced for the same input files and settings
+  std::ifstream inp(mIndexFile, std::ios::binary);
+  if (!inp) {
+    LOGP(info, "No preprocessing index {} found, will scan the files", mIndexFile);
+    return false;
+  }
+  std::string buf((std::istreambuf_iterator<char>(inp)), std::istreambuf_iterator<char>());
+  IndexInput in{buf.data(), buf.data() + buf.size()};
+  uint64_t magic = 0, keySize = 0;
+  if (!in.get(magic) || magic != IndexMagic || !in.get(keySize) || keySize != key.size() || in.end - in.ptr < long(keySize) ||
+      memcmp(in.ptr, key.data(), keySize) != 0) {
+    LOGP(info, "Preprocessing index {} is outdated or was made with different settings, will scan the files", mIndexFile);
+    return false;
+  }
+  in.ptr += keySize;
+  uint32_t orbitFirst = 0, nLinks = 0;
+  bool ok = in.get(orbitFirst) && in.get(nLinks);
+  std::vector<LinkData> links;
+  size_t nBlocks = 0;
+  int nErrors = 0;
+  for (uint32_t il = 0; ok && il < nLinks; il++) {
+    RDHAny rdh;
+    ok = in.get(rdh);
+    auto& link = links.emplace_back(rdh, this);
+    int32_t nErr = 0;
+    uint32_t nbl = 0, ntf = 0;
+    ok = ok && in.get(link.irOfSOX.orbit) && in.get(link.irOfSOX.bc) && in.get(link.spec) && in.get(link.subspec) &&
+         in.get(link.nTimeFrames) && in.get(link.nHBFrames) && in.get(link.nSPages) && in.get(link.nCRUPages) &&
+         in.get(link.cruDetector) && in.get(link.continuousRO) && in.get(link.origin) && in.get(link.description) &&
+         in.get(nErr) && in.get(nbl);
+    link.nErrors = nErr;
+    nErrors += nErr;
+    for (uint32_t ib = 0; ok && ib < nbl; ib++) {
+      auto& bl = link.blocks.emplace_back();
+      uint64_t offset = 0;
+      ok = in.get(offset) && in.get(bl.size) && in.get(bl.tfID) && in.get(bl.ir.orbit) && in.get(bl.ir.bc) &&
+           in.get(bl.fileID) && in.get(bl.flags) && bl.fileID < mFiles.size();
+      bl.offset = offset;
+    }
+    ok = ok && in.get(ntf);
+    for (uint32_t it = 0; ok && it < ntf; it++) {
+      int32_t startBlock = 0;
+      uint32_t tfID = 0;
+      ok = in.get(startBlock) && in.get(tfID) && startBlock >= 0 && startBlock <= int(nbl); // TF beyond max.TF to read has no blocks
+      link.tfStartBlock.emplace_back(startBlock, tfID);
+    }
+    nBlocks += nbl;
+  }
+  if (!ok || in.ptr != in.end) {
+    LOGP(warning, "Preprocessing index {} is corrupted, will scan the files", mIndexFile);
+    return false;
+  }
+  mLinksData = std::move(links);
+  mLinkEntries.clear();
+  for (int il = 0; il < int(mLinksData.size()); il++) {
+    mLinkEntries[mLinksData[il].spec] = il;
+  }
+  if (mFirstTFAutodetect == FirstTFDetection::Pending) {
+    imposeFirstTF(orbitFirst);
+  }
+  LOGP(info, "Loaded preprocessing index {} with {} blocks of {} links, {} errors were detected at the scan", mIndexFile, nBlocks, mLinksData.size(), nErrors);
+  return true;
+}
+
 //_____________________________________________________________________
 void RawFileReader::printStat(bool verbose) const
 {
@@ -662,6 +981,7 @@ void RawFileReader::clear()
   mLinkEntries.clear();
   mOrderedIDs.clear();
   mLinksData.clear();
+  mFileMaps.clear(); // messages referring to the mapped data keep their own references
   for (auto fl : mFiles) {
     fclose(fl);
   }
@@ -723,15 +1043,37 @@ bool RawFileReader::init()
   }
 
   int nf = mFiles.size();
-  mEmpty = true;
-  for (int i = 0; i < nf; i++) {
-    if (preprocessFile(i)) {
-      mEmpty = false;
+  if (mMapFiles) {
+    mFileMaps.clear();
+    for (int i = 0; i < nf; i++) {
+      struct stat st;
+      int fd = fileno(mFiles[i]);
+      bool statOK = fstat(fd, &st) == 0;
+      auto& fmap = mFileMaps.emplace_back(statOK ? std::make_shared<const FileMap>(fd, st.st_size) : nullptr);
+      if (!fmap || (!fmap->data && st.st_size)) {
+        LOGF(warning, "Failed to map file %s, will read it", mFileNames[i]);
+      }
     }
   }
-  if (mStopProcessing) {
-    LOG(error) << "Abandoning processing due to corrupted data";
-    return false;
+  mEmpty = true;
+  mIndexLoaded = false;
+  std::string indexKey = mIndexFile.empty() ? std::string{} : getIndexKey();
+  if (!indexKey.empty() && loadIndex(indexKey)) {
+    mIndexLoaded = true;
+    mEmpty = mLinksData.empty();
+  } else {
+    for (int i = 0; i < nf; i++) {
+      if (preprocessFile(i)) {
+        mEmpty = false;
+      }
+    }
+    if (mStopProcessing) {
+      LOG(error) << "Abandoning processing due to corrupted data";
+      return false;
+    }
+    if (!indexKey.empty()) {
+      storeIndex(indexKey);
+    }
   }
   mOrderedIDs.resize(mLinksData.size());
   for (int i = mLinksData.size(); i--;) {
@@ -81,6 +81,7 @@ class RawReaderSpecs : public o2f::Task
   int mRunNumber = 0;             // run number to pass
   int mVerbosity = 0;
   int mTFRateLimit = -999;
+  int mNThreads = 1;              // number of threads to assemble the links data
   bool mPreferCalcTF = false;
   size_t mMinSHM = 0;
   size_t mLoopsDone = 0;
@@ -96,12 +97,14 @@ class RawReaderSpecs : public o2f::Task
 
 //___________________________________________________________
 RawReaderSpecs::RawReaderSpecs(const ReaderInp& rinp)
-  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM)
+  : mLoop(rinp.loop < 0 ? INT_MAX : (rinp.loop < 1 ? 1 : rinp.loop)), mDelayUSec(rinp.delay_us), mMinTFID(rinp.minTF), mMaxTFID(rinp.maxTF), mRunNumber(rinp.runNumber), mPartPerSP(rinp.partPerSP), mSup0xccdb(rinp.sup0xccdb), mReader(std::make_unique<o2::raw::RawFileReader>(rinp.inifile, 0, rinp.bufferSize, rinp.onlyDet)), mRawChannelName(rinp.rawChannelConfig), mPreferCalcTF(rinp.preferCalcTF), mMinSHM(rinp.minSHM), mNThreads(std::max(1, rinp.nThreads))
 {
   mReader->setCheckErrors(rinp.errMap);
   mReader->setMaxTFToRead(rinp.maxTF);
   mReader->setNominalSPageSize(rinp.spSize);
   mReader->setCacheData(rinp.cache);
+  mReader->setMapFiles(rinp.mmap);
+  mReader->setIndexFile(rinp.indexFile);
   mReader->setTFAutodetect(rinp.autodetectTF0 ? RawFileReader::FirstTFDetection::Pending : RawFileReader::FirstTFDetection::Disabled);
   mReader->setPreferCalculatedTFStart(rinp.preferCalcTF);
   LOG(info) << "Will preprocess files with buffer size of " << rinp.bufferSize << " bytes";
@@ -220,7 +223,6 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     tfID = mMinTFID;
   }
   mReader->setNextTFToRead(tfID);
-  std::vector<RawFileReader::PartStat> partsSP;
 
   static o2f::RateLimiter limiter;
   limiter.check(ctx, mTFRateLimit, mMinSHM);
@@ -234,6 +236,20 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
   uint64_t creationTime = 0;
   const auto& hbfU = HBFUtils::Instance();
 
+  // The parts of every link are defined and their messages created first, then the payloads of
+  // different links are read in parallel. With mapped files and a transport which does not need
+  // its own memory (i.e. not shmem), the superpages are sent directly from the mapped pages.
+  struct LinkParts {
+    int il = 0;
+    bool zeroCopy = false;
+    o2h::DataHeader hdrTmpl;
+    std::string fmqChannel;
+    std::vector<RawFileReader::PartStat> parts;
+    std::vector<fair::mq::MessagePtr> payloads;
+  };
+  std::vector<LinkParts> linksParts;
+  linksParts.reserve(nlinks);
+
   for (int il = 0; il < nlinks; il++) {
     auto& link = mReader->getLink(il);
 
@@ -248,8 +264,10 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
       continue; // this link has no data for wanted TF
     }
 
-    o2h::DataHeader hdrTmpl(link.description, link.origin, link.subspec); // template with 0 size
-    int nParts = mPartPerSP ? link.getNextTFSuperPagesStat(partsSP) : link.getNHBFinTF();
+    auto& lp = linksParts.emplace_back();
+    lp.il = il;
+    auto& hdrTmpl = lp.hdrTmpl = o2h::DataHeader(link.description, link.origin, link.subspec); // template with 0 size
+    int nParts = mPartPerSP ? link.getNextTFSuperPagesStat(lp.parts) : link.getNextTFHBFStat(lp.parts);
     hdrTmpl.payloadSerializationMethod = o2h::gSerializationMethodNone;
     hdrTmpl.splitPayloadParts = nParts;
     hdrTmpl.tfCounter = mTFCounter;
@@ -257,21 +275,60 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
     if (mVerbosity > 1) {
       LOG(info) << link.describe() << " will read " << nParts << " HBFs starting from block " << link.nextBlock2Read;
     }
-    const auto fmqChannel = findOutputChannel(hdrTmpl);
-    if (fmqChannel.empty()) { // no output channel
+    lp.fmqChannel = findOutputChannel(hdrTmpl);
+    if (lp.fmqChannel.empty()) { // no output channel
+      linksParts.pop_back();
+      continue;
+    }
+
+    auto fmqFactory = device->GetChannel(lp.fmqChannel, 0).Transport();
+    lp.zeroCopy = mPartPerSP && mReader->getMapFiles() && fmqFactory->GetType() != fair::mq::Transport::SHM;
+    for (const auto& part : lp.parts) {
+      if (lp.zeroCopy) {
+        const char* ptr = nullptr;
+        auto fmap = mReader->getFileMap(link.blocks[link.nextBlock2Read].fileID);
+        if (link.mapNextSuperPage(ptr, &part)) { // the message keeps the mapping alive
+          auto hint = new std::shared_ptr<const RawFileReader::FileMap>(std::move(fmap));
+          lp.payloads.push_back(fmqFactory->CreateMessage(const_cast<char*>(ptr), part.size, [](void*, void* h) { delete static_cast<std::shared_ptr<const RawFileReader::FileMap>*>(h); }, hint));
+          continue;
+        }
+      }
+      lp.payloads.push_back(fmqFactory->CreateMessage(part.size, fair::mq::Alignment{64}));
+      if (lp.zeroCopy) { // file is not mapped, read it right away
+        if (link.readNextSuperPage(reinterpret_cast<char*>(lp.payloads.back()->GetData()), &part) != size_t(part.size)) {
+          LOG(error) << "Link " << il << " failed to read " << part.size << " bytes in TF=" << mTFCounter << " part=" << lp.payloads.size() - 1;
+        }
+      }
+    }
+  }
+
+#ifdef WITH_OPENMP
+#pragma omp parallel for schedule(dynamic) num_threads(mNThreads)
+#endif
+  for (int ilp = 0; ilp < int(linksParts.size()); ilp++) {
+    auto& lp = linksParts[ilp];
+    if (lp.zeroCopy) {
       continue;
     }
+    auto& link = mReader->getLink(lp.il);
+    for (size_t ip = 0; ip < lp.parts.size(); ip++) {
+      auto buff = reinterpret_cast<char*>(lp.payloads[ip]->GetData());
+      auto bread = mPartPerSP ? link.readNextSuperPage(buff, &lp.parts[ip]) : link.readNextHBF(buff);
+      if (bread != size_t(lp.parts[ip].size)) {
+        LOG(error) << "Link " << lp.il << " read " << bread << " bytes instead of " << lp.parts[ip].size
+                   << " expected in TF=" << mTFCounter << " part=" << ip;
+      }
+    }
+  }
 
-    auto fmqFactory = device->GetChannel(fmqChannel, 0).Transport();
+  for (auto& lp : linksParts) {
+    auto& link = mReader->getLink(lp.il);
+    auto& hdrTmpl = lp.hdrTmpl;
+    auto fmqFactory = device->GetChannel(lp.fmqChannel, 0).Transport();
     while (hdrTmpl.splitPayloadIndex < hdrTmpl.splitPayloadParts) {
-      hdrTmpl.payloadSize = mPartPerSP ? partsSP[hdrTmpl.splitPayloadIndex].size : link.getNextHBFSize();
+      auto& plMessage = lp.payloads[hdrTmpl.splitPayloadIndex];
+      hdrTmpl.payloadSize = plMessage->GetSize();
       auto hdMessage = fmqFactory->CreateMessage(hstackSize, fair::mq::Alignment{64});
-      auto plMessage = fmqFactory->CreateMessage(hdrTmpl.payloadSize, fair::mq::Alignment{64});
-      auto bread = mPartPerSP ? link.readNextSuperPage(reinterpret_cast<char*>(plMessage->GetData()), &partsSP[hdrTmpl.splitPayloadIndex]) : link.readNextHBF(reinterpret_cast<char*>(plMessage->GetData()));
-      if (bread != hdrTmpl.payloadSize) {
-        LOG(error) << "Link " << il << " read " << bread << " bytes instead of " << hdrTmpl.payloadSize
-                   << " expected in TF=" << mTFCounter << " part=" << hdrTmpl.splitPayloadIndex;
-      }
       // check if the RDH to send corresponds to expected orbit
       if (hdrTmpl.splitPayloadIndex == 0) {
         auto ir = o2::raw::RDHUtils::getHeartBeatIR(plMessage->GetData());
@@ -283,7 +340,7 @@ void RawReaderSpecs::run(o2f::ProcessingContext& ctx)
       memcpy(hdMessage->GetData(), headerStack.data(), headerStack.size());
       hdrTmpl.splitPayloadIndex++; // prepare for next
 
-      addPart(std::move(hdMessage), std::move(plMessage), fmqChannel);
+      addPart(std::move(hdMessage), std::move(plMessage), lp.fmqChannel);
     }
     LOGF(debug, "Added %d parts for TF#%d(%d in iteration %d) of %s/%s/0x%u", hdrTmpl.splitPayloadParts, mTFCounter, tfID,
          mLoopsDone, link.origin.as<std::string>(), link.description.as<std::string>(), link.subspec);
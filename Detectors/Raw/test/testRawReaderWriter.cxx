@@ -13,6 +13,8 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 #include <algorithm>
+#include <chrono>
+#include <filesystem>
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -189,9 +191,11 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
 
   std::unique_ptr<RawFileReader> reader;
   std::string confName;
+  std::string indexFile;
+  bool mapFiles = false;
 
   //_________________________________________________________________
-  TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg") : confName(cfg) {}
+  TestRawReader(const std::string& name = "TST", const std::string& cfg = "rawConf.cfg", bool mmap = false) : confName(cfg), mapFiles(mmap) {}
 
   //_________________________________________________________________
   void init()
@@ -200,6 +204,8 @@ struct TestRawReader { // simple class to read detector raw data for multiple li
     uint32_t errCheck = 0xffffffff;
     errCheck ^= 0x1 << RawFileReader::ErrNoSuperPageForTF; // makes no sense for superpages not interleaved by others
     reader->setCheckErrors(errCheck);
+    reader->setMapFiles(mapFiles);
+    reader->setIndexFile(indexFile);
     reader->init();
   }
 
@@ -318,6 +324,110 @@ BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU)
   dr.run(); // read back and check
 }
 
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_mmap)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT_mmap.cfg"};
+  dw.init();
+  dw.run();
+  //
+  TestRawReader dr{"TST", "test_raw_conf_GBT_mmap.cfg", true}; // RDHs are scanned in place in the mapped files
+  dr.init();
+  dr.run();
+
+  // the files are scanned independently in place and by reading, the results must be identical
+  TestRawReader drRead{"TST", "test_raw_conf_GBT_mmap.cfg"}, drMap{"TST", "test_raw_conf_GBT_mmap.cfg", true};
+  drRead.init();
+  drMap.init();
+  BOOST_REQUIRE(drRead.reader->getNLinks() == drMap.reader->getNLinks());
+  BOOST_REQUIRE(drRead.reader->getNTimeFrames() == drMap.reader->getNTimeFrames());
+  for (int il = 0; il < drRead.reader->getNLinks(); il++) {
+    const auto &lnkRead = drRead.reader->getLink(il), &lnkMap = drMap.reader->getLink(il);
+    BOOST_CHECK(lnkRead.spec == lnkMap.spec && lnkRead.nTimeFrames == lnkMap.nTimeFrames && lnkRead.nHBFrames == lnkMap.nHBFrames);
+    BOOST_CHECK(lnkRead.nCRUPages == lnkMap.nCRUPages && lnkRead.nErrors == lnkMap.nErrors);
+    BOOST_REQUIRE(lnkRead.blocks.size() == lnkMap.blocks.size());
+    for (size_t ib = 0; ib < lnkRead.blocks.size(); ib++) {
+      const auto &blRead = lnkRead.blocks[ib], &blMap = lnkMap.blocks[ib];
+      BOOST_CHECK(blRead.offset == blMap.offset && blRead.size == blMap.size && blRead.tfID == blMap.tfID && blRead.ir == blMap.ir && blRead.flags == blMap.flags);
+    }
+  }
+
+  // superpages provided from the mapped files must be identical to those read
+  std::vector<RawFileReader::PartStat> partsRead, partsMap;
+  std::vector<char> buff;
+  size_t nSPChecked = 0;
+  for (uint32_t tf = 0; tf < drRead.reader->getNTimeFrames(); tf++) {
+    for (int il = 0; il < drRead.reader->getNLinks(); il++) {
+      auto& lnkRead = drRead.reader->getLink(il);
+      auto& lnkMap = drMap.reader->getLink(il);
+      bool okRead = lnkRead.rewindToTF(tf), okMap = lnkMap.rewindToTF(tf);
+      BOOST_REQUIRE(okRead == okMap);
+      if (!okRead) {
+        continue;
+      }
+      lnkRead.getNextTFSuperPagesStat(partsRead);
+      lnkMap.getNextTFSuperPagesStat(partsMap);
+      BOOST_REQUIRE(partsRead.size() == partsMap.size());
+      for (size_t ip = 0; ip < partsRead.size(); ip++) {
+        BOOST_REQUIRE(partsRead[ip].size == partsMap[ip].size);
+        buff.resize(partsRead[ip].size);
+        const char* ptr = nullptr;
+        BOOST_CHECK(lnkRead.readNextSuperPage(buff.data(), &partsRead[ip]) == size_t(partsRead[ip].size));
+        BOOST_CHECK(lnkMap.mapNextSuperPage(ptr, &partsMap[ip]) == size_t(partsMap[ip].size));
+        BOOST_REQUIRE(ptr);
+        BOOST_CHECK(memcmp(ptr, buff.data(), partsRead[ip].size) == 0);
+        nSPChecked++;
+      }
+      BOOST_CHECK(lnkRead.nextBlock2Read == lnkMap.nextBlock2Read);
+    }
+  }
+  BOOST_CHECK(nSPChecked > 0);
+}
+
+BOOST_AUTO_TEST_CASE(RawReaderWriter_CRU_index)
+{
+  TestRawWriter dw{"TST", true, "test_raw_conf_GBT_index.cfg"};
+  dw.init();
+  dw.run();
+  //
+  const std::string indexFile = "test_raw_GBT.index";
+  std::filesystem::remove(indexFile);
+  TestRawReader drScan{"TST", "test_raw_conf_GBT_index.cfg"}, drLoad{"TST", "test_raw_conf_GBT_index.cfg"};
+  drScan.indexFile = drLoad.indexFile = indexFile;
+  drScan.init();
+  BOOST_CHECK(!drScan.reader->isIndexLoaded());
+  BOOST_REQUIRE(std::filesystem::exists(indexFile));
+  drLoad.init();
+  BOOST_CHECK(drLoad.reader->isIndexLoaded());
+  BOOST_REQUIRE(drScan.reader->getNLinks() == drLoad.reader->getNLinks());
+  BOOST_CHECK(drScan.reader->getNTimeFrames() == drLoad.reader->getNTimeFrames());
+  for (int il = 0; il < drScan.reader->getNLinks(); il++) {
+    const auto &lnkScan = drScan.reader->getLink(il), &lnkLoad = drLoad.reader->getLink(il);
+    BOOST_CHECK(lnkScan.spec == lnkLoad.spec && lnkScan.nTimeFrames == lnkLoad.nTimeFrames && lnkScan.nErrors == lnkLoad.nErrors);
+    BOOST_REQUIRE(lnkScan.blocks.size() == lnkLoad.blocks.size());
+    for (size_t ib = 0; ib < lnkScan.blocks.size(); ib++) {
+      const auto &blScan = lnkScan.blocks[ib], &blLoad = lnkLoad.blocks[ib];
+      BOOST_CHECK(blScan.offset == blLoad.offset && blScan.size == blLoad.size && blScan.fileID == blLoad.fileID &&
+                  blScan.tfID == blLoad.tfID && blScan.ir == blLoad.ir && blScan.flags == blLoad.flags);
+    }
+    BOOST_CHECK(lnkScan.tfStartBlock == lnkLoad.tfStartBlock);
+  }
+  drLoad.run(); // data read using the loaded index must pass all the checks
+
+  // the index made with different settings or for modified files is not used
+  auto checkIndexUse = [&indexFile](uint32_t maxTF, bool expected) {
+    RawFileReader reader("test_raw_conf_GBT_index.cfg");
+    reader.setIndexFile(indexFile);
+    reader.setMaxTFToRead(maxTF);
+    reader.init();
+    BOOST_CHECK(reader.isIndexLoaded() == expected);
+  };
+  checkIndexUse(1, false); // rewrites the index for the new settings
+  checkIndexUse(1, true);
+  std::filesystem::last_write_time("testdata_cru0.raw", std::filesystem::last_write_time("testdata_cru0.raw") + std::chrono::seconds(1));
+  checkIndexUse(1, false);
+  std::filesystem::remove(indexFile);
+}
+
 BOOST_AUTO_TEST_CASE(RawReaderWriter_RORC)
 {
   TestRawWriter dw{"TST", false, "test_raw_conf_DDL.cfg"}; // this is RORC detector with origin TST
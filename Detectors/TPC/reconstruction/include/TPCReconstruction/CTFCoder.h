@@ -230,9 +230,10 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl, co
   ec->setANSHeader(mANSVersion);
 
   o2::ctf::CTFIOSize iosize;
-  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), &iosize](auto begin, auto end, CTF::Slots slot, size_t probabilityBits, std::vector<bool>* reject = nullptr) {
+  auto encodeTPC = [&buff, &optField, &coders = mCoders, mfc = this->getMemMarginFactor(), chunked = this->getChunkedEncoding(), nThreads = this->getNThreads(), &iosize](auto begin, auto end, CTF::Slots slot, size_t probabilityBits, std::vector<bool>* reject = nullptr) {
     // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
     const auto slotVal = static_cast<int>(slot);
+    const auto opt = (chunked && optField[slotVal] == MD::EENCODE_OR_PACK) ? MD::EENCODE_CHUNKED : optField[slotVal];
     if (reject && begin != end) {
       std::vector<std::decay_t<decltype(*begin)>> tmp;
       tmp.reserve(std::distance(begin, end));
@@ -241,9 +242,9 @@ o2::ctf::CTFIOSize CTFCoder::encode(VEC& buff, const CompressedClusters& ccl, co
           tmp.emplace_back(*i);
         }
       }
-      iosize += CTF::get(buff.data())->encode(tmp.begin(), tmp.end(), slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal], mfc);
+      iosize += CTF::get(buff.data())->encode(tmp.begin(), tmp.end(), slotVal, probabilityBits, opt, &buff, coders[slotVal], mfc, nThreads);
     } else {
-      iosize += CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, optField[slotVal], &buff, coders[slotVal], mfc);
+      iosize += CTF::get(buff.data())->encode(begin, end, slotVal, probabilityBits, opt, &buff, coders[slotVal], mfc, nThreads);
     }
   };
 
@@ -345,9 +346,9 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VEC& buffVec, TRIGVEC&
 
   // decode encoded data directly to destination buff
   o2::ctf::CTFIOSize iosize;
-  auto decodeTPC = [&ec, &coders = mCoders, &iosize](auto begin, CTF::Slots slot) {
+  auto decodeTPC = [&ec, &coders = mCoders, nThreads = this->getNThreads(), &iosize](auto begin, CTF::Slots slot) {
     const auto slotVal = static_cast<int>(slot);
-    iosize += ec.decode(begin, slotVal, coders[slotVal]);
+    iosize += ec.decode(begin, slotVal, coders[slotVal], nThreads);
   };
 
   if (mCombineColumns) {
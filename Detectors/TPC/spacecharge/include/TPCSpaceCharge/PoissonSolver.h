@@ -42,6 +42,10 @@ class DataContainer3D;
 /// The PoissonSolver class represents methods to solve the poisson equation.
 /// Original version with more methods can be found in AliTPCPoissonSolver.
 /// Following methods are implemented: poissonSolver3D, poissonSolver3D2D, poissonSolver2D
+///
+/// The grids of the multi grid hierarchy of the full 3D solver are allocated at the first call of poissonSolver3D
+/// and reused by the following calls. Keeping the solver alive is therefore faster when solving the same grid
+/// geometry for many charge densities.
 
 /// \tparam DataT the type of data which is used during the calculations
 template <typename DataT = double>
@@ -102,6 +106,36 @@ class PoissonSolver
   static constexpr DataT INVTWOPI = 1. / o2::constants::math::TwoPI; ///< inverse of 2*pi
   inline static int sNThreads{4};                                    ///< number of threads which are used during some of the calculations (increasing this number has no big impact)
 
+  /// grids and coefficients of the multi grid hierarchy of poissonMultiGrid3D, kept between the solves
+  struct MultiGridBuffers {
+    std::vector<Vector> arrayV;             ///< potential <--> error
+    std::vector<Vector> chargeFMG;          ///< charge is restricted in full multiGrid
+    std::vector<Vector> charge;             ///< charge <--> residue
+    std::vector<Vector> prevArrayV;         ///< error calculation
+    std::vector<Vector> residue;            ///< residue calculation
+    std::vector<DataT> coefficient1;        ///< (1 + h_{r}/2r_{i}) from central differences in r direction
+    std::vector<DataT> coefficient2;        ///< (1 + h_{r}/2r_{i}) from central differences in r direction
+    std::vector<DataT> coefficient3;        ///< (1/r_{i}^2) from central differences in phi direction
+    std::vector<DataT> coefficient4;        ///< 1/2
+    std::vector<DataT> inverseCoefficient4; ///< inverse of coefficient4
+    std::vector<DataT> relaxBuffer;         ///< relaxed values of the current colour in relax3D
+  };
+  MultiGridBuffers mBuffers; ///<! buffers of the multi grid
+
+  /// grid dimensions and relaxation parameters of one level of the full 3D multi grid
+  struct Level3D {
+    int nRRow;      ///< number of vertices in r direction
+    int nZColumn;   ///< number of vertices in z direction
+    int nPhiSlice;  ///< number of vertices in phi direction
+    DataT h;        ///< grid spacing in r direction
+    DataT ratioZ;   ///< ratio between the squares of the grid spacing in r and z direction
+    DataT ratioPhi; ///< ratio between the squares of the grid spacing in r and phi direction
+  };
+
+  /// \param level level of the multi grid (1 being the finest grid)
+  /// \param ratioZ ratio between the squares of the grid spacing in r and z direction of the finest grid
+  Level3D getLevel3D(const int level, const DataT ratioZ) const;
+
   /// \returns inverse grid size in phi (either 1/2Pi or NSECTORSPERSIDE/2Pi)
   static DataT getGridSizePhiInv();
 
@@ -226,6 +260,9 @@ class PoissonSolver
   /// Using the following equations
   /// \f$ U_{i,j,k} = (1 + \frac{1}{r_{i}h_{r}}) U_{i+1,j,k}  + (1 - \frac{1}{r_{i}h_{r}}) U_{i+1,j,k}  \f$
   ///
+  /// The red-black Gauss-Seidel relaxation is done in blocks of r rows of each phi slice on sNThreads threads.
+  /// The new values are calculated along z for all vertices of a block and only those of the current colour are stored.
+  ///
   /// \param matricesCurrentV potential in 3D (matrices of matrix)
   /// \param matricesCurrentCharge charge in 3D
   /// \param tnRRow number of grid in in r-direction for coarser grid should be 2^N + 1, finer grid in 2^{N+1} + 1
@@ -239,7 +276,7 @@ class PoissonSolver
   /// \param coefficient3 coefficients for z
   /// \param coefficient4 coefficients for f(r,\phi,z)
   void relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2, const DataT tempRatioZ,
-               const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const;
+               const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4);
 
   /// Relax2D
   ///
@@ -352,7 +389,7 @@ class PoissonSolver
   /// \param inverseCoefficient4 coefficient for relaxation (inverse coefficient4)
   void vCycle3D2D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, const DataT ratioPhi, std::vector<Vector>& tvArrayV,
                   std::vector<Vector>& tvCharge, std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3,
-                  std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4) const;
+                  std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4);
 
   /// VCycle 3D, V Cycle in multiGrid, fine-->coarsest-->fine, propagating the residue to correct initial guess of V
   ///
@@ -381,7 +418,15 @@ class PoissonSolver
   /// \param inverseCoefficient4 coefficient for relaxation (inverse coefficient4)
   void vCycle3D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, std::vector<Vector>& tvArrayV, std::vector<Vector>& tvCharge,
                 std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3,
-                std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4) const;
+                std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4);
+
+  /// WCycle 3D, W Cycle in multiGrid: as the V Cycle, but the correction on each coarser grid is obtained with two W Cycles
+  /// (i.e. the coarsest grid is visited 2^(gridTo - gridFrom - 1) times)
+  ///
+  /// The parameters are the same as for vCycle3D
+  void wCycle3D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, std::vector<Vector>& tvArrayV, std::vector<Vector>& tvCharge,
+                std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3,
+                std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4);
 
   /// V-Cycle 2D
   ///
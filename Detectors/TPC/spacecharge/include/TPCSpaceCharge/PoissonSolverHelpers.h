@@ -28,7 +28,7 @@ namespace tpc
 ///< Enumeration of Cycles Type
 enum class CycleType {
   VCycle = 0, ///< V Cycle
-  WCycle = 1, ///< W Cycle (TODO)
+  WCycle = 1, ///< W Cycle
   FCycle = 2  ///< Full Cycle
 };
 
@@ -48,6 +48,7 @@ enum class RelaxType {
 struct MGParameters {                                             ///< Parameters choice for MultiGrid algorithm
   inline static bool isFull3D = true;                             ///<  TRUE: full coarsening, FALSE: semi coarsening
   inline static CycleType cycleType = CycleType::FCycle;          ///< cycleType follow  CycleType
+  inline static CycleType fmgCycleType = CycleType::VCycle;       ///< cycle (VCycle or WCycle) used on each level of the full multi grid cycle (3D full coarsening only)
   inline static GridTransferType gtType = GridTransferType::Full; ///< gtType grid transfer type follow GridTransferType
   inline static RelaxType relaxType = RelaxType::GaussSeidel;     ///< relaxType follow RelaxType
   inline static int nPre = 2;                                     ///< number of iteration for pre smoothing
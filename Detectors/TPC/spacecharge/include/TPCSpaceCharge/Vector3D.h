@@ -62,13 +62,14 @@ class Vector3D
     return mStorage[index];
   }
 
+  /// the data points are stored contiguously in z direction (as in DataContainer3D), then in r and phi direction
   /// \param iR index in r direction
   /// \param iZ index in z direction
   /// \param iPhi index in phi direction
   /// \return returns the index for given indices
   int getIndex(const unsigned int iR, const unsigned int iZ, const unsigned int iPhi) const
   {
-    return iR + mNr * (iZ + mNz * iPhi);
+    return iZ + mNz * (iR + mNr * iPhi);
   }
 
   /// resize the vector
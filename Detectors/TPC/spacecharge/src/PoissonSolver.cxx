@@ -21,6 +21,7 @@
 #include "TPCSpaceCharge/PoissonSolver.h"
 #include "TPCSpaceCharge/PoissonSolverHelpers.h"
 #include "Framework/Logger.h"
+#include <algorithm>
 #include <numeric>
 #include <fmt/core.h>
 #include "TPCSpaceCharge/Vector3D.h"
@@ -401,18 +402,24 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
   int tnZColumn = mParamGrid.NZVertices;
   int tPhiSlice = mParamGrid.NPhiVertices;
 
-  // 1) Memory allocation for multi grid
-  std::vector<Vector> tvArrayV(nLoop);     // potential <--> error
-  std::vector<Vector> tvChargeFMG(nLoop);  // charge is restricted in full multiGrid
-  std::vector<Vector> tvCharge(nLoop);     // charge <--> residue
-  std::vector<Vector> tvPrevArrayV(nLoop); // error calculation
-  std::vector<Vector> tvResidue(nLoop);    // residue calculation
+  // 1) Memory allocation for multi grid: the grids of the previous solve are reused
+  auto& tvArrayV = mBuffers.arrayV;
+  auto& tvChargeFMG = mBuffers.chargeFMG;
+  auto& tvCharge = mBuffers.charge;
+  auto& tvPrevArrayV = mBuffers.prevArrayV;
+  auto& tvResidue = mBuffers.residue;
+  for (auto* levels : {&tvArrayV, &tvChargeFMG, &tvCharge, &tvPrevArrayV, &tvResidue}) {
+    levels->resize(nLoop);
+  }
 
-  std::vector<DataT> coefficient1(mParamGrid.NRVertices);        // coefficient1(mParamGrid.NRVertices) for storing (1 + h_{r}/2r_{i}) from central differences in r direction
-  std::vector<DataT> coefficient2(mParamGrid.NRVertices);        // coefficient2(mParamGrid.NRVertices) for storing (1 + h_{r}/2r_{i}) from central differences in r direction
-  std::vector<DataT> coefficient3(mParamGrid.NRVertices);        // coefficient3(mParamGrid.NRVertices) for storing (1/r_{i}^2) from central differences in phi direction
-  std::vector<DataT> coefficient4(mParamGrid.NRVertices);        // coefficient4(mParamGrid.NRVertices) for storing  1/2
-  std::vector<DataT> inverseCoefficient4(mParamGrid.NRVertices); // inverse of coefficient4(mParamGrid.NRVertices)
+  auto& coefficient1 = mBuffers.coefficient1;
+  auto& coefficient2 = mBuffers.coefficient2;
+  auto& coefficient3 = mBuffers.coefficient3;
+  auto& coefficient4 = mBuffers.coefficient4;
+  auto& inverseCoefficient4 = mBuffers.inverseCoefficient4;
+  for (auto* coefficient : {&coefficient1, &coefficient2, &coefficient3, &coefficient4, &inverseCoefficient4}) {
+    coefficient->assign(mParamGrid.NRVertices, 0);
+  }
 
   for (int count = 1; count <= nLoop; ++count) {
     // tnRRow,tnZColumn in new grid
@@ -440,6 +447,9 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
         }
       }
       tvCharge[index] = tvChargeFMG[index];
+    } else {
+      // the potential on the coarser grids is the initial guess of the full multi grid
+      std::fill(tvArrayV[index].begin(), tvArrayV[index].end(), 0);
     }
     iOne *= 2; // doubling
     jOne *= 2; // doubling
@@ -529,7 +539,11 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
         // copy to store previous potential
         tvPrevArrayV[count] = tvArrayV[count];
 
-        vCycle3D(symmetry, count + 1, nLoop, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+        if (MGParameters::fmgCycleType == CycleType::WCycle) {
+          wCycle3D(symmetry, count + 1, nLoop, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+        } else {
+          vCycle3D(symmetry, count + 1, nLoop, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+        }
 
         // converge error
         const DataT convergenceError = getConvergenceError(tvArrayV[count], tvPrevArrayV[count]);
@@ -553,8 +567,8 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
       // keep old slice information
       otPhiSlice = tPhiSlice;
     }
-  } else if (MGParameters::cycleType == CycleType::VCycle) {
-    // V-cycle
+  } else if (MGParameters::cycleType == CycleType::VCycle || MGParameters::cycleType == CycleType::WCycle) {
+    // V-cycle or W-cycle
     int gridFrom = 1;
     int gridTo = nLoop;
 
@@ -562,8 +576,12 @@ void PoissonSolver<DataT>::poissonMultiGrid3D(DataContainer& matricesV, const Da
       // copy to store previous potential
       tvPrevArrayV[0] = tvArrayV[0];
 
-      // Do V Cycle from the coarsest to finest grid
-      vCycle3D(symmetry, gridFrom, gridTo, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+      // Do V Cycle (W Cycle) from the coarsest to finest grid
+      if (MGParameters::cycleType == CycleType::WCycle) {
+        wCycle3D(symmetry, gridFrom, gridTo, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+      } else {
+        vCycle3D(symmetry, gridFrom, gridTo, MGParameters::nPre, MGParameters::nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+      }
 
       // convergence error
       const DataT convergenceError = getConvergenceError(tvArrayV[0], tvPrevArrayV[0]);
@@ -746,7 +764,7 @@ void PoissonSolver<DataT>::vCycle2D(const int gridFrom, const int gridTo, const
 template <typename DataT>
 void PoissonSolver<DataT>::vCycle3D2D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, const DataT ratioPhi,
                                       std::vector<Vector>& tvArrayV, std::vector<Vector>& tvCharge, std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1,
-                                      std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3, std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4) const
+                                      std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3, std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4)
 {
   unsigned int iOne = 1 << (gridFrom - 1);
   unsigned int jOne = 1 << (gridFrom - 1);
@@ -831,7 +849,7 @@ void PoissonSolver<DataT>::vCycle3D2D(const int symmetry, const int gridFrom, co
 template <typename DataT>
 void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, std::vector<Vector>& tvArrayV,
                                     std::vector<Vector>& tvCharge, std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3,
-                                    std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4) const
+                                    std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4)
 {
   const DataT gridSpacingR = getSpacingR();
 
@@ -930,6 +948,54 @@ void PoissonSolver<DataT>::vCycle3D(const int symmetry, const int gridFrom, cons
   }
 }
 
+template <typename DataT>
+void PoissonSolver<DataT>::wCycle3D(const int symmetry, const int gridFrom, const int gridTo, const int nPre, const int nPost, const DataT ratioZ, std::vector<Vector>& tvArrayV,
+                                    std::vector<Vector>& tvCharge, std::vector<Vector>& tvResidue, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2, std::vector<DataT>& coefficient3,
+                                    std::vector<DataT>& coefficient4, std::vector<DataT>& inverseCoefficient4)
+{
+  const int index = gridFrom - 1;
+  const Level3D fine = getLevel3D(gridFrom, ratioZ);
+  const DataT h2 = fine.h * fine.h;
+  calcCoefficients(1, fine.nRRow - 1, fine.h, fine.ratioZ, fine.ratioPhi, coefficient1, coefficient2, coefficient3, coefficient4);
+
+  // relax on the coarsest grid
+  if (gridFrom == gridTo) {
+    relax3D(tvArrayV[index], tvCharge[index], fine.nRRow, fine.nZColumn, fine.nPhiSlice, symmetry, h2, fine.ratioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+    return;
+  }
+
+  for (int i = 1; i < fine.nRRow - 1; ++i) {
+    inverseCoefficient4[i] = 1 / coefficient4[i];
+  }
+
+  // 1) Pre-Smoothing: Gauss-Seidel Relaxation or Jacobi
+  for (int jPre = 1; jPre <= nPre; ++jPre) {
+    relax3D(tvArrayV[index], tvCharge[index], fine.nRRow, fine.nZColumn, fine.nPhiSlice, symmetry, h2, fine.ratioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+  }
+
+  // 2) Residue calculation
+  residue3D(tvResidue[index], tvArrayV[index], tvCharge[index], fine.nRRow, fine.nZColumn, fine.nPhiSlice, symmetry, 1 / h2, fine.ratioZ, coefficient1, coefficient2, coefficient3, inverseCoefficient4);
+
+  // 3) Restriction and zeroing coarser V
+  const Level3D coarse = getLevel3D(gridFrom + 1, ratioZ);
+  restrict3D(tvCharge[gridFrom], tvResidue[index], coarse.nRRow, coarse.nZColumn, coarse.nPhiSlice, fine.nPhiSlice);
+  std::fill(tvArrayV[gridFrom].begin(), tvArrayV[gridFrom].end(), 0);
+
+  // 4) two W Cycles on the coarser grid
+  for (int iCycle = 0; iCycle < 2; ++iCycle) {
+    wCycle3D(symmetry, gridFrom + 1, gridTo, nPre, nPost, ratioZ, tvArrayV, tvCharge, tvResidue, coefficient1, coefficient2, coefficient3, coefficient4, inverseCoefficient4);
+  }
+
+  // 5) Interpolation/Prolongation
+  addInterp3D(tvArrayV[index], tvArrayV[gridFrom], fine.nRRow, fine.nZColumn, fine.nPhiSlice, coarse.nPhiSlice);
+
+  // 6) Post-Smoothing: Gauss-Seidel Relaxation, the coefficients were overwritten on the coarser grids
+  calcCoefficients(1, fine.nRRow - 1, fine.h, fine.ratioZ, fine.ratioPhi, coefficient1, coefficient2, coefficient3, coefficient4);
+  for (int jPost = 1; jPost <= nPost; ++jPost) {
+    relax3D(tvArrayV[index], tvCharge[index], fine.nRRow, fine.nZColumn, fine.nPhiSlice, symmetry, h2, fine.ratioZ, coefficient1, coefficient2, coefficient3, coefficient4);
+  }
+}
+
 template <typename DataT>
 void PoissonSolver<DataT>::residue2D(Vector& residue, const Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const DataT ih2, const DataT inverseTempFourth,
                                      const DataT tempRatio, std::vector<DataT>& coefficient1, std::vector<DataT>& coefficient2)
@@ -991,8 +1057,8 @@ void PoissonSolver<DataT>::residue3D(Vector& residue, const Vector& matricesCurr
       }
     }
 
-    for (int j = 1; j < tnZColumn - 1; ++j) {
-      for (int i = 1; i < tnRRow - 1; ++i) {
+    for (int i = 1; i < tnRRow - 1; ++i) {
+      for (int j = 1; j < tnZColumn - 1; ++j) {
         residue(i, j, m) = ih2 * (coefficient2[i] * matricesCurrentV(i - 1, j, m) + tempRatioZ * (matricesCurrentV(i, j - 1, m) + matricesCurrentV(i, j + 1, m)) + coefficient1[i] * matricesCurrentV(i + 1, j, m) +
                                   coefficient3[i] * (signPlus * matricesCurrentV(i, j, mp1) + signMinus * matricesCurrentV(i, j, mm1)) - inverseCoefficient4[i] * matricesCurrentV(i, j, m)) +
                            matricesCurrentCharge(i, j, m);
@@ -1218,54 +1284,107 @@ void PoissonSolver<DataT>::addInterp2D(Vector& matricesCurrentV, const Vector& m
 
 template <typename DataT>
 void PoissonSolver<DataT>::relax3D(Vector& matricesCurrentV, const Vector& matricesCurrentCharge, const int tnRRow, const int tnZColumn, const int iPhi, const int symmetry, const DataT h2,
-                                   const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4) const
+                                   const DataT tempRatioZ, const std::vector<DataT>& coefficient1, const std::vector<DataT>& coefficient2, const std::vector<DataT>& coefficient3, const std::vector<DataT>& coefficient4)
 {
-  // Gauss-Seidel (Read Black}
+  // Gauss-Seidel (Red Black)
   if (MGParameters::relaxType == RelaxType::GaussSeidel) {
-    // for each slice
+    // The vertices of one colour only depend on the vertices of the other colour. In each pass, the new values of all vertices of a
+    // block of r rows are first calculated along z (contiguous in memory) and stored in a buffer, then the ones of the current colour
+    // are copied back. The two steps are separated, so that no vertex is read while it is written and the blocks are independent.
+    // With periodic phi and an odd number of slices, the first and the last slice have the same colour. The last slice is therefore
+    // relaxed after all others, which gives the same result as the sequential ordering.
+    constexpr int blockR = 8;                // number of r rows relaxed together
+    constexpr int minVerticesParallel = 16384; // minimum number of vertices to use several threads
+    const int sliceSize = tnRRow * tnZColumn;
+    auto& buffer = mBuffers.relaxBuffer;
+    if (buffer.size() < static_cast<size_t>(sliceSize * iPhi)) {
+      buffer.resize(sliceSize * iPhi);
+    }
+    DataT* potential = matricesCurrentV.data().data();
+    const DataT* charge = matricesCurrentCharge.data().data();
+    DataT* relaxed = buffer.data();
+    const int nBlocksR = (tnRRow - 2 + blockR - 1) / blockR;
+
     for (int iPass = 1; iPass <= 2; ++iPass) {
       const int msw = (iPass % 2) ? 1 : 2;
-      for (int m = 0; m < iPhi; ++m) {
-        const int jsw = ((msw + m) % 2) ? 1 : 2;
-        int mp1 = m + 1;
-        int signPlus = 1;
-        int mm1 = m - 1;
-        int signMinus = 1;
-        // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
-        if (symmetry == 1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-          }
+      const auto relaxSlices = [&](const int mFirst, const int mLast) {
+        const int nBlocks = (mLast - mFirst) * nBlocksR;
+#pragma omp parallel num_threads(sNThreads) if ((mLast - mFirst) * sliceSize >= minVerticesParallel)
+        {
+#pragma omp for
+          for (int block = 0; block < nBlocks; ++block) {
+            const int m = mFirst + block / nBlocksR;
+            const int iFirst = 1 + (block % nBlocksR) * blockR;
+            const int iLast = std::min(iFirst + blockR, tnRRow - 1);
+            int mp1 = m + 1;
+            int signPlus = 1;
+            int mm1 = m - 1;
+            int signMinus = 1;
+            // Reflection symmetry in phi (e.g. symmetry at sector boundaries, or half sectors, etc.)
+            if (symmetry == 1) {
+              if (mp1 > iPhi - 1) {
+                mp1 = iPhi - 2;
+              }
+              if (mm1 < 0) {
+                mm1 = 1;
+              }
+            }
+            // Anti-symmetry in phi
+            else if (symmetry == -1) {
+              if (mp1 > iPhi - 1) {
+                mp1 = iPhi - 2;
+                signPlus = -1;
+              }
+              if (mm1 < 0) {
+                mm1 = 1;
+                signMinus = -1;
+              }
+            } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
+              if (mp1 > iPhi - 1) {
+                mp1 = m + 1 - iPhi;
+              }
+              if (mm1 < 0) {
+                mm1 = m - 1 + iPhi;
+              }
+            }
+            for (int i = iFirst; i < iLast; ++i) {
+              const int offset = m * sliceSize + i * tnZColumn;
+              const DataT* vCurrent = potential + offset;
+              const DataT* vRMinus = vCurrent - tnZColumn;
+              const DataT* vRPlus = vCurrent + tnZColumn;
+              const DataT* vPhiPlus = potential + mp1 * sliceSize + i * tnZColumn;
+              const DataT* vPhiMinus = potential + mm1 * sliceSize + i * tnZColumn;
+              const DataT* chargeCurrent = charge + offset;
+              DataT* relaxedCurrent = relaxed + offset;
+              const DataT coeff1 = coefficient1[i];
+              const DataT coeff2 = coefficient2[i];
+              const DataT coeff3 = coefficient3[i];
+              const DataT coeff4 = coefficient4[i];
+              for (int j = 1; j < tnZColumn - 1; ++j) {
+                relaxedCurrent[j] = (coeff2 * vRMinus[j] + tempRatioZ * (vCurrent[j - 1] + vCurrent[j + 1]) + coeff1 * vRPlus[j] + coeff3 * (signPlus * vPhiPlus[j] + signMinus * vPhiMinus[j]) + (h2 * chargeCurrent[j])) * coeff4;
+              } // end cols
+            }   // end rows
+          }     // end blocks
+
+#pragma omp for
+          for (int block = 0; block < nBlocks; ++block) {
+            const int m = mFirst + block / nBlocksR;
+            const int iFirst = 1 + (block % nBlocksR) * blockR;
+            const int iLast = std::min(iFirst + blockR, tnRRow - 1);
+            const int jsw = ((msw + m) % 2) ? 1 : 2;
+            for (int i = iFirst; i < iLast; ++i) {
+              // vertex (i, j) has the current colour if i + j + jsw is odd
+              const int offset = m * sliceSize + i * tnZColumn;
+              for (int j = ((i + jsw) % 2) ? 2 : 1; j < tnZColumn - 1; j += 2) {
+                potential[offset + j] = relaxed[offset + j];
+              }
+            }
+          } // end blocks
         }
-        // Anti-symmetry in phi
-        else if (symmetry == -1) {
-          if (mp1 > iPhi - 1) {
-            mp1 = iPhi - 2;
-            signPlus = -1;
-          }
-          if (mm1 < 0) {
-            mm1 = 1;
-            signMinus = -1;
-          }
-        } else { // No Symmetries in phi, no boundaries, the calculation is continuous across all phi
-          if (mp1 > iPhi - 1) {
-            mp1 = m + 1 - iPhi;
-          }
-          if (mm1 < 0) {
-            mm1 = m - 1 + iPhi;
-          }
-        }
-        int isw = jsw;
-        for (int j = 1; j < tnZColumn - 1; ++j, isw = 3 - isw) {
-          for (int i = isw; i < tnRRow - 1; i += 2) {
-            (matricesCurrentV)(i, j, m) = (coefficient2[i] * (matricesCurrentV)(i - 1, j, m) + tempRatioZ * ((matricesCurrentV)(i, j - 1, m) + (matricesCurrentV)(i, j + 1, m)) + coefficient1[i] * (matricesCurrentV)(i + 1, j, m) + coefficient3[i] * (signPlus * (matricesCurrentV)(i, j, mp1) + signMinus * (matricesCurrentV)(i, j, mm1)) + (h2 * (matricesCurrentCharge)(i, j, m))) * coefficient4[i];
-          } // end cols
-        }   // end mParamGrid.NRVertices
-      }     // end phi
-    }       // end sweep
+      };
+      relaxSlices(0, iPhi - 1);
+      relaxSlices(iPhi - 1, iPhi);
+    } // end sweep
   } else if (MGParameters::relaxType == RelaxType::Jacobi) {
     // for each slice
     for (int m = 0; m < iPhi; ++m) {
@@ -1517,6 +1636,26 @@ void PoissonSolver<DataT>::calcCoefficients2D(unsigned int from, unsigned int to
   }
 }
 
+template <typename DataT>
+typename PoissonSolver<DataT>::Level3D PoissonSolver<DataT>::getLevel3D(const int level, const DataT ratioZ) const
+{
+  int nnPhi = mParamGrid.NPhiVertices;
+  while (nnPhi % 2 == 0) {
+    nnPhi /= 2;
+  }
+
+  const unsigned int one = 1 << (level - 1); // same coarsening in r, z and phi
+  Level3D grid;
+  grid.nRRow = one == 1 ? mParamGrid.NRVertices : mParamGrid.NRVertices / one + 1;
+  grid.nZColumn = one == 1 ? mParamGrid.NZVertices : mParamGrid.NZVertices / one + 1;
+  grid.nPhiSlice = std::max(static_cast<int>(mParamGrid.NPhiVertices / one), nnPhi);
+  grid.h = getSpacingR() * one;
+  const DataT gridSizePhiInv = grid.nPhiSlice * getGridSizePhiInv();
+  grid.ratioPhi = grid.h * grid.h * gridSizePhiInv * gridSizePhiInv; // ratio_{phi} = gridSize_{r} / gridSize_{phi}
+  grid.ratioZ = ratioZ;                                               // the grid is coarsened in the same way in r and z
+  return grid;
+}
+
 template <typename DataT>
 DataT PoissonSolver<DataT>::getGridSizePhiInv()
 {
@@ -0,0 +1,130 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file benchPoissonSolver.cxx
+/// \brief Benchmark of the time to convergence of the 3D poisson solver on the production grid
+///
+/// The charge density and the boundary potential are taken from the analytical fields, as in
+/// testO2TPCPoissonSolver.cxx. The same solver is used for all iterations (as for the production
+/// of distortion maps), except for the Fresh benchmark, which creates a new one for every solve.
+/// Every benchmark reports the maximal difference to the analytical potential.
+
+#include "benchmark/benchmark.h"
+#include "TPCSpaceCharge/PoissonSolver.h"
+#include "TPCSpaceCharge/PoissonSolverHelpers.h"
+#include "TPCSpaceCharge/SpaceChargeHelpers.h"
+#include "TPCSpaceCharge/DataContainer3D.h"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+using namespace o2::tpc;
+
+namespace
+{
+using DataT = double;
+constexpr unsigned short NR = 129;  // grid in r
+constexpr unsigned short NZ = 129;  // grid in z
+constexpr unsigned short NPHI = 180; // grid in phi
+
+using DataContainer = DataContainer3D<DataT>;
+
+/// grid, charge density and boundary potential of the production grid
+struct ProductionGrid {
+  using GridProp = GridProperties<DataT>;
+  const ParamSpaceCharge params{NR, NZ, NPHI};
+  const RegularGrid3D<DataT> grid{GridProp::ZMIN, GridProp::RMIN, GridProp::PHIMIN, GridProp::getGridSpacingZ(NZ), GridProp::getGridSpacingR(NR), GridProp::getGridSpacingPhi(NPHI), params};
+  DataContainer charge{NZ, NR, NPHI};
+  DataContainer boundary{NZ, NR, NPHI};
+  DataContainer analytical{NZ, NR, NPHI};
+
+  ProductionGrid()
+  {
+    const AnalyticalFields<DataT> fields;
+    for (size_t iPhi = 0; iPhi < NPHI; ++iPhi) {
+      const DataT phi = grid.getPhiVertex(iPhi);
+      for (size_t iR = 0; iR < NR; ++iR) {
+        const DataT radius = grid.getRVertex(iR);
+        for (size_t iZ = 0; iZ < NZ; ++iZ) {
+          const DataT z = grid.getZVertex(iZ);
+          charge(iZ, iR, iPhi) = fields.evalDensity(z, radius, phi);
+          analytical(iZ, iR, iPhi) = fields.evalPotential(z, radius, phi);
+          if (iR == 0 || iR == NR - 1 || iZ == 0 || iZ == NZ - 1) {
+            boundary(iZ, iR, iPhi) = analytical(iZ, iR, iPhi);
+          }
+        }
+      }
+    }
+  }
+
+  DataT maxDeviation(const DataContainer& potential) const
+  {
+    DataT maxDiff = 0;
+    for (size_t i = 0; i < potential.getNDataPoints(); ++i) {
+      maxDiff = std::max(maxDiff, std::abs(potential.getData()[i] - analytical.getData()[i]));
+    }
+    return maxDiff;
+  }
+};
+
+const ProductionGrid& getProductionGrid()
+{
+  static const ProductionGrid grid;
+  return grid;
+}
+
+/// range(0): 0 full multi grid with V cycles, 1 full multi grid with W cycles, 2 V cycles, 3 W cycles
+void setCycle(const int cycle)
+{
+  MGParameters::isFull3D = true;
+  MGParameters::cycleType = cycle < 2 ? CycleType::FCycle : (cycle == 2 ? CycleType::VCycle : CycleType::WCycle);
+  MGParameters::fmgCycleType = cycle == 1 ? CycleType::WCycle : CycleType::VCycle;
+}
+
+void BM_PoissonSolver3D(benchmark::State& state)
+{
+  const auto& production = getProductionGrid();
+  setCycle(state.range(0));
+  PoissonSolver<DataT>::setNThreads(state.range(1));
+  PoissonSolver<DataT> solver(production.grid);
+  DataContainer potential{NZ, NR, NPHI};
+  for (auto _ : state) {
+    state.PauseTiming();
+    potential = production.boundary;
+    state.ResumeTiming();
+    solver.poissonSolver3D(potential, production.charge, 0);
+    benchmark::DoNotOptimize(potential.getData().data());
+  }
+  state.counters["maxDeviation"] = production.maxDeviation(potential);
+}
+
+void BM_PoissonSolver3DFresh(benchmark::State& state)
+{
+  const auto& production = getProductionGrid();
+  setCycle(state.range(0));
+  PoissonSolver<DataT>::setNThreads(state.range(1));
+  DataContainer potential{NZ, NR, NPHI};
+  for (auto _ : state) {
+    state.PauseTiming();
+    potential = production.boundary;
+    state.ResumeTiming();
+    auto solver = std::make_unique<PoissonSolver<DataT>>(production.grid);
+    solver->poissonSolver3D(potential, production.charge, 0);
+    benchmark::DoNotOptimize(potential.getData().data());
+  }
+  state.counters["maxDeviation"] = production.maxDeviation(potential);
+}
+} // namespace
+
+BENCHMARK(BM_PoissonSolver3D)->ArgsProduct({{0, 1, 2, 3}, {1, 4, 8}})->ArgNames({"cycle", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_PoissonSolver3DFresh)->ArgsProduct({{0}, {1, 4}})->ArgNames({"cycle", "threads"})->Unit(benchmark::kMillisecond)->UseRealTime();
+
+BENCHMARK_MAIN();
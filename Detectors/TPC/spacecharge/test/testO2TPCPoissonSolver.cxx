@@ -243,5 +243,22 @@ BOOST_AUTO_TEST_CASE(PoissonSolver2D_test)
   poissonSolver2D<DataT>();
 }
 
+BOOST_AUTO_TEST_CASE(PoissonSolver3DWCycle_test)
+{
+  o2::tpc::MGParameters::isFull3D = true; // 3D
+  o2::tpc::MGParameters::cycleType = CycleType::WCycle;
+  poissonSolver3D<DataT>();
+  o2::tpc::MGParameters::cycleType = CycleType::FCycle;
+}
+
+BOOST_AUTO_TEST_CASE(PoissonSolver3DFMGWCycle_test)
+{
+  o2::tpc::MGParameters::isFull3D = true; // 3D
+  o2::tpc::MGParameters::cycleType = CycleType::FCycle;
+  o2::tpc::MGParameters::fmgCycleType = CycleType::WCycle; // W cycles on each level of the full multi grid
+  poissonSolver3D<DataT>();
+  o2::tpc::MGParameters::fmgCycleType = CycleType::VCycle;
+}
+
 } // namespace tpc
 } // namespace o2
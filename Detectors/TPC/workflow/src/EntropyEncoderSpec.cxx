@@ -333,6 +333,8 @@ DataProcessorSpec getEntropyEncoderSpec(bool inputFromFile, bool selIR)
             {"irframe-clusters-maxz", VariantType::Float, 25.f, {"Max z for non assigned clusters (combined with maxeta)"}},
             {"mem-factor", VariantType::Float, 1.f, {"Memory allocation margin factor"}},
             {"nThreads-tpc-encoder", VariantType::UInt32, 1u, {"number of threads to use for decoding"}},
+            {"ctf-threads", VariantType::Int, 1, {"number of threads for concurrent encoding of the chunks of large CTF blocks"}},
+            {"ctf-chunked-encoding", VariantType::Bool, false, {"encode large CTF blocks in independently decodable chunks"}},
             {"ans-version", VariantType::String, {"version of ans entropy coder implementation to use"}}}};
 }
 
@@ -128,24 +128,26 @@ o2::ctf::CTFIOSize CTFCoder::encode_impl(VEC& buff, const gsl::span<const BCData
   ec->setANSHeader(mANSVersion);
   // at every encoding the buffer might be autoexpanded, so we don't work with fixed pointer ec
   o2::ctf::CTFIOSize iosize;
-#define ENCODEZDC(beg, end, slot, bits) CTF::get(buff.data())->encode(beg, end, int(slot), bits, optField[int(slot)], &buff, mCoders[int(slot)], getMemMarginFactor());
+  o2::ctf::ParallelBlockEncoder<CTF, VEC> encoder(buff, mNThreads, getMemMarginFactor());
+#define ENCODEZDC(beg, end, slot, bits) encoder.add(beg, end, int(slot), bits, optField[int(slot)], mCoders[int(slot)]);
   // clang-format off
-  iosize += ENCODEZDC(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
-  iosize += ENCODEZDC(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
-  iosize += ENCODEZDC(helper.begin_moduleTrig(),   helper.end_moduleTrig(),    CTF::BLC_moduleTrig,   0);
-  iosize += ENCODEZDC(helper.begin_channelsHL(),   helper.end_channelsHL(),    CTF::BLC_channelsHL,   0);
-  iosize += ENCODEZDC(helper.begin_triggersHL(),   helper.end_triggersHL(),    CTF::BLC_triggersHL,   0);
-  iosize += ENCODEZDC(helper.begin_extTriggers(),  helper.end_extTriggers(),   CTF::BLC_extTriggers,  0);
-  iosize += ENCODEZDC(helper.begin_nchanTrig(),    helper.end_nchanTrig(),     CTF::BLC_nchanTrig,    0);
+  ENCODEZDC(helper.begin_bcIncTrig(),    helper.end_bcIncTrig(),     CTF::BLC_bcIncTrig,    0);
+  ENCODEZDC(helper.begin_orbitIncTrig(), helper.end_orbitIncTrig(),  CTF::BLC_orbitIncTrig, 0);
+  ENCODEZDC(helper.begin_moduleTrig(),   helper.end_moduleTrig(),    CTF::BLC_moduleTrig,   0);
+  ENCODEZDC(helper.begin_channelsHL(),   helper.end_channelsHL(),    CTF::BLC_channelsHL,   0);
+  ENCODEZDC(helper.begin_triggersHL(),   helper.end_triggersHL(),    CTF::BLC_triggersHL,   0);
+  ENCODEZDC(helper.begin_extTriggers(),  helper.end_extTriggers(),   CTF::BLC_extTriggers,  0);
+  ENCODEZDC(helper.begin_nchanTrig(),    helper.end_nchanTrig(),     CTF::BLC_nchanTrig,    0);
   //
-  iosize += ENCODEZDC(helper.begin_chanID(),       helper.end_chanID(),        CTF::BLC_chanID,       0);
-  iosize += ENCODEZDC(helper.begin_chanData(),     helper.end_chanData(),      CTF::BLC_chanData,     0);
+  ENCODEZDC(helper.begin_chanID(),       helper.end_chanID(),        CTF::BLC_chanID,       0);
+  ENCODEZDC(helper.begin_chanData(),     helper.end_chanData(),      CTF::BLC_chanData,     0);
   //
-  iosize += ENCODEZDC(helper.begin_orbitIncEOD(),  helper.end_orbitIncEOD(),   CTF::BLC_orbitIncEOD,  0);
-  iosize += ENCODEZDC(helper.begin_pedData(),      helper.end_pedData(),       CTF::BLC_pedData,      0);
-  iosize += ENCODEZDC(helper.begin_sclInc(),       helper.end_sclInc(),        CTF::BLC_sclInc,       0);
+  ENCODEZDC(helper.begin_orbitIncEOD(),  helper.end_orbitIncEOD(),   CTF::BLC_orbitIncEOD,  0);
+  ENCODEZDC(helper.begin_pedData(),      helper.end_pedData(),       CTF::BLC_pedData,      0);
+  ENCODEZDC(helper.begin_sclInc(),       helper.end_sclInc(),        CTF::BLC_sclInc,       0);
 
   // clang-format on
+  iosize += encoder.encode();
   CTF::get(buff.data())->print(getPrefix(), mVerbosity);
   finaliseCTFOutput<CTF>(buff);
   iosize.rawIn = sizeof(BCData) * trigData.size() + sizeof(ChannelData) * chanData.size() + sizeof(OrbitData) * pedData.size();
@@ -165,23 +167,25 @@ o2::ctf::CTFIOSize CTFCoder::decode(const CTF::base& ec, VTRG& trigVec, VCHAN& c
   std::vector<uint8_t> extTriggers, chanID;
 
   o2::ctf::CTFIOSize iosize;
-#define DECODEZDC(part, slot) ec.decode(part, int(slot), mCoders[int(slot)])
+  o2::ctf::ParallelBlockDecoder<CTF> decoder(ec, mNThreads);
+#define DECODEZDC(part, slot) decoder.add(part, int(slot), mCoders[int(slot)])
   // clang-format off
-  iosize += DECODEZDC(bcIncTrig,      CTF::BLC_bcIncTrig);
-  iosize += DECODEZDC(orbitIncTrig,   CTF::BLC_orbitIncTrig);
-  iosize += DECODEZDC(moduleTrig,     CTF::BLC_moduleTrig);
-  iosize += DECODEZDC(channelsHL,     CTF::BLC_channelsHL);
-  iosize += DECODEZDC(triggersHL,     CTF::BLC_triggersHL);
-  iosize += DECODEZDC(extTriggers,    CTF::BLC_extTriggers);
-  iosize += DECODEZDC(nchanTrig,      CTF::BLC_nchanTrig);
+  DECODEZDC(bcIncTrig,      CTF::BLC_bcIncTrig);
+  DECODEZDC(orbitIncTrig,   CTF::BLC_orbitIncTrig);
+  DECODEZDC(moduleTrig,     CTF::BLC_moduleTrig);
+  DECODEZDC(channelsHL,     CTF::BLC_channelsHL);
+  DECODEZDC(triggersHL,     CTF::BLC_triggersHL);
+  DECODEZDC(extTriggers,    CTF::BLC_extTriggers);
+  DECODEZDC(nchanTrig,      CTF::BLC_nchanTrig);
   //
-  iosize += DECODEZDC(chanID,         CTF::BLC_chanID);
-  iosize += DECODEZDC(chanData,       CTF::BLC_chanData);
+  DECODEZDC(chanID,         CTF::BLC_chanID);
+  DECODEZDC(chanData,       CTF::BLC_chanData);
   //
-  iosize += DECODEZDC(orbitIncEOD,    CTF::BLC_orbitIncEOD);
-  iosize += DECODEZDC(pedData,        CTF::BLC_pedData);
-  iosize += DECODEZDC(scalerInc,      CTF::BLC_sclInc);
+  DECODEZDC(orbitIncEOD,    CTF::BLC_orbitIncEOD);
+  DECODEZDC(pedData,        CTF::BLC_pedData);
+  DECODEZDC(scalerInc,      CTF::BLC_sclInc);
   // clang-format on
+  iosize += decoder.decode();
   //
   trigVec.clear();
   chanVec.clear();
@@ -9,9 +9,14 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 
+#include <algorithm>
 #include <map>
 #include <list>
+#include <deque>
 #include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 #include <getopt.h>
 
 #include "TSystem.h"
@@ -24,10 +29,236 @@
 #include <TGrid.h>
 #include <TMap.h>
 #include <TLeaf.h>
+#include <TBranch.h>
+#include <TROOT.h>
 
 #include "aodMerger.h"
 #include <cinttypes>
 
+// The input files are opened and their dataframes are read by reader threads, while the main
+// thread merges them in the order of the input list. The trees of a dataframe are loaded into
+// memory, which decompresses their baskets, unless they are large and have no index to shift
+// (these are fast copied). At most maxInflightDFs dataframes are loaded but not yet merged,
+// except for the file which is merged at the moment, which is always read.
+struct InputDF {
+  std::string name;
+  std::vector<TTree*> trees;
+  bool duplicateKeys = false; // a key with a higher cycle than the one before it was found
+};
+
+struct InputFile {
+  TString name;
+  TFile* file = nullptr;
+  TMap* metaData = nullptr;
+  TMap* parentFiles = nullptr;
+  bool opened = false; // file is set or could not be opened
+  bool done = false;   // all dataframes are read
+  std::deque<InputDF> dfs;
+  std::mutex io; // the reader thread and the merging must not access the file at the same time
+};
+
+class InputReader
+{
+ public:
+  InputReader(std::vector<TString> const& names, int nThreads, int maxInflightDFs, bool readParentFiles)
+    : mFiles(names.size()), mMaxInflightDFs(maxInflightDFs), mReadParentFiles(readParentFiles)
+  {
+    for (size_t i = 0; i < names.size(); ++i) {
+      mFiles[i].name = names[i];
+    }
+    for (int i = 0; i < nThreads; ++i) {
+      mThreads.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~InputReader()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mCond.notify_all();
+    for (auto& t : mThreads) {
+      t.join();
+    }
+  }
+
+  // wait until the file @a i is opened and make it the one being merged
+  InputFile& waitForFile(int i)
+  {
+    std::unique_lock<std::mutex> lock(mMutex);
+    mCurrentFile = i;
+    mCond.notify_all();
+    mCond.wait(lock, [this, i]() { return mFiles[i].opened; });
+    return mFiles[i];
+  }
+
+  // the next dataframe of file @a i, false if all are merged
+  bool nextDF(int i, InputDF& df)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mMutex);
+      auto& in = mFiles[i];
+      mCond.wait(lock, [&in]() { return !in.dfs.empty() || in.done; });
+      if (in.dfs.empty()) {
+        return false;
+      }
+      df = std::move(in.dfs.front());
+      in.dfs.pop_front();
+    }
+    // the reader of this file may be waiting for its queue to be empty
+    mCond.notify_all();
+    return true;
+  }
+
+  // a dataframe returned by nextDF is merged
+  void releaseDF()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      --mInflightDFs;
+    }
+    mCond.notify_all();
+  }
+
+ private:
+  void work()
+  {
+    while (true) {
+      int i = 0;
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mStop || mNextFile >= (int)mFiles.size()) {
+          return;
+        }
+        i = mNextFile++;
+      }
+      readFile(mFiles[i], i);
+    }
+  }
+
+  void setOpened(InputFile& in, bool done)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      in.opened = true;
+      in.done = done;
+    }
+    mCond.notify_all();
+  }
+
+  void readFile(InputFile& in, int index)
+  {
+    std::unique_lock<std::mutex> ioLock(in.io);
+    in.file = TFile::Open(in.name);
+    if (!in.file || in.file->IsZombie()) {
+      setOpened(in, true);
+      return;
+    }
+    TList* keyList = in.file->GetListOfKeys();
+    keyList->Sort();
+    std::vector<std::string> dfNames;
+    for (auto key1 : *keyList) {
+      if (((TObjString*)key1)->GetString().EqualTo("metaData")) {
+        in.metaData = (TMap*)in.file->Get("metaData");
+      }
+      if (((TObjString*)key1)->GetString().EqualTo("parentFiles") && mReadParentFiles) {
+        in.parentFiles = (TMap*)in.file->Get("parentFiles");
+      }
+      if (((TObjString*)key1)->GetString().BeginsWith("DF_")) {
+        dfNames.emplace_back(((TObjString*)key1)->GetString().Data());
+      }
+    }
+    ioLock.unlock();
+    setOpened(in, false);
+
+    for (auto& dfName : dfNames) {
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        // the file being merged bypasses the limit only while the merging waits for its next dataframe
+        mCond.wait(lock, [this, index]() { return mStop || mInflightDFs < mMaxInflightDFs || (index == mCurrentFile && mFiles[index].dfs.empty()); });
+        if (mStop) {
+          return;
+        }
+        ++mInflightDFs;
+      }
+
+      ioLock.lock();
+      InputDF df;
+      df.name = dfName;
+      auto folder = (TDirectoryFile*)in.file->Get(df.name.c_str());
+      auto treeList = folder->GetListOfKeys();
+
+      treeList->Sort();
+
+      // purging keys from duplicates
+      for (auto i = 0; i < treeList->GetEntries(); ++i) {
+        TKey* ki = (TKey*)treeList->At(i);
+        for (int j = i + 1; j < treeList->GetEntries(); ++j) {
+          TKey* kj = (TKey*)treeList->At(j);
+          if (std::strcmp(ki->GetName(), kj->GetName()) == 0 && std::strcmp(ki->GetTitle(), kj->GetTitle()) == 0) {
+            if (ki->GetCycle() < kj->GetCycle()) {
+              df.duplicateKeys = true;
+            } else {
+              // key is a duplicate, let's remove it
+              treeList->Remove(kj);
+              j--;
+            }
+          } else {
+            // we changed key, since they are sorted, we won't have the same anymore
+            break;
+          }
+        }
+      }
+
+      for (auto key2 : *treeList) {
+        auto tree = (TTree*)in.file->Get(Form("%s/%s", df.name.c_str(), ((TObjString*)key2)->GetString().Data()));
+        bool fastCopy = (tree->GetTotBytes() > 10000000);
+        if (!fastCopy || hasIndex(tree)) {
+          tree->LoadBaskets();
+        }
+        df.trees.push_back(tree);
+      }
+      ioLock.unlock();
+
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        in.dfs.push_back(std::move(df));
+      }
+      mCond.notify_all();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      in.done = true;
+    }
+    mCond.notify_all();
+  }
+
+  static bool hasIndex(TTree* tree)
+  {
+    TObjArray* branches = tree->GetListOfBranches();
+    for (int i = 0; i < branches->GetEntriesFast(); ++i) {
+      TString branchName(((TBranch*)branches->UncheckedAt(i))->GetName());
+      if (branchName.BeginsWith("fIndex") && !branchName.EndsWith("_size")) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::vector<InputFile> mFiles;
+  std::vector<std::thread> mThreads;
+  std::mutex mMutex;
+  std::condition_variable mCond;
+  int mNextFile = 0;
+  int mCurrentFile = 0;
+  int mInflightDFs = 0;
+  int mMaxInflightDFs;
+  bool mReadParentFiles;
+  bool mStop = false;
+};
+
 // AOD merger with correct index rewriting
 // No need to know the datamodel because the branch names follow a canonical standard (identified by fIndex)
 int main(int argc, char* argv[])
@@ -40,6 +271,8 @@ int main(int argc, char* argv[])
   int verbosity = 2;
   int exitCode = 0; // 0: success, >0: failure
   int compression = 505;
+  int nThreads = 2;
+  int maxInflightDFs = 4;
 
   int option_index = 0;
   static struct option long_options[] = {
@@ -49,6 +282,8 @@ int main(int argc, char* argv[])
     {"skip-non-existing-files", no_argument, nullptr, 3},
     {"skip-parent-files-list", no_argument, nullptr, 4},
     {"compression", required_argument, nullptr, 5},
+    {"threads", required_argument, nullptr, 6},
+    {"max-inflight-dfs", required_argument, nullptr, 7},
     {"verbosity", required_argument, nullptr, 'v'},
     {"help", no_argument, nullptr, 'h'},
     {nullptr, 0, nullptr, 0}};
@@ -69,6 +304,10 @@ int main(int argc, char* argv[])
       skipParentFilesList = true;
     } else if (c == 5) {
       compression = atoi(optarg);
+    } else if (c == 6) {
+      nThreads = std::max(atoi(optarg), 1);
+    } else if (c == 7) {
+      maxInflightDFs = std::max(atoi(optarg), 1);
     } else if (c == 'v') {
       verbosity = atoi(optarg);
     } else if (c == 'h') {
@@ -79,6 +318,8 @@ int main(int argc, char* argv[])
       printf("  --skip-non-existing-files    Flag to allow skipping of non-existing files in the input list.\n");
       printf("  --skip-parent-files-list     Flag to allow skipping the merging of the parent files list.\n");
       printf("  --compression <root compression id>  Compression algorithm / level to use (default: %d)\n", compression);
+      printf("  --threads <n>                Number of threads reading the input files. Default: %d\n", nThreads);
+      printf("  --max-inflight-dfs <n>       Maximum number of DFs read but not yet merged. Default: %d\n", maxInflightDFs);
       printf("  --verbosity <flag>           Verbosity of output (default: %d).\n", verbosity);
       return -1;
     } else {
@@ -90,6 +331,7 @@ int main(int argc, char* argv[])
   printf("  Input file: %s\n", inputCollection.c_str());
   printf("  Output file name: %s\n", outputFileName.c_str());
   printf("  Maximal folder size (uncompressed): %ld\n", maxDirSize);
+  printf("  Reading threads: %d, maximal DFs in flight: %d\n", nThreads, maxInflightDFs);
   if (skipNonExistingFiles) {
     printf("  WARNING: Skipping non-existing files.\n");
   }
@@ -107,12 +349,9 @@ int main(int argc, char* argv[])
   std::ifstream in;
   in.open(inputCollection);
   TString line;
+  std::vector<TString> inputFiles;
   bool connectedToAliEn = false;
-  TMap* metaData = nullptr;
-  TMap* parentFiles = nullptr;
-  int totalMergedDFs = 0;
-  int mergedDFs = 0;
-  while (in.good() && exitCode == 0) {
+  while (in.good()) {
     in >> line;
 
     if (line.Length() == 0) {
@@ -124,12 +363,23 @@ int main(int argc, char* argv[])
       TGrid::Connect("alien:");
       connectedToAliEn = true; // Only try once
     }
+    inputFiles.emplace_back(line);
+  }
 
-    printf("Processing input file: %s\n", line.Data());
+  ROOT::EnableThreadSafety();
+  InputReader reader(inputFiles, nThreads, maxInflightDFs, !skipParentFilesList);
+
+  TMap* metaData = nullptr;
+  TMap* parentFiles = nullptr;
+  int totalMergedDFs = 0;
+  int mergedDFs = 0;
+  for (int ifile = 0; ifile < (int)inputFiles.size() && exitCode == 0; ++ifile) {
+    printf("Processing input file: %s\n", inputFiles[ifile].Data());
 
-    auto inputFile = TFile::Open(line);
+    auto& input = reader.waitForFile(ifile);
+    auto inputFile = input.file;
     if (!inputFile || inputFile->IsZombie()) {
-      printf("Error: %s input file %s.\n", !inputFile ? "Could not open" : "Zombie", line.Data());
+      printf("Error: %s input file %s.\n", !inputFile ? "Could not open" : "Zombie", inputFiles[ifile].Data());
       if (skipNonExistingFiles) {
         continue;
       } else {
@@ -139,93 +389,67 @@ int main(int argc, char* argv[])
       }
     }
 
-    TList* keyList = inputFile->GetListOfKeys();
-    keyList->Sort();
-
-    for (auto key1 : *keyList) {
-      if (((TObjString*)key1)->GetString().EqualTo("metaData")) {
-        auto metaDataCurrentFile = (TMap*)inputFile->Get("metaData");
-        if (metaData == nullptr) {
-          metaData = metaDataCurrentFile;
-          outputFile->cd();
-          metaData->Write("metaData", TObject::kSingleKey);
-        } else {
-          for (auto metaDataPair : *metaData) {
-            auto metaDataKey = ((TPair*)metaDataPair)->Key();
-            if (metaDataCurrentFile->Contains(((TObjString*)metaDataKey)->GetString())) {
-              auto value = (TObjString*)metaData->GetValue(((TObjString*)metaDataKey)->GetString());
-              auto valueCurrentFile = (TObjString*)metaDataCurrentFile->GetValue(((TObjString*)metaDataKey)->GetString());
-              if (!value->GetString().EqualTo(valueCurrentFile->GetString())) {
-                printf("WARNING: Metadata differs between input files. Key %s : %s vs. %s\n", ((TObjString*)metaDataKey)->GetString().Data(),
-                       value->GetString().Data(), valueCurrentFile->GetString().Data());
-              }
-            } else {
-              printf("WARNING: Metadata differs between input files. Key %s is not present in current file\n", ((TObjString*)metaDataKey)->GetString().Data());
+    if (input.metaData) {
+      auto metaDataCurrentFile = input.metaData;
+      if (metaData == nullptr) {
+        metaData = metaDataCurrentFile;
+        outputFile->cd();
+        metaData->Write("metaData", TObject::kSingleKey);
+      } else {
+        for (auto metaDataPair : *metaData) {
+          auto metaDataKey = ((TPair*)metaDataPair)->Key();
+          if (metaDataCurrentFile->Contains(((TObjString*)metaDataKey)->GetString())) {
+            auto value = (TObjString*)metaData->GetValue(((TObjString*)metaDataKey)->GetString());
+            auto valueCurrentFile = (TObjString*)metaDataCurrentFile->GetValue(((TObjString*)metaDataKey)->GetString());
+            if (!value->GetString().EqualTo(valueCurrentFile->GetString())) {
+              printf("WARNING: Metadata differs between input files. Key %s : %s vs. %s\n", ((TObjString*)metaDataKey)->GetString().Data(),
+                     value->GetString().Data(), valueCurrentFile->GetString().Data());
             }
+          } else {
+            printf("WARNING: Metadata differs between input files. Key %s is not present in current file\n", ((TObjString*)metaDataKey)->GetString().Data());
           }
         }
       }
+    }
 
-      if (((TObjString*)key1)->GetString().EqualTo("parentFiles") && !skipParentFilesList) {
-        auto parentFilesCurrentFile = (TMap*)inputFile->Get("parentFiles");
-        if (parentFiles == nullptr) {
-          parentFiles = new TMap;
-        }
-        for (auto pair : *parentFilesCurrentFile) {
-          parentFiles->Add(((TPair*)pair)->Key(), ((TPair*)pair)->Value());
-        }
-        delete parentFilesCurrentFile;
+    if (input.parentFiles) {
+      auto parentFilesCurrentFile = input.parentFiles;
+      if (parentFiles == nullptr) {
+        parentFiles = new TMap;
       }
-
-      if (!((TObjString*)key1)->GetString().BeginsWith("DF_")) {
-        continue;
+      for (auto pair : *parentFilesCurrentFile) {
+        parentFiles->Add(((TPair*)pair)->Key(), ((TPair*)pair)->Value());
       }
+      delete parentFilesCurrentFile;
+    }
 
-      auto dfName = ((TObjString*)key1)->GetString().Data();
+    InputDF df;
+    while (reader.nextDF(ifile, df)) {
+      std::unique_lock<std::mutex> ioLock(input.io);
+      auto dfName = df.name.c_str();
 
       if (verbosity > 0) {
         printf("  Processing folder %s\n", dfName);
       }
       ++mergedDFs;
       ++totalMergedDFs;
-      auto folder = (TDirectoryFile*)inputFile->Get(dfName);
-      auto treeList = folder->GetListOfKeys();
-
-      treeList->Sort();
-
-      // purging keys from duplicates
-      for (auto i = 0; i < treeList->GetEntries(); ++i) {
-        TKey* ki = (TKey*)treeList->At(i);
-        for (int j = i + 1; j < treeList->GetEntries(); ++j) {
-          TKey* kj = (TKey*)treeList->At(j);
-          if (std::strcmp(ki->GetName(), kj->GetName()) == 0 && std::strcmp(ki->GetTitle(), kj->GetTitle()) == 0) {
-            if (ki->GetCycle() < kj->GetCycle()) {
-              printf("    *** FATAL *** we had ordered the keys, first cycle should be higher, please check");
-              exitCode = 5;
-            } else {
-              // key is a duplicate, let's remove it
-              treeList->Remove(kj);
-              j--;
-            }
-          } else {
-            // we changed key, since they are sorted, we won't have the same anymore
-            break;
-          }
-        }
+      if (df.duplicateKeys) {
+        printf("    *** FATAL *** we had ordered the keys, first cycle should be higher, please check");
+        exitCode = 5;
       }
 
       std::list<std::string> foundTrees;
 
-      for (auto key2 : *treeList) {
-        auto treeName = ((TObjString*)key2)->GetString().Data();
+      for (auto inputTree : df.trees) {
+        auto treeName = inputTree->GetName();
         bool found = (std::find(foundTrees.begin(), foundTrees.end(), treeName) != foundTrees.end());
         if (found == true) {
           printf("    ***WARNING*** Tree %s was already merged (even if we purged duplicated trees before, so this should not happen), skipping\n", treeName);
+          delete inputTree;
           continue;
         }
         foundTrees.push_back(treeName);
 
-        auto inputTree = (TTree*)inputFile->Get(Form("%s/%s", dfName, treeName));
         bool fastCopy = (inputTree->GetTotBytes() > 10000000); // Only do this for large enough trees to avoid that baskets are too small
         if (verbosity > 1) {
           printf("    Processing tree %s with %lld entries with total size %lld (fast copy: %d)\n", treeName, inputTree->GetEntries(), inputTree->GetTotBytes(), fastCopy);
@@ -357,6 +581,8 @@ int main(int argc, char* argv[])
           delete[] buffer;
         }
       }
+      ioLock.unlock();
+      reader.releaseDF();
       if (exitCode > 0) {
         break;
       }
@@ -414,7 +640,11 @@ int main(int argc, char* argv[])
         mergedDFs = 0;
       }
     }
-    inputFile->Close();
+    // when aborting, the reading of the file may not be finished
+    if (exitCode == 0) {
+      inputFile->Close();
+      delete inputFile;
+    }
   }
 
   if (parentFiles) {
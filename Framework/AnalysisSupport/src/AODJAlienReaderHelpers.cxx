@@ -12,6 +12,7 @@
 #include "AODJAlienReaderHelpers.h"
 #include "Framework/TableTreeHelpers.h"
 #include "Framework/AnalysisHelpers.h"
+#include "Framework/AnalysisSupportHelpers.h"
 #include "Framework/DataProcessingStats.h"
 #include "Framework/RootTableBuilderHelpers.h"
 #include "Framework/AlgorithmSpec.h"
@@ -34,8 +35,13 @@
 #include <TGrid.h>
 #include <TFile.h>
 #include <TTreeCache.h>
+#include <TTreeCacheUnzip.h>
+#include <TROOT.h>
 #include <TSystem.h>
 
+#include <map>
+#include <set>
+
 #include <arrow/ipc/reader.h>
 #include <arrow/ipc/writer.h>
 #include <arrow/io/interfaces.h>
@@ -152,6 +158,19 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
 
     auto maxRate = options.get<float>("aod-max-io-rate");
 
+    // the next dataframe can be read in the background while the current one is processed
+    auto readAhead = options.get<bool>("aod-read-ahead");
+    if (readAhead) {
+      ROOT::EnableThreadSafety();
+    }
+    // parallel decompression of the baskets in the tree caches
+    auto unzipThreads = options.get<int>("aod-unzip-threads");
+    if (unzipThreads > 0) {
+      ROOT::EnableImplicitMT(unzipThreads);
+      TTreeCacheUnzip::SetParallelUnzip(TTreeCacheUnzip::kEnable);
+      LOGP(info, "Decompressing the baskets with {} threads", unzipThreads);
+    }
+
     // create a DataInputDirector
     auto didir = std::make_shared<DataInputDirector>(filename, &monitoring, parentAccessLevel, parentFileReplacement);
     if (options.isSet("aod-reader-json")) {
@@ -161,6 +180,13 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
       }
     }
 
+    // columns to read for the tables of which all consumers declare the columns they use
+    auto projections = std::make_shared<std::map<std::string, std::set<std::string>>>(
+      AnalysisSupportHelpers::parseColumnProjections(options.isSet("aod-reader-columns") ? options.get<std::string>("aod-reader-columns") : ""));
+    for (auto& [table, columns] : *projections) {
+      LOGP(info, "Reading only {} declared columns (and the index columns) of {}", columns.size(), table);
+    }
+
     // get the run time watchdog
     auto* watchdog = new RuntimeWatchdog(options.get<int64_t>("time-limit"));
 
@@ -195,7 +221,8 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
                            numTF,
                            watchdog,
                            maxRate,
-                           didir, reportTFN, reportTFFileName](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
+                           readAhead,
+                           didir, projections, reportTFN, reportTFFileName](Monitoring& monitoring, DataAllocator& outputs, ControlService& control, DeviceSpec const& device) {
       // Each parallel reader device.inputTimesliceId reads the files fileCounter*device.maxInputTimeslices+device.inputTimesliceId
       // the TF to read is numTF
       assert(device.inputTimesliceId < device.maxInputTimeslices);
@@ -235,8 +262,10 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
         // create header
         auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
         auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
+        auto projection = projections->find(DataSpecUtils::describe(route.matcher));
+        auto columns = projection != projections->end() ? &projection->second : nullptr;
 
-        if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed)) {
+        if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed, columns)) {
           if (first) {
             // check if there is a next file to read
             fcnt += device.maxInputTimeslices;
@@ -250,7 +279,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
             }
             // get first folder of next file
             ntf = 0;
-            if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed)) {
+            if (!didir->readTree(outputs, dh, fcnt, ntf, totalSizeCompressed, totalSizeUncompressed, columns)) {
               LOGP(fatal, "Can not retrieve tree for table {}: fileCounter {}, timeFrame {}", concrete.origin.as<std::string>(), fcnt, ntf);
               throw std::runtime_error("Processing is stopped!");
             }
@@ -271,14 +300,7 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
           if (reportTFFileName) {
             // Origin file name for derived output map
             auto o2 = Output(TFFileNameHeader);
-            auto fileAndFolder = didir->getFileFolder(dh, fcnt, ntf);
-            std::string currentFilename(fileAndFolder.file->GetName());
-            if (strcmp(fileAndFolder.file->GetEndpointUrl()->GetProtocol(), "file") == 0 && fileAndFolder.file->GetEndpointUrl()->GetFile()[0] != '/') {
-              // This is not an absolute local path. Make it absolute.
-              static std::string pwd = gSystem->pwd() + std::string("/");
-              currentFilename = pwd + std::string(fileAndFolder.file->GetName());
-            }
-            outputs.make<std::string>(o2) = currentFilename;
+            outputs.make<std::string>(o2) = didir->getFileName(dh, fcnt);
           }
         }
         first = false;
@@ -299,6 +321,9 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
       monitoring.send(Metric{(uint64_t)totalDFSent, "df-sent"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeUncompressed / 1000, "aod-bytes-read-uncompressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
       monitoring.send(Metric{(uint64_t)totalSizeCompressed / 1000, "aod-bytes-read-compressed"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      if (readAhead) {
+        monitoring.send(Metric{didir->getReadAheadStallTime() / 1000000, "aod-read-ahead-stall-ms"}.addTag(Key::Subsystem, monitoring::tags::Value::DPL));
+      }
 
       // save file number and time frame
       *fileCounter = (fcnt - device.inputTimesliceId) / device.maxInputTimeslices;
@@ -311,8 +336,8 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
       auto& firstRoute = requestedTables.front();
       auto concrete = DataSpecUtils::asConcreteDataMatcher(firstRoute.matcher);
       auto dh = header::DataHeader(concrete.description, concrete.origin, concrete.subSpec);
-      auto fileAndFolder = didir->getFileFolder(dh, fcnt, ntf);
-      if (!fileAndFolder.file) {
+      bool sameFile = didir->hasTimeFrame(dh, fcnt, ntf);
+      if (!sameFile) {
         fcnt += 1;
         ntf = 0;
         if (didir->atEnd(fcnt)) {
@@ -324,6 +349,23 @@ AlgorithmSpec AODJAlienReaderHelpers::rootFileReaderCallback(ConfigContext const
           return;
         }
       }
+
+      // Read the next dataframe of the same file in the background. The first dataframe
+      // of a file is read when it is requested, since switching files is done by the
+      // DataInputDescriptors while reading.
+      if (readAhead && sameFile) {
+        std::vector<std::pair<header::DataHeader, std::set<std::string> const*>> tables;
+        for (auto& route : requestedTables) {
+          if ((device.inputTimesliceId % route.maxTimeslices) != route.timeslice) {
+            continue;
+          }
+          auto concrete = DataSpecUtils::asConcreteDataMatcher(route.matcher);
+          auto projection = projections->find(DataSpecUtils::describe(route.matcher));
+          tables.emplace_back(header::DataHeader(concrete.description, concrete.origin, concrete.subSpec),
+                              projection != projections->end() ? &projection->second : nullptr);
+        }
+        didir->startReadAhead(tables, fcnt, ntf);
+      }
     });
   })};
 
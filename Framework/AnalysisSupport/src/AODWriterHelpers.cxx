@@ -21,6 +21,8 @@
 #include "Framework/TableConsumer.h"
 #include "Framework/DataOutputDirector.h"
 #include "Framework/TableTreeHelpers.h"
+#include "Framework/ArrowIPCHelpers.h"
+#include "Framework/RuntimeError.h"
 
 #include <TFile.h>
 #include <TFile.h>
@@ -28,6 +30,7 @@
 #include <TMap.h>
 #include <TObjString.h>
 #include <arrow/table.h>
+#include <arrow/util/key_value_metadata.h>
 
 namespace o2::framework::writers
 {
@@ -59,7 +62,20 @@ AlgorithmSpec AODWriterHelpers::getOutputTTreeWriter(ConfigContext const& ctx)
   if (ctx.options().hasOption("aod-writer-compression")) {
     compressionLevel = ctx.options().get<int>("aod-writer-compression");
   }
-  return AlgorithmSpec{[dod, outputInputs = ac.outputsInputsAOD, compressionLevel](InitContext& ic) -> std::function<void(ProcessingContext&)> {
+  // the tables are written either as TTrees or as Arrow IPC files
+  bool arrowFormat = false;
+  std::string arrowCodec = "zstd";
+  if (ctx.options().isSet("aod-writer-format")) {
+    auto format = ctx.options().get<std::string>("aod-writer-format");
+    if (format != "root" && format != "arrow") {
+      throw runtime_error_f("Unknown AOD writer format %s, use root or arrow", format.c_str());
+    }
+    arrowFormat = format == "arrow";
+  }
+  if (ctx.options().isSet("aod-writer-arrow-codec")) {
+    arrowCodec = ctx.options().get<std::string>("aod-writer-arrow-codec");
+  }
+  return AlgorithmSpec{[dod, outputInputs = ac.outputsInputsAOD, compressionLevel, arrowFormat, arrowCodec](InitContext& ic) -> std::function<void(ProcessingContext&)> {
     LOGP(debug, "======== getGlobalAODSink::Init ==========");
 
     // find out if any table needs to be saved
@@ -101,7 +117,7 @@ AlgorithmSpec AODWriterHelpers::getOutputTTreeWriter(ConfigContext const& ctx)
     std::vector<TString> aodMetaDataVals;
 
     // this functor is called once per time frame
-    return [dod, tfNumbers, tfFilenames, aodMetaDataKeys, aodMetaDataVals, compressionLevel](ProcessingContext& pc) mutable -> void {
+    return [dod, tfNumbers, tfFilenames, aodMetaDataKeys, aodMetaDataVals, compressionLevel, arrowFormat, arrowCodec](ProcessingContext& pc) mutable -> void {
       LOGP(debug, "======== getGlobalAODSink::processing ==========");
       LOGP(debug, " processing data set with {} entries", pc.inputs().size());
 
@@ -194,6 +210,34 @@ AlgorithmSpec AODWriterHelpers::getOutputTTreeWriter(ConfigContext const& ctx)
         // loop over all DataOutputDescriptors
         // a table can be saved in multiple ways
         // e.g. different selections of columns to different files
+        if (arrowFormat) {
+          // one Arrow IPC file per table and time frame, time frames are not merged
+          std::shared_ptr<arrow::KeyValueMetadata> metadata;
+          if (!aodMetaDataKeys.empty() && aodMetaDataKeys.size() == aodMetaDataVals.size()) {
+            metadata = std::make_shared<arrow::KeyValueMetadata>();
+            for (uint32_t imd = 0; imd < aodMetaDataKeys.size(); imd++) {
+              metadata->Append(aodMetaDataKeys[imd].Data(), aodMetaDataVals[imd].Data());
+            }
+          }
+          for (auto d : ds) {
+            auto toWrite = table;
+            if (!d->colnames.empty()) {
+              std::vector<int> indices;
+              for (auto& cn : d->colnames) {
+                auto idx = table->schema()->GetFieldIndex(cn);
+                if (idx != -1) {
+                  indices.push_back(idx);
+                }
+              }
+              toWrite = table->SelectColumns(indices).ValueOrDie();
+            }
+            if (metadata) {
+              toWrite = toWrite->ReplaceSchemaMetadata(metadata);
+            }
+            ArrowIPCHelpers::writeTable(toWrite, dod->getArrowFileName(d, it->second), arrowCodec);
+          }
+          continue;
+        }
         for (auto d : ds) {
           auto fileAndFolder = dod->getFileFolder(d, tfNumber, aodInputFile, compressionLevel);
           auto treename = fileAndFolder.folderName + "/" + d->treename;
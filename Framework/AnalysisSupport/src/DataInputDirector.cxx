@@ -15,6 +15,7 @@
 #include "Framework/Output.h"
 #include "Headers/DataHeader.h"
 #include "Framework/TableTreeHelpers.h"
+#include "Framework/ArrowIPCHelpers.h"
 #include "Monitoring/Tags.h"
 #include "Monitoring/Metric.h"
 #include "Monitoring/Monitoring.h"
@@ -26,8 +27,16 @@
 #include "TGrid.h"
 #include "TObjString.h"
 #include "TMap.h"
+#include "TSystem.h"
+
+#include <arrow/table.h>
+#include <arrow/util/byte_size.h>
+#include <fmt/ranges.h>
 
 #include <uv.h>
+#include <filesystem>
+#include <future>
+#include <mutex>
 
 #if __has_include(<TJAlienFile.h>)
 #include <TJAlienFile.h>
@@ -114,14 +123,26 @@ bool DataInputDescriptor::setFile(int counter)
     }
     closeInputFile();
   }
-  mcurrentFile = TFile::Open(filename.c_str());
-  if (!mcurrentFile) {
-    throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", filename));
+  if (!mcurrentDirectory.empty()) {
+    if (mcurrentDirectory == filename) {
+      return true;
+    }
+    closeInputFile();
   }
-  mcurrentFile->SetReadaheadSize(50 * 1024 * 1024);
+  std::error_code ec;
+  if (std::filesystem::is_directory(filename, ec)) {
+    // output of the AOD writer in arrow format, the tables are in DF_<n>/<treename>.arrow
+    mcurrentDirectory = filename;
+  } else {
+    mcurrentFile = TFile::Open(filename.c_str());
+    if (!mcurrentFile) {
+      throw std::runtime_error(fmt::format("Couldn't open file \"{}\"!", filename));
+    }
+    mcurrentFile->SetReadaheadSize(50 * 1024 * 1024);
 
-  // get the parent file map if exists
-  mParentFileMap = (TMap*)mcurrentFile->Get("parentFiles"); // folder name (DF_XXX) --> parent file (absolute path)
+    // get the parent file map if exists
+    mParentFileMap = (TMap*)mcurrentFile->Get("parentFiles"); // folder name (DF_XXX) --> parent file (absolute path)
+  }
   if (mParentFileMap && !mParentFileReplacement.empty()) {
     auto pos = mParentFileReplacement.find(';');
     if (pos == std::string::npos) {
@@ -141,13 +162,22 @@ bool DataInputDescriptor::setFile(int counter)
   // get the directory names
   if (mfilenames[counter]->numberOfTimeFrames <= 0) {
     std::regex TFRegex = std::regex("DF_[0-9]+");
-    TList* keyList = mcurrentFile->GetListOfKeys();
 
     // extract TF numbers and sort accordingly
-    for (auto key : *keyList) {
-      if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
-        auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
-        mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
+    if (!mcurrentDirectory.empty()) {
+      for (auto const& entry : std::filesystem::directory_iterator(mcurrentDirectory)) {
+        auto folderName = entry.path().filename().string();
+        if (entry.is_directory() && std::regex_match(folderName, TFRegex)) {
+          mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(std::stoul(folderName.substr(3)));
+        }
+      }
+    } else {
+      TList* keyList = mcurrentFile->GetListOfKeys();
+      for (auto key : *keyList) {
+        if (std::regex_match(((TObjString*)key)->GetString().Data(), TFRegex)) {
+          auto folderNumber = std::stoul(std::string(((TObjString*)key)->GetString().Data()).substr(3));
+          mfilenames[counter]->listOfTimeFrameNumbers.emplace_back(folderNumber);
+        }
       }
     }
     if (mParentFileMap != nullptr) {
@@ -215,6 +245,31 @@ FileAndFolder DataInputDescriptor::getFileFolder(int counter, int numTF)
   return fileAndFolder;
 }
 
+bool DataInputDescriptor::hasTimeFrame(int counter, int numTF)
+{
+  if (!setFile(counter)) {
+    return false;
+  }
+  return numTF < mfilenames[counter]->numberOfTimeFrames;
+}
+
+std::string DataInputDescriptor::getFileName(int counter)
+{
+  if (!setFile(counter)) {
+    return "";
+  }
+  if (!mcurrentDirectory.empty()) {
+    return std::filesystem::absolute(mcurrentDirectory).string();
+  }
+  std::string currentFilename(mcurrentFile->GetName());
+  if (strcmp(mcurrentFile->GetEndpointUrl()->GetProtocol(), "file") == 0 && mcurrentFile->GetEndpointUrl()->GetFile()[0] != '/') {
+    // This is not an absolute local path. Make it absolute.
+    static std::string pwd = gSystem->pwd() + std::string("/");
+    currentFilename = pwd + currentFilename;
+  }
+  return currentFilename;
+}
+
 DataInputDescriptor* DataInputDescriptor::getParentFile(int counter, int numTF, std::string treename)
 {
   if (!mParentFileMap) {
@@ -285,6 +340,10 @@ void DataInputDescriptor::printFileStatistics()
 
 void DataInputDescriptor::closeInputFile()
 {
+  if (!mcurrentDirectory.empty()) {
+    LOGP(info, "Read info: dir={},total_df={},read_df={},io_time={:.1f}", mcurrentDirectory, getTimeFramesInFile(mCurrentFileID), getReadTimeFramesInFile(mCurrentFileID), ((float)mIOTime / 1e9));
+    mcurrentDirectory.clear();
+  }
   if (mcurrentFile) {
     if (mParentFile) {
       mParentFile->closeInputFile();
@@ -354,13 +413,11 @@ int DataInputDescriptor::findDFNumber(int file, std::string dfName)
   return it - dfList.begin();
 }
 
-bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+std::pair<TTree*, DataInputDescriptor*> DataInputDescriptor::getTree(int counter, int numTF, std::string const& treename)
 {
-  auto ioStart = uv_hrtime();
-
   auto fileAndFolder = getFileFolder(counter, numTF);
   if (!fileAndFolder.file) {
-    return false;
+    return {nullptr, nullptr};
   }
 
   auto fullpath = fileAndFolder.folderName + "/" + treename;
@@ -375,29 +432,120 @@ bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh
         throw std::runtime_error(fmt::format(R"(DF {} listed in parent file map but not found in the corresponding file "{}")", fileAndFolder.folderName, parentFile->mcurrentFile->GetName()));
       }
       // first argument is 0 as the parent file object contains only 1 file
-      return parentFile->readTree(outputs, dh, 0, parentNumTF, treename, totalSizeCompressed, totalSizeUncompressed);
+      return parentFile->getTree(0, parentNumTF, treename);
     }
     throw std::runtime_error(fmt::format(R"(Couldn't get TTree "{}" from "{}". Please check https://aliceo2group.github.io/analysis-framework/docs/troubleshooting/#tree-not-found for more information.)", fileAndFolder.folderName + "/" + treename, fileAndFolder.file->GetName()));
   }
+  return {tree, this};
+}
 
-  // create table output
-  auto o = Output(dh);
-  auto t2t = outputs.make<TreeToTable>(o);
+namespace
+{
+// the columns which are not read are null, they are reported once per table so that
+// the tasks accessing columns they do not declare can be spotted
+void reportSkippedColumns(std::string const& table, std::vector<std::string> const& skipped)
+{
+  static std::mutex mutex;
+  static std::set<std::string> reported;
+  std::lock_guard lock(mutex);
+  if (skipped.empty() || !reported.insert(table).second) {
+    return;
+  }
+  LOGP(warning, "{} columns of {} are not read as no task declares them, they are null: {}", skipped.size(), table, fmt::join(skipped, ", "));
+}
 
+void fillTable(TreeToTable& t2t, TTree* tree, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
   // add branches to read
   // fill the table
-  t2t->setLabel(tree->GetName());
-  totalSizeCompressed += tree->GetZipBytes();
-  totalSizeUncompressed += tree->GetTotBytes();
-  t2t->addAllColumns(tree);
-  t2t->fill(tree);
+  t2t.setLabel(tree->GetName());
+  if (columns) {
+    reportSkippedColumns(tree->GetName(), t2t.addProjectedColumns(tree, *columns));
+    auto [zipBytes, totBytes] = t2t.readBytes(tree);
+    totalSizeCompressed += zipBytes;
+    totalSizeUncompressed += totBytes;
+  } else {
+    totalSizeCompressed += tree->GetZipBytes();
+    totalSizeUncompressed += tree->GetTotBytes();
+    t2t.addAllColumns(tree);
+  }
+  t2t.fill(tree);
   delete tree;
+}
+} // namespace
+
+std::shared_ptr<arrow::Table> DataInputDescriptor::readArrowTable(int counter, int numTF, std::string const& treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+{
+  if (!hasTimeFrame(counter, numTF)) {
+    return nullptr;
+  }
+  auto ioStart = uv_hrtime();
+
+  auto path = mcurrentDirectory + "/" + mfilenames[counter]->listOfTimeFrameKeys[numTF] + "/" + treename + ArrowIPCHelpers::extension;
+  std::error_code ec;
+  auto fileSize = std::filesystem::file_size(path, ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format(R"(Couldn't get table "{}" from "{}".)", treename, mcurrentDirectory + "/" + mfilenames[counter]->listOfTimeFrameKeys[numTF]));
+  }
+  // all columns are read, they are memory mapped and only the ones used are paged in
+  auto table = ArrowIPCHelpers::readTable(path);
+  totalSizeCompressed += fileSize;
+  totalSizeUncompressed += arrow::util::TotalBufferSize(*table);
+  mfilenames[counter]->alreadyRead[numTF] = true;
 
   mIOTime += (uv_hrtime() - ioStart);
+  return table;
+}
+
+bool DataInputDescriptor::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
+  auto ioStart = uv_hrtime();
+
+  if (setFile(counter) && !mcurrentDirectory.empty()) {
+    auto table = readArrowTable(counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed);
+    if (!table) {
+      return false;
+    }
+    outputs.adopt(Output(dh), table);
+    return true;
+  }
+
+  auto [tree, source] = getTree(counter, numTF, treename);
+  if (!tree) {
+    return false;
+  }
+
+  // create table output
+  auto o = Output(dh);
+  auto t2t = outputs.make<TreeToTable>(o);
+  fillTable(*t2t, tree, totalSizeCompressed, totalSizeUncompressed, columns);
+
+  source->mIOTime += (uv_hrtime() - ioStart);
 
   return true;
 }
 
+std::shared_ptr<arrow::Table> DataInputDescriptor::readTable(int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
+  auto ioStart = uv_hrtime();
+
+  if (setFile(counter) && !mcurrentDirectory.empty()) {
+    return readArrowTable(counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed);
+  }
+
+  auto [tree, source] = getTree(counter, numTF, treename);
+  if (!tree) {
+    return nullptr;
+  }
+
+  TreeToTable t2t;
+  fillTable(t2t, tree, totalSizeCompressed, totalSizeUncompressed, columns);
+
+  source->mIOTime += (uv_hrtime() - ioStart);
+
+  return t2t.finalize();
+}
+
 DataInputDirector::DataInputDirector()
 {
   createDefaultDataInputDescriptor();
@@ -426,6 +574,7 @@ DataInputDirector::DataInputDirector(std::vector<std::string> inputFiles, o2::mo
 
 DataInputDirector::~DataInputDirector()
 {
+  waitForReadAhead();
   for (auto fn : mdefaultInputFiles) {
     delete fn;
   }
@@ -695,6 +844,7 @@ DataInputDescriptor* DataInputDirector::getDataInputDescriptor(header::DataHeade
 
 FileAndFolder DataInputDirector::getFileFolder(header::DataHeader dh, int counter, int numTF)
 {
+  waitForReadAhead();
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -704,8 +854,33 @@ FileAndFolder DataInputDirector::getFileFolder(header::DataHeader dh, int counte
   return didesc->getFileFolder(counter, numTF);
 }
 
+bool DataInputDirector::hasTimeFrame(header::DataHeader dh, int counter, int numTF)
+{
+  waitForReadAhead();
+  auto didesc = getDataInputDescriptor(dh);
+  // if NOT match then use defaultDataInputDescriptor
+  if (!didesc) {
+    didesc = mdefaultDataInputDescriptor;
+  }
+
+  return didesc->hasTimeFrame(counter, numTF);
+}
+
+std::string DataInputDirector::getFileName(header::DataHeader dh, int counter)
+{
+  waitForReadAhead();
+  auto didesc = getDataInputDescriptor(dh);
+  // if NOT match then use defaultDataInputDescriptor
+  if (!didesc) {
+    didesc = mdefaultDataInputDescriptor;
+  }
+
+  return didesc->getFileName(counter);
+}
+
 int DataInputDirector::getTimeFramesInFile(header::DataHeader dh, int counter)
 {
+  waitForReadAhead();
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -717,6 +892,7 @@ int DataInputDirector::getTimeFramesInFile(header::DataHeader dh, int counter)
 
 uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counter, int numTF)
 {
+  waitForReadAhead();
   auto didesc = getDataInputDescriptor(dh);
   // if NOT match then use defaultDataInputDescriptor
   if (!didesc) {
@@ -726,10 +902,8 @@ uint64_t DataInputDirector::getTimeFrameNumber(header::DataHeader dh, int counte
   return didesc->getTimeFrameNumber(counter, numTF);
 }
 
-bool DataInputDirector::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed)
+DataInputDescriptor* DataInputDirector::getDataInputDescriptor(header::DataHeader dh, std::string& treename)
 {
-  std::string treename;
-
   auto didesc = getDataInputDescriptor(dh);
   if (didesc) {
     // if match then use filename and treename from DataInputDescriptor
@@ -741,12 +915,90 @@ bool DataInputDirector::readTree(DataAllocator& outputs, header::DataHeader dh,
     didesc = mdefaultDataInputDescriptor;
     treename = aod::datamodel::getTreeName(dh);
   }
+  return didesc;
+}
+
+std::shared_ptr<arrow::Table> DataInputDirector::takeReadAheadTable(header::DataHeader const& dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
+  waitForReadAhead();
+  if (counter != mReadAheadCounter || numTF != mReadAheadTF) {
+    return nullptr;
+  }
+  auto table = std::find_if(mReadAheadTables.begin(), mReadAheadTables.end(), [&dh, columns](ReadAheadTable const& t) {
+    return t.table && t.columns == columns && t.dh.dataOrigin == dh.dataOrigin && t.dh.dataDescription == dh.dataDescription && t.dh.subSpecification == dh.subSpecification;
+  });
+  if (table == mReadAheadTables.end()) {
+    return nullptr;
+  }
+  auto result = table->table;
+  totalSizeCompressed += table->compressedSize;
+  totalSizeUncompressed += table->uncompressedSize;
+  mReadAheadTables.erase(table);
+  return result;
+}
 
-  return didesc->readTree(outputs, dh, counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed);
+bool DataInputDirector::readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
+  if (auto table = takeReadAheadTable(dh, counter, numTF, totalSizeCompressed, totalSizeUncompressed, columns)) {
+    outputs.adopt(Output(dh), table);
+    return true;
+  }
+
+  std::string treename;
+  auto didesc = getDataInputDescriptor(dh, treename);
+  return didesc->readTree(outputs, dh, counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed, columns);
+}
+
+std::shared_ptr<arrow::Table> DataInputDirector::readTable(header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns)
+{
+  if (auto table = takeReadAheadTable(dh, counter, numTF, totalSizeCompressed, totalSizeUncompressed, columns)) {
+    return table;
+  }
+
+  std::string treename;
+  auto didesc = getDataInputDescriptor(dh, treename);
+  return didesc->readTable(counter, numTF, treename, totalSizeCompressed, totalSizeUncompressed, columns);
+}
+
+void DataInputDirector::startReadAhead(std::vector<std::pair<header::DataHeader, std::set<std::string> const*>> const& tables, int counter, int numTF)
+{
+  waitForReadAhead();
+  mReadAheadTables.clear();
+  for (auto& [dh, columns] : tables) {
+    mReadAheadTables.push_back({dh, columns});
+  }
+  mReadAheadCounter = counter;
+  mReadAheadTF = numTF;
+  mReadAhead = std::async(std::launch::async, [this, counter, numTF]() {
+    try {
+      for (auto& t : mReadAheadTables) {
+        std::string treename;
+        auto didesc = getDataInputDescriptor(t.dh, treename);
+        t.table = didesc->readTable(counter, numTF, treename, t.compressedSize, t.uncompressedSize, t.columns);
+        if (!t.table) {
+          break;
+        }
+      }
+    } catch (...) {
+      // the tables are read again when requested, which reports the error
+      mReadAheadTables.clear();
+    }
+  });
+}
+
+void DataInputDirector::waitForReadAhead()
+{
+  if (!mReadAhead.valid()) {
+    return;
+  }
+  auto waitStart = uv_hrtime();
+  mReadAhead.get();
+  mReadAheadStallTime += uv_hrtime() - waitStart;
 }
 
 void DataInputDirector::closeInputFiles()
 {
+  waitForReadAhead();
   mdefaultDataInputDescriptor->closeInputFile();
   for (auto didesc : mdataInputDescriptors) {
     didesc->closeInputFile();
@@ -16,9 +16,18 @@
 #include "Framework/DataDescriptorMatcher.h"
 #include "Framework/DataAllocator.h"
 
+#include <future>
 #include <regex>
+#include <set>
 #include "rapidjson/fwd.h"
 
+class TTree;
+
+namespace arrow
+{
+class Table;
+}
+
 namespace o2::monitoring
 {
 class Monitoring;
@@ -79,11 +88,18 @@ class DataInputDescriptor
 
   uint64_t getTimeFrameNumber(int counter, int numTF);
   FileAndFolder getFileFolder(int counter, int numTF);
+  // true if the dataframe @a numTF of file @a counter exists
+  bool hasTimeFrame(int counter, int numTF);
+  // absolute name of the file (or directory of Arrow IPC files) @a counter
+  std::string getFileName(int counter);
   DataInputDescriptor* getParentFile(int counter, int numTF, std::string treename);
   int getTimeFramesInFile(int counter);
   int getReadTimeFramesInFile(int counter);
 
-  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed);
+  // only the branches in @a columns (and the index columns) are read when given, see TreeToTable::addProjectedColumns
+  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns = nullptr);
+  // same as readTree, but returns the table instead of sending it, nullptr if the dataframe is not available
+  std::shared_ptr<arrow::Table> readTable(int counter, int numTF, std::string treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns = nullptr);
 
   void printFileStatistics();
   void closeInputFile();
@@ -99,6 +115,8 @@ class DataInputDescriptor
   std::vector<FileNameHolder*> mfilenames;
   std::vector<FileNameHolder*>* mdefaultFilenamesPtr = nullptr;
   TFile* mcurrentFile = nullptr;
+  // inputs which are directories hold the tables as Arrow IPC files, see ArrowIPCHelpers
+  std::string mcurrentDirectory;
   int mCurrentFileID = -1;
   bool mAlienSupport = false;
 
@@ -112,6 +130,11 @@ class DataInputDescriptor
 
   uint64_t mIOTime = 0;
   uint64_t mCurrentFileStartedAt = 0;
+
+  // the tree in this file or in a parent file, with the descriptor of the file it was found in
+  std::pair<TTree*, DataInputDescriptor*> getTree(int counter, int numTF, std::string const& treename);
+  // the table from the Arrow IPC file <directory>/DF_<n>/<treename>.arrow, nullptr if the dataframe is not available
+  std::shared_ptr<arrow::Table> readArrowTable(int counter, int numTF, std::string const& treename, size_t& totalSizeCompressed, size_t& totalSizeUncompressed);
 };
 
 class DataInputDirector
@@ -141,9 +164,21 @@ class DataInputDirector
   DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh);
   int getNumberInputDescriptors() { return mdataInputDescriptors.size(); }
 
-  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed);
+  bool readTree(DataAllocator& outputs, header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns = nullptr);
+  // same as readTree, but returns the table instead of sending it, nullptr if the dataframe is not available
+  std::shared_ptr<arrow::Table> readTable(header::DataHeader dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns = nullptr);
+  /// Read the given tables of the dataframe @a numTF of file @a counter in a background
+  /// thread, while the current dataframe is processed. The readTree calls for this dataframe
+  /// then send the tables which were read ahead. The methods which access the input files
+  /// wait for the background reading to be finished.
+  void startReadAhead(std::vector<std::pair<header::DataHeader, std::set<std::string> const*>> const& tables, int counter, int numTF);
+  void waitForReadAhead();
+  /// time spent waiting for the background reading, in ns
+  uint64_t getReadAheadStallTime() const { return mReadAheadStallTime; }
   uint64_t getTimeFrameNumber(header::DataHeader dh, int counter, int numTF);
   FileAndFolder getFileFolder(header::DataHeader dh, int counter, int numTF);
+  bool hasTimeFrame(header::DataHeader dh, int counter, int numTF);
+  std::string getFileName(header::DataHeader dh, int counter);
   int getTimeFramesInFile(header::DataHeader dh, int counter);
 
   uint64_t getTotalSizeCompressed();
@@ -165,8 +200,24 @@ class DataInputDirector
   bool mDebugMode = false;
   bool mAlienSupport = false;
 
+  struct ReadAheadTable {
+    header::DataHeader dh;
+    std::set<std::string> const* columns = nullptr;
+    std::shared_ptr<arrow::Table> table = nullptr;
+    size_t compressedSize = 0;
+    size_t uncompressedSize = 0;
+  };
+  std::vector<ReadAheadTable> mReadAheadTables;
+  int mReadAheadCounter = -1;
+  int mReadAheadTF = -1;
+  std::future<void> mReadAhead;
+  uint64_t mReadAheadStallTime = 0;
+
+  // the table read ahead for this dataframe, which is then dropped, nullptr if it was not read ahead
+  std::shared_ptr<arrow::Table> takeReadAheadTable(header::DataHeader const& dh, int counter, int numTF, size_t& totalSizeCompressed, size_t& totalSizeUncompressed, std::set<std::string> const* columns);
   bool readJsonDocument(rapidjson::Document* doc);
   bool isValid();
+  DataInputDescriptor* getDataInputDescriptor(header::DataHeader dh, std::string& treename);
 };
 
 } // namespace o2::framework
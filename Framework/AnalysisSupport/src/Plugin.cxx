@@ -15,6 +15,7 @@
 #include "Framework/ConfigParamDiscovery.h"
 #include "Framework/Capability.h"
 #include "Framework/Signpost.h"
+#include "Framework/ArrowIPCHelpers.h"
 #include "AODJAlienReaderHelpers.h"
 #include "AODWriterHelpers.h"
 #include <TFile.h>
@@ -22,7 +23,10 @@
 #include <TGrid.h>
 #include <TObjString.h>
 #include <TString.h>
+#include <arrow/type.h>
+#include <arrow/util/key_value_metadata.h>
 #include <fmt/format.h>
+#include <filesystem>
 #include <memory>
 
 O2_DECLARE_DYNAMIC_LOG(analysis_support);
@@ -126,6 +130,48 @@ auto readMetadata(std::unique_ptr<TFile>& currentFile) -> std::vector<ConfigPara
   return results;
 }
 
+// Same as getListOfTables and readMetadata for the output of the AOD writer in arrow
+// format, a directory with the tables of each dataframe in DF_<n>/<treename>.arrow.
+// The metadata is stored in the schema of each table.
+auto readArrowMetadata(std::string const& dirname) -> std::vector<ConfigParamSpec>
+{
+  std::vector<ConfigParamSpec> results;
+  std::vector<std::string> tables;
+  std::string firstTable;
+  for (auto const& df : std::filesystem::directory_iterator(dirname)) {
+    if (!df.is_directory() || !df.path().filename().string().starts_with("DF_")) {
+      continue;
+    }
+    for (auto const& t : std::filesystem::directory_iterator(df.path())) {
+      if (t.path().extension() == ArrowIPCHelpers::extension) {
+        tables.emplace_back(t.path().stem().string());
+        firstTable = t.path().string();
+      }
+    }
+    break;
+  }
+  if (tables.empty()) {
+    return results;
+  }
+
+  auto metadata = ArrowIPCHelpers::readSchema(firstTable)->metadata();
+  if (metadata && metadata->size() > 0) {
+    LOGP(info, "Metadata for directory \"{}\":", dirname);
+    for (int64_t i = 0; i < metadata->size(); ++i) {
+      LOGP(info, "- {}: {}", metadata->key(i), metadata->value(i));
+      std::string key = "aod-metadata-" + metadata->key(i);
+      char const* value = strdup(metadata->value(i).c_str());
+      results.push_back(ConfigParamSpec{key, VariantType::String, value, {"Metadata in AOD"}});
+    }
+    results.push_back(ConfigParamSpec{"aod-metadata-source", VariantType::String, dirname, {"File from which the metadata was extracted."}});
+  } else {
+    LOGP(info, "No metadata found in directory \"{}\"", dirname);
+    results.push_back(ConfigParamSpec{"aod-metadata-disable", VariantType::String, "1", {"Metadata not found in AOD"}});
+  }
+  results.push_back(ConfigParamSpec{"aod-metadata-tables", VariantType::ArrayString, tables, {"Tables in first AOD"}});
+  return results;
+}
+
 struct DiscoverMetadataInAOD : o2::framework::ConfigDiscoveryPlugin {
   ConfigDiscovery* create() override
   {
@@ -146,6 +192,11 @@ struct DiscoverMetadataInAOD : o2::framework::ConfigDiscoveryPlugin {
           std::getline(file, filename);
           file.close();
         }
+        std::error_code ec;
+        if (std::filesystem::is_directory(filename, ec)) {
+          LOGP(info, "Loading metadata from directory {} in PID {}", filename, getpid());
+          return readArrowMetadata(filename);
+        }
         if (filename.rfind("alien://", 0) == 0) {
           TGrid::Connect("alien://");
         }
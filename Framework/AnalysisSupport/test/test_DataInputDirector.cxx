@@ -12,12 +12,18 @@
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
 
+#include <cstdio>
 #include <fstream>
 #include <boost/test/unit_test.hpp>
 
 #include "Headers/DataHeader.h"
 #include "../src/DataInputDirector.h"
 
+#include <TFile.h>
+#include <TTree.h>
+#include <arrow/array.h>
+#include <arrow/table.h>
+
 BOOST_AUTO_TEST_CASE(TestDatainputDirector)
 {
   using namespace o2::header;
@@ -108,3 +114,95 @@ BOOST_AUTO_TEST_CASE(TestDatainputDirector)
   BOOST_CHECK(didesc);
   BOOST_CHECK_EQUAL(didesc->getNumberInputfiles(), 3);
 }
+
+namespace
+{
+// a file with the dataframes DF_1 and DF_2, the column fX of the table AOD/TEST holds 10 * <dataframe> + <row>
+void writeDataFrames(std::string const& filename)
+{
+  TFile f(filename.c_str(), "RECREATE");
+  for (int df : {1, 2}) {
+    auto dir = f.mkdir(("DF_" + std::to_string(df)).c_str());
+    dir->cd();
+    TTree t("O2test", "test table");
+    Int_t x;
+    t.Branch("fX", &x, "fX/I");
+    for (int i = 0; i < 5; ++i) {
+      x = 10 * df + i;
+      t.Fill();
+    }
+    t.Write();
+  }
+  f.Close();
+}
+
+int firstX(std::shared_ptr<arrow::Table> const& table)
+{
+  return std::static_pointer_cast<arrow::Int32Array>(table->GetColumnByName("fX")->chunk(0))->Value(0);
+}
+} // namespace
+
+BOOST_AUTO_TEST_CASE(TestReadAhead)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  std::string filename("testReadAhead.root");
+  writeDataFrames(filename);
+  auto dh = DataHeader(DataDescription{"TEST"}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0});
+  size_t compressed = 0;
+  size_t uncompressed = 0;
+
+  DataInputDirector didir(filename);
+  didir.startReadAhead({{dh, nullptr}}, 0, 1);
+
+  // a different dataframe is read synchronously
+  auto table = didir.readTable(dh, 0, 0, compressed, uncompressed);
+  BOOST_REQUIRE(table);
+  BOOST_CHECK_EQUAL(firstX(table), 10);
+
+  // a different column selection is read synchronously
+  std::set<std::string> columns{"fX"};
+  table = didir.readTable(dh, 0, 1, compressed, uncompressed, &columns);
+  BOOST_REQUIRE(table);
+  BOOST_CHECK_EQUAL(firstX(table), 20);
+
+  // once the file is gone, only the dataframe which was read ahead is still available
+  didir.closeInputFiles();
+  std::remove(filename.c_str());
+  compressed = 0;
+  table = didir.readTable(dh, 0, 1, compressed, uncompressed);
+  BOOST_REQUIRE(table);
+  BOOST_CHECK_EQUAL(firstX(table), 20);
+  BOOST_CHECK_EQUAL(table->num_rows(), 5);
+  BOOST_CHECK_GT(compressed, 0);
+  // it is sent only once
+  BOOST_CHECK_THROW(didir.readTable(dh, 0, 1, compressed, uncompressed), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(TestReadAheadError)
+{
+  using namespace o2::header;
+  using namespace o2::framework;
+
+  std::string filename("testReadAheadError.root");
+  writeDataFrames(filename);
+  auto dh = DataHeader(DataDescription{"TEST"}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0});
+  auto missing = DataHeader(DataDescription{"MISSING"}, DataOrigin{"AOD"}, DataHeader::SubSpecificationType{0});
+  size_t compressed = 0;
+  size_t uncompressed = 0;
+
+  // the tree of the second table does not exist, the error of the background
+  // thread is reported again by the synchronous read
+  DataInputDirector didir(filename);
+  didir.startReadAhead({{dh, nullptr}, {missing, nullptr}}, 0, 1);
+  didir.waitForReadAhead();
+  BOOST_CHECK_THROW(didir.readTable(missing, 0, 1, compressed, uncompressed), std::runtime_error);
+  // the other tables are read again
+  auto table = didir.readTable(dh, 0, 1, compressed, uncompressed);
+  BOOST_REQUIRE(table);
+  BOOST_CHECK_EQUAL(firstX(table), 20);
+
+  didir.closeInputFiles();
+  std::remove(filename.c_str());
+}
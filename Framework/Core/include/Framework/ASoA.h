@@ -423,6 +423,10 @@ concept has_extension = is_metadata<T> && not_void<typename T::extension_table_t
 template <typename T>
 concept is_spawnable_column = std::same_as<typename T::spawnable_t, std::true_type>;
 
+/// persistent column which is read from file, i.e. not calculated from an expression
+template <typename C>
+concept is_stored_column = is_persistent_column<C> && !is_spawnable_column<C>;
+
 template <typename B, typename E>
 struct EquivalentIndex {
   constexpr static bool value = false;
@@ -20,6 +20,7 @@
 #include "Framework/OutputObjHeader.h"
 #include "Framework/OutputRef.h"
 #include "Framework/OutputSpec.h"
+#include "Framework/ParallelGroups.h"
 #include "Framework/Plugins.h"
 #include "Framework/StringHelpers.h"
 #include "Framework/TableBuilder.h"
@@ -96,6 +97,10 @@ struct WritingCursor {
   void operator()(Ts... args)
   {
     static_assert(sizeof...(Ts) == framework::pack_size(typename persistent_table_t::persistent_columns_t{}), "Argument number mismatch");
+    if (O2_BUILTIN_UNLIKELY(mDeferred.recording())) {
+      mDeferred.record([this, ... values = extract(args)]() { (*this)(values...); });
+      return;
+    }
     ++mCount;
     cursor(0, extract(args)...);
   }
@@ -103,9 +108,18 @@ struct WritingCursor {
   /// Last index inserted in the table
   int64_t lastIndex()
   {
+    if (O2_BUILTIN_UNLIKELY(mDeferred.recording())) {
+      throw runtime_error("lastIndex() is not available when processing groups in parallel");
+    }
     return mCount;
   }
 
+  /// rows added while processing groups in parallel, see ParallelGroups
+  DeferredCalls& deferred()
+  {
+    return mDeferred;
+  }
+
   bool resetCursor(LifetimeHolder<TableBuilder> builder)
   {
     mBuilder = std::move(builder);
@@ -152,6 +166,7 @@ struct WritingCursor {
   /// able to do all-columns methods like reserve.
   LifetimeHolder<TableBuilder> mBuilder = nullptr;
   int64_t mCount = -1;
+  DeferredCalls mDeferred;
 };
 
 /// Helper to define output for a Table
@@ -455,6 +470,27 @@ struct Builds : decltype(transformBase<T>()) {
   }
 };
 
+/// Declares the columns stored in the file of table T which a task accesses, e.g.
+///
+///   ReadsColumns<aod::Tracks, aod::track::Signed1Pt, aod::track::Tgl> trackColumns;
+///
+/// If all the consumers of a table which is read from file declare their columns,
+/// the AOD reader only reads the declared columns, the index columns and the columns
+/// used in the Filter and Partition expressions of the tasks. The other columns are
+/// null, so the stored columns behind the dynamic and expression columns a task uses
+/// (here aod::track::Pt and aod::track::Eta) have to be declared as well. The reader
+/// logs the columns it skips for each table.
+template <soa::is_table T, soa::is_stored_column... Cs>
+struct ReadsColumns {
+  using table_t = T;
+  static_assert((framework::has_type_v<Cs, typename T::persistent_columns_t> && ...), "ReadsColumns declares a column which is not in the table");
+
+  static std::vector<std::string> labels()
+  {
+    return {Cs::columnLabel()...};
+  }
+};
+
 /// This helper class allows you to declare things which will be created by a
 /// given analysis task. Currently wrapped objects are limited to be TNamed
 /// descendants. Objects will be written to a ROOT file at the end of the
@@ -577,7 +613,7 @@ auto getTableFromFilter(soa::is_not_filtered_table auto const& table, soa::Selec
   return std::make_unique<o2::soa::Filtered<std::decay_t<decltype(table)>>>(std::vector{table.asArrowTable()}, std::forward<soa::SelectionVector>(selection));
 }
 
-void initializePartitionCaches(std::set<uint32_t> const& hashes, std::shared_ptr<arrow::Schema> const& schema, expressions::Filter const& filter, gandiva::NodePtr& tree, gandiva::FilterPtr& gfilter);
+void initializePartitionCaches(std::set<uint32_t> const& hashes, std::shared_ptr<arrow::Schema> const& schema, expressions::Filter const& filter, gandiva::NodePtr& tree, gandiva::FilterPtr& gfilter, std::shared_ptr<expressions::InterpretedFilter>& ifilter);
 
 template <typename T>
 struct Partition {
@@ -593,14 +629,15 @@ struct Partition {
 
   void intializeCaches(std::set<uint32_t> const& hashes, std::shared_ptr<arrow::Schema> const& schema)
   {
-    initializePartitionCaches(hashes, schema, filter, tree, gfilter);
+    initializePartitionCaches(hashes, schema, filter, tree, gfilter, ifilter);
   }
 
   void bindTable(T const& table)
   {
     intializeCaches(T::table_t::hashes(), table.asArrowTable()->schema());
     if (dataframeChanged) {
-      mFiltered = getTableFromFilter(table, soa::selectionToVector(framework::expressions::createSelection(table.asArrowTable(), gfilter)));
+      auto selection = ifilter != nullptr ? framework::expressions::createSelection(table.asArrowTable(), ifilter) : framework::expressions::createSelection(table.asArrowTable(), gfilter);
+      mFiltered = getTableFromFilter(table, soa::selectionToVector(selection));
       dataframeChanged = false;
     }
   }
@@ -662,6 +699,7 @@ struct Partition {
   std::unique_ptr<o2::soa::Filtered<T>> mFiltered = nullptr;
   gandiva::NodePtr tree = nullptr;
   gandiva::FilterPtr gfilter = nullptr;
+  std::shared_ptr<expressions::InterpretedFilter> ifilter = nullptr;
   bool dataframeChanged = true;
 
   using iterator = typename o2::soa::Filtered<T>::iterator;
@@ -18,6 +18,7 @@
 #include "Framework/ProcessingContext.h"
 #include "Framework/EndOfStreamContext.h"
 #include "Framework/HistogramRegistry.h"
+#include "Framework/ParallelGroups.h"
 #include "Framework/CCDBParamSpec.h"
 #include "Framework/ConfigParamSpec.h"
 #include "Framework/ConfigParamRegistry.h"
@@ -28,6 +29,8 @@
 #include "Framework/PluginManager.h"
 #include "Framework/DeviceSpec.h"
 
+#include <set>
+
 namespace o2::framework
 {
 
@@ -277,8 +280,9 @@ struct OutputManager<HistogramRegistry> {
     return true;
   }
 
-  static bool finalize(ProcessingContext&, HistogramRegistry&)
+  static bool finalize(ProcessingContext&, HistogramRegistry& what)
   {
+    what.flush();
     return true;
   }
 
@@ -573,6 +577,20 @@ struct OptionManager<ProcessConfigurable<R, T, As...>> {
   }
 };
 
+template <>
+struct OptionManager<ParallelGroups> {
+  static bool appendOption(std::vector<ConfigParamSpec>& options, ParallelGroups& what)
+  {
+    return ConfigurableHelpers::appendOption(options, what);
+  }
+
+  static bool prepare(InitContext& context, ParallelGroups& what)
+  {
+    what.value = context.options().get<int>(what.name.c_str());
+    return true;
+  }
+};
+
 template <typename ANY>
 struct UpdateProcessSwitches {
   static bool set(std::pair<std::string, bool>, ANY&)
@@ -631,6 +649,80 @@ struct IndexManager<Builds<IDX>> {
   }
 };
 
+/// declare that the column @a label is read from @a input, if not yet declared
+inline void addColumnToInput(InputSpec& input, std::string const& label)
+{
+  auto name = "column:" + label;
+  if (std::none_of(input.metadata.begin(), input.metadata.end(), [&name](ConfigParamSpec const& p) { return p.name == name; })) {
+    input.metadata.push_back(ConfigParamSpec{name, VariantType::Bool, true, {"\"\""}});
+  }
+}
+
+/// the columns used in the expressions of a task are read from all the inputs
+/// of which the task declares the columns
+inline void addExpressionColumnsToInputs(std::vector<InputSpec>& inputs, std::set<std::string> const& labels)
+{
+  for (auto& input : inputs) {
+    if (std::none_of(input.metadata.begin(), input.metadata.end(), [](ConfigParamSpec const& p) { return p.name.starts_with("column:"); })) {
+      continue;
+    }
+    for (auto& label : labels) {
+      addColumnToInput(input, label);
+    }
+  }
+}
+
+/// Manager template for the columns a task reads from its input tables
+template <typename T>
+struct ColumnsManager {
+  static bool requestColumns(std::vector<InputSpec>&, T const&) { return false; }
+  static bool addExpressionColumns(std::set<std::string>&, T const&) { return false; }
+};
+
+template <soa::is_table T, soa::is_stored_column... Cs>
+struct ColumnsManager<ReadsColumns<T, Cs...>> {
+  static bool requestColumns(std::vector<InputSpec>& inputs, ReadsColumns<T, Cs...> const&)
+  {
+    auto labels = ReadsColumns<T, Cs...>::labels();
+    [&inputs, &labels]<size_t N, std::array<soa::TableRef, N> refs, size_t... Is>(std::index_sequence<Is...>) {
+      ([&inputs, &labels]() {
+        auto input = std::find_if(inputs.begin(), inputs.end(), [](InputSpec const& i) { return i.binding == o2::aod::label<refs[Is]>(); });
+        if (input != inputs.end()) {
+          for (auto& label : labels) {
+            addColumnToInput(*input, label);
+          }
+        }
+      }(),
+       ...);
+    }.template operator()<T::originals.size(), T::originals>(std::make_index_sequence<T::originals.size()>());
+    return true;
+  }
+
+  static bool addExpressionColumns(std::set<std::string>&, ReadsColumns<T, Cs...> const&) { return false; }
+};
+
+template <>
+struct ColumnsManager<expressions::Filter> {
+  static bool requestColumns(std::vector<InputSpec>&, expressions::Filter const&) { return false; }
+
+  static bool addExpressionColumns(std::set<std::string>& labels, expressions::Filter const& filter)
+  {
+    labels.merge(expressions::getColumnLabels(filter));
+    return true;
+  }
+};
+
+template <typename T>
+struct ColumnsManager<Partition<T>> {
+  static bool requestColumns(std::vector<InputSpec>&, Partition<T> const&) { return false; }
+
+  static bool addExpressionColumns(std::set<std::string>& labels, Partition<T> const& partition)
+  {
+    labels.merge(expressions::getColumnLabels(partition.filter));
+    return true;
+  }
+};
+
 /// Manager template to handle slice caching
 template <typename T>
 struct PresliceManager {
@@ -701,6 +793,126 @@ struct PresliceManager<PresliceBase<T, Policy, OPT>> {
     return true;
   }
 };
+
+/// Manager template to handle the members of a task when its groups are processed in parallel
+template <typename T>
+struct ParallelGroupsManager {
+  /// members rebound for each group, which prevent the parallel processing
+  static bool requiresSerial(T&)
+  {
+    return false;
+  }
+
+  template <typename ANY>
+  static bool beginGroups(ANY& what, size_t nGroups, int nThreads)
+  {
+    if constexpr (std::derived_from<ANY, ProducesGroup>) {
+      homogeneous_apply_refs<true>([nGroups, nThreads](auto& p) { return ParallelGroupsManager<std::decay_t<decltype(p)>>::beginGroups(p, nGroups, nThreads); }, what);
+      return true;
+    }
+    return false;
+  }
+
+  /// apply what was recorded for the groups, or discard it if the processing failed
+  template <typename ANY>
+  static bool endGroups(ANY& what, bool apply)
+  {
+    if constexpr (std::derived_from<ANY, ProducesGroup>) {
+      homogeneous_apply_refs<true>([apply](auto& p) { return ParallelGroupsManager<std::decay_t<decltype(p)>>::endGroups(p, apply); }, what);
+      return true;
+    }
+    return false;
+  }
+};
+
+template <typename T>
+struct ParallelGroupsManager<Partition<T>> {
+  static bool requiresSerial(Partition<T>&)
+  {
+    return true;
+  }
+  static bool beginGroups(Partition<T>&, size_t, int)
+  {
+    return false;
+  }
+  static bool endGroups(Partition<T>&, bool)
+  {
+    return false;
+  }
+};
+
+/// OutputObj is filled directly by process(), which is not thread safe
+template <typename T>
+struct ParallelGroupsManager<OutputObj<T>> {
+  static bool requiresSerial(OutputObj<T>&)
+  {
+    return true;
+  }
+  static bool beginGroups(OutputObj<T>&, size_t, int)
+  {
+    return false;
+  }
+  static bool endGroups(OutputObj<T>&, bool)
+  {
+    return false;
+  }
+};
+
+template <typename T1, typename GroupingPolicy, typename BP, typename G, typename... As>
+struct ParallelGroupsManager<GroupedCombinationsGenerator<T1, GroupingPolicy, BP, G, As...>> {
+  static bool requiresSerial(GroupedCombinationsGenerator<T1, GroupingPolicy, BP, G, As...>&)
+  {
+    return true;
+  }
+  static bool beginGroups(GroupedCombinationsGenerator<T1, GroupingPolicy, BP, G, As...>&, size_t, int)
+  {
+    return false;
+  }
+  static bool endGroups(GroupedCombinationsGenerator<T1, GroupingPolicy, BP, G, As...>&, bool)
+  {
+    return false;
+  }
+};
+
+template <is_producable T>
+struct ParallelGroupsManager<Produces<T>> {
+  static bool requiresSerial(Produces<T>&)
+  {
+    return false;
+  }
+  static bool beginGroups(Produces<T>& what, size_t nGroups, int)
+  {
+    what.deferred().begin(nGroups);
+    return true;
+  }
+  static bool endGroups(Produces<T>& what, bool apply)
+  {
+    if (apply) {
+      what.deferred().replay();
+    } else {
+      what.deferred().begin(0);
+    }
+    return true;
+  }
+};
+
+template <>
+struct ParallelGroupsManager<HistogramRegistry> {
+  static bool requiresSerial(HistogramRegistry&)
+  {
+    return false;
+  }
+  static bool beginGroups(HistogramRegistry& what, size_t, int nThreads)
+  {
+    what.beginSharding(nThreads);
+    return true;
+  }
+  static bool endGroups(HistogramRegistry& what, bool apply)
+  {
+    what.endSharding(apply);
+    return true;
+  }
+};
 } // namespace o2::framework
 
 #endif // ANALYSISMANAGERS_H
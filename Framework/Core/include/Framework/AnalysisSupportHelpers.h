@@ -17,6 +17,9 @@
 #include "Framework/AnalysisContext.h"
 #include "Headers/DataHeader.h"
 #include <array>
+#include <map>
+#include <set>
+#include <string>
 
 namespace o2::framework
 {
@@ -43,6 +46,13 @@ struct AnalysisSupportHelpers {
                                          std::vector<InputSpec>& requestedAODs,
                                          std::vector<InputSpec>& requestedDYNs,
                                          DataProcessorSpec& publisher);
+  /// Restrict the branches read by the AOD reader to the columns declared by the
+  /// consumers of each table (see ReadsColumns). Tables with at least one consumer
+  /// which does not declare its columns are read in full.
+  static void addColumnProjectionsToReader(std::vector<DataProcessorSpec>& workflow);
+  /// The columns to read for each table from the aod-reader-columns option of the
+  /// AOD reader (<table>:<column>,...;...), as set by addColumnProjectionsToReader.
+  static std::map<std::string, std::set<std::string>> parseColumnProjections(std::string const& projections);
 
   /// Match all inputs of kind ATSK and write them to a ROOT file,
   /// one root file per originating task.
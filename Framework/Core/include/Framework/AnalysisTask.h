@@ -313,7 +313,7 @@ struct AnalysisDataProcessorBuilder {
   }
 
   template <typename Task, typename R, typename C, typename Grouping, typename... Associated>
-  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo>& infos, ArrowTableSlicingCache& slices)
+  static void invokeProcess(Task& task, InputRecord& inputs, R (C::*processingFunction)(Grouping, Associated...), std::vector<ExpressionInfo>& infos, ArrowTableSlicingCache& slices, ParallelGroups* parallel = nullptr)
   {
     using G = std::decay_t<Grouping>;
     auto groupingTable = AnalysisDataProcessorBuilder::bindGroupingTable(inputs, processingFunction, infos);
@@ -388,6 +388,36 @@ struct AnalysisDataProcessorBuilder {
       overwriteInternalIndices(associatedTables, associatedTables);
       if constexpr (soa::is_iterator<std::decay_t<G>>) {
         auto slicer = GroupSlicer(groupingTable, associatedTables, slices);
+        if (parallel != nullptr && parallel->enabled()) {
+          // the slicing is sequential, only the processing of the slices is distributed
+          using group_t = std::pair<std::decay_t<decltype(slicer.begin().groupingElement())>, decltype(slicer.begin().associatedTables())>;
+          std::vector<group_t> groups;
+          groups.reserve(slicer.max);
+          for (auto& slice : slicer) {
+            groups.emplace_back(slice.groupingElement(), slice.associatedTables());
+          }
+          homogeneous_apply_refs([nGroups = groups.size(), nThreads = parallel->value](auto& x) {
+            return ParallelGroupsManager<std::decay_t<decltype(x)>>::beginGroups(x, nGroups, nThreads);
+          },
+                                 task);
+          try {
+            parallel->run(groups.size(), [&](size_t i) {
+              auto& [element, associatedSlices] = groups[i];
+              overwriteInternalIndices(associatedSlices, associatedTables);
+              std::apply(
+                [&binder](auto&... x) mutable {
+                  (binder(x), ...);
+                },
+                associatedSlices);
+              invokeProcessWithArgs(task, processingFunction, element, associatedSlices);
+            });
+          } catch (...) {
+            homogeneous_apply_refs([](auto& x) { return ParallelGroupsManager<std::decay_t<decltype(x)>>::endGroups(x, false); }, task);
+            throw;
+          }
+          homogeneous_apply_refs([](auto& x) { return ParallelGroupsManager<std::decay_t<decltype(x)>>::endGroups(x, true); }, task);
+          return;
+        }
         for (auto& slice : slicer) {
           auto associatedSlices = slice.associatedTables();
           overwriteInternalIndices(associatedSlices, associatedTables);
@@ -565,6 +595,15 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
   },
                          *task.get());
 
+  // declare the columns read from the tables of which the task declares its columns
+  std::set<std::string> expressionColumns;
+  homogeneous_apply_refs([&inputs, &expressionColumns](auto& x) {
+    using X = std::decay_t<decltype(x)>;
+    return ColumnsManager<X>::requestColumns(inputs, x) || ColumnsManager<X>::addExpressionColumns(expressionColumns, x);
+  },
+                         *task.get());
+  addExpressionColumnsToInputs(inputs, expressionColumns);
+
   // no static way to check if the task defines any processing, we can only make sure it subscribes to at least something
   if (inputs.empty() == true) {
     LOG(warn) << "Task " << name_str << " has no inputs";
@@ -611,6 +650,33 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       task->init(ic);
     }
 
+    /// check if the groups can be processed in parallel
+    ParallelGroups* parallel = nullptr;
+    homogeneous_apply_refs(
+      overloaded{
+        [&parallel](ParallelGroups& x) {
+          parallel = &x;
+          return true;
+        },
+        [](auto&) {
+          return false;
+        }},
+      *task.get());
+    if (parallel != nullptr && parallel->enabled()) {
+      bool serial = false;
+      homogeneous_apply_refs([&serial](auto& x) {
+        serial |= ParallelGroupsManager<std::decay_t<decltype(x)>>::requiresSerial(x);
+        return true;
+      },
+                             *task.get());
+      if (serial) {
+        LOGP(warning, "Task has partitions, grouped combinations or output objects, its groups are processed serially");
+        parallel->forceSerial();
+      } else {
+        LOGP(info, "Processing the groups of the dataframes with {} threads", parallel->value);
+      }
+    }
+
     ic.services().get<ArrowTableSlicingCacheDef>().setCaches(std::move(bindingsKeys));
     ic.services().get<ArrowTableSlicingCacheDef>().setCachesUnsorted(std::move(bindingsKeysUnsorted));
     // initialize global caches
@@ -619,7 +685,7 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
     },
                            *(task.get()));
 
-    return [task, expressionInfos](ProcessingContext& pc) mutable {
+    return [task, expressionInfos, parallel](ProcessingContext& pc) mutable {
       // load the ccdb object from their cache
       homogeneous_apply_refs([&pc](auto&& x) { return ConditionManager<std::decay_t<decltype(x)>>::newDataframe(pc.inputs(), x); }, *task.get());
       // reset partitions once per dataframe
@@ -647,14 +713,14 @@ DataProcessorSpec adaptAnalysisTask(ConfigContext const& ctx, Args&&... args)
       }
       // execute process()
       if constexpr (requires { AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos, slices); }) {
-        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos, slices);
+        AnalysisDataProcessorBuilder::invokeProcess(*(task.get()), pc.inputs(), &T::process, expressionInfos, slices, parallel);
       }
       // execute optional process()
       homogeneous_apply_refs(
-        [&pc, &expressionInfos, &task, &slices](auto& x) mutable {
+        [&pc, &expressionInfos, &task, &slices, parallel](auto& x) mutable {
           if constexpr (base_of_template<ProcessConfigurable, std::decay_t<decltype(x)>>) {
             if (x.value == true) {
-              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos, slices);
+              AnalysisDataProcessorBuilder::invokeProcess(*task.get(), pc.inputs(), x.process, expressionInfos, slices, parallel);
               return true;
             }
           }
@@ -0,0 +1,46 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_ARROWIPCHELPERS_H_
+#define O2_FRAMEWORK_ARROWIPCHELPERS_H_
+
+#include <memory>
+#include <string>
+
+namespace arrow
+{
+class Schema;
+class Table;
+} // namespace arrow
+
+namespace o2::framework
+{
+
+/// Helpers to store tables as Arrow IPC (Feather v2) files, used for the "arrow"
+/// format of the AOD writer and for reading such outputs back.
+struct ArrowIPCHelpers {
+  /// The file extension of the Arrow IPC files
+  static constexpr char const* extension = ".arrow";
+
+  /// write @a table to @a path, compressing the buffers with @a codec ("lz4", "zstd" or "none").
+  /// The key / value metadata of the schema is kept.
+  static void writeTable(std::shared_ptr<arrow::Table> const& table, std::string const& path, std::string const& codec);
+
+  /// Read the table in @a path. The file is memory mapped, so the buffers of
+  /// uncompressed files point directly into the mapping and are not copied.
+  static std::shared_ptr<arrow::Table> readTable(std::string const& path);
+
+  /// Read only the schema (including the metadata) of the table in @a path
+  static std::shared_ptr<arrow::Schema> readSchema(std::string const& path);
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_ARROWIPCHELPERS_H_
@@ -20,11 +20,26 @@ namespace o2::framework
 {
 using ListVector = std::vector<std::vector<int64_t>>;
 
+/// Lookup tables for the slices of a sorted index, built once per table update.
+/// The non-negative keys are looked up directly in a table indexed by the key or,
+/// when the keys are too sparse for that, by a binary search in the sorted keys.
+struct SortedSliceIndex {
+  std::vector<int64_t> offsets;   // offset of the slice of every entry of values, the total count at the end
+  std::vector<int> positions;     // position in values of each non-negative key, -1 if absent (dense keys)
+  std::vector<int> keys;          // sorted non-negative keys (sparse keys)
+  std::vector<int> keyPositions;  // position in values of each of the keys (sparse keys)
+
+  void build(gsl::span<int const> values, gsl::span<int64_t const> counts);
+  void clear();
+};
+
 struct SliceInfoPtr {
   gsl::span<int const> values;
   gsl::span<int64_t const> counts;
+  SortedSliceIndex const* index = nullptr; // values and counts are scanned if not provided
 
   std::pair<int64_t, int64_t> getSliceFor(int value) const;
+  std::pair<int64_t, int64_t> scanSliceFor(int value) const;
 };
 
 struct SliceInfoUnsortedPtr {
@@ -53,6 +68,7 @@ struct ArrowTableSlicingCache {
   std::vector<StringPair> bindingsKeys;
   std::vector<std::shared_ptr<arrow::NumericArray<arrow::Int32Type>>> values;
   std::vector<std::shared_ptr<arrow::NumericArray<arrow::Int64Type>>> counts;
+  std::vector<SortedSliceIndex> indices;
 
   std::vector<StringPair> bindingsKeysUnsorted;
   std::vector<std::vector<int>> valuesUnsorted;
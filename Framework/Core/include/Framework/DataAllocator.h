@@ -18,6 +18,7 @@
 #include "Framework/OutputRef.h"
 #include "Framework/OutputRoute.h"
 #include "Framework/DataChunk.h"
+#include "Framework/DataRef.h"
 #include "Framework/FairMQDeviceProxy.h"
 #include "Framework/TimingInfo.h"
 #include "Framework/TypeTraits.h"
@@ -440,6 +441,15 @@ class DataAllocator
   void snapshot(const Output& spec, const char* payload, size_t payloadSize,
                 o2::header::SerializationMethod serializationMethod = o2::header::gSerializationMethodNone);
 
+  /// Send the payload of the input @a ref to @a spec, with the serialization method of the input.
+  /// The payload is not copied when the message holding it is known and the output uses the same
+  /// transport, the new message is a shallow copy sharing the buffer (e.g. in shared memory).
+  /// Otherwise the payload is copied like with snapshot.
+  void forward(const Output& spec, DataRef const& ref);
+  /// The message sent by forward with @a transport: a shallow copy of the input message
+  /// if it can be shared, a new message holding a copy of the payload otherwise.
+  static fair::mq::MessagePtr forwardedMessage(fair::mq::TransportFactory& transport, DataRef const& ref);
+
   /// make an object of type T and route to output specified by OutputRef
   /// The object is owned by the framework, returned reference can be used to fill the object.
   ///
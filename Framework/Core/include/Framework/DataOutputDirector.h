@@ -85,6 +85,9 @@ struct DataOutputDirector {
 
   // get the matching TFile
   FileAndFolder getFileFolder(DataOutputDescriptor* dodesc, uint64_t folderNumber, std::string parentFileName, int compression);
+  // get the name of the Arrow IPC file of a table in the Arrow output
+  // <resdir>/<filenamebase>/DF_<folderNumber>/<treename>.arrow, the folders are created
+  std::string getArrowFileName(DataOutputDescriptor* dodesc, uint64_t folderNumber);
 
   // check file sizes
   bool checkFileSizes();
@@ -13,6 +13,11 @@
 
 #include <cstddef> // for size_t
 
+namespace fair::mq
+{
+class Message;
+}
+
 namespace o2
 {
 namespace framework
@@ -27,6 +32,9 @@ struct DataRef {
   const char* header = nullptr;
   const char* payload = nullptr;
   size_t payloadSize = 0;
+  // the message holding the payload, if known. Allows to send the payload
+  // again without copying it, see DataAllocator::forward
+  const fair::mq::Message* payloadMessage = nullptr;
 };
 
 } // namespace framework
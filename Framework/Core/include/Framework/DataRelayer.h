@@ -22,7 +22,10 @@
 #include "Framework/TimesliceSlot.h"
 #include "Framework/ServiceRegistryRef.h"
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <functional>
@@ -49,7 +52,10 @@ class DataRelayer
  public:
   /// DataRelayer is thread safe because we have a lock around
   /// each method and there is no particular order in which
-  /// methods need to be called.
+  /// methods need to be called. The lock is sharded by pipeline
+  /// lane: relaying, consuming or checking a slot only locks the lane
+  /// of the slot, so that different lanes can be served in parallel,
+  /// while the operations which touch every slot lock all the lanes.
   constexpr static ServiceKind service_kind = ServiceKind::Global;
   /// This represents what the DataRelayer did when
   /// inserting a set of messages in the cache.
@@ -213,7 +219,42 @@ class DataRelayer
   std::vector<PruneOp> mPruneOps;
   size_t mMaxLanes;
 
-  O2_LOCKABLE_NAMED(std::recursive_mutex, mMutex, "data relayer mutex");
+  /// One bit per slot and input route, set when the route received
+  /// something for the slot. A cleared bit guarantees that the associated
+  /// MessageSet in mCache is empty, so that the completion check can
+  /// skip the missing routes without touching the cache.
+  std::vector<uint64_t> mReadyRoutes;
+  size_t mReadyRoutesWords = 0;
+
+  void markRouteReady(TimesliceSlot slot, size_t route)
+  {
+    mReadyRoutes[slot.index * mReadyRoutesWords + route / 64] |= uint64_t{1} << (route % 64);
+  }
+  void clearReadyRoutes(TimesliceSlot slot)
+  {
+    std::fill_n(mReadyRoutes.begin() + slot.index * mReadyRoutesWords, mReadyRoutesWords, 0);
+  }
+  [[nodiscard]] bool isRouteReady(TimesliceSlot slot, size_t route) const
+  {
+    return mReadyRoutes[slot.index * mReadyRoutesWords + route / 64] & (uint64_t{1} << (route % 64));
+  }
+
+  /// Lockable over all the lanes, for the operations which need to see
+  /// (or modify) the whole cache. Lanes are always locked in the same order.
+  struct AllLanes {
+    DataRelayer& relayer;
+    void lock();
+    void unlock();
+  };
+
+  /// @return the mutex protecting the cachelines of the lane for @a timeslice
+  /// (or slot) @a value.
+  std::recursive_mutex& laneMutex(size_t value) { return mLaneMutexes[value % mMaxLanes]; }
+
+  std::unique_ptr<std::recursive_mutex[]> mLaneMutexes;
+  AllLanes mAllLanes{*this};
+  /// mPruneOps can be modified by different lanes at the same time.
+  O2_LOCKABLE_NAMED(std::mutex, mPruneOpsMutex, "data relayer prune ops mutex");
 };
 
 } // namespace o2::framework
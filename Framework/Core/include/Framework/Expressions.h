@@ -47,6 +47,11 @@ using Selection = std::shared_ptr<gandiva::SelectionVector>;
 using FilterPtr = std::shared_ptr<gandiva::Filter>;
 } // namespace gandiva
 
+namespace o2::framework::expressions
+{
+struct InterpretedFilter;
+}
+
 using atype = arrow::Type;
 struct ExpressionInfo {
   ExpressionInfo(int ai, size_t hash, std::set<uint32_t>&& hs, gandiva::SchemaPtr sc)
@@ -62,6 +67,7 @@ struct ExpressionInfo {
   gandiva::SchemaPtr schema;
   gandiva::NodePtr tree = nullptr;
   gandiva::FilterPtr filter = nullptr;
+  std::shared_ptr<o2::framework::expressions::InterpretedFilter> interpreted = nullptr;
   gandiva::Selection selection = nullptr;
   bool resetSelection = false;
 };
@@ -430,6 +436,8 @@ using Operations = std::vector<ColumnOperationSpec>;
 
 /// Function to create an internal operation sequence from a filter tree
 Operations createOperations(Filter const& expression);
+/// Function to get the labels of the columns used in a filter tree
+std::set<std::string> getColumnLabels(Filter const& expression);
 
 /// Function to check compatibility of a given arrow schema with operation sequence
 bool isTableCompatible(std::set<uint32_t> const& hashes, Operations const& specs);
@@ -442,6 +450,17 @@ std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
 /// Function to create gandiva filter from operation sequence
 std::shared_ptr<gandiva::Filter> createFilter(gandiva::SchemaPtr const& Schema,
                                               Operations const& opSpecs);
+/// The filters can be evaluated by an interpreter of the operation sequence instead, which
+/// avoids the JIT compilation of a gandiva filter for each expression and schema. Enabled by
+/// setting DPL_FILTER_INTERPRETER=1, the expressions with functions other than the arithmetic,
+/// bitwise, comparison, logical, abs and conditional operations are still compiled with gandiva.
+bool useFilterInterpreter();
+/// Function to create an interpreted filter from operation sequence, combined with logical 'and'
+/// with @a previous if given. Returns nullptr if the interpreter does not support the operations.
+std::shared_ptr<InterpretedFilter> createInterpretedFilter(Operations const& opSpecs,
+                                                           std::shared_ptr<InterpretedFilter> const& previous = nullptr);
+/// Function for creating gandiva selection with an interpreted filter
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<InterpretedFilter> const& ifilter);
 /// Function to create gandiva projector from operation sequence
 std::shared_ptr<gandiva::Projector> createProjector(gandiva::SchemaPtr const& Schema,
                                                     Operations const& opSpecs,
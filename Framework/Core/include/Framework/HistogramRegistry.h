@@ -19,6 +19,7 @@
 #include "Framework/OutputRef.h"
 #include "Framework/OutputObjHeader.h"
 #include "Framework/OutputSpec.h"
+#include "Framework/ParallelGroups.h"
 #include "Framework/SerializationMethods.h"
 #include "Framework/TableBuilder.h"
 #include "Framework/RuntimeError.h"
@@ -33,6 +34,7 @@
 
 #include <concepts>
 #include <deque>
+#include <mutex>
 
 class TList;
 
@@ -78,6 +80,31 @@ concept ValidComplexFillStep = std::is_base_of_v<StepTHn, T>;
 template <typename T, int D>
 concept ValidFill = ValidSimpleFill<T, D> || ValidComplexFill<T, D> || ValidComplexFillStep<T, D>;
 
+// fills of the histograms of a registry, kept as structure of arrays until they are applied in bulk
+struct HistogramFillBuffer {
+  std::vector<uint16_t> histIndex; // index of the histogram in the registry
+  std::vector<uint8_t> nValues;    // number of position and weight values of the fill
+  std::vector<double> values;      // values of all fills, one after the other
+
+  template <typename... Ts>
+  void add(uint32_t idx, Ts... positionAndWeight)
+  {
+    histIndex.push_back(idx);
+    nValues.push_back(sizeof...(Ts));
+    (values.push_back(static_cast<double>(positionAndWeight)), ...);
+  }
+  size_t size() const
+  {
+    return histIndex.size();
+  }
+  void clear()
+  {
+    histIndex.clear();
+    nValues.clear();
+    values.clear();
+  }
+};
+
 struct HistFiller {
   // fill any type of histogram (if weight was requested it must be the last argument)
   template <typename T, typename... Ts>
@@ -105,6 +132,10 @@ struct HistFiller {
   template <typename... Cs, typename R, typename T>
   static void fillHistAny(std::shared_ptr<R> hist, const T& table, const o2::framework::expressions::Filter& filter);
 
+  // apply the buffered fills at the given indices to a histogram, the values of fill i start at values[offsets[i]]
+  template <typename T>
+  static void fillHistBuffered(std::shared_ptr<T> hist, const HistogramFillBuffer& buffer, const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& fills, size_t begin, size_t end);
+
   // function that returns rough estimate for the size of a histogram in MB
   template <typename T>
   static double getSize(std::shared_ptr<T> hist, double fillFraction = 1.);
@@ -204,6 +235,18 @@ class HistogramRegistry
   // print summary of the histograms stored in registry
   void print(bool showAxisDetails = false);
 
+  // buffer the fills and apply them to the histograms in bulk once maxFills are buffered, at the end of
+  // each dataframe and when the output is created (0, the default, to fill the histograms directly)
+  void setFillBufferSize(size_t maxFills);
+
+  // apply the buffered fills to the histograms
+  void flush();
+
+  // use one fill buffer per thread while the groups of a dataframe are processed in parallel by nThreads,
+  // the buffers are applied (or discarded) at the end
+  void beginSharding(int nThreads);
+  void endSharding(bool apply);
+
   // lookup distance counter for benchmarking
   mutable uint32_t lookup = 0;
 
@@ -218,6 +261,12 @@ class HistogramRegistry
   // helper function that checks if histogram name can be used in registry
   void validateHistName(const std::string& name, const uint32_t hash);
 
+  // buffer a fill in the buffer of the calling thread and flush it once full
+  template <typename... Ts>
+  void bufferFill(uint32_t idx, Ts... positionAndWeight);
+
+  void flush(HistogramFillBuffer& buffer);
+
   // helper function to find the histogram position in the registry
   template <typename T>
   uint32_t getHistIndex(const T& histName);
@@ -250,6 +299,15 @@ class HistogramRegistry
   static constexpr uint32_t MAX_REGISTRY_SIZE{REGISTRY_BITMASK + 1};
   std::array<uint32_t, MAX_REGISTRY_SIZE> mRegistryKey{};
   std::array<HistPtr, MAX_REGISTRY_SIZE> mRegistryValue{};
+
+  // maximum number of buffered fills per thread while processing groups in parallel, if not set
+  static constexpr size_t DEFAULT_SHARD_SIZE{1 << 16};
+  size_t mFillBufferSize{};
+  bool mSharded{};
+  // one per thread when sharded
+  std::vector<HistogramFillBuffer> mFillBuffers{};
+  // for the flushes of the shards
+  std::shared_ptr<std::mutex> mFlushMutex{std::make_shared<std::mutex>()};
 };
 
 //--------------------------------------------------------------------------------------------------
@@ -445,9 +503,28 @@ template <typename... Ts>
 void HistogramRegistry::fill(const HistName& histName, Ts... positionAndWeight)
   requires(FillValue<Ts> && ...)
 {
+  if (mFillBufferSize || mSharded) {
+    bufferFill(getHistIndex(histName), positionAndWeight...);
+    return;
+  }
   std::visit([positionAndWeight...](auto&& hist) { HistFiller::fillHistAny(hist, positionAndWeight...); }, mRegistryValue[getHistIndex(histName)]);
 }
 
+template <typename... Ts>
+void HistogramRegistry::bufferFill(uint32_t idx, Ts... positionAndWeight)
+{
+  auto& buffer = mFillBuffers[mSharded ? ParallelGroups::threadIndex() : 0];
+  buffer.add(idx, positionAndWeight...);
+  if (buffer.size() >= (mFillBufferSize ? mFillBufferSize : DEFAULT_SHARD_SIZE)) {
+    if (mSharded) {
+      std::lock_guard<std::mutex> lock(*mFlushMutex);
+      flush(buffer);
+    } else {
+      flush(buffer);
+    }
+  }
+}
+
 extern template void HistogramRegistry::fill(const HistName& histName, double);
 extern template void HistogramRegistry::fill(const HistName& histName, float);
 extern template void HistogramRegistry::fill(const HistName& histName, int);
@@ -484,6 +561,11 @@ extern template std::shared_ptr<StepTHn> HistogramRegistry::add<StepTHn>(char co
 template <typename... Cs, typename T>
 void HistogramRegistry::fill(const HistName& histName, const T& table, const o2::framework::expressions::Filter& filter)
 {
+  if (mSharded) {
+    std::lock_guard<std::mutex> lock(*mFlushMutex);
+    std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
+    return;
+  }
   std::visit([&table, &filter](auto&& hist) { HistFiller::fillHistAny<Cs...>(hist, table, filter); }, mRegistryValue[getHistIndex(histName)]);
 }
 
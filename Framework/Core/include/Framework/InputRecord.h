@@ -20,6 +20,7 @@
 #include "Framework/RuntimeError.h"
 #include "Framework/Logger.h"
 #include "Framework/ObjectCache.h"
+#include "Framework/SharedObjectStore.h"
 #include "Framework/CallbackService.h"
 
 #include "Headers/DataHeader.h"
@@ -412,7 +413,7 @@ class InputRecord
         auto cacheEntry = cache.matcherToId.find(path);
         if (cacheEntry == cache.matcherToId.end()) {
           cache.matcherToId.insert(std::make_pair(path, id));
-          std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<CCDBSerialized<ValueT>>(ref).release(), false);
+          std::unique_ptr<ValueT const, Deleter<ValueT const>> result(deserialiseCCDB<ValueT>(ref, cache, id), false);
           void* obj = (void*)result.get();
           callbacks.call<CallbackService::Id::CCDBDeserialised>((ConcreteDataMatcher&)matcher, (void*)obj);
           cache.idToObject[id] = obj;
@@ -428,8 +429,10 @@ class InputRecord
         }
         // The id in the cache is different. Let's destroy the old cached entry
         // and create a new one.
-        delete reinterpret_cast<ValueT*>(cache.idToObject[oldId]);
-        std::unique_ptr<ValueT const, Deleter<ValueT const>> result(DataRefUtils::as<CCDBSerialized<ValueT>>(ref).release(), false);
+        if (cache.idToSharedImage.erase(oldId) == 0) {
+          delete reinterpret_cast<ValueT*>(cache.idToObject[oldId]);
+        }
+        std::unique_ptr<ValueT const, Deleter<ValueT const>> result(deserialiseCCDB<ValueT>(ref, cache, id), false);
         void* obj = (void*)result.get();
         callbacks.call<CallbackService::Id::CCDBDeserialised>((ConcreteDataMatcher&)matcher, (void*)obj);
         cache.idToObject[id] = obj;
@@ -718,6 +721,27 @@ class InputRecord
   // Produce a string describing the available inputs.
   [[nodiscard]] std::string describeAvailableInputs() const;
 
+  // Deserialise a CCDB object to be kept in the ObjectCache. When enabled, flat objects
+  // declared as self-contained are mapped from the node-local SharedObjectStore, so that they are built once per node.
+  template <typename T>
+  T* deserialiseCCDB(DataRef const& ref, ObjectCache& cache, ObjectCache::Id id)
+  {
+    if constexpr (shareable_flat_object<T>) {
+      if (SharedObjectStore::isEnabled()) {
+        auto headers = DataRefUtils::extractCCDBHeaders(ref);
+        auto etag = headers.find("ETag");
+        if (etag != headers.end()) {
+          auto [obj, image] = SharedObjectStore::getFlatObject<T>(etag->second, [&ref]() { return DataRefUtils::as<CCDBSerialized<T>>(ref); });
+          if (image) {
+            cache.idToSharedImage[id] = image;
+          }
+          return obj;
+        }
+      }
+    }
+    return DataRefUtils::as<CCDBSerialized<T>>(ref).release();
+  }
+
   ServiceRegistryRef mRegistry;
   std::vector<InputRoute> const& mInputsSchema;
   InputSpan& mSpan;
@@ -14,6 +14,7 @@
 #include "Framework/DataRef.h"
 #include <unordered_map>
 #include <map>
+#include <memory>
 
 namespace o2::framework
 {
@@ -47,6 +48,9 @@ struct ObjectCache {
   /// A map from a CacheId (which is the void* ptr of the previous map).
   /// to an actual (type erased) pointer to the deserialised object.
   std::unordered_map<Id, void*, Id::hash_fn> idToObject;
+  /// Objects mapped from the node-local SharedObjectStore are not owned
+  /// by the cache: their storage is released with the image kept here.
+  std::unordered_map<Id, std::shared_ptr<void>, Id::hash_fn> idToSharedImage;
 
   /// A cache to the deserialised metadata
   /// We keep it separate because we want to avoid that looking up
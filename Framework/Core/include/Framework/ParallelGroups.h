@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_PARALLELGROUPS_H_
+#define O2_FRAMEWORK_PARALLELGROUPS_H_
+
+#include "Framework/Configurable.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::framework
+{
+
+/// Calls to a member of a task (e.g. filling a histogram or a produced table) recorded
+/// for each group while the groups of a dataframe are processed in parallel. They are
+/// replayed in the order of the groups once all of them are processed, so that the
+/// results are the same as with the serial processing.
+class DeferredCalls
+{
+ public:
+  /// The group processed by the calling thread, -1 outside of the parallel processing
+  static int currentGroup();
+  static void setCurrentGroup(int group);
+
+  /// true if the calls of the current thread have to be recorded
+  bool recording() const
+  {
+    return !mCalls.empty() && currentGroup() >= 0;
+  }
+
+  template <typename F>
+  void record(F&& call)
+  {
+    mCalls[currentGroup()].emplace_back(std::forward<F>(call));
+  }
+
+  /// start recording for @a nGroups groups
+  void begin(size_t nGroups);
+  /// execute the recorded calls in the order of the groups and stop recording
+  void replay();
+
+ private:
+  std::vector<std::vector<std::function<void()>>> mCalls;
+};
+
+class GroupWorkerPool;
+
+/// Declare this in a task to process the groups of its grouped process() functions
+/// (i.e. those with an iterator as first argument) on several threads, e.g.
+///
+///   ParallelGroups parallelGroups{"group-threads", 4, "threads for the groups"};
+///
+/// Each group is processed by a single thread, the slicing of the tables stays serial.
+/// Rows of Produces<> tables are recorded for each group and added in the order of the
+/// groups at the end of the dataframe, so the tables are the same as with the serial
+/// processing. HistogramRegistry fills are buffered for each thread and applied to the
+/// histograms in bulk, see HistogramRegistry::setFillBufferSize. Everything else process()
+/// modifies must be thread safe: histograms retrieved from a registry must not be filled,
+/// and the lastIndex() of produced tables is not available. Tasks with Partition or grouped
+/// combination members are always processed serially, since those are rebound for each
+/// group, and so are tasks with OutputObj members, which are filled directly.
+struct ParallelGroups : Configurable<int> {
+  ParallelGroups(std::string const& name = "group-threads", int&& nThreads = 0, std::string const& help = "Number of threads for the groups of a dataframe (<= 1 for serial processing)")
+    : Configurable<int>(name, std::forward<int>(nThreads), help)
+  {
+  }
+
+  bool enabled() const
+  {
+    return value > 1 && !mForceSerial;
+  }
+  void forceSerial()
+  {
+    mForceSerial = true;
+  }
+
+  /// 0 for the thread calling run() and outside of the processing, 1 to (threads - 1) for the workers
+  static int threadIndex();
+
+  /// run @a f for all indices in [0, @a n) on the worker threads and the calling one,
+  /// with the current group of DeferredCalls set to the index. The first exception thrown
+  /// by @a f stops the processing and is rethrown.
+  void run(size_t n, std::function<void(size_t)> const& f);
+
+ private:
+  std::shared_ptr<GroupWorkerPool> mPool;
+  bool mForceSerial = false;
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_PARALLELGROUPS_H_
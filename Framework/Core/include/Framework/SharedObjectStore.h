@@ -0,0 +1,152 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+#ifndef O2_FRAMEWORK_SHAREDOBJECTSTORE_H_
+#define O2_FRAMEWORK_SHAREDOBJECTSTORE_H_
+
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeinfo>
+#include <utility>
+
+namespace o2::gpu
+{
+template <class T>
+struct FlatObjectSelfContained; // GPU/Utils/FlatObject.h
+} // namespace o2::gpu
+
+namespace o2::framework
+{
+
+/// Objects following the FlatObject (GPU/Utils) protocol: all variable size data
+/// live in a single flat buffer and the object can be bitwise moved together with it,
+/// provided the buffer address is updated at the new location.
+template <typename T>
+concept flat_object = requires(T& obj, T const& cobj, char* ptr) {
+  { cobj.getFlatBufferPtr() } -> std::convertible_to<const char*>;
+  { cobj.getFlatBufferContainerPtr() } -> std::convertible_to<const char*>;
+  { cobj.getFlatBufferSize() } -> std::convertible_to<size_t>;
+  obj.setActualBufferAddress(ptr);
+  obj.adoptInternalBuffer(ptr);
+};
+
+/// Flat objects which declare with o2::gpu::FlatObjectSelfContained that they keep nothing outside
+/// of their flat buffer (e.g. TPCFastTransform owns a heap allocated slow correction, so it cannot be shared).
+template <typename T>
+concept shareable_flat_object = flat_object<T> && o2::gpu::FlatObjectSelfContained<T>::value;
+
+/// A node-local store of immutable object images in POSIX shared memory, so that
+/// large objects (e.g. CCDB objects used by several devices) are built once per node.
+///
+/// Each image lives in its own region named after a key which must identify the content
+/// (e.g. the CCDB ETag together with the type). The first process needing it creates and
+/// fills the region, the others wait until it is ready and map it. The payload is mapped
+/// copy-on-write: pages modified by a process (e.g. by pointer relocation) become private
+/// to it, all the others stay shared. The PIDs of the processes using a region are registered in
+/// its header under a file lock, which the kernel releases if a process dies. The region is removed
+/// by the last live process releasing it; regions whose users all died are removed by the next
+/// process using the store (see cleanup).
+class SharedObjectStore
+{
+ public:
+  /// A mapped image, unmapped when the last reference goes away
+  class Image
+  {
+   public:
+    Image(std::string name, int fd, void* header, char* payload, size_t size, unsigned long inode);
+    ~Image();
+    Image(const Image&) = delete;
+    Image& operator=(const Image&) = delete;
+
+    char* data() const { return mPayload; }
+    size_t size() const { return mSize; }
+
+   private:
+    std::string mName;
+    int mFD = -1; // kept open for the locking of the header
+    void* mHeader = nullptr;
+    char* mPayload = nullptr;
+    size_t mSize = 0;
+    unsigned long mInode = 0;
+  };
+
+  /// Fills the payload of a new region, returns false on failure
+  using Filler = std::function<bool(char* dest)>;
+
+  /// Sharing of CCDB objects is enabled by the DPL_CCDB_SHARED_OBJECTS environment variable
+  static bool isEnabled();
+
+  /// Map the image of the key, waiting if another process is creating it.
+  /// Returns nullptr if it does not exist (or could not be created by its owner).
+  static std::shared_ptr<Image> open(std::string const& key);
+
+  /// Create the image of the key with size bytes filled by fill.
+  /// Returns nullptr if it exists already (use open then) or on failure.
+  static std::shared_ptr<Image> create(std::string const& key, size_t size, Filler const& fill);
+
+  /// Remove the region of the key, if any. Processes which mapped it are not affected.
+  static void remove(std::string const& key);
+
+  /// Name of the shared memory region for the key
+  static std::string regionName(std::string const& key);
+
+  /// Remove the regions of this user left by processes which died without releasing them.
+  /// Done automatically once per process before the first access to the store, returns the number of removed regions.
+  static int cleanup();
+
+  /// Get a flat object shared between the processes of the node. The image is the bitwise copy
+  /// of the object followed by its flat buffer; every process relocates its own copy-on-write
+  /// mapping, so only the pages with pointers get duplicated. Only types which declared themselves
+  /// self-contained (o2::gpu::FlatObjectSelfContained) are accepted. The object must not be destroyed:
+  /// its storage is released together with the returned image. build() is only called when the
+  /// image does not exist yet. If the image cannot be shared, the built object is returned with
+  /// a null image and is owned by the caller. Returns nullptr if the object could not be built.
+  template <shareable_flat_object T, typename B>
+  static std::pair<T*, std::shared_ptr<Image>> getFlatObject(std::string const& key, B&& build)
+  {
+    std::string fullKey = key + "/" + typeid(T).name();
+    auto image = open(fullKey);
+    if (!image) {
+      std::unique_ptr<T> obj = build();
+      if (!obj) {
+        return {nullptr, nullptr};
+      }
+      const char* buffer = obj->getFlatBufferPtr() ? obj->getFlatBufferPtr() : obj->getFlatBufferContainerPtr();
+      image = create(fullKey, FlatBufferOffset<T> + obj->getFlatBufferSize(), [&obj, buffer](char* dest) {
+        std::memcpy(dest, (const void*)obj.get(), sizeof(T));
+        if (obj->getFlatBufferSize()) {
+          std::memcpy(dest + FlatBufferOffset<T>, buffer, obj->getFlatBufferSize());
+        }
+        return true;
+      });
+      if (!image && !(image = open(fullKey))) {
+        // created concurrently and failed, or shared memory is not usable: keep the local copy
+        return {obj.release(), nullptr};
+      }
+    }
+    auto* obj = reinterpret_cast<T*>(image->data());
+    char* buffer = image->data() + FlatBufferOffset<T>;
+    obj->setActualBufferAddress(buffer);
+    obj->adoptInternalBuffer(buffer); // so that the usual rectification after reading is a no-op
+    return {obj, image};
+  }
+
+ private:
+  template <typename T>
+  static constexpr size_t FlatBufferOffset = (sizeof(T) + 63) & ~size_t(63);
+};
+
+} // namespace o2::framework
+
+#endif // O2_FRAMEWORK_SHAREDOBJECTSTORE_H_
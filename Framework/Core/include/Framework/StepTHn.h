@@ -37,6 +37,9 @@ class StepTHn : public TNamed
   template <typename... Ts>
   void Fill(int iStep, const Ts&... valuesAndWeight);
   void Fill(int iStep, int nParams, double positionAndWeight[]);
+  // fill nEntries at once, entry i being the step followed by nParams[i] - 1 position (and weight) values.
+  // The weights falling into the same bin are summed in double before being added to the containers.
+  void FillBatch(int nEntries, const double* const* stepPositionAndWeight, const int* nParams);
 
   THnBase* getTHn(Int_t step, Bool_t sparse = kFALSE)
   {
@@ -67,6 +70,7 @@ class StepTHn : public TNamed
   void deleteContainers();
 
   Long64_t getGlobalBinIndex(const Int_t* binIdx);
+  Long64_t getBin(const double* position); // -1 for under- and overflows
 
   Long64_t mNBins;  // number of total bins
   Int_t mNVars;     // number of variables
@@ -19,6 +19,7 @@
 #include "TableBuilder.h"
 #include <arrow/dataset/file_base.h>
 #include <memory>
+#include <set>
 
 // =============================================================================
 namespace o2::framework
@@ -59,10 +60,12 @@ auto basicROOTTypeFromArrow(arrow::Type::type id);
 class BranchToColumn
 {
  public:
-  BranchToColumn(TBranch* branch, bool VLA, std::string name, EDataType type, int listSize, arrow::MemoryPool* pool);
+  BranchToColumn(TBranch* branch, bool VLA, std::string name, EDataType type, int listSize, arrow::MemoryPool* pool, bool placeholder = false);
   //  BranchToColumn(TBranch* branch, TBranch* sizeBranch, std::string name, EDataType type, arrow::MemoryPool* pool);
   ~BranchToColumn() = default;
   TBranch* branch();
+  /// true if the column is filled with nulls instead of the content of the branch
+  bool placeholder() const { return mPlaceholder; }
 
   std::pair<std::shared_ptr<arrow::ChunkedArray>, std::shared_ptr<arrow::Field>> read(TBuffer* buffer);
 
@@ -77,6 +80,7 @@ class BranchToColumn
   int mListSize = 1;
   std::unique_ptr<arrow::ArrayBuilder> mBuilder = nullptr;
   arrow::MemoryPool* mPool = nullptr;
+  bool mPlaceholder = false;
 };
 
 class ColumnToBranch
@@ -131,8 +135,14 @@ class TreeToTable
   TreeToTable(arrow::MemoryPool* pool = arrow::default_memory_pool());
   void setLabel(const char* label);
   void addAllColumns(TTree* tree, std::vector<std::string>&& names = {});
+  /// Read only the branches of the columns in @a names and of the index columns. The
+  /// other columns of the tree are added as arrays of nulls, without reading their branches.
+  /// Returns the names of these columns.
+  std::vector<std::string> addProjectedColumns(TTree* tree, std::set<std::string> const& names);
   void fill(TTree*);
   std::shared_ptr<arrow::Table> finalize();
+  /// compressed and uncompressed size of the branches which are read
+  std::pair<int64_t, int64_t> readBytes(TTree* tree) const;
 
  private:
   arrow::MemoryPool* mArrowMemoryPool;
@@ -140,7 +150,8 @@ class TreeToTable
   std::string mTableLabel;
   std::shared_ptr<arrow::Table> mTable;
 
-  void addReader(TBranch* branch, std::string const& name, bool VLA);
+  void addReader(TBranch* branch, std::string const& name, bool VLA, bool placeholder = false);
+  void setupCache(TTree* tree);
 };
 
 class FragmentToBatch
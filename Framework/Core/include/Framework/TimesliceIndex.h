@@ -19,7 +19,9 @@
 #include "Framework/TimesliceSlot.h"
 #include "Framework/ChannelInfo.h"
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include <algorithm>
 
@@ -36,7 +38,9 @@ class TimesliceIndex
 {
  public:
   /// TimesliceIndex is threadsafe because it's accessed only by the
-  /// DataRelayer.
+  /// DataRelayer, which serialises the access to the slots of a given
+  /// lane. The dirty flags are atomic, so that they can be set and
+  /// cleared from different lanes at the same time.
   constexpr static ServiceKind service_kind = ServiceKind::Global;
 
   /// What to do when there is backpressure
@@ -85,6 +89,8 @@ class TimesliceIndex
   [[nodiscard]] inline size_t size() const;
   [[nodiscard]] inline bool isValid(TimesliceSlot const& slot) const;
   [[nodiscard]] inline bool isDirty(TimesliceSlot const& slot) const;
+  /// @return true if at least one slot needs to be checked by the completion policy
+  [[nodiscard]] inline bool hasDirtySlots() const;
   inline void markAsDirty(TimesliceSlot slot, bool value);
   inline void markAsInvalid(TimesliceSlot slot);
   /// Mark all the cachelines as invalid, e.g. due to an out of band event
@@ -147,8 +153,14 @@ class TimesliceIndex
   std::vector<data_matcher::VariableContext> mPublishedVariables;
 
   /// This keeps track whether or not something was relayed
-  /// since last time we called getReadyToProcess()
-  std::vector<bool> mDirty;
+  /// since last time we called getReadyToProcess(). One atomic flag
+  /// per slot rather than a std::vector<bool>, whose bits share the same
+  /// word and therefore cannot be updated concurrently.
+  std::unique_ptr<std::atomic<bool>[]> mDirty;
+  size_t mDirtySize = 0;
+  /// How many slots are currently dirty, so that we can skip the
+  /// completion check altogether when nothing changed.
+  std::atomic<size_t> mDirtyCount = 0;
 
   /// This is the oldest possible timeslice for any given channel
   /// The cardinality of this vector is the number of input channels
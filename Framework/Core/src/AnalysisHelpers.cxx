@@ -12,7 +12,7 @@
 
 namespace o2::framework
 {
-void initializePartitionCaches(std::set<uint32_t> const& hashes, std::shared_ptr<arrow::Schema> const& schema, expressions::Filter const& filter, gandiva::NodePtr& tree, gandiva::FilterPtr& gfilter)
+void initializePartitionCaches(std::set<uint32_t> const& hashes, std::shared_ptr<arrow::Schema> const& schema, expressions::Filter const& filter, gandiva::NodePtr& tree, gandiva::FilterPtr& gfilter, std::shared_ptr<expressions::InterpretedFilter>& ifilter)
 {
   if (tree == nullptr) {
     expressions::Operations ops = createOperations(filter);
@@ -21,8 +21,11 @@ void initializePartitionCaches(std::set<uint32_t> const& hashes, std::shared_ptr
     } else {
       throw std::runtime_error("Partition filter does not match declared table type");
     }
+    if (expressions::useFilterInterpreter()) {
+      ifilter = expressions::createInterpretedFilter(ops);
+    }
   }
-  if (gfilter == nullptr) {
+  if (gfilter == nullptr && ifilter == nullptr) {
     gfilter = framework::expressions::createFilter(schema, framework::expressions::makeCondition(tree));
   }
 }
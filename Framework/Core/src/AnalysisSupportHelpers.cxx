@@ -18,8 +18,12 @@
 #include "Framework/TableTreeHelpers.h"
 #include "Framework/PluginManager.h"
 #include "Framework/ConfigContext.h"
+#include "Framework/Logger.h"
 #include "WorkflowHelpers.h"
 
+#include <set>
+#include <sstream>
+
 template class std::vector<o2::framework::OutputObjectInfo>;
 template class std::vector<o2::framework::OutputTaskInfo>;
 
@@ -207,6 +211,73 @@ void AnalysisSupportHelpers::addMissingOutputsToBuilder(std::vector<InputSpec> c
   }
 }
 
+void AnalysisSupportHelpers::addColumnProjectionsToReader(std::vector<DataProcessorSpec>& workflow)
+{
+  auto reader = std::find_if(workflow.begin(), workflow.end(), [](DataProcessorSpec const& spec) { return spec.name == "internal-dpl-aod-reader"; });
+  if (reader == workflow.end()) {
+    return;
+  }
+  std::string projections;
+  for (auto& output : reader->outputs) {
+    if (!DataSpecUtils::partialMatch(output, AODOrigins)) {
+      continue;
+    }
+    std::set<std::string> columns;
+    bool allColumns = false;
+    for (auto& spec : workflow) {
+      if (spec.name == reader->name) {
+        continue;
+      }
+      for (auto& input : spec.inputs) {
+        if (!DataSpecUtils::match(input, output)) {
+          continue;
+        }
+        auto declared = std::count_if(input.metadata.begin(), input.metadata.end(), [&columns](ConfigParamSpec const& p) {
+          if (p.name.starts_with("column:")) {
+            columns.insert(p.name.substr(7));
+            return true;
+          }
+          return false;
+        });
+        // consumers which do not declare their columns read the whole table
+        allColumns = allColumns || declared == 0;
+      }
+    }
+    if (allColumns || columns.empty()) {
+      continue;
+    }
+    projections += (projections.empty() ? "" : ";") + DataSpecUtils::describe(output) + ":";
+    for (auto c = columns.begin(); c != columns.end(); ++c) {
+      projections += (c == columns.begin() ? "" : ",") + *c;
+    }
+  }
+  auto option = std::find_if(reader->options.begin(), reader->options.end(), [](ConfigParamSpec const& spec) { return spec.name == "aod-reader-columns"; });
+  if (option != reader->options.end()) {
+    option->defaultValue = projections;
+  }
+}
+
+std::map<std::string, std::set<std::string>> AnalysisSupportHelpers::parseColumnProjections(std::string const& projections)
+{
+  std::map<std::string, std::set<std::string>> result;
+  std::istringstream tables(projections);
+  std::string table;
+  while (std::getline(tables, table, ';')) {
+    auto pos = table.rfind(':');
+    if (pos == std::string::npos) {
+      LOGP(error, "Malformed column projection \"{}\", reading all columns", table);
+      continue;
+    }
+    std::istringstream names(table.substr(pos + 1));
+    std::string name;
+    auto& columns = result[table.substr(0, pos)];
+    while (std::getline(names, name, ',')) {
+      columns.insert(name);
+    }
+  }
+  return result;
+}
+
 // =============================================================================
 DataProcessorSpec AnalysisSupportHelpers::getOutputObjHistSink(ConfigContext const& ctx)
 {
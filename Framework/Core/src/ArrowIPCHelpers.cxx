@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowIPCHelpers.h"
+#include "Framework/RuntimeError.h"
+
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
+#include <arrow/ipc/writer.h>
+#include <arrow/record_batch.h>
+#include <arrow/table.h>
+#include <arrow/util/compression.h>
+
+namespace o2::framework
+{
+
+void ArrowIPCHelpers::writeTable(std::shared_ptr<arrow::Table> const& table, std::string const& path, std::string const& codec)
+{
+  auto options = arrow::ipc::IpcWriteOptions::Defaults();
+  if (codec == "lz4" || codec == "zstd") {
+    auto compressor = arrow::util::Codec::Create(codec == "lz4" ? arrow::Compression::LZ4_FRAME : arrow::Compression::ZSTD);
+    if (!compressor.ok()) {
+      throw runtime_error_f("Codec %s not available: %s", codec.c_str(), compressor.status().ToString().c_str());
+    }
+    options.codec = std::move(compressor).ValueOrDie();
+  } else if (codec != "none" && !codec.empty()) {
+    throw runtime_error_f("Unknown codec %s for Arrow IPC files, use lz4, zstd or none", codec.c_str());
+  }
+
+  auto file = arrow::io::FileOutputStream::Open(path);
+  if (!file.ok()) {
+    throw runtime_error_f("Could not open %s: %s", path.c_str(), file.status().ToString().c_str());
+  }
+  auto writer = arrow::ipc::MakeFileWriter(file.ValueOrDie(), table->schema(), options);
+  if (!writer.ok()) {
+    throw runtime_error_f("Could not create the writer for %s: %s", path.c_str(), writer.status().ToString().c_str());
+  }
+  auto status = writer.ValueOrDie()->WriteTable(*table);
+  if (status.ok()) {
+    status = writer.ValueOrDie()->Close();
+  }
+  if (status.ok()) {
+    status = file.ValueOrDie()->Close();
+  }
+  if (!status.ok()) {
+    throw runtime_error_f("Could not write %s: %s", path.c_str(), status.ToString().c_str());
+  }
+}
+
+namespace
+{
+std::shared_ptr<arrow::ipc::RecordBatchFileReader> openFile(std::string const& path)
+{
+  auto file = arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ);
+  if (!file.ok()) {
+    throw runtime_error_f("Could not open %s: %s", path.c_str(), file.status().ToString().c_str());
+  }
+  auto reader = arrow::ipc::RecordBatchFileReader::Open(file.ValueOrDie());
+  if (!reader.ok()) {
+    throw runtime_error_f("%s is not an Arrow IPC file: %s", path.c_str(), reader.status().ToString().c_str());
+  }
+  return reader.ValueOrDie();
+}
+} // namespace
+
+std::shared_ptr<arrow::Table> ArrowIPCHelpers::readTable(std::string const& path)
+{
+  auto fileReader = openFile(path);
+  std::vector<std::shared_ptr<arrow::RecordBatch>> batches;
+  for (int i = 0; i < fileReader->num_record_batches(); ++i) {
+    auto batch = fileReader->ReadRecordBatch(i);
+    if (!batch.ok()) {
+      throw runtime_error_f("Could not read batch %d of %s: %s", i, path.c_str(), batch.status().ToString().c_str());
+    }
+    batches.push_back(batch.ValueOrDie());
+  }
+  auto table = arrow::Table::FromRecordBatches(fileReader->schema(), batches);
+  if (!table.ok()) {
+    throw runtime_error_f("Could not create the table of %s: %s", path.c_str(), table.status().ToString().c_str());
+  }
+  return table.ValueOrDie();
+}
+
+std::shared_ptr<arrow::Schema> ArrowIPCHelpers::readSchema(std::string const& path)
+{
+  return openFile(path)->schema();
+}
+
+} // namespace o2::framework
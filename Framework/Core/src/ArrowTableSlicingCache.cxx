@@ -16,6 +16,8 @@
 #include <arrow/compute/kernel.h>
 #include <arrow/table.h>
 
+#include <algorithm>
+
 namespace o2::framework
 {
 
@@ -26,7 +28,75 @@ void updatePairList(std::vector<StringPair>& list, std::string const& binding, s
   }
 }
 
+void SortedSliceIndex::build(gsl::span<int const> values, gsl::span<int64_t const> counts)
+{
+  clear();
+  offsets.resize(values.size() + 1);
+  int maxKey = -1;
+  size_t nKeys = 0;
+  offsets[0] = 0;
+  for (auto i = 0U; i < values.size(); ++i) {
+    offsets[i + 1] = offsets[i] + counts[i];
+    if (values[i] >= 0) {
+      maxKey = std::max(maxKey, values[i]);
+      ++nKeys;
+    }
+  }
+  // a table indexed by the key unless it would be much larger than the keys themselves
+  if (maxKey < 0 || static_cast<size_t>(maxKey) < 8 * nKeys + 1024) {
+    positions.resize(maxKey + 1, -1);
+    for (auto i = 0U; i < values.size(); ++i) {
+      if (values[i] >= 0) {
+        positions[values[i]] = i;
+      }
+    }
+  } else {
+    keys.reserve(nKeys);
+    keyPositions.reserve(nKeys);
+    for (auto i = 0U; i < values.size(); ++i) {
+      if (values[i] >= 0) { // the non-negative keys are sorted, as checked by validateOrder
+        keys.push_back(values[i]);
+        keyPositions.push_back(i);
+      }
+    }
+  }
+}
+
+void SortedSliceIndex::clear()
+{
+  offsets.clear();
+  positions.clear();
+  keys.clear();
+  keyPositions.clear();
+}
+
 std::pair<int64_t, int64_t> SliceInfoPtr::getSliceFor(int value) const
+{
+  if (index == nullptr || index->offsets.empty() || value < 0) {
+    return scanSliceFor(value);
+  }
+  int p = -1;
+  if (!index->keys.empty()) {
+    if (value > index->keys.back()) {
+      return {0, 0};
+    }
+    auto it = std::lower_bound(index->keys.begin(), index->keys.end(), value);
+    if (*it == value) {
+      p = index->keyPositions[std::distance(index->keys.begin(), it)];
+    }
+  } else {
+    if (static_cast<size_t>(value) >= index->positions.size()) {
+      return {0, 0};
+    }
+    p = index->positions[value];
+  }
+  if (p < 0) {
+    return {index->offsets.back(), 0};
+  }
+  return {index->offsets[p], counts[p]};
+}
+
+std::pair<int64_t, int64_t> SliceInfoPtr::scanSliceFor(int value) const
 {
   int64_t offset = 0;
   if (values.empty()) {
@@ -81,6 +151,7 @@ ArrowTableSlicingCache::ArrowTableSlicingCache(std::vector<StringPair>&& bsks, s
 {
   values.resize(bindingsKeys.size());
   counts.resize(bindingsKeys.size());
+  indices.resize(bindingsKeys.size());
 
   valuesUnsorted.resize(bindingsKeysUnsorted.size());
   groups.resize(bindingsKeysUnsorted.size());
@@ -94,6 +165,8 @@ void ArrowTableSlicingCache::setCaches(std::vector<StringPair>&& bsks, std::vect
   values.resize(bindingsKeys.size());
   counts.clear();
   counts.resize(bindingsKeys.size());
+  indices.clear();
+  indices.resize(bindingsKeys.size());
   valuesUnsorted.clear();
   valuesUnsorted.resize(bindingsKeysUnsorted.size());
   groups.clear();
@@ -105,6 +178,7 @@ arrow::Status ArrowTableSlicingCache::updateCacheEntry(int pos, std::shared_ptr<
   if (table->num_rows() == 0) {
     values[pos].reset();
     counts[pos].reset();
+    indices[pos].clear();
     return arrow::Status::OK();
   }
   validateOrder(bindingsKeys[pos], table);
@@ -118,6 +192,8 @@ arrow::Status ArrowTableSlicingCache::updateCacheEntry(int pos, std::shared_ptr<
   counts[pos].reset();
   values[pos] = std::make_shared<arrow::NumericArray<arrow::Int32Type>>(pair.field(0)->data());
   counts[pos] = std::make_shared<arrow::NumericArray<arrow::Int64Type>>(pair.field(1)->data());
+  auto info = getCacheForPos(pos);
+  indices[pos].build(info.values, info.counts);
   return arrow::Status::OK();
 }
 
@@ -136,12 +212,12 @@ arrow::Status ArrowTableSlicingCache::updateCacheEntryUnsorted(int pos, const st
     for (auto iElement = 0; iElement < chunk.length(); ++iElement) {
       auto v = chunk.Value(iElement);
       if (v >= 0) {
-        if (std::find(valuesUnsorted[pos].begin(), valuesUnsorted[pos].end(), v) == valuesUnsorted[pos].end()) {
-          valuesUnsorted[pos].push_back(v);
-        }
         if (groups[pos].size() <= v) {
           groups[pos].resize(v + 1);
         }
+        if ((groups[pos])[v].empty()) { // first occurrence of the value
+          valuesUnsorted[pos].push_back(v);
+        }
         (groups[pos])[v].push_back(row);
       }
       ++row;
@@ -212,7 +288,8 @@ SliceInfoPtr ArrowTableSlicingCache::getCacheForPos(int pos) const
 
   return {
     {reinterpret_cast<int const*>(values[pos]->values()->data()), static_cast<size_t>(values[pos]->length())},
-    {reinterpret_cast<int64_t const*>(counts[pos]->values()->data()), static_cast<size_t>(counts[pos]->length())} //
+    {reinterpret_cast<int64_t const*>(counts[pos]->values()->data()), static_cast<size_t>(counts[pos]->length())},
+    &indices[pos] //
   };
 }
 
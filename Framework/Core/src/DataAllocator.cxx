@@ -15,6 +15,7 @@
 #include "Framework/MessageContext.h"
 #include "Framework/ArrowContext.h"
 #include "Framework/DataSpecUtils.h"
+#include "Framework/DataRefUtils.h"
 #include "Framework/DataProcessingHeader.h"
 #include "Framework/FairMQResizableBuffer.h"
 #include "Framework/DataProcessingContext.h"
@@ -365,6 +366,32 @@ void DataAllocator::snapshot(const Output& spec, const char* payload, size_t pay
   addPartToContext(routeIndex, std::move(payloadMessage), spec, serializationMethod);
 }
 
+void DataAllocator::forward(const Output& spec, DataRef const& ref)
+{
+  auto const* inputHeader = DataRefUtils::getHeader<DataHeader*>(ref);
+  auto& proxy = mRegistry.get<FairMQDeviceProxy>();
+  auto& timingInfo = mRegistry.get<TimingInfo>();
+  RouteIndex routeIndex = matchDataHeader(spec, timingInfo.timeslice);
+
+  addPartToContext(routeIndex, forwardedMessage(*proxy.getOutputTransport(routeIndex), ref), spec, inputHeader->payloadSerializationMethod);
+}
+
+fair::mq::MessagePtr DataAllocator::forwardedMessage(fair::mq::TransportFactory& transport, DataRef const& ref)
+{
+  auto payloadSize = DataRefUtils::getPayloadSize(ref);
+  auto const* input = ref.payloadMessage;
+  // the whole message is shared, so it must hold exactly the payload
+  if (input == nullptr || input->GetTransport()->GetType() != transport.GetType() ||
+      input->GetData() != ref.payload || input->GetSize() != payloadSize) {
+    fair::mq::MessagePtr payloadMessage = transport.CreateMessage(payloadSize, fair::mq::Alignment{64});
+    memcpy(payloadMessage->GetData(), ref.payload, payloadSize);
+    return payloadMessage;
+  }
+  fair::mq::MessagePtr payloadMessage = transport.CreateMessage();
+  payloadMessage->Copy(*input);
+  return payloadMessage;
+}
+
 Output DataAllocator::getOutputByBind(OutputRef&& ref)
 {
   if (ref.label.empty()) {
@@ -508,6 +508,19 @@ FileAndFolder DataOutputDirector::getFileFolder(DataOutputDescriptor* dodesc, ui
   return fileAndFolder;
 }
 
+std::string DataOutputDirector::getArrowFileName(DataOutputDescriptor* dodesc, uint64_t folderNumber)
+{
+  auto dirname = mresultDirectory + "/" + dodesc->getFilenameBase() + "/DF_" + std::to_string(folderNumber);
+  auto dir = fs::path{dirname.c_str()};
+  if (!fs::is_directory(dir)) {
+    if (!fs::create_directories(dir)) {
+      LOGF(fatal, "Could not create output directory %s", dirname.c_str());
+    }
+  }
+
+  return dirname + "/" + dodesc->treename + ".arrow";
+}
+
 bool DataOutputDirector::checkFileSizes()
 {
   // is the maximum-file-size check enabled?
@@ -70,9 +70,10 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
     mCompletionPolicy{policy},
     mDistinctRoutesIndex{DataRelayerHelpers::createDistinctRouteIndex(routes)},
     mInputMatchers{DataRelayerHelpers::createInputMatchers(routes)},
-    mMaxLanes{InputRouteHelpers::maxLanes(routes)}
+    mMaxLanes{InputRouteHelpers::maxLanes(routes)},
+    mLaneMutexes{std::make_unique<std::recursive_mutex[]>(mMaxLanes)}
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
 
   if (policy.configureRelayer == nullptr) {
     static int pipelineLength = DefaultsHelpers::pipelineLength();
@@ -102,7 +103,7 @@ DataRelayer::DataRelayer(const CompletionPolicy& policy,
 
 TimesliceId DataRelayer::getTimesliceForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   auto& variables = mTimesliceIndex.getVariablesForSlot(slot);
   return VariableContextHelpers::getTimeslice(variables);
 }
@@ -111,7 +112,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
                                                               ServiceRegistryRef services, bool createNew)
 {
   LOGP(debug, "DataRelayer::processDanglingInputs");
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
   auto& deviceProxy = services.get<FairMQDeviceProxy>();
 
   ActivityStats activity;
@@ -220,6 +221,7 @@ DataRelayer::ActivityStats DataRelayer::processDanglingInputs(std::vector<Expira
       PartRef newRef;
       expirator.handler(services, newRef, variables);
       part.reset(std::move(newRef));
+      markRouteReady(slot, expirator.routeIndex.value);
       activity.expiredSlots++;
 
       mTimesliceIndex.markAsDirty(slot, true);
@@ -281,8 +283,23 @@ void sendVariableContextMetrics(VariableContext& context, TimesliceSlot slot, Da
                   &states, slot);
 }
 
+void DataRelayer::AllLanes::lock()
+{
+  for (size_t li = 0; li < relayer.mMaxLanes; ++li) {
+    relayer.mLaneMutexes[li].lock();
+  }
+}
+
+void DataRelayer::AllLanes::unlock()
+{
+  for (size_t li = relayer.mMaxLanes; li > 0; --li) {
+    relayer.mLaneMutexes[li - 1].unlock();
+  }
+}
+
 void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex channel)
 {
+  std::scoped_lock<AllLanes> lock(mAllLanes);
   auto newOldest = mTimesliceIndex.setOldestPossibleInput(proposed, channel);
   LOGP(debug, "DataRelayer::setOldestPossibleInput {} from channel {}", newOldest.timeslice.value, newOldest.channel.value);
   static bool dontDrop = getenv("DPL_DONT_DROP_OLD_TIMESLICE") && atoi(getenv("DPL_DONT_DROP_OLD_TIMESLICE"));
@@ -299,7 +316,10 @@ void DataRelayer::setOldestPossibleInput(TimesliceId proposed, ChannelIndex chan
       }
       continue;
     }
-    mPruneOps.push_back(PruneOp{si});
+    {
+      std::scoped_lock<O2_LOCKABLE(std::mutex)> pruneLock(mPruneOpsMutex);
+      mPruneOps.push_back(PruneOp{si});
+    }
     bool didDrop = false;
     for (size_t mi = 0; mi < mInputs.size(); ++mi) {
       auto& input = mInputs[mi];
@@ -350,10 +370,15 @@ TimesliceIndex::OldestOutputInfo DataRelayer::getOldestPossibleOutput() const
 
 void DataRelayer::prunePending(OnDropCallback onDrop)
 {
-  for (auto& op : mPruneOps) {
+  std::scoped_lock<AllLanes> lock(mAllLanes);
+  std::vector<PruneOp> pruneOps;
+  {
+    std::scoped_lock<O2_LOCKABLE(std::mutex)> pruneLock(mPruneOpsMutex);
+    pruneOps.swap(mPruneOps);
+  }
+  for (auto& op : pruneOps) {
     this->pruneCache(op.slot, onDrop);
   }
-  mPruneOps.clear();
 }
 
 void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
@@ -400,6 +425,7 @@ void DataRelayer::pruneCache(TimesliceSlot slot, OnDropCallback onDrop)
   };
 
   pruneCache(slot);
+  clearReadyRoutes(slot);
 }
 
 bool isCalibrationData(std::unique_ptr<fair::mq::Message>& first)
@@ -416,8 +442,10 @@ DataRelayer::RelayChoice
                      size_t nPayloads,
                      std::function<void(TimesliceSlot, std::vector<MessageSet>&, TimesliceIndex::OldestOutputInfo)> onDrop)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
   DataProcessingHeader const* dph = o2::header::get<DataProcessingHeader*>(rawHeader);
+  // Only the slots of the lane of the incoming data can be touched, so
+  // we do not need to block the other lanes.
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(dph->startTime));
   // IMPLEMENTATION DETAILS
   //
   // This returns true if a given slot is available for the current number of lanes
@@ -564,12 +592,16 @@ DataRelayer::RelayChoice
   if (input != INVALID_INPUT && TimesliceId::isValid(timeslice) && TimesliceSlot::isValid(slot)) {
     if (needsCleaning) {
       this->pruneCache(slot, onDrop);
-      mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
+      {
+        std::scoped_lock<O2_LOCKABLE(std::mutex)> pruneLock(mPruneOpsMutex);
+        mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
+      }
     }
     size_t saved = saveInSlot(timeslice, input, slot, info);
     if (saved == 0) {
       return RelayChoice{.type = RelayChoice::Type::Dropped, .timeslice = timeslice};
     }
+    markRouteReady(slot, input);
     index.publishSlot(slot);
     index.markAsDirty(slot, true);
     stats.updateStats({static_cast<short>(ProcessingStatsId::RELAYED_MESSAGES), DataProcessingStats::Op::Add, (int)1});
@@ -650,11 +682,15 @@ DataRelayer::RelayChoice
       // At this point the variables match the new input but the
       // cache still holds the old data, so we prune it.
       this->pruneCache(slot, onDrop);
-      mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
+      {
+        std::scoped_lock<O2_LOCKABLE(std::mutex)> pruneLock(mPruneOpsMutex);
+        mPruneOps.erase(std::remove_if(mPruneOps.begin(), mPruneOps.end(), [slot](const auto& x) { return x.slot == slot; }), mPruneOps.end());
+      }
       size_t saved = saveInSlot(timeslice, input, slot, info);
       if (saved == 0) {
         return RelayChoice{.type = RelayChoice::Type::Dropped, .timeslice = timeslice};
       }
+      markRouteReady(slot, input);
       index.publishSlot(slot);
       index.markAsDirty(slot, true);
       return RelayChoice{.type = RelayChoice::Type::WillRelay};
@@ -665,7 +701,6 @@ DataRelayer::RelayChoice
 void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& completed)
 {
   LOGP(debug, "DataRelayer::getReadyToProcess");
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
 
   // THE STATE
   const auto& cache = mCache;
@@ -710,6 +745,14 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
     LOGP(debug, "numInputTypes == 0, returning.");
     return;
   }
+  // Only slots which were touched by relay / processDanglingInputs (or
+  // explicitly rescanned) need to be checked again.
+  if (mTimesliceIndex.hasDirtySlots() == false) {
+    LOGP(debug, "No dirty slots, nothing to check.");
+    std::scoped_lock<AllLanes> lock(mAllLanes);
+    mTimesliceIndex.updateOldestPossibleOutput(false);
+    return;
+  }
   size_t cacheLines = cache.size() / numInputTypes;
   assert(cacheLines * numInputTypes == cache.size());
   int countConsume = 0;
@@ -718,22 +761,35 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
   int countDiscard = 0;
   int countWait = 0;
   int notDirty = 0;
+  int notValid = 0;
 
   for (int li = cacheLines - 1; li >= 0; --li) {
     TimesliceSlot slot{(size_t)li};
     // We only check the cachelines which have been updated by an incoming
-    // message.
+    // message. The dirty flag is atomic, so we can skip clean slots without
+    // taking the lock of their lane.
     if (mTimesliceIndex.isDirty(slot) == false) {
       notDirty++;
       continue;
     }
+    // Only the lane of the slot is locked while we check it, so that data
+    // for the other lanes can still be relayed.
+    std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
     if (!mCompletionPolicy.callbackFull) {
       throw runtime_error_f("Completion police %s has no callback set", mCompletionPolicy.name.c_str());
     }
+    // A slot without timeslice cannot result in any action, no need to ask the policy.
+    if (mTimesliceIndex.isValid(slot) == false) {
+      notValid++;
+      mTimesliceIndex.markAsDirty(slot, false);
+      continue;
+    }
     auto partial = getPartialRecord(li);
     // TODO: get the data ref from message model
-    auto getter = [&partial](size_t idx, size_t part) {
-      if (partial[idx].size() > 0 && partial[idx].header(part).get()) {
+    // Routes which did not receive anything are rejected via the readiness bits,
+    // so that for devices with many inputs we only touch the cache of the ready ones.
+    auto getter = [&partial, slot, this](size_t idx, size_t part) {
+      if (isRouteReady(slot, idx) && partial[idx].size() > 0 && partial[idx].header(part).get()) {
         auto header = partial[idx].header(part).get();
         auto payload = partial[idx].payload(part).get();
         return DataRef{nullptr,
@@ -743,8 +799,8 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
       }
       return DataRef{};
     };
-    auto nPartsGetter = [&partial](size_t idx) {
-      return partial[idx].size();
+    auto nPartsGetter = [&partial, slot, this](size_t idx) -> size_t {
+      return isRouteReady(slot, idx) ? partial[idx].size() : 0;
     };
     InputSpan span{getter, nPartsGetter, static_cast<size_t>(partial.size())};
     CompletionPolicy::CompletionOp action = mCompletionPolicy.callbackFull(span, mInputs, mContext);
@@ -790,15 +846,18 @@ void DataRelayer::getReadyToProcess(std::vector<DataRelayer::RecordAction>& comp
         break;
     }
   }
-  mTimesliceIndex.updateOldestPossibleOutput(false);
-  LOGP(debug, "DataRelayer::getReadyToProcess results notDirty:{}, consume:{}, consumeExisting:{}, process:{}, discard:{}, wait:{}",
-       notDirty, countConsume, countConsumeExisting, countProcess,
+  {
+    std::scoped_lock<AllLanes> lock(mAllLanes);
+    mTimesliceIndex.updateOldestPossibleOutput(false);
+  }
+  LOGP(debug, "DataRelayer::getReadyToProcess results notDirty:{}, notValid:{}, consume:{}, consumeExisting:{}, process:{}, discard:{}, wait:{}",
+       notDirty, notValid, countConsume, countConsumeExisting, countProcess,
        countDiscard, countWait);
 }
 
 void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStatus, CacheEntryStatus newStatus)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   const auto numInputTypes = mDistinctRoutesIndex.size();
 
   auto markInputDone = [&cachedStateMetrics = mCachedStateMetrics,
@@ -816,7 +875,7 @@ void DataRelayer::updateCacheStatus(TimesliceSlot slot, CacheEntryStatus oldStat
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
 
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
@@ -864,13 +923,14 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeAllInputsForTimeslice
     moveHeaderPayloadToOutput(slot, ai);
   }
   invalidateCacheFor(slot);
+  clearReadyRoutes(slot);
 
   return messages;
 }
 
 std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTimeslice(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
 
   const auto numInputTypes = mDistinctRoutesIndex.size();
   // State of the computation
@@ -913,11 +973,12 @@ std::vector<o2::framework::MessageSet> DataRelayer::consumeExistingInputsForTime
 
 void DataRelayer::clear()
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
 
   for (auto& cache : mCache) {
     cache.clear();
   }
+  std::fill(mReadyRoutes.begin(), mReadyRoutes.end(), 0);
   for (size_t s = 0; s < mTimesliceIndex.size(); ++s) {
     mTimesliceIndex.markAsInvalid(TimesliceSlot{s});
   }
@@ -935,7 +996,7 @@ size_t
 /// the time pipelining.
 void DataRelayer::setPipelineLength(size_t s)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
 
   mTimesliceIndex.resize(s);
   mVariableContextes.resize(s);
@@ -944,7 +1005,7 @@ void DataRelayer::setPipelineLength(size_t s)
 
 void DataRelayer::publishMetrics()
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
 
   auto numInputTypes = mDistinctRoutesIndex.size();
   // FIXME: many of the DataRelayer function rely on allocated cache, so its
@@ -954,6 +1015,8 @@ void DataRelayer::publishMetrics()
   auto& states = mContext.get<DataProcessingStates>();
 
   mCachedStateMetrics.resize(mCache.size());
+  mReadyRoutesWords = (numInputTypes + 63) / 64;
+  mReadyRoutes.resize(mReadyRoutesWords * mTimesliceIndex.size());
 
   // There is maximum 16 variables available. We keep them row-wise so that
   // that we can take mod 16 of the index to understand which variable we
@@ -981,31 +1044,31 @@ void DataRelayer::publishMetrics()
 
 uint32_t DataRelayer::getFirstTFOrbitForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   return VariableContextHelpers::getFirstTFOrbit(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint32_t DataRelayer::getFirstTFCounterForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   return VariableContextHelpers::getFirstTFCounter(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint32_t DataRelayer::getRunNumberForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   return VariableContextHelpers::getRunNumber(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 uint64_t DataRelayer::getCreationTimeForSlot(TimesliceSlot slot)
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(laneMutex(slot.index));
   return VariableContextHelpers::getCreationTime(mTimesliceIndex.getVariablesForSlot(slot));
 }
 
 void DataRelayer::sendContextState()
 {
-  std::scoped_lock<O2_LOCKABLE(std::recursive_mutex)> lock(mMutex);
+  std::scoped_lock<AllLanes> lock(mAllLanes);
   auto& states = mContext.get<DataProcessingStates>();
   for (size_t ci = 0; ci < mTimesliceIndex.size(); ++ci) {
     auto slot = TimesliceSlot{ci};
@@ -0,0 +1,564 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ExpressionHelpers.h"
+#include "Framework/RuntimeError.h"
+#include <arrow/array.h>
+#include <arrow/table.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <type_traits>
+#include <unordered_map>
+#include <variant>
+
+namespace o2::framework::expressions
+{
+
+/// The operation sequences of the filters applied to a table. A row is selected
+/// if all of them evaluate to true.
+struct InterpretedFilter {
+  std::vector<Operations> conjunction;
+};
+
+namespace
+{
+bool isSupportedType(atype::type t)
+{
+  switch (t) {
+    case atype::BOOL:
+    case atype::UINT8:
+    case atype::INT8:
+    case atype::UINT16:
+    case atype::INT16:
+    case atype::UINT32:
+    case atype::INT32:
+    case atype::UINT64:
+    case atype::INT64:
+    case atype::FLOAT:
+    case atype::DOUBLE:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool isIntegerType(atype::type t)
+{
+  return isSupportedType(t) && t != atype::BOOL && t != atype::FLOAT && t != atype::DOUBLE;
+}
+
+bool isFloatingType(atype::type t)
+{
+  return t == atype::FLOAT || t == atype::DOUBLE;
+}
+
+/// call @a f with a std::type_identity of the C++ type used for the values of arrow type @a t,
+/// booleans are stored as one byte per value
+template <typename F>
+void dispatchType(atype::type t, F&& f)
+{
+  switch (t) {
+    case atype::BOOL:
+      return f(std::type_identity<uint8_t>{});
+    case atype::UINT8:
+      return f(std::type_identity<uint8_t>{});
+    case atype::INT8:
+      return f(std::type_identity<int8_t>{});
+    case atype::UINT16:
+      return f(std::type_identity<uint16_t>{});
+    case atype::INT16:
+      return f(std::type_identity<int16_t>{});
+    case atype::UINT32:
+      return f(std::type_identity<uint32_t>{});
+    case atype::INT32:
+      return f(std::type_identity<int32_t>{});
+    case atype::UINT64:
+      return f(std::type_identity<uint64_t>{});
+    case atype::INT64:
+      return f(std::type_identity<int64_t>{});
+    case atype::FLOAT:
+      return f(std::type_identity<float>{});
+    case atype::DOUBLE:
+      return f(std::type_identity<double>{});
+    default:
+      throw runtime_error_f("Type %s is not supported by the filter interpreter", stringType(t));
+  }
+}
+
+/// the type both operands of an operation are converted to before it is applied,
+/// following the upcasts of createExpressionTree
+atype::type operationType(ColumnOperationSpec const& spec)
+{
+  switch (spec.op) {
+    case BasicOp::LogicalAnd:
+    case BasicOp::LogicalOr:
+      return atype::BOOL;
+    case BasicOp::LessThan:
+    case BasicOp::LessThanOrEqual:
+    case BasicOp::GreaterThan:
+    case BasicOp::GreaterThanOrEqual:
+    case BasicOp::Equal:
+    case BasicOp::NotEqual:
+      // the order of the arrow type ids is the order of the numeric upcasts
+      return std::max(spec.left.type, spec.right.type);
+    default:
+      return spec.type;
+  }
+}
+
+bool isSupported(ColumnOperationSpec const& spec)
+{
+  auto typesOk = [&spec](std::initializer_list<DatumSpec const*> operands) {
+    return std::all_of(operands.begin(), operands.end(), [](DatumSpec const* d) { return isSupportedType(d->type); }) && isSupportedType(spec.type);
+  };
+  switch (spec.op) {
+    case BasicOp::LogicalAnd:
+    case BasicOp::LogicalOr:
+      return spec.left.type == atype::BOOL && spec.right.type == atype::BOOL;
+    case BasicOp::LessThan:
+    case BasicOp::LessThanOrEqual:
+    case BasicOp::GreaterThan:
+    case BasicOp::GreaterThanOrEqual:
+    case BasicOp::Equal:
+    case BasicOp::NotEqual:
+    case BasicOp::Addition:
+    case BasicOp::Subtraction:
+    case BasicOp::Multiplication:
+      return typesOk({&spec.left, &spec.right});
+    case BasicOp::Division:
+      // integer division by zero is an error in gandiva
+      return typesOk({&spec.left, &spec.right}) && isFloatingType(spec.type);
+    case BasicOp::BitwiseAnd:
+    case BasicOp::BitwiseOr:
+    case BasicOp::BitwiseXor:
+      return typesOk({&spec.left, &spec.right}) && isIntegerType(spec.type);
+    case BasicOp::Abs:
+      return typesOk({&spec.left}) && isFloatingType(spec.type);
+    case BasicOp::Conditional:
+      return typesOk({&spec.left, &spec.right}) && spec.condition.type == atype::BOOL;
+    default:
+      return false;
+  }
+}
+
+/// an operand of an operation: either a column of the batch, the result of another
+/// operation or a literal. valid is nullptr if none of its values is null
+struct Operand {
+  atype::type type = atype::NA;
+  void const* data = nullptr;
+  LiteralNode::var_t literal;
+  uint8_t const* valid = nullptr;
+};
+
+/// values of an operand converted to T, data is nullptr for a literal
+template <typename T>
+struct Values {
+  T const* data = nullptr;
+  T literal{};
+};
+
+template <typename T>
+Values<T> convert(Operand const& operand, std::vector<T>& scratch, size_t n)
+{
+  Values<T> values;
+  if (operand.data == nullptr) {
+    std::visit([&values](auto v) { values.literal = static_cast<T>(v); }, operand.literal);
+    return values;
+  }
+  dispatchType(operand.type, [&]<typename S>(std::type_identity<S>) {
+    if constexpr (std::is_same_v<S, T>) {
+      values.data = static_cast<T const*>(operand.data);
+    } else {
+      auto* source = static_cast<S const*>(operand.data);
+      scratch.resize(n);
+      for (size_t i = 0; i < n; ++i) {
+        scratch[i] = static_cast<T>(source[i]);
+      }
+      values.data = scratch.data();
+    }
+  });
+  return values;
+}
+
+/// the element-wise loops, with the literal operands kept out of the loops so that
+/// the compiler can vectorize them
+template <typename T, typename R, typename Op>
+void apply(Values<T> const& l, Values<T> const& r, R* out, size_t n, Op op)
+{
+  if (l.data != nullptr && r.data != nullptr) {
+    auto const* __restrict__ a = l.data;
+    auto const* __restrict__ b = r.data;
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = static_cast<R>(op(a[i], b[i]));
+    }
+  } else if (l.data != nullptr) {
+    auto const* __restrict__ a = l.data;
+    auto const b = r.literal;
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = static_cast<R>(op(a[i], b));
+    }
+  } else if (r.data != nullptr) {
+    auto const a = l.literal;
+    auto const* __restrict__ b = r.data;
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = static_cast<R>(op(a, b[i]));
+    }
+  } else {
+    std::fill(out, out + n, static_cast<R>(op(l.literal, r.literal)));
+  }
+}
+
+/// integer arithmetic wraps around as in gandiva
+template <typename T, typename Op>
+constexpr auto wrapping(Op op)
+{
+  return [op](T a, T b) {
+    if constexpr (std::is_integral_v<T>) {
+      using U = std::make_unsigned_t<T>;
+      return static_cast<T>(op(static_cast<U>(a), static_cast<U>(b)));
+    } else {
+      return op(a, b);
+    }
+  };
+}
+
+using ResultColumn = std::variant<std::monostate,
+                                  std::vector<uint8_t>, std::vector<int8_t>,
+                                  std::vector<uint16_t>, std::vector<int16_t>,
+                                  std::vector<uint32_t>, std::vector<int32_t>,
+                                  std::vector<uint64_t>, std::vector<int64_t>,
+                                  std::vector<float>, std::vector<double>>;
+
+/// Evaluates operation sequences on a record batch. Null values are handled as in gandiva:
+/// they propagate through the operations, except for logical 'and' and 'or' where the
+/// other operand can decide the result, a null condition selects the 'else' branch and
+/// the rows for which the filter is null are not selected.
+class BatchEvaluator
+{
+ public:
+  explicit BatchEvaluator(arrow::RecordBatch const& batch) : mBatch{batch}, mRows{static_cast<size_t>(batch.num_rows())} {}
+
+  /// the values of the filter (0 or 1) of each row of the batch
+  std::vector<uint8_t> evaluate(Operations const& opSpecs)
+  {
+    mResults.clear();
+    mResults.resize(opSpecs.size());
+    mValid.clear();
+    mValid.resize(opSpecs.size());
+    for (auto it = opSpecs.rbegin(); it != opSpecs.rend(); ++it) {
+      evaluate(*it);
+    }
+    auto values = std::move(std::get<std::vector<uint8_t>>(mResults[0]));
+    if (!mValid[0].empty()) {
+      for (size_t i = 0; i < mRows; ++i) {
+        values[i] &= mValid[0][i];
+      }
+    }
+    return values;
+  }
+
+ private:
+  Operand operand(DatumSpec const& spec)
+  {
+    Operand o{spec.type, nullptr, {}};
+    switch (spec.datum.index()) {
+      case 1: // result of another operation
+        std::visit([&o](auto const& v) {
+          if constexpr (!std::is_same_v<std::decay_t<decltype(v)>, std::monostate>) {
+            o.data = v.data();
+          }
+        },
+                   mResults[std::get<size_t>(spec.datum)]);
+        if (auto const& valid = mValid[std::get<size_t>(spec.datum)]; !valid.empty()) {
+          o.valid = valid.data();
+        }
+        break;
+      case 2: // literal
+        o.literal = std::get<LiteralNode::var_t>(spec.datum);
+        break;
+      case 3: // column
+        o.data = column(std::get<std::string>(spec.datum), spec.type);
+        o.valid = validity(std::get<std::string>(spec.datum));
+        break;
+      default:
+        throw runtime_error("Malformed DatumSpec");
+    }
+    return o;
+  }
+
+  void const* column(std::string const& name, atype::type type)
+  {
+    auto array = mBatch.GetColumnByName(name);
+    if (array == nullptr) {
+      throw runtime_error_f("Cannot find field \"%s\"", name.c_str());
+    }
+    if (array->type_id() != type) {
+      throw runtime_error_f("Field \"%s\" has type %s instead of %s", name.c_str(), stringType(array->type_id()), stringType(type));
+    }
+    if (type == atype::BOOL) {
+      // unpack the bits, once for each batch
+      auto& unpacked = mBooleans[name];
+      if (unpacked.size() != mRows) {
+        auto const& values = static_cast<arrow::BooleanArray const&>(*array);
+        unpacked.resize(mRows);
+        for (size_t i = 0; i < mRows; ++i) {
+          unpacked[i] = values.Value(i);
+        }
+      }
+      return unpacked.data();
+    }
+    void const* data = nullptr;
+    dispatchType(type, [&]<typename T>(std::type_identity<T>) {
+      data = array->data()->GetValues<T>(1);
+    });
+    return data;
+  }
+
+  /// the validity of the values of a column, nullptr if none of them is null
+  uint8_t const* validity(std::string const& name)
+  {
+    auto array = mBatch.GetColumnByName(name);
+    if (array->null_count() == 0) {
+      return nullptr;
+    }
+    auto& unpacked = mValidities[name];
+    if (unpacked.size() != mRows) {
+      unpacked.resize(mRows);
+      for (size_t i = 0; i < mRows; ++i) {
+        unpacked[i] = array->IsValid(i);
+      }
+    }
+    return unpacked.data();
+  }
+
+  /// a row of the result is valid if it is valid in all the operands
+  void propagateValidity(std::initializer_list<Operand const*> operands, std::vector<uint8_t>& valid) const
+  {
+    for (auto const* o : operands) {
+      if (o->valid == nullptr) {
+        continue;
+      }
+      if (valid.empty()) {
+        valid.assign(o->valid, o->valid + mRows);
+      } else {
+        for (size_t i = 0; i < mRows; ++i) {
+          valid[i] &= o->valid[i];
+        }
+      }
+    }
+  }
+
+  /// logical 'and' and 'or' with null operands: the result is valid if an operand decides it
+  /// (false for 'and', true for 'or') or if both operands are valid
+  void logicalWithNulls(bool isAnd, Operand const& left, Operand const& right, ResultColumn& result, std::vector<uint8_t>& valid)
+  {
+    std::vector<uint8_t> scratchLeft, scratchRight;
+    auto l = convert<uint8_t>(left, scratchLeft, mRows);
+    auto r = convert<uint8_t>(right, scratchRight, mRows);
+    auto& out = result.emplace<std::vector<uint8_t>>(mRows);
+    valid.resize(mRows);
+    for (size_t i = 0; i < mRows; ++i) {
+      bool validLeft = left.valid == nullptr || left.valid[i];
+      bool validRight = right.valid == nullptr || right.valid[i];
+      bool decides = (validLeft && (l.data != nullptr ? l.data[i] : l.literal) != isAnd) ||
+                     (validRight && (r.data != nullptr ? r.data[i] : r.literal) != isAnd);
+      out[i] = decides != isAnd;
+      valid[i] = decides || (validLeft && validRight);
+    }
+  }
+
+  void evaluate(ColumnOperationSpec const& spec)
+  {
+    auto& result = mResults[std::get<size_t>(spec.result.datum)];
+    auto& valid = mValid[std::get<size_t>(spec.result.datum)];
+    auto left = operand(spec.left);
+    if (spec.op == BasicOp::Abs) {
+      propagateValidity({&left}, valid);
+      dispatchType(spec.type, [&]<typename T>(std::type_identity<T>) {
+        if constexpr (std::is_floating_point_v<T>) {
+          std::vector<T> scratch;
+          auto l = convert<T>(left, scratch, mRows);
+          auto& out = result.emplace<std::vector<T>>(mRows);
+          apply(l, l, out.data(), mRows, [](T a, T) { return std::abs(a); });
+        }
+      });
+      return;
+    }
+    auto right = operand(spec.right);
+    if (spec.op == BasicOp::Conditional) {
+      auto condition = operand(spec.condition);
+      std::vector<uint8_t> scratchCondition;
+      auto c = convert<uint8_t>(condition, scratchCondition, mRows);
+      auto select = [&](size_t i) -> bool {
+        return (condition.valid == nullptr || condition.valid[i]) && (c.data != nullptr ? c.data[i] : c.literal);
+      };
+      dispatchType(spec.type, [&]<typename T>(std::type_identity<T>) {
+        std::vector<T> scratchLeft, scratchRight;
+        auto l = convert<T>(left, scratchLeft, mRows);
+        auto r = convert<T>(right, scratchRight, mRows);
+        auto& out = result.emplace<std::vector<T>>(mRows);
+        for (size_t i = 0; i < mRows; ++i) {
+          out[i] = select(i) ? (l.data != nullptr ? l.data[i] : l.literal) : (r.data != nullptr ? r.data[i] : r.literal);
+        }
+      });
+      if (left.valid != nullptr || right.valid != nullptr) {
+        valid.resize(mRows);
+        for (size_t i = 0; i < mRows; ++i) {
+          auto const* branch = select(i) ? left.valid : right.valid;
+          valid[i] = branch == nullptr || branch[i];
+        }
+      }
+      return;
+    }
+    if ((spec.op == BasicOp::LogicalAnd || spec.op == BasicOp::LogicalOr) && (left.valid != nullptr || right.valid != nullptr)) {
+      logicalWithNulls(spec.op == BasicOp::LogicalAnd, left, right, result, valid);
+      return;
+    }
+    propagateValidity({&left, &right}, valid);
+    dispatchType(operationType(spec), [&]<typename T>(std::type_identity<T>) {
+      std::vector<T> scratchLeft, scratchRight;
+      auto l = convert<T>(left, scratchLeft, mRows);
+      auto r = convert<T>(right, scratchRight, mRows);
+      auto compare = [&](auto op) {
+        auto& out = result.emplace<std::vector<uint8_t>>(mRows);
+        apply(l, r, out.data(), mRows, op);
+      };
+      auto arithmetic = [&](auto op) {
+        auto& out = result.emplace<std::vector<T>>(mRows);
+        apply(l, r, out.data(), mRows, wrapping<T>(op));
+      };
+      switch (spec.op) {
+        case BasicOp::LogicalAnd:
+          if constexpr (std::is_integral_v<T>) {
+            return compare([](T a, T b) { return a & b; });
+          }
+          break;
+        case BasicOp::LogicalOr:
+          if constexpr (std::is_integral_v<T>) {
+            return compare([](T a, T b) { return a | b; });
+          }
+          break;
+        case BasicOp::LessThan:
+          return compare([](T a, T b) { return a < b; });
+        case BasicOp::LessThanOrEqual:
+          return compare([](T a, T b) { return a <= b; });
+        case BasicOp::GreaterThan:
+          return compare([](T a, T b) { return a > b; });
+        case BasicOp::GreaterThanOrEqual:
+          return compare([](T a, T b) { return a >= b; });
+        case BasicOp::Equal:
+          return compare([](T a, T b) { return a == b; });
+        case BasicOp::NotEqual:
+          return compare([](T a, T b) { return a != b; });
+        case BasicOp::Addition:
+          return arithmetic([](auto a, auto b) { return a + b; });
+        case BasicOp::Subtraction:
+          return arithmetic([](auto a, auto b) { return a - b; });
+        case BasicOp::Multiplication:
+          return arithmetic([](auto a, auto b) { return a * b; });
+        case BasicOp::Division:
+          return arithmetic([](auto a, auto b) { return a / b; });
+        case BasicOp::BitwiseAnd:
+          if constexpr (std::is_integral_v<T>) {
+            return arithmetic([](auto a, auto b) { return a & b; });
+          }
+          break;
+        case BasicOp::BitwiseOr:
+          if constexpr (std::is_integral_v<T>) {
+            return arithmetic([](auto a, auto b) { return a | b; });
+          }
+          break;
+        case BasicOp::BitwiseXor:
+          if constexpr (std::is_integral_v<T>) {
+            return arithmetic([](auto a, auto b) { return a ^ b; });
+          }
+          break;
+        default:
+          break;
+      }
+      throw runtime_error_f("Operation %d on %s is not supported by the filter interpreter", static_cast<int>(spec.op), stringType(operationType(spec)));
+    });
+  }
+
+  arrow::RecordBatch const& mBatch;
+  size_t mRows;
+  std::vector<ResultColumn> mResults;
+  std::vector<std::vector<uint8_t>> mValid; // empty if none of the values of the result is null
+  std::unordered_map<std::string, std::vector<uint8_t>> mBooleans;
+  std::unordered_map<std::string, std::vector<uint8_t>> mValidities;
+};
+} // namespace
+
+bool useFilterInterpreter()
+{
+  static bool use = getenv("DPL_FILTER_INTERPRETER") && atoi(getenv("DPL_FILTER_INTERPRETER"));
+  return use;
+}
+
+std::shared_ptr<InterpretedFilter> createInterpretedFilter(Operations const& opSpecs, std::shared_ptr<InterpretedFilter> const& previous)
+{
+  if (opSpecs.empty() || opSpecs[0].type != atype::BOOL || !std::all_of(opSpecs.begin(), opSpecs.end(), isSupported)) {
+    return nullptr;
+  }
+  auto filter = previous != nullptr ? std::make_shared<InterpretedFilter>(*previous) : std::make_shared<InterpretedFilter>();
+  filter->conjunction.push_back(opSpecs);
+  return filter;
+}
+
+gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<InterpretedFilter> const& ifilter)
+{
+  gandiva::Selection selection;
+  auto s = gandiva::SelectionVector::MakeInt64(table->num_rows(),
+                                               arrow::default_memory_pool(),
+                                               &selection);
+  if (!s.ok()) {
+    throw runtime_error_f("Cannot allocate selection vector %s", s.ToString().c_str());
+  }
+  if (table->num_rows() == 0) {
+    return selection;
+  }
+  arrow::TableBatchReader reader(*table);
+  std::shared_ptr<arrow::RecordBatch> batch;
+  int64_t offset = 0;
+  int64_t nSelected = 0;
+  while (true) {
+    s = reader.ReadNext(&batch);
+    if (!s.ok()) {
+      throw runtime_error_f("Cannot read batches from table %s", s.ToString().c_str());
+    }
+    if (batch == nullptr) {
+      break;
+    }
+    BatchEvaluator evaluator{*batch};
+    std::vector<uint8_t> mask;
+    for (auto const& opSpecs : ifilter->conjunction) {
+      auto values = evaluator.evaluate(opSpecs);
+      if (mask.empty()) {
+        mask = std::move(values);
+      } else {
+        for (size_t i = 0; i < mask.size(); ++i) {
+          mask[i] &= values[i];
+        }
+      }
+    }
+    for (size_t i = 0; i < mask.size(); ++i) {
+      if (mask[i]) {
+        selection->SetIndex(nSelected++, offset + i);
+      }
+    }
+    offset += batch->num_rows();
+  }
+  selection->SetNumSlots(nSelected);
+  return selection;
+}
+
+} // namespace o2::framework::expressions
@@ -545,7 +545,14 @@ gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table, s
 gandiva::Selection createSelection(std::shared_ptr<arrow::Table> const& table,
                                    Filter const& expression)
 {
-  return createSelection(table, createFilter(table->schema(), createOperations(std::move(expression))));
+  auto ops = createOperations(std::move(expression));
+  if (useFilterInterpreter()) {
+    auto ifilter = createInterpretedFilter(ops);
+    if (ifilter != nullptr) {
+      return createSelection(table, ifilter);
+    }
+  }
+  return createSelection(table, createFilter(table->schema(), ops));
 }
 
 auto createProjection(std::shared_ptr<arrow::Table> const& table, std::shared_ptr<gandiva::Projector> const& gprojector)
@@ -700,6 +707,19 @@ gandiva::NodePtr createExpressionTree(Operations const& opSpecs,
   return tree;
 }
 
+std::set<std::string> getColumnLabels(Filter const& expression)
+{
+  std::set<std::string> labels;
+  for (auto const& spec : createOperations(expression)) {
+    for (auto const* datum : {&spec.left, &spec.right, &spec.condition}) {
+      if (datum->datum.index() == 3) {
+        labels.insert(std::get<std::string>(datum->datum));
+      }
+    }
+  }
+  return labels;
+}
+
 bool isTableCompatible(std::set<uint32_t> const& hashes, Operations const& specs)
 {
   std::set<uint32_t> opHashes;
@@ -728,8 +748,15 @@ void updateExpressionInfos(expressions::Filter const& filter, std::vector<Expres
       /// If the tree is already set, add a new tree to it with logical 'and'
       if (info.tree != nullptr) {
         info.tree = gandiva::TreeExprBuilder::MakeAnd({info.tree, tree});
+        /// Once a filter needs gandiva, all of them are evaluated by it
+        if (info.interpreted != nullptr) {
+          info.interpreted = createInterpretedFilter(ops, info.interpreted);
+        }
       } else {
         info.tree = tree;
+        if (useFilterInterpreter()) {
+          info.interpreted = createInterpretedFilter(ops);
+        }
       }
     }
   }
@@ -737,6 +764,13 @@ void updateExpressionInfos(expressions::Filter const& filter, std::vector<Expres
 
 void updateFilterInfo(ExpressionInfo& info, std::shared_ptr<arrow::Table>& table)
 {
+  if (info.interpreted != nullptr) {
+    if (info.resetSelection == true) {
+      info.selection = framework::expressions::createSelection(table, info.interpreted);
+      info.resetSelection = false;
+    }
+    return;
+  }
   if (info.tree != nullptr && info.filter == nullptr) {
     info.filter = framework::expressions::createFilter(table->schema(), framework::expressions::makeCondition(info.tree));
   }
@@ -189,11 +189,143 @@ double HistogramRegistry::getSize(double fillFraction)
 
 void HistogramRegistry::clean()
 {
+  for (auto& buffer : mFillBuffers) {
+    buffer.clear();
+  }
   for (auto& value : mRegistryValue) {
     std::visit([](auto&& hist) { hist.reset(); }, value);
   }
 }
 
+namespace
+{
+template <typename T, size_t... Is>
+void fillSimple(T* hist, const double* values, std::index_sequence<Is...>)
+{
+  if constexpr (ValidSimpleFill<T, sizeof...(Is)>) {
+    hist->Fill(values[Is]...);
+  } else {
+    LOGF(fatal, R"(Histogram "%s" cannot be filled with %d values.)", hist->GetName(), sizeof...(Is));
+  }
+}
+} // namespace
+
+template <typename T>
+void HistFiller::fillHistBuffered(std::shared_ptr<T> hist, const HistogramFillBuffer& buffer, const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& fills, size_t begin, size_t end)
+{
+  if constexpr (std::is_base_of_v<StepTHn, T>) {
+    // steps and positions are accumulated bin by bin
+    std::vector<const double*> values(end - begin);
+    std::vector<int> nValues(end - begin);
+    for (size_t i = begin; i < end; ++i) {
+      values[i - begin] = buffer.values.data() + offsets[fills[i]];
+      nValues[i - begin] = buffer.nValues[fills[i]];
+    }
+    hist->FillBatch(end - begin, values.data(), nValues.data());
+  } else if constexpr (std::is_base_of_v<THnBase, T>) {
+    int nDim = hist->GetNdimensions();
+    for (size_t i = begin; i < end; ++i) {
+      const double* values = buffer.values.data() + offsets[fills[i]];
+      int nValues = buffer.nValues[fills[i]];
+      if (nValues == nDim) {
+        hist->Fill(values);
+      } else if (nValues == nDim + 1) {
+        hist->Fill(values, values[nDim]);
+      } else {
+        badHistogramFill(hist->GetName());
+      }
+    }
+  } else {
+    for (size_t i = begin; i < end; ++i) {
+      const double* values = buffer.values.data() + offsets[fills[i]];
+      switch (buffer.nValues[fills[i]]) {
+        case 1:
+          fillSimple(hist.get(), values, std::make_index_sequence<1>{});
+          break;
+        case 2:
+          fillSimple(hist.get(), values, std::make_index_sequence<2>{});
+          break;
+        case 3:
+          fillSimple(hist.get(), values, std::make_index_sequence<3>{});
+          break;
+        case 4:
+          fillSimple(hist.get(), values, std::make_index_sequence<4>{});
+          break;
+        case 5:
+          fillSimple(hist.get(), values, std::make_index_sequence<5>{});
+          break;
+        default:
+          badHistogramFill(hist->GetName());
+      }
+    }
+  }
+}
+
+void HistogramRegistry::setFillBufferSize(size_t maxFills)
+{
+  flush();
+  mFillBufferSize = maxFills;
+  mFillBuffers.resize(1);
+}
+
+void HistogramRegistry::flush()
+{
+  for (auto& buffer : mFillBuffers) {
+    flush(buffer);
+  }
+}
+
+void HistogramRegistry::beginSharding(int nThreads)
+{
+  flush();
+  mFillBuffers.resize(std::max(nThreads, 1));
+  mSharded = true;
+}
+
+void HistogramRegistry::endSharding(bool apply)
+{
+  mSharded = false;
+  for (auto& buffer : mFillBuffers) {
+    if (apply) {
+      flush(buffer);
+    } else {
+      buffer.clear();
+    }
+  }
+  mFillBuffers.resize(1);
+}
+
+void HistogramRegistry::flush(HistogramFillBuffer& buffer)
+{
+  if (buffer.size() == 0) {
+    return;
+  }
+  // order the fills by histogram, keeping their order for each of them
+  std::vector<uint32_t> offsets(buffer.size());
+  std::vector<uint32_t> begins(MAX_REGISTRY_SIZE + 1);
+  uint32_t offset = 0;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    offsets[i] = offset;
+    offset += buffer.nValues[i];
+    ++begins[buffer.histIndex[i] + 1];
+  }
+  for (auto idx = 0u; idx < MAX_REGISTRY_SIZE; ++idx) {
+    begins[idx + 1] += begins[idx];
+  }
+  std::vector<uint32_t> fills(buffer.size());
+  auto positions = begins;
+  for (size_t i = 0; i < buffer.size(); ++i) {
+    fills[positions[buffer.histIndex[i]]++] = i;
+  }
+
+  for (auto idx = 0u; idx < MAX_REGISTRY_SIZE; ++idx) {
+    if (begins[idx] != begins[idx + 1]) {
+      std::visit([&](auto&& hist) { HistFiller::fillHistBuffered(hist, buffer, offsets, fills, begins[idx], begins[idx + 1]); }, mRegistryValue[idx]);
+    }
+  }
+  buffer.clear();
+}
+
 // print some useful meta-info about the stored histograms
 void HistogramRegistry::print(bool showAxisDetails)
 {
@@ -285,6 +417,7 @@ void HistogramRegistry::print(bool showAxisDetails)
 // create output structure will be propagated to file-sink
 TList* HistogramRegistry::getListOfHistograms()
 {
+  flush();
   TList* list = new TList();
   list->SetName(mName.data());
 
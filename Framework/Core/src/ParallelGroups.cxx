@@ -0,0 +1,181 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ParallelGroups.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace o2::framework
+{
+
+namespace
+{
+thread_local int gCurrentGroup = -1;
+thread_local int gThreadIndex = 0;
+} // namespace
+
+int DeferredCalls::currentGroup()
+{
+  return gCurrentGroup;
+}
+
+void DeferredCalls::setCurrentGroup(int group)
+{
+  gCurrentGroup = group;
+}
+
+void DeferredCalls::begin(size_t nGroups)
+{
+  mCalls.clear();
+  mCalls.resize(nGroups);
+}
+
+void DeferredCalls::replay()
+{
+  auto calls = std::move(mCalls);
+  mCalls.clear();
+  for (auto& group : calls) {
+    for (auto& call : group) {
+      call();
+    }
+  }
+}
+
+/// Threads waiting for the jobs of ParallelGroups::run. All of them take part in every
+/// job, taking the indices one by one until none is left.
+class GroupWorkerPool
+{
+ public:
+  explicit GroupWorkerPool(int nWorkers)
+  {
+    for (int i = 0; i < nWorkers; ++i) {
+      mThreads.emplace_back([this, i]() {
+        gThreadIndex = i + 1;
+        work();
+      });
+    }
+  }
+
+  ~GroupWorkerPool()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mStart.notify_all();
+    for (auto& t : mThreads) {
+      t.join();
+    }
+  }
+
+  size_t size() const
+  {
+    return mThreads.size();
+  }
+
+  void run(size_t n, std::function<void(size_t)> const& f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mJob = &f;
+      mN = n;
+      mNext = 0;
+      mFinished = 0;
+      mError = nullptr;
+      ++mGeneration;
+    }
+    mStart.notify_all();
+    process(f, n);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mFinished == mThreads.size(); });
+    mJob = nullptr;
+    if (mError) {
+      std::rethrow_exception(mError);
+    }
+  }
+
+ private:
+  void work()
+  {
+    uint64_t seen = 0;
+    while (true) {
+      std::function<void(size_t)> const* job = nullptr;
+      size_t n = 0;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStart.wait(lock, [this, seen]() { return mStop || mGeneration != seen; });
+        if (mStop) {
+          return;
+        }
+        seen = mGeneration;
+        job = mJob;
+        n = mN;
+      }
+      process(*job, n);
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mFinished;
+      }
+      mDone.notify_one();
+    }
+  }
+
+  void process(std::function<void(size_t)> const& f, size_t n)
+  {
+    for (size_t i = mNext++; i < n; i = mNext++) {
+      try {
+        DeferredCalls::setCurrentGroup(i);
+        f(i);
+        DeferredCalls::setCurrentGroup(-1);
+      } catch (...) {
+        DeferredCalls::setCurrentGroup(-1);
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mError) {
+          mError = std::current_exception();
+        }
+        mNext = n; // nothing else to start
+      }
+    }
+  }
+
+  std::vector<std::thread> mThreads;
+  std::mutex mMutex;
+  std::condition_variable mStart;
+  std::condition_variable mDone;
+  std::function<void(size_t)> const* mJob = nullptr;
+  size_t mN = 0;
+  std::atomic<size_t> mNext{0};
+  size_t mFinished = 0;
+  uint64_t mGeneration = 0;
+  bool mStop = false;
+  std::exception_ptr mError;
+};
+
+int ParallelGroups::threadIndex()
+{
+  return gThreadIndex;
+}
+
+void ParallelGroups::run(size_t n, std::function<void(size_t)> const& f)
+{
+  if (!mPool || mPool->size() != static_cast<size_t>(value - 1)) {
+    mPool.reset();
+    mPool = std::make_shared<GroupWorkerPool>(std::max(value - 1, 0));
+  }
+  mPool->run(n, f);
+}
+
+} // namespace o2::framework
@@ -0,0 +1,352 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/SharedObjectStore.h"
+#include "Framework/Logger.h"
+
+#include <fmt/format.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <cerrno>
+#include <csignal>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace o2::framework
+{
+
+namespace
+{
+constexpr uint64_t RegionMagic = 0x4f32534f424a0002; // "O2SOBJ" + version
+constexpr int MaxWaitSeconds = 120;                  // for another process to fill the image
+constexpr int MaxUsers = 512;                        // registrations per region
+constexpr char RegionPrefix[] = "o2-dpl-obj-";
+
+enum RegionState : uint32_t {
+  Creating = 0, // zero filled region, the creator did not finish yet
+  Ready = 1,
+  Failed = 2
+};
+
+/// Occupies the first page of the region, which is mapped shared by all processes.
+/// The payload starts at the next page and is mapped copy-on-write.
+/// The users and removed fields are accessed only with the file lock of the region held.
+struct RegionHeader {
+  uint64_t magic;
+  std::atomic<uint32_t> state;
+  uint32_t removed; // set by the process which unlinked the region, it must not be used anymore
+  int32_t creatorPID;
+  uint64_t payloadSize;
+  char key[256];           // possibly truncated, for diagnostics
+  int32_t users[MaxUsers]; // PIDs of the processes using the region (one entry per mapped image), 0 if free
+};
+static_assert(std::atomic<uint32_t>::is_always_lock_free);
+static_assert(sizeof(RegionHeader) <= 4096);
+
+size_t headerSize()
+{
+  static size_t pageSize = sysconf(_SC_PAGESIZE);
+  return pageSize;
+}
+
+/// Exclusive lock of the region, released by the kernel if the process dies
+class RegionLock
+{
+ public:
+  RegionLock(int fd) : mFD(fd) { flock(mFD, LOCK_EX); }
+  ~RegionLock() { flock(mFD, LOCK_UN); }
+
+ private:
+  int mFD;
+};
+
+bool processAlive(int pid)
+{
+  return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+/// unlink the region only if the name still refers to the one we mapped
+void unlinkIfSame(std::string const& name, unsigned long inode)
+{
+  int fd = shm_open(name.c_str(), O_RDONLY, 0);
+  if (fd < 0) {
+    return;
+  }
+  struct stat st;
+  if (fstat(fd, &st) == 0 && st.st_ino == inode) {
+    shm_unlink(name.c_str());
+  }
+  close(fd);
+}
+
+/// drop the registrations of dead processes, returns the number of remaining ones. Requires the lock.
+int pruneUsers(RegionHeader* header)
+{
+  int n = 0;
+  for (auto& pid : header->users) {
+    if (pid && !processAlive(pid)) {
+      pid = 0;
+    }
+    n += pid != 0;
+  }
+  return n;
+}
+
+enum class Registration {
+  Done,
+  Removed, // the region is being removed, to be retried
+  Full
+};
+
+Registration registerUser(int fd, RegionHeader* header)
+{
+  RegionLock lock(fd);
+  if (header->removed) {
+    return Registration::Removed;
+  }
+  pruneUsers(header);
+  for (auto& pid : header->users) {
+    if (!pid) {
+      pid = getpid();
+      return Registration::Done;
+    }
+  }
+  return Registration::Full;
+}
+
+/// drop the registration of this process, the last live user removes the region
+void release(std::string const& name, int fd, RegionHeader* header, unsigned long inode)
+{
+  {
+    RegionLock lock(fd);
+    for (auto& pid : header->users) {
+      if (pid == getpid()) {
+        pid = 0;
+        break;
+      }
+    }
+    if (!header->removed && pruneUsers(header) == 0) {
+      header->removed = 1;
+      unlinkIfSame(name, inode);
+    }
+  }
+  munmap(header, headerSize());
+  close(fd);
+}
+
+std::shared_ptr<SharedObjectStore::Image> mapPayload(std::string const& name, int fd, RegionHeader* header, unsigned long inode)
+{
+  void* payload = nullptr;
+  if (header->payloadSize) {
+    payload = mmap(nullptr, header->payloadSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, headerSize());
+    if (payload == MAP_FAILED) {
+      LOGP(error, "Failed to map the payload of {}: {}", name, strerror(errno));
+      release(name, fd, header, inode);
+      return nullptr;
+    }
+  }
+  return std::make_shared<SharedObjectStore::Image>(name, fd, header, (char*)payload, header->payloadSize, inode);
+}
+
+void cleanupOnce()
+{
+  static int nRemoved = SharedObjectStore::cleanup();
+  (void)nRemoved;
+}
+} // namespace
+
+SharedObjectStore::Image::Image(std::string name, int fd, void* header, char* payload, size_t size, unsigned long inode)
+  : mName(std::move(name)), mFD(fd), mHeader(header), mPayload(payload), mSize(size), mInode(inode)
+{
+}
+
+SharedObjectStore::Image::~Image()
+{
+  if (mPayload) {
+    munmap(mPayload, mSize);
+  }
+  release(mName, mFD, reinterpret_cast<RegionHeader*>(mHeader), mInode);
+}
+
+bool SharedObjectStore::isEnabled()
+{
+  static bool enabled = getenv("DPL_CCDB_SHARED_OBJECTS") && atoi(getenv("DPL_CCDB_SHARED_OBJECTS"));
+  return enabled;
+}
+
+std::string SharedObjectStore::regionName(std::string const& key)
+{
+  return fmt::format("/{}{}-{:016x}", RegionPrefix, getuid(), std::hash<std::string>{}(key));
+}
+
+int SharedObjectStore::cleanup()
+{
+  // POSIX shared memory objects are the files of /dev/shm on Linux
+  const std::string prefix = fmt::format("{}{}-", RegionPrefix, getuid());
+  int nRemoved = 0;
+  std::error_code ec;
+  for (const auto& entry : std::filesystem::directory_iterator("/dev/shm", ec)) {
+    auto fname = entry.path().filename().string();
+    if (fname.compare(0, prefix.size(), prefix) != 0) {
+      continue;
+    }
+    auto name = "/" + fname;
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      continue;
+    }
+    struct stat st;
+    void* ptr = MAP_FAILED;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < headerSize() ||
+        (ptr = mmap(nullptr, headerSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+      close(fd);
+      continue;
+    }
+    auto* header = reinterpret_cast<RegionHeader*>(ptr);
+    if (header->magic == RegionMagic) {
+      RegionLock lock(fd);
+      bool abandoned = header->state.load(std::memory_order_acquire) == Creating ? !processAlive(header->creatorPID) : pruneUsers(header) == 0;
+      if (!header->removed && abandoned) {
+        LOGP(info, "Removing shared object {} ({}) abandoned by its users", name, header->key);
+        header->removed = 1;
+        unlinkIfSame(name, st.st_ino);
+        nRemoved++;
+      }
+    }
+    munmap(ptr, headerSize());
+    close(fd);
+  }
+  return nRemoved;
+}
+
+std::shared_ptr<SharedObjectStore::Image> SharedObjectStore::open(std::string const& key)
+{
+  cleanupOnce();
+  auto name = regionName(key);
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(MaxWaitSeconds);
+  while (std::chrono::steady_clock::now() < deadline) {
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      if (errno != ENOENT) {
+        LOGP(warning, "Failed to open shared object {}: {}", name, strerror(errno));
+      }
+      return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < headerSize()) {
+      close(fd); // the creator did not size it yet
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    void* ptr = mmap(nullptr, headerSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+      LOGP(warning, "Failed to map shared object {}: {}", name, strerror(errno));
+      close(fd);
+      return nullptr;
+    }
+    auto* header = reinterpret_cast<RegionHeader*>(ptr);
+    auto state = header->state.load(std::memory_order_acquire);
+    bool retry = false;
+    if (state == Creating) {
+      if (!processAlive(header->creatorPID)) {
+        LOGP(warning, "Removing shared object {} left incomplete by process {}", name, header->creatorPID);
+        unlinkIfSame(name, st.st_ino);
+      }
+      retry = true;
+    } else if (state == Failed || header->magic != RegionMagic || key.compare(0, sizeof(header->key) - 1, header->key) != 0) {
+      if (state != Failed) {
+        LOGP(error, "Shared object {} does not hold {}", name, key);
+      }
+      munmap(ptr, headerSize());
+      close(fd);
+      return nullptr;
+    } else {
+      // register as user, unless the last user is already removing it
+      auto registration = registerUser(fd, header);
+      if (registration == Registration::Full) {
+        LOGP(warning, "Shared object {} has already {} users", name, MaxUsers);
+        munmap(ptr, headerSize());
+        close(fd);
+        return nullptr;
+      }
+      retry = registration == Registration::Removed;
+    }
+    if (retry) {
+      munmap(ptr, headerSize());
+      close(fd);
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      continue;
+    }
+    return mapPayload(name, fd, header, st.st_ino);
+  }
+  LOGP(warning, "Timeout waiting for shared object {} to be ready", name);
+  return nullptr;
+}
+
+std::shared_ptr<SharedObjectStore::Image> SharedObjectStore::create(std::string const& key, size_t size, Filler const& fill)
+{
+  cleanupOnce();
+  auto name = regionName(key);
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+  if (fd < 0) {
+    if (errno != EEXIST) {
+      LOGP(warning, "Failed to create shared object {}: {}", name, strerror(errno));
+    }
+    return nullptr;
+  }
+  struct stat st;
+  void* ptr = MAP_FAILED;
+  if (fstat(fd, &st) != 0 || ftruncate(fd, headerSize() + size) != 0 ||
+      (ptr = mmap(nullptr, headerSize(), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+    LOGP(warning, "Failed to allocate {} bytes for shared object {}: {}", size, name, strerror(errno));
+    shm_unlink(name.c_str());
+    close(fd);
+    return nullptr;
+  }
+  auto* header = reinterpret_cast<RegionHeader*>(ptr);
+  header->creatorPID = getpid();
+  header->magic = RegionMagic;
+  header->payloadSize = size;
+  header->users[0] = header->creatorPID; // the region is new, no need to lock
+  strncpy(header->key, key.c_str(), sizeof(header->key) - 1);
+
+  bool ok = true;
+  if (size) {
+    void* payload = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, headerSize());
+    if (payload == MAP_FAILED) {
+      LOGP(warning, "Failed to map {} bytes for shared object {}: {}", size, name, strerror(errno));
+      ok = false;
+    } else {
+      ok = fill((char*)payload);
+      munmap(payload, size);
+    }
+  }
+  header->state.store(ok ? Ready : Failed, std::memory_order_release);
+  if (!ok) {
+    release(name, fd, header, st.st_ino);
+    return nullptr;
+  }
+  LOGP(info, "Created shared object {} of {} bytes for {}", name, size, key);
+  return mapPayload(name, fd, header, st.st_ino);
+}
+
+void SharedObjectStore::remove(std::string const& key)
+{
+  shm_unlink(regionName(key).c_str());
+}
+
+} // namespace o2::framework
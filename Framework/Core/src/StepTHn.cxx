@@ -26,6 +26,9 @@
 #include "THn.h"
 #include "TMath.h"
 
+#include <algorithm>
+#include <vector>
+
 ClassImp(StepTHn);
 templateClassImp(StepTHnT);
 
@@ -389,6 +392,100 @@ void StepTHn::Fill(int iStep, int nParams, double positionAndWeight[])
     LOGF(fatal, "Fill called with invalid number of parameters (%d vs %d)", mNVars, nParams);
   }
 
+  Long64_t bin = getBin(positionAndWeight);
+  if (bin < 0) {
+    return;
+  }
+
+  if (!mValues[iStep]) {
+    mValues[iStep] = createArray();
+    LOGF(info, "Created values container for step %d", iStep);
+  }
+
+  if (weight != 1.) {
+    // initialize with already filled entries (which have been filled with weight == 1), in this case mSumw2 := mValues
+    if (!mSumw2[iStep]) {
+      mSumw2[iStep] = createArray();
+      LOGF(info, "Created sumw2 container for step %d", iStep);
+    }
+  }
+
+  // TODO probably slow; add StepTHnT::add ?
+  mValues[iStep]->SetAt(mValues[iStep]->GetAt(bin) + weight, bin);
+  if (mSumw2[iStep]) {
+    mSumw2[iStep]->SetAt(mSumw2[iStep]->GetAt(bin) + weight, bin);
+  }
+}
+
+void StepTHn::FillBatch(int nEntries, const double* const* stepPositionAndWeight, const int* nParams)
+{
+  struct BinFill {
+    int step;
+    Long64_t bin;
+    double weight;
+    bool sumw2; // the sumw2 container exists when the entry is filled
+  };
+  std::vector<BinFill> fills;
+  fills.reserve(nEntries);
+  std::vector<bool> hasSumw2(mNSteps);
+  for (int i = 0; i < mNSteps; i++) {
+    hasSumw2[i] = mSumw2[i] != nullptr;
+  }
+
+  for (int i = 0; i < nEntries; i++) {
+    int iStep = stepPositionAndWeight[i][0];
+    const double* positionAndWeight = stepPositionAndWeight[i] + 1;
+    if (iStep >= mNSteps) {
+      LOGF(fatal, "Selected step for filling is not in range of StepTHn.");
+    }
+    double weight = 1.0;
+    if (nParams[i] - 1 == mNVars + 1) {
+      weight = positionAndWeight[mNVars];
+    } else if (nParams[i] - 1 != mNVars) {
+      LOGF(fatal, "Fill called with invalid number of parameters (%d vs %d)", mNVars, nParams[i] - 1);
+    }
+    Long64_t bin = getBin(positionAndWeight);
+    if (bin < 0) {
+      continue;
+    }
+    if (weight != 1.) {
+      hasSumw2[iStep] = true;
+    }
+    fills.push_back({iStep, bin, weight, hasSumw2[iStep]});
+  }
+
+  // the weights of a bin are summed in double in the order of the entries and added to the container once,
+  // so with float storage (StepTHnF) the contents can differ in the last bits from filling one by one
+  std::stable_sort(fills.begin(), fills.end(), [](const BinFill& a, const BinFill& b) {
+    return a.step < b.step || (a.step == b.step && a.bin < b.bin);
+  });
+
+  for (size_t begin = 0, end = 0; begin < fills.size(); begin = end) {
+    auto& first = fills[begin];
+    double sumw = 0., sumw2 = 0.;
+    for (end = begin; end < fills.size() && fills[end].step == first.step && fills[end].bin == first.bin; end++) {
+      sumw += fills[end].weight;
+      if (fills[end].sumw2) {
+        sumw2 += fills[end].weight;
+      }
+    }
+    if (!mValues[first.step]) {
+      mValues[first.step] = createArray();
+      LOGF(info, "Created values container for step %d", first.step);
+    }
+    if (hasSumw2[first.step] && !mSumw2[first.step]) {
+      mSumw2[first.step] = createArray();
+      LOGF(info, "Created sumw2 container for step %d", first.step);
+    }
+    mValues[first.step]->SetAt(mValues[first.step]->GetAt(first.bin) + sumw, first.bin);
+    if (mSumw2[first.step]) {
+      mSumw2[first.step]->SetAt(mSumw2[first.step]->GetAt(first.bin) + sumw2, first.bin);
+    }
+  }
+}
+
+Long64_t StepTHn::getBin(const double* position)
+{
   // fill axis cache
   if (!mAxisCache) {
     mAxisCache = new TAxis*[mNVars];
@@ -403,7 +500,7 @@ void StepTHn::Fill(int iStep, int nParams, double positionAndWeight[])
 
     // initial values to prevent checking for 0 below
     for (Int_t i = 0; i < mNVars; i++) {
-      mLastVars[i] = positionAndWeight[i];
+      mLastVars[i] = position[i];
       mLastBins[i] = mAxisCache[i]->FindBin(mLastVars[i]);
     }
   }
@@ -414,43 +511,25 @@ void StepTHn::Fill(int iStep, int nParams, double positionAndWeight[])
     bin *= mNbinsCache[i];
 
     Int_t tmpBin = 0;
-    if (mLastVars[i] == positionAndWeight[i]) {
+    if (mLastVars[i] == position[i]) {
       tmpBin = mLastBins[i];
     } else {
-      tmpBin = mAxisCache[i]->FindBin(positionAndWeight[i]);
+      tmpBin = mAxisCache[i]->FindBin(position[i]);
       mLastBins[i] = tmpBin;
-      mLastVars[i] = positionAndWeight[i];
+      mLastVars[i] = position[i];
     }
     //Printf("%d", tmpBin);
 
     // under/overflow not supported
     if (tmpBin < 1 || tmpBin > mNbinsCache[i]) {
-      return;
+      return -1;
     }
 
     // bins start from 0 here
     bin += tmpBin - 1;
     //     Printf("%lld", bin);
   }
-
-  if (!mValues[iStep]) {
-    mValues[iStep] = createArray();
-    LOGF(info, "Created values container for step %d", iStep);
-  }
-
-  if (weight != 1.) {
-    // initialize with already filled entries (which have been filled with weight == 1), in this case mSumw2 := mValues
-    if (!mSumw2[iStep]) {
-      mSumw2[iStep] = createArray();
-      LOGF(info, "Created sumw2 container for step %d", iStep);
-    }
-  }
-
-  // TODO probably slow; add StepTHnT::add ?
-  mValues[iStep]->SetAt(mValues[iStep]->GetAt(bin) + weight, bin);
-  if (mSumw2[iStep]) {
-    mSumw2[iStep]->SetAt(mSumw2[iStep]->GetAt(bin) + weight, bin);
-  }
+  return bin;
 }
 
 template class StepTHnT<TArrayF>;
@@ -14,6 +14,7 @@
 #include "Framework/Signpost.h"
 
 #include "arrow/type_traits.h"
+#include <arrow/array/util.h>
 #include <arrow/dataset/file_base.h>
 #include <arrow/record_batch.h>
 #include <arrow/type.h>
@@ -108,17 +109,18 @@ TBranch* BranchToColumn::branch()
   return mBranch;
 }
 
-BranchToColumn::BranchToColumn(TBranch* branch, bool VLA, std::string name, EDataType type, int listSize, arrow::MemoryPool* pool)
+BranchToColumn::BranchToColumn(TBranch* branch, bool VLA, std::string name, EDataType type, int listSize, arrow::MemoryPool* pool, bool placeholder)
   : mBranch{branch},
     mVLA{VLA},
     mColumnName{std::move(name)},
     mType{type},
     mArrowType{arrowTypeFromROOT(type, listSize)},
     mListSize{listSize},
-    mPool{pool}
+    mPool{pool},
+    mPlaceholder{placeholder}
 
 {
-  if (mType == EDataType::kBool_t) {
+  if (mType == EDataType::kBool_t && !mPlaceholder) {
     if (mListSize > 1) {
       auto status = arrow::MakeBuilder(mPool, mArrowType->field(0)->type(), &mBuilder);
       if (!status.ok()) {
@@ -145,6 +147,17 @@ std::pair<std::shared_ptr<arrow::ChunkedArray>, std::shared_ptr<arrow::Field>> B
   buffer->Reset();
   std::shared_ptr<arrow::Array> array;
 
+  if (mPlaceholder) {
+    // the number of entries is known without reading the baskets
+    auto&& result = arrow::MakeArrayOfNull(mArrowType, totalEntries, mPool);
+    if (!result.ok()) {
+      throw runtime_error("Cannot create placeholder array");
+    }
+    O2_SIGNPOST_EVENT_EMIT(tabletree_helpers, sid, "BranchToColumn", "Skipping branch %{public}s", mBranch->GetName());
+    return std::make_pair(std::make_shared<arrow::ChunkedArray>(std::move(result).ValueUnsafe()),
+                          std::make_shared<arrow::Field>(mBranch->GetName(), mArrowType));
+  }
+
   if (mType == EDataType::kBool_t) {
     // boolean array special case: we need to use builder to create the bitmap
     status = mValueBuilder->Reserve(totalEntries * mListSize);
@@ -460,9 +473,8 @@ struct BranchInfo {
   TBranch* ptr;
   bool mVLA;
 };
-} // namespace
 
-void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
+std::vector<BranchInfo> getBranchInfos(TTree* tree)
 {
   auto branches = tree->GetListOfBranches();
   auto n = branches->GetEntries();
@@ -489,6 +501,13 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
       }
     }
   }
+  return branchInfos;
+}
+} // namespace
+
+void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
+{
+  auto branchInfos = getBranchInfos(tree);
 
   if (names.empty()) {
     for (auto& bi : branchInfos) {
@@ -510,11 +529,34 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
   if (mBranchReaders.empty()) {
     throw runtime_error("No columns will be read");
   }
+  setupCache(tree);
+}
+
+std::vector<std::string> TreeToTable::addProjectedColumns(TTree* tree, std::set<std::string> const& names)
+{
+  std::vector<std::string> skipped;
+  // the index columns are always needed to bind and group the tables
+  for (auto& bi : getBranchInfos(tree)) {
+    bool read = names.contains(bi.name) || bi.name.starts_with("fIndex");
+    addReader(bi.ptr, bi.name, bi.mVLA, !read);
+    if (!read) {
+      skipped.push_back(bi.name);
+    }
+  }
+  setupCache(tree);
+  return skipped;
+}
+
+void TreeToTable::setupCache(TTree* tree)
+{
   // Was affected by https://github.com/root-project/root/issues/8962
   // Re-enabling this seems to cut the number of IOPS in half
   tree->SetCacheSize(25000000);
   // tree->SetClusterPrefetch(true);
   for (auto& reader : mBranchReaders) {
+    if (reader->placeholder()) {
+      continue;
+    }
     tree->AddBranchToCache(reader->branch());
     if (strncmp(reader->branch()->GetName(), "fIndexArray", strlen("fIndexArray")) == 0) {
       std::string sizeBranchName = reader->branch()->GetName();
@@ -528,6 +570,25 @@ void TreeToTable::addAllColumns(TTree* tree, std::vector<std::string>&& names)
   tree->StopCacheLearningPhase();
 }
 
+std::pair<int64_t, int64_t> TreeToTable::readBytes(TTree* tree) const
+{
+  int64_t zipBytes = 0;
+  int64_t totBytes = 0;
+  for (auto& reader : mBranchReaders) {
+    if (reader->placeholder()) {
+      continue;
+    }
+    zipBytes += reader->branch()->GetZipBytes();
+    totBytes += reader->branch()->GetTotBytes();
+    auto* sizeBranch = tree->GetBranch((std::string{reader->branch()->GetName()} + TableTreeHelpers::sizeBranchSuffix).c_str());
+    if (sizeBranch != nullptr) {
+      zipBytes += sizeBranch->GetZipBytes();
+      totBytes += sizeBranch->GetTotBytes();
+    }
+  }
+  return {zipBytes, totBytes};
+}
+
 void TreeToTable::setLabel(const char* label)
 {
   mTableLabel = label;
@@ -552,7 +613,7 @@ void TreeToTable::fill(TTree*tree)
   mTable = arrow::Table::Make(schema, columns);
 }
 
-void TreeToTable::addReader(TBranch* branch, std::string const& name, bool VLA)
+void TreeToTable::addReader(TBranch* branch, std::string const& name, bool VLA, bool placeholder)
 {
   static TClass* cls;
   EDataType type;
@@ -561,7 +622,7 @@ void TreeToTable::addReader(TBranch* branch, std::string const& name, bool VLA)
   if (!VLA) {
     listSize = static_cast<TLeaf*>(branch->GetListOfLeaves()->At(0))->GetLenStatic();
   }
-  mBranchReaders.emplace_back(std::make_unique<BranchToColumn>(branch, VLA, name, type, listSize, mArrowMemoryPool));
+  mBranchReaders.emplace_back(std::make_unique<BranchToColumn>(branch, VLA, name, type, listSize, mArrowMemoryPool, placeholder));
 }
 
 std::shared_ptr<arrow::Table> TreeToTable::finalize()
@@ -27,7 +27,16 @@ void TimesliceIndex::resize(size_t s)
 {
   mVariables.resize(s);
   mPublishedVariables.resize(s);
-  mDirty.resize(s, false);
+  // Atomics cannot be moved, so we need to reallocate and copy the old state.
+  auto dirty = std::make_unique<std::atomic<bool>[]>(s);
+  size_t dirtyCount = 0;
+  for (size_t i = 0; i < s; ++i) {
+    dirty[i].store(i < mDirtySize ? mDirty[i].load() : false);
+    dirtyCount += dirty[i].load() ? 1 : 0;
+  }
+  mDirty = std::move(dirty);
+  mDirtyCount = dirtyCount;
+  mDirtySize = s;
 }
 
 void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
@@ -35,7 +44,7 @@ void TimesliceIndex::associate(TimesliceId timestamp, TimesliceSlot slot)
   assert(mVariables.size() > slot.index);
   mVariables[slot.index].put({0, static_cast<uint64_t>(timestamp.value)});
   mVariables[slot.index].commit();
-  mDirty[slot.index] = true;
+  markAsDirty(slot, true);
   O2_SIGNPOST_ID_GENERATE(tid, timeslice_index);
   O2_SIGNPOST_EVENT_EMIT(timeslice_index, tid, "associate", "Associating timestamp %zu to slot %zu", timestamp.value, slot.index);
 }
@@ -180,7 +189,7 @@ TimesliceIndex::OldestInputInfo TimesliceIndex::setOldestPossibleInput(Timeslice
 
 bool TimesliceIndex::validateSlot(TimesliceSlot slot, TimesliceId currentOldest)
 {
-  if (mDirty[slot.index] == true) {
+  if (isDirty(slot)) {
     return true;
   }
 
@@ -2023,6 +2023,8 @@ int runStateMachine(DataProcessorSpecs const& workflow,
             "--aod-writer-resmode",
             "--aod-writer-maxfilesize",
             "--aod-writer-keep",
+            "--aod-writer-format",
+            "--aod-writer-arrow-codec",
             "--aod-max-io-rate",
             "--aod-parent-access-level",
             "--aod-parent-base-path-replacement",
@@ -0,0 +1,81 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include "Framework/ArrowTableSlicingCache.h"
+#include <arrow/builder.h>
+#include <arrow/table.h>
+#include <benchmark/benchmark.h>
+#include <random>
+
+using namespace o2::framework;
+
+namespace
+{
+/// table sorted by an index column of nGroups groups, with a few rows of each group
+/// and some rows without group (negative index) in between. With sparse keys only
+/// every 100th group index is used.
+std::shared_ptr<arrow::Table> makeTable(int nGroups, bool sparse)
+{
+  std::default_random_engine e1(1234567891);
+  std::uniform_int_distribution<int> rows(0, 10);
+  arrow::Int32Builder builder;
+  for (auto g = 0; g < nGroups; ++g) {
+    auto n = rows(e1);
+    for (auto i = 0; i < n; ++i) {
+      (void)builder.Append(sparse ? 100 * g : g);
+    }
+    if (g % 10 == 0) {
+      (void)builder.Append(-1 - g / 10);
+    }
+  }
+  std::shared_ptr<arrow::Array> array;
+  (void)builder.Finish(&array);
+  return arrow::Table::Make(arrow::schema({arrow::field("fIndexCollisions", arrow::int32())}), {array});
+}
+} // namespace
+
+static void BM_SliceCacheUpdate(benchmark::State& state)
+{
+  auto table = makeTable(state.range(0), state.range(1));
+  ArrowTableSlicingCache cache({{"Tracks", "fIndexCollisions"}});
+  for (auto _ : state) {
+    auto status = cache.updateCacheEntry(0, table);
+    benchmark::DoNotOptimize(status);
+  }
+  state.SetItemsProcessed(state.iterations() * table->num_rows());
+}
+
+BENCHMARK(BM_SliceCacheUpdate)->RangeMultiplier(4)->Ranges({{64, 64 << 10}, {0, 1}});
+
+// slices of all groups, as when grouping by collision, with the lookup tables or with the scan of the values
+static void BM_SliceCacheLookup(benchmark::State& state)
+{
+  auto nGroups = state.range(0);
+  bool sparse = state.range(1);
+  auto table = makeTable(nGroups, sparse);
+  ArrowTableSlicingCache cache({{"Tracks", "fIndexCollisions"}});
+  (void)cache.updateCacheEntry(0, table);
+  auto info = cache.getCacheForPos(0);
+  bool scan = state.range(2);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (auto g = 0; g < nGroups; ++g) {
+      auto [offset, count] = scan ? info.scanSliceFor(sparse ? 100 * g : g) : info.getSliceFor(sparse ? 100 * g : g);
+      sum += offset + count;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * nGroups);
+}
+
+BENCHMARK(BM_SliceCacheLookup)->RangeMultiplier(4)->Ranges({{64, 64 << 10}, {0, 1}, {0, 1}});
+
+BENCHMARK_MAIN();
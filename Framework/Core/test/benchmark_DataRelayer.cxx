@@ -15,9 +15,19 @@
 #include "Framework/CompletionPolicyHelpers.h"
 #include "Framework/DataRelayer.h"
 #include "Framework/DataProcessingHeader.h"
+#include "Framework/DataProcessingStats.h"
+#include "Framework/DataProcessingStates.h"
+#include "Framework/DeviceState.h"
+#include "Framework/DriverConfig.h"
+#include "Framework/ServiceRegistryHelpers.h"
+#include "Framework/TimingHelpers.h"
 #include <Monitoring/Monitoring.h>
 #include <fairmq/TransportFactory.h>
+#include <uv.h>
+#include <array>
+#include <atomic>
 #include <cstring>
+#include <thread>
 #include <vector>
 
 using Monitoring = o2::monitoring::Monitoring;
@@ -354,4 +364,98 @@ static void BM_RelayMultiplePayloads(benchmark::State& state)
 
 BENCHMARK(BM_RelayMultiplePayloads)->Arg(10)->Arg(100)->Arg(1000);
 
+// Simulates a time pipelined device: one thread per lane relays synthetic
+// inputs for the timeslices of its lane, while the main thread keeps
+// checking for completed slots and consumes them. With the lock sharded
+// by lane, relaying on different lanes does not serialise.
+static void BM_RelayContention(benchmark::State& state)
+{
+  const size_t nLanes = state.range(0);
+  constexpr size_t timeslicesPerLane = 1000;
+
+  ServiceRegistry registry;
+  ServiceRegistryRef ref{registry};
+  const DriverConfig driverConfig{
+    .batch = false,
+  };
+  DataProcessingStates states(
+    TimingHelpers::defaultRealtimeBaseConfigurator(0, uv_default_loop()),
+    TimingHelpers::defaultCPUTimeConfigurator(uv_default_loop()));
+  DataProcessingStats stats(
+    TimingHelpers::defaultRealtimeBaseConfigurator(0, uv_default_loop()),
+    TimingHelpers::defaultCPUTimeConfigurator(uv_default_loop()), {});
+  using MetricSpec = DataProcessingStats::MetricSpec;
+  std::vector<MetricSpec> specs{
+    MetricSpec{.name = "malformed_inputs", .metricId = static_cast<short>(ProcessingStatsId::MALFORMED_INPUTS)},
+    MetricSpec{.name = "dropped_computations", .metricId = static_cast<short>(ProcessingStatsId::DROPPED_COMPUTATIONS)},
+    MetricSpec{.name = "dropped_incoming_messages", .metricId = static_cast<short>(ProcessingStatsId::DROPPED_INCOMING_MESSAGES)},
+    MetricSpec{.name = "relayed_messages", .metricId = static_cast<short>(ProcessingStatsId::RELAYED_MESSAGES)}};
+  for (auto& spec : specs) {
+    stats.registerMetric(spec);
+  }
+  DeviceState deviceState;
+  ref.registerService(ServiceRegistryHelpers::handleForService<DataProcessingStats>(&stats));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DataProcessingStates>(&states));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DriverConfig const>(&driverConfig));
+  ref.registerService(ServiceRegistryHelpers::handleForService<DeviceState>(&deviceState));
+
+  InputSpec spec{"clusters", "TPC", "CLUSTERS"};
+  std::vector<InputRoute> inputs;
+  for (size_t li = 0; li < nLanes; ++li) {
+    inputs.push_back(InputRoute{spec, 0, "Fake", li});
+  }
+  std::vector<InputChannelInfo> infos{1};
+  TimesliceIndex index{nLanes, infos};
+  ref.registerService(ServiceRegistryHelpers::handleForService<TimesliceIndex>(&index));
+
+  auto policy = CompletionPolicyHelpers::consumeWhenAny();
+  DataRelayer relayer(policy, inputs, index, {registry});
+  relayer.setPipelineLength(2 * nLanes);
+
+  DataHeader dh;
+  dh.dataDescription = "CLUSTERS";
+  dh.dataOrigin = "TPC";
+  dh.subSpecification = 0;
+  dh.payloadSize = 1000;
+
+  auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  DataRelayer::InputInfo fakeInfo{0, 2, DataRelayer::InputType::Data, {ChannelIndex::INVALID}};
+
+  for (auto _ : state) {
+    std::atomic<size_t> consumed = 0;
+    std::vector<std::thread> producers;
+    for (size_t li = 0; li < nLanes; ++li) {
+      producers.emplace_back([&, li]() {
+        for (size_t ti = 0; ti < timeslicesPerLane; ++ti) {
+          DataProcessingHeader dph{li + ti * nLanes, 1};
+          Stack stack{dh, dph};
+          std::array<fair::mq::MessagePtr, 2> messages;
+          messages[0] = transport->CreateMessage(stack.size());
+          messages[1] = transport->CreateMessage(dh.payloadSize);
+          memcpy(messages[0]->GetData(), stack.data(), stack.size());
+          // Wait for a slot of the lane to be consumed if the lane is full.
+          while (relayer.relay(messages[0]->GetData(), messages.data(), fakeInfo, messages.size()).type == DataRelayer::RelayChoice::Type::Backpressured) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+    std::vector<RecordAction> ready;
+    while (consumed < nLanes * timeslicesPerLane) {
+      ready.clear();
+      relayer.getReadyToProcess(ready);
+      for (auto& action : ready) {
+        auto result = relayer.consumeAllInputsForTimeslice(action.slot);
+        consumed += result.size();
+      }
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * nLanes * timeslicesPerLane);
+}
+
+BENCHMARK(BM_RelayContention)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
 BENCHMARK_MAIN();
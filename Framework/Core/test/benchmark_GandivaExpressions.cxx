@@ -67,7 +67,25 @@ static void BM_GandivaExpression(benchmark::State& state)
   benchmark::DoNotOptimize(tt);
 }
 
+// selection of the rows of a table with a compiled gandiva filter or with the interpreter
+static void BM_FilterSelection(benchmark::State& state)
+{
+  auto tt = createTable(state.range(0));
+  auto table = tt.asArrowTable();
+  expressions::Filter filter = (nabs(test::x) < 1.f) && ((test::y > 0.f) || (test::z * 2.f < test::x));
+  auto ops = expressions::createOperations(filter);
+  bool interpreted = state.range(1);
+  auto gfilter = interpreted ? nullptr : expressions::createFilter(table->schema(), ops);
+  auto ifilter = interpreted ? expressions::createInterpretedFilter(ops) : nullptr;
+  for (auto _ : state) {
+    auto selection = interpreted ? expressions::createSelection(table, ifilter) : expressions::createSelection(table, gfilter);
+    benchmark::DoNotOptimize(selection);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
 BENCHMARK(BM_DirectCalculation)->Arg(maxrows);
 BENCHMARK(BM_GandivaExpression)->Arg(maxrows);
+BENCHMARK(BM_FilterSelection)->Args({1000, 0})->Args({1000, 1})->Args({100000, 0})->Args({100000, 1});
 
 BENCHMARK_MAIN();
@@ -62,6 +62,35 @@ static void BM_StandardNameLookup(benchmark::State& state)
     }
   }
 }
+/// Fill a TH1, a THn and a StepTHn of a HistogramRegistry directly or through the fill buffer
+static void BM_RegistryFill(benchmark::State& state)
+{
+  HistogramRegistry registry{"registry"};
+  registry.add("th1", "th1", kTH1F, {{100, 0, 1}});
+  registry.add("thn", "thn", kTHnF, {{100, 0, 1}, {20, 0, 1}, {10, 0, 1}, {10, 0, 1}});
+  registry.add("step", "step", {kStepTHnF, {{100, 0, 1}, {20, 0, 1}, {10, 0, 1}, {10, 0, 1}}, 2});
+  registry.setFillBufferSize(state.range(1));
+  std::vector<float> values(4096);
+  for (auto i = 0u; i < values.size(); ++i) {
+    values[i] = (i * 2654435761u % 10007) / 10007.f;
+  }
+  for (auto _ : state) {
+    for (auto i = 0u; i < values.size() - 3; ++i) {
+      if (state.range(0) == 0) {
+        registry.fill(HIST("th1"), values[i]);
+      } else if (state.range(0) == 1) {
+        registry.fill(HIST("thn"), values[i], values[i + 1], values[i + 2], values[i + 3]);
+      } else {
+        registry.fill(HIST("step"), 1, values[i], values[i + 1], values[i + 2], values[i + 3]);
+      }
+    }
+    registry.flush();
+  }
+  state.SetItemsProcessed(state.iterations() * (values.size() - 3));
+}
+
+BENCHMARK(BM_RegistryFill)->Args({0, 0})->Args({0, 4096})->Args({1, 0})->Args({1, 4096})->Args({2, 0})->Args({2, 4096});
+
 BENCHMARK(BM_HashedNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 BENCHMARK(BM_StandardNameLookup)->Arg(4)->Arg(8)->Arg(16)->Arg(64)->Arg(128)->Arg(256)->Arg(512);
 
@@ -13,6 +13,8 @@
 #include "TestClasses.h"
 #include "Framework/AnalysisTask.h"
 #include "Framework/AnalysisDataModel.h"
+#include "Framework/AnalysisSupportHelpers.h"
+#include "Framework/DataSpecUtils.h"
 
 #include <catch_amalgamated.hpp>
 
@@ -185,6 +187,17 @@ struct LTask {
   void process(aod::McCollision const&, soa::SmallGroups<soa::Join<aod::Collisions, aod::McCollisionLabels>> const&) {}
 };
 
+struct MTask {
+  ReadsColumns<aod::Tracks, aod::track::Signed1Pt, aod::track::Tgl> trackColumns;
+  Filter xFilter = aod::track::x > 0.f;
+  void process(soa::Filtered<aod::Tracks> const&) {}
+};
+
+struct NTask {
+  ReadsColumns<aod::Tracks, aod::track::X> trackColumns;
+  void process(aod::Tracks const&) {}
+};
+
 TEST_CASE("AdaptorCompilation")
 {
   auto cfgc = makeEmptyConfigContext();
@@ -325,3 +338,49 @@ TEST_CASE("TestPartitionIteration")
   }
   REQUIRE(i == 1);
 }
+
+TEST_CASE("ColumnProjections")
+{
+  auto cfgc = makeEmptyConfigContext();
+  auto taskM = adaptAnalysisTask<MTask>(*cfgc, TaskName{"testM"});
+  auto taskN = adaptAnalysisTask<NTask>(*cfgc, TaskName{"testN"});
+  REQUIRE(taskM.inputs[0].binding == "Tracks");
+  REQUIRE(taskN.inputs[0].binding == "Tracks");
+
+  auto columns = [](InputSpec const& input) {
+    std::set<std::string> labels;
+    for (auto& p : input.metadata) {
+      if (p.name.starts_with("column:")) {
+        labels.insert(p.name.substr(7));
+      }
+    }
+    return labels;
+  };
+  // the filter column is read as well
+  REQUIRE(columns(taskM.inputs[0]) == std::set<std::string>{"fSigned1Pt", "fTgl", "fX"});
+  REQUIRE(columns(taskN.inputs[0]) == std::set<std::string>{"fX"});
+
+  OutputSpec tracks{DataSpecUtils::asConcreteDataMatcher(taskM.inputs[0])};
+  auto makeReader = [&tracks]() {
+    return DataProcessorSpec{
+      .name = "internal-dpl-aod-reader",
+      .outputs = {tracks},
+      .options = {ConfigParamSpec{"aod-reader-columns", VariantType::String, "", {"columns"}}}};
+  };
+  auto readerColumns = [](WorkflowSpec const& workflow) {
+    return AnalysisSupportHelpers::parseColumnProjections(workflow[0].options[0].defaultValue.get<std::string>());
+  };
+
+  // the reader reads the union of the declared columns
+  WorkflowSpec workflow{makeReader(), taskM, taskN};
+  AnalysisSupportHelpers::addColumnProjectionsToReader(workflow);
+  auto projections = readerColumns(workflow);
+  REQUIRE(projections.size() == 1);
+  REQUIRE(projections[DataSpecUtils::describe(tracks)] == std::set<std::string>{"fSigned1Pt", "fTgl", "fX"});
+
+  // a consumer which does not declare its columns reads the whole table
+  auto taskD = adaptAnalysisTask<DTask>(*cfgc, TaskName{"testD"});
+  WorkflowSpec full{makeReader(), taskM, taskD};
+  AnalysisSupportHelpers::addColumnProjectionsToReader(full);
+  REQUIRE(readerColumns(full).empty());
+}
@@ -0,0 +1,53 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include <catch_amalgamated.hpp>
+
+#include "Framework/ArrowIPCHelpers.h"
+#include "Framework/TableBuilder.h"
+
+#include <arrow/array.h>
+#include <arrow/table.h>
+#include <arrow/util/compression.h>
+#include <arrow/util/key_value_metadata.h>
+
+using namespace o2::framework;
+
+TEST_CASE("ArrowIPCRoundTrip")
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<int, float>({"fX", "fY"});
+  for (int i = 0; i < 1000; ++i) {
+    rowWriter(0, i, 0.5f * i);
+  }
+  auto table = builder.finalize();
+  auto metadata = std::make_shared<arrow::KeyValueMetadata>(std::vector<std::string>{"DataType"}, std::vector<std::string>{"MC"});
+  table = table->ReplaceSchemaMetadata(metadata);
+
+  std::vector<std::pair<std::string, arrow::Compression::type>> codecs{{"none", arrow::Compression::UNCOMPRESSED}, {"lz4", arrow::Compression::LZ4_FRAME}, {"zstd", arrow::Compression::ZSTD}};
+  for (auto& [codec, type] : codecs) {
+    if (!arrow::util::Codec::IsAvailable(type)) {
+      continue;
+    }
+    auto path = "arrowipc_" + codec + ArrowIPCHelpers::extension;
+    ArrowIPCHelpers::writeTable(table, path, codec);
+    auto readBack = ArrowIPCHelpers::readTable(path);
+    REQUIRE(readBack->num_rows() == 1000);
+    REQUIRE(readBack->num_columns() == 2);
+    REQUIRE(readBack->schema()->field(1)->name() == "fY");
+    REQUIRE(readBack->schema()->metadata()->Get("DataType").ValueOrDie() == "MC");
+    REQUIRE(readBack->Equals(*table));
+    REQUIRE(ArrowIPCHelpers::readSchema(path)->Equals(*table->schema(), true));
+  }
+
+  REQUIRE_THROWS(ArrowIPCHelpers::writeTable(table, "arrowipc_bad.arrow", "gzip2"));
+  REQUIRE_THROWS(ArrowIPCHelpers::readTable("arrowipc_missing.arrow"));
+}
@@ -12,6 +12,7 @@
 #include <catch_amalgamated.hpp>
 #include "Headers/DataHeader.h"
 #include "Framework/DataOutputDirector.h"
+#include <filesystem>
 #include <fstream>
 
 TEST_CASE("TestDataOutputDirector")
@@ -120,4 +121,8 @@ TEST_CASE("TestDataOutputDirector")
   REQUIRE(ds[1]->tablename == std::string("DUE"));
   REQUIRE(ds[1]->treename == std::string("due"));
   REQUIRE(ds[1]->colnames.size() == 1);
+
+  dod.setResultDir("arrowresults");
+  REQUIRE(dod.getArrowFileName(ds[1], 12) == std::string("arrowresults/dueresults/DF_12/due.arrow"));
+  REQUIRE(std::filesystem::is_directory("arrowresults/dueresults/DF_12"));
 }
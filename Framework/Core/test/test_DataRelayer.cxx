@@ -249,6 +249,90 @@ TEST_CASE("DataRelayer")
     REQUIRE(result.at(1).size() == 1);
   }
 
+  // Only the slots which were touched since the last check should
+  // be passed to the completion policy.
+  SECTION("TestIncrementalCompletion")
+  {
+    InputSpec spec1{"clusters", "TPC", "CLUSTERS"};
+    InputSpec spec2{"clusters_its", "ITS", "CLUSTERS"};
+
+    std::vector<InputRoute> inputs = {
+      InputRoute{spec1, 0, "Fake1", 0},
+      InputRoute{spec2, 1, "Fake2", 0}};
+
+    std::vector<InputChannelInfo> infos{1};
+    TimesliceIndex index{1, infos};
+    ref.registerService(ServiceRegistryHelpers::handleForService<TimesliceIndex>(&index));
+
+    int evaluations = 0;
+    auto consumeWhenAll = CompletionPolicyHelpers::consumeWhenAll();
+    CompletionPolicy policy{"counting", consumeWhenAll.matcher,
+                            [&evaluations, &consumeWhenAll](InputSpan const& span, std::vector<InputSpec> const& specs, ServiceRegistryRef& ref) {
+                              evaluations++;
+                              return consumeWhenAll.callbackFull(span, specs, ref);
+                            }};
+    DataRelayer relayer(policy, inputs, index, {registry});
+    relayer.setPipelineLength(4);
+
+    auto transport = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+    auto channelAlloc = o2::pmr::getTransportAllocator(transport.get());
+
+    auto createMessage = [&transport, &channelAlloc, &relayer](DataHeader& dh, size_t time) {
+      std::array<fair::mq::MessagePtr, 2> messages;
+      messages[0] = o2::pmr::getMessage(Stack{channelAlloc, dh, DataProcessingHeader{time, 1}});
+      messages[1] = transport->CreateMessage(1000);
+      DataRelayer::InputInfo fakeInfo{0, messages.size(), DataRelayer::InputType::Data, {ChannelIndex::INVALID}};
+      relayer.relay(messages[0]->GetData(), messages.data(), fakeInfo, messages.size());
+    };
+
+    DataHeader dh1;
+    dh1.dataDescription = "CLUSTERS";
+    dh1.dataOrigin = "TPC";
+    dh1.subSpecification = 0;
+    dh1.splitPayloadIndex = 0;
+    dh1.splitPayloadParts = 1;
+
+    DataHeader dh2;
+    dh2.dataDescription = "CLUSTERS";
+    dh2.dataOrigin = "ITS";
+    dh2.subSpecification = 0;
+    dh2.splitPayloadIndex = 0;
+    dh2.splitPayloadParts = 1;
+
+    std::vector<RecordAction> ready;
+    relayer.getReadyToProcess(ready);
+    REQUIRE(evaluations == 0);
+
+    createMessage(dh1, 0);
+    relayer.getReadyToProcess(ready);
+    REQUIRE(ready.size() == 0);
+    REQUIRE(evaluations == 1);
+    REQUIRE(index.hasDirtySlots() == false);
+
+    // Nothing new arrived, the policy is not invoked again.
+    relayer.getReadyToProcess(ready);
+    REQUIRE(evaluations == 1);
+
+    // A rescan only needs to check the slots which are actually in use.
+    relayer.rescan();
+    relayer.getReadyToProcess(ready);
+    REQUIRE(ready.size() == 0);
+    REQUIRE(evaluations == 2);
+
+    createMessage(dh2, 0);
+    relayer.getReadyToProcess(ready);
+    REQUIRE(ready.size() == 1);
+    REQUIRE(evaluations == 3);
+    auto result = relayer.consumeAllInputsForTimeslice(ready[0].slot);
+    REQUIRE(result.size() == 2);
+
+    relayer.rescan();
+    ready.clear();
+    relayer.getReadyToProcess(ready);
+    REQUIRE(ready.size() == 0);
+    REQUIRE(evaluations == 3);
+  }
+
   // This test a more complicated set of inputs, and verifies that data is
   // correctly relayed before being processed.
   SECTION("TestRelayBug")
@@ -14,7 +14,10 @@
 #include "Framework/AnalysisDataModel.h"
 #include "Framework/AODReaderHelpers.h"
 #include <catch_amalgamated.hpp>
+#include <arrow/builder.h>
 #include <arrow/util/config.h>
+#include <gandiva/tree_expr_builder.h>
+#include <random>
 
 using namespace o2::framework;
 using namespace o2::framework::expressions;
@@ -28,6 +31,7 @@ static BindingNode eta{"eta", 3, atype::FLOAT};
 static BindingNode tgl{"tgl", 4, atype::FLOAT};
 static BindingNode signed1Pt{"signed1Pt", 5, atype::FLOAT};
 static BindingNode testInt{"testInt", 6, atype::INT32};
+static BindingNode good{"good", 7, atype::BOOL};
 } // namespace nodes
 
 namespace o2::aod::track
@@ -283,3 +287,79 @@ TEST_CASE("TestConditionalExpressions")
   auto gandiva_filter2 = createFilter(schema2, gandiva_condition2);
   REQUIRE(gandiva_tree2->ToString() == "bool greater_than((float) fSigned1Pt, (const float) 0 raw(0)) && if (bool less_than(float absf((float) fEta), (const float) 1 raw(3f800000)) && if (bool less_than((float) fPt, (const float) 1 raw(3f800000))) { bool greater_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) } else { bool less_than((float) fPhi, (const float) 1.5708 raw(3fc90fdb)) }) { bool greater_than(float absf((float) fX), (const float) 1 raw(3f800000)) } else { bool greater_than(float absf((float) fY), (const float) 1 raw(3f800000)) }");
 }
+
+TEST_CASE("TestFilterInterpreter")
+{
+  TableBuilder builder;
+  auto rowWriter = builder.persist<float, float, int32_t, bool>({"pt", "eta", "testInt", "good"});
+  std::default_random_engine e(1234567890);
+  std::uniform_real_distribution<float> pt(0.f, 5.f);
+  std::normal_distribution<float> eta(0.f, 1.f);
+  std::uniform_int_distribution<int32_t> testInt(-10, 10);
+  for (auto i = 0; i < 1000; ++i) {
+    rowWriter(0, pt(e), eta(e), testInt(e), testInt(e) > 0);
+  }
+  auto table = builder.finalize();
+
+  auto compare = [&table](gandiva::Selection const& interpreted, gandiva::Selection const& compiled) {
+    REQUIRE(interpreted->GetNumSlots() == compiled->GetNumSlots());
+    for (auto i = 0; i < compiled->GetNumSlots(); ++i) {
+      REQUIRE(interpreted->GetIndex(i) == compiled->GetIndex(i));
+    }
+  };
+
+  std::vector<Filter> filters;
+  filters.emplace_back((nodes::pt > 1.f) && (nabs(nodes::eta) < 0.8f));
+  filters.emplace_back(((nodes::testInt & 3) == 3) || (nodes::testInt < -5));
+  filters.emplace_back((nodes::good == true) && (nodes::pt * 2.f > nodes::eta + 1.f));
+  filters.emplace_back(ifnode(nodes::pt < 1.f, nodes::eta > 0.f, nodes::eta < 0.f));
+  for (auto& filter : filters) {
+    auto ops = createOperations(filter);
+    auto ifilter = createInterpretedFilter(ops);
+    REQUIRE(ifilter != nullptr);
+    auto selection = createSelection(table, ifilter);
+    REQUIRE(selection->GetNumSlots() > 0);
+    compare(selection, createSelection(table, createFilter(table->schema(), ops)));
+  }
+
+  // several filters of a task input are combined with logical 'and'
+  auto ops0 = createOperations(filters[0]);
+  auto ops1 = createOperations(filters[1]);
+  auto combined = createInterpretedFilter(ops1, createInterpretedFilter(ops0));
+  auto tree = gandiva::TreeExprBuilder::MakeAnd({createExpressionTree(ops0, table->schema()), createExpressionTree(ops1, table->schema())});
+  compare(createSelection(table, combined), createSelection(table, createFilter(table->schema(), makeCondition(tree))));
+
+  // null values: gandiva does not select the rows with a null result, and a null operand of
+  // a logical 'and'/'or' or in the branch of a conditional which is not taken may not matter
+  arrow::FloatBuilder ptBuilder;
+  arrow::FloatBuilder etaBuilder;
+  arrow::Int32Builder intBuilder;
+  arrow::BooleanBuilder goodBuilder;
+  for (auto i = 0; i < 1000; ++i) {
+    (void)(i % 7 == 0 ? ptBuilder.AppendNull() : ptBuilder.Append(pt(e)));
+    (void)(i % 5 == 0 ? etaBuilder.AppendNull() : etaBuilder.Append(eta(e)));
+    (void)(i % 3 == 0 ? intBuilder.AppendNull() : intBuilder.Append(testInt(e)));
+    (void)(i % 11 == 0 ? goodBuilder.AppendNull() : goodBuilder.Append(testInt(e) > 0));
+  }
+  std::vector<std::shared_ptr<arrow::Array>> arrays(4);
+  (void)ptBuilder.Finish(&arrays[0]);
+  (void)etaBuilder.Finish(&arrays[1]);
+  (void)intBuilder.Finish(&arrays[2]);
+  (void)goodBuilder.Finish(&arrays[3]);
+  auto nullable = arrow::Table::Make(arrow::schema({arrow::field("pt", arrow::float32()), arrow::field("eta", arrow::float32()), arrow::field("testInt", arrow::int32()), arrow::field("good", arrow::boolean())}), arrays);
+  filters.emplace_back((nodes::pt > 1.f) || (nodes::good == true));
+  filters.emplace_back(((nodes::eta > 0.f) || (nodes::testInt > 0)) && ((nodes::pt < 2.f) && (nodes::good == false)));
+  filters.emplace_back(ifnode(nodes::good == true, nodes::pt > 1.f, nodes::eta * 2.f < 1.f) || (nodes::testInt < -5));
+  for (auto& filter : filters) {
+    auto ops = createOperations(filter);
+    auto ifilter = createInterpretedFilter(ops);
+    REQUIRE(ifilter != nullptr);
+    auto selection = createSelection(nullable, ifilter);
+    REQUIRE(selection->GetNumSlots() > 0);
+    compare(selection, createSelection(nullable, createFilter(nullable->schema(), ops)));
+  }
+
+  // functions are left to gandiva
+  Filter unsupported = nsqrt(nodes::pt) > 1.f;
+  REQUIRE(createInterpretedFilter(createOperations(unsupported)) == nullptr);
+}
@@ -14,9 +14,12 @@
 #include "MemoryResources/MemoryResources.h"
 #include "Headers/DataHeader.h"
 #include "Headers/Stack.h"
+#include "Framework/DataAllocator.h"
+#include "Framework/DataRef.h"
 
 #include <catch_amalgamated.hpp>
 #include <vector>
+#include <cstring>
 #include <fairmq/Tools.h>
 #include <fairmq/ProgOptions.h>
 #include <gsl/gsl>
@@ -217,3 +220,48 @@ TEST_CASE("addDataBlockForEach_test")
     REQUIRE(checkOK == 2);
   }
 }
+
+TEST_CASE("DataAllocatorForward")
+{
+  size_t session{(size_t)getpid() * 1000 + 1};
+  fair::mq::ProgOptions config;
+  config.SetProperty<std::string>("session", std::to_string(session));
+
+  auto factoryZMQ = fair::mq::TransportFactory::CreateTransportFactory("zeromq");
+  auto factorySHM = fair::mq::TransportFactory::CreateTransportFactory("shmem", "DataAllocatorForward", &config);
+  REQUIRE(factorySHM != nullptr);
+  REQUIRE(factoryZMQ != nullptr);
+
+  std::vector<int> data{1, 2, 3, 4, 5};
+  auto size = data.size() * sizeof(int);
+  for (auto* inputFactory : {factoryZMQ.get(), factorySHM.get()}) {
+    auto input = inputFactory->CreateMessage(size, fair::mq::Alignment{64});
+    memcpy(input->GetData(), data.data(), size);
+    DataHeader dh{gDataDescriptionInvalid, gDataOriginInvalid, DataHeader::SubSpecificationType{0}, size};
+    o2::framework::DataRef ref{nullptr, reinterpret_cast<char const*>(&dh), static_cast<char const*>(input->GetData()), size, input.get()};
+
+    for (auto* outputFactory : {factoryZMQ.get(), factorySHM.get()}) {
+      auto output = o2::framework::DataAllocator::forwardedMessage(*outputFactory, ref);
+      REQUIRE(output->GetType() == outputFactory->GetType());
+      REQUIRE(output->GetSize() == size);
+      REQUIRE(memcmp(output->GetData(), data.data(), size) == 0);
+      // the buffer is shared with the same transport, copied with another one
+      REQUIRE((output->GetData() == input->GetData()) == (outputFactory == inputFactory));
+    }
+
+    // the payload is copied when the message holding it is not known
+    auto unknown = ref;
+    unknown.payloadMessage = nullptr;
+    auto copy = o2::framework::DataAllocator::forwardedMessage(*inputFactory, unknown);
+    REQUIRE(copy->GetData() != input->GetData());
+    REQUIRE(memcmp(copy->GetData(), data.data(), size) == 0);
+
+    // as well as when the message holds more than the payload
+    auto part = ref;
+    dh.payloadSize = size - sizeof(int);
+    part.payloadSize = dh.payloadSize;
+    copy = o2::framework::DataAllocator::forwardedMessage(*inputFactory, part);
+    REQUIRE(copy->GetSize() == size - sizeof(int));
+    REQUIRE(copy->GetData() != input->GetData());
+  }
+}
@@ -753,3 +753,24 @@ TEST_CASE("TestSlicingException")
     FAIL("Slicing should have failed due to unsorted index");
   }
 }
+
+TEST_CASE("SortedSliceIndexLookup")
+{
+  // dense keys with gaps and rows without group, then keys too sparse for a direct lookup table
+  for (int stride : {1, 3, 100000}) {
+    std::vector<int> values{-1};
+    std::vector<int64_t> counts{2};
+    for (auto i = 0; i < 50; ++i) {
+      values.push_back(stride * 2 * i + (i % 7 == 0 ? 1 : 0));
+      counts.push_back(i % 5);
+    }
+    SortedSliceIndex index;
+    index.build(values, counts);
+    SliceInfoPtr indexed{values, counts, &index};
+    SliceInfoPtr scanned{values, counts};
+    for (auto v = -3; v < stride * 100 + 3; v += (stride > 1000 ? stride / 2 : 1)) {
+      REQUIRE(indexed.getSliceFor(v) == scanned.getSliceFor(v));
+      REQUIRE(indexed.getSliceFor(v + 1) == scanned.getSliceFor(v + 1));
+    }
+  }
+}
@@ -125,3 +125,75 @@ TEST_CASE("HistogramRegistryStepTHn")
 
   registry.print();
 }
+
+TEST_CASE("HistogramRegistryFillBuffer")
+{
+  auto makeRegistry = []() {
+    HistogramRegistry registry{"registry"};
+    registry.add("x", "x", kTH1F, {{20, 0.0, 10.0}});
+    registry.add("xy", "xy", kTH2D, {{20, 0.0, 10.0}, {10, -5.0, 5.0}});
+    registry.add("profile", "profile", kTProfile, {{20, 0.0, 10.0}});
+    registry.add("sparse", "sparse", kTHnSparseF, {{20, 0.0, 10.0}, {10, -5.0, 5.0}, {5, 0.0, 1.0}});
+    registry.add("step", "step", {kStepTHnF, {{20, 0.0, 10.0}, {10, -5.0, 5.0}}, 2});
+    return registry;
+  };
+  auto fillAll = [](HistogramRegistry& registry, int i) {
+    double x = (i * 7 % 103) / 10.0, y = (i * 13 % 97) / 10.0 - 5.0;
+    registry.fill(HIST("x"), x);
+    registry.fill(HIST("xy"), x, y, 0.5);
+    registry.fill(HIST("profile"), x, y);
+    registry.fill(HIST("sparse"), x, y, 0.3, i % 3 == 0 ? 2.0 : 1.0);
+    registry.fill(HIST("step"), i % 2, x, y);
+  };
+  auto compare = [](HistogramRegistry& a, HistogramRegistry& b) {
+    REQUIRE(a.get<TH1>(HIST("x"))->GetEntries() == b.get<TH1>(HIST("x"))->GetEntries());
+    for (int bin = 0; bin < 22; ++bin) {
+      REQUIRE(a.get<TH1>(HIST("x"))->GetBinContent(bin) == b.get<TH1>(HIST("x"))->GetBinContent(bin));
+      REQUIRE(a.get<TProfile>(HIST("profile"))->GetBinContent(bin) == Catch::Approx(b.get<TProfile>(HIST("profile"))->GetBinContent(bin)));
+      for (int biny = 0; biny < 12; ++biny) {
+        REQUIRE(a.get<TH2>(HIST("xy"))->GetBinContent(bin, biny) == b.get<TH2>(HIST("xy"))->GetBinContent(bin, biny));
+      }
+    }
+    REQUIRE(a.get<THnSparse>(HIST("sparse"))->GetNbins() == b.get<THnSparse>(HIST("sparse"))->GetNbins());
+    REQUIRE(a.get<THnSparse>(HIST("sparse"))->GetEntries() == b.get<THnSparse>(HIST("sparse"))->GetEntries());
+    REQUIRE(a.get<THnSparse>(HIST("sparse"))->GetSumw() == b.get<THnSparse>(HIST("sparse"))->GetSumw());
+    for (int step = 0; step < 2; ++step) {
+      auto va = a.get<StepTHn>(HIST("step"))->getValues(step);
+      auto vb = b.get<StepTHn>(HIST("step"))->getValues(step);
+      REQUIRE(va->GetSize() == vb->GetSize());
+      for (int bin = 0; bin < va->GetSize(); ++bin) {
+        REQUIRE(va->GetAt(bin) == vb->GetAt(bin));
+      }
+    }
+  };
+
+  auto direct = makeRegistry();
+  for (int i = 0; i < 1000; ++i) {
+    fillAll(direct, i);
+  }
+
+  auto buffered = makeRegistry();
+  buffered.setFillBufferSize(300);
+  for (int i = 0; i < 1000; ++i) {
+    fillAll(buffered, i);
+  }
+  buffered.flush();
+  compare(direct, buffered);
+
+  // one buffer per thread
+  auto sharded = makeRegistry();
+  ParallelGroups parallel{"group-threads", 4, "threads"};
+  sharded.beginSharding(4);
+  parallel.run(1000, [&sharded, &fillAll](size_t i) { fillAll(sharded, i); });
+  sharded.endSharding(true);
+  compare(direct, sharded);
+
+  // shards small enough to be flushed while the groups are processed
+  auto overflowing = makeRegistry();
+  overflowing.setFillBufferSize(50);
+  overflowing.beginSharding(4);
+  parallel.run(1000, [&overflowing, &fillAll](size_t i) { fillAll(overflowing, i); });
+  REQUIRE(overflowing.get<TH1>(HIST("x"))->GetEntries() > 0);
+  overflowing.endSharding(true);
+  compare(direct, overflowing);
+}
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include <catch_amalgamated.hpp>
+#include "Framework/ParallelGroups.h"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+
+using namespace o2::framework;
+
+TEST_CASE("ParallelGroupsRun")
+{
+  ParallelGroups parallel{"group-threads", 4, "threads"};
+  REQUIRE(parallel.enabled());
+  for (size_t n : {0, 1, 3, 1000}) {
+    std::vector<std::atomic<int>> calls(n);
+    std::atomic<bool> groupsOk = true;
+    parallel.run(n, [&](size_t i) {
+      calls[i]++;
+      groupsOk = groupsOk && DeferredCalls::currentGroup() == static_cast<int>(i);
+    });
+    for (auto& c : calls) {
+      REQUIRE(c == 1);
+    }
+    REQUIRE(groupsOk);
+  }
+  REQUIRE(DeferredCalls::currentGroup() == -1);
+
+  REQUIRE_THROWS_AS(parallel.run(100, [](size_t i) { if (i == 17) { throw std::runtime_error("failed"); } }), std::runtime_error);
+  std::atomic<int> nCalls = 0;
+  parallel.run(10, [&nCalls](size_t) { nCalls++; });
+  REQUIRE(nCalls == 10);
+
+  ParallelGroups serial{"group-threads", 0, "threads"};
+  REQUIRE(!serial.enabled());
+  parallel.forceSerial();
+  REQUIRE(!parallel.enabled());
+}
+
+TEST_CASE("DeferredCallsOrder")
+{
+  ParallelGroups parallel{"group-threads", 3, "threads"};
+  DeferredCalls deferred;
+  std::vector<std::pair<size_t, int>> calls;
+  auto call = [&](size_t group, int k) {
+    if (deferred.recording()) {
+      deferred.record([&calls, group, k]() { calls.emplace_back(group, k); });
+    } else {
+      calls.emplace_back(group, k);
+    }
+  };
+  size_t nGroups = 500;
+  deferred.begin(nGroups);
+  parallel.run(nGroups, [&call](size_t i) {
+    for (int k = 0; k < static_cast<int>(i % 4); ++k) {
+      call(i, k);
+    }
+  });
+  REQUIRE(calls.empty());
+  deferred.replay();
+  REQUIRE(!deferred.recording());
+  REQUIRE(calls.size() == 750);
+  REQUIRE(std::is_sorted(calls.begin(), calls.end()));
+  call(nGroups, 0);
+  REQUIRE(calls.size() == 751);
+}
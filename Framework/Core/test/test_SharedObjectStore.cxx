@@ -0,0 +1,180 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#include <catch_amalgamated.hpp>
+#include "Framework/SharedObjectStore.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace o2::framework;
+
+namespace
+{
+/// Minimal object following the FlatObject protocol: the buffer holds
+/// an array of values and a pointer to it, which has to be relocated.
+struct TestFlatObject {
+  int nValues = 0;
+  char* container = nullptr;
+  char* buffer = nullptr;
+
+  ~TestFlatObject()
+  {
+    delete[] container;
+  }
+  void build(int n)
+  {
+    nValues = n;
+    buffer = container = new char[getFlatBufferSize()];
+    valuesPtr() = reinterpret_cast<int*>(buffer + sizeof(int*));
+    for (int i = 0; i < n; i++) {
+      values()[i] = i * i;
+    }
+  }
+  int*& valuesPtr() const { return *reinterpret_cast<int**>(buffer); }
+  int* values() const { return valuesPtr(); }
+  size_t getFlatBufferSize() const { return sizeof(int*) + nValues * sizeof(int); }
+  const char* getFlatBufferPtr() const { return buffer; }
+  const char* getFlatBufferContainerPtr() const { return container; }
+  void setActualBufferAddress(char* ptr)
+  {
+    auto* oldBase = reinterpret_cast<char*>(*reinterpret_cast<int**>(ptr)) - sizeof(int*);
+    buffer = ptr;
+    valuesPtr() = reinterpret_cast<int*>(buffer + (reinterpret_cast<char*>(values()) - oldBase));
+  }
+  void adoptInternalBuffer(char* ptr) { container = ptr; }
+};
+
+/// Same protocol, but not declared to be self-contained
+struct TestUnsharedFlatObject : TestFlatObject {
+};
+} // namespace
+
+template <>
+struct o2::gpu::FlatObjectSelfContained<TestFlatObject> {
+  static constexpr bool value = true;
+};
+template <>
+struct o2::gpu::FlatObjectSelfContained<TestUnsharedFlatObject> {
+  static constexpr bool value = false;
+};
+
+namespace
+{
+static_assert(flat_object<TestFlatObject>);
+static_assert(!flat_object<std::vector<int>>);
+static_assert(shareable_flat_object<TestFlatObject>);
+static_assert(flat_object<TestUnsharedFlatObject> && !shareable_flat_object<TestUnsharedFlatObject>);
+
+bool regionExists(std::string const& key)
+{
+  int fd = shm_open(SharedObjectStore::regionName(key).c_str(), O_RDONLY, 0);
+  if (fd >= 0) {
+    close(fd);
+  }
+  return fd >= 0;
+}
+} // namespace
+
+TEST_CASE("SharedObjectStoreImages")
+{
+  std::string key = "test-image-" + std::to_string(getpid());
+  SharedObjectStore::remove(key);
+  REQUIRE(SharedObjectStore::open(key) == nullptr);
+  auto image = SharedObjectStore::create(key, 10000, [](char* dest) { memset(dest, 'x', 10000); return true; });
+  REQUIRE(image);
+  REQUIRE(image->size() == 10000);
+  REQUIRE(SharedObjectStore::create(key, 10000, [](char*) { return true; }) == nullptr);
+  image->data()[0] = 'y'; // copy-on-write, invisible to others
+  {
+    auto other = SharedObjectStore::open(key);
+    REQUIRE(other);
+    REQUIRE(other->data() != image->data());
+    REQUIRE(other->data()[0] == 'x');
+    REQUIRE(other->data()[9999] == 'x');
+  }
+  REQUIRE(regionExists(key));
+  image.reset();
+  REQUIRE(!regionExists(key)); // removed by the last user
+
+  REQUIRE(SharedObjectStore::create(key, 100, [](char*) { return false; }) == nullptr);
+  REQUIRE(!regionExists(key));
+}
+
+TEST_CASE("SharedObjectStoreFlatObjects")
+{
+  std::string key = "test-flat-" + std::to_string(getpid());
+  int nBuilds = 0;
+  auto build = [&nBuilds]() {
+    nBuilds++;
+    auto obj = std::make_unique<TestFlatObject>();
+    obj->build(5000);
+    return obj;
+  };
+  auto [obj, image] = SharedObjectStore::getFlatObject<TestFlatObject>(key, build);
+  REQUIRE(obj);
+  REQUIRE(image);
+  REQUIRE(nBuilds == 1);
+  REQUIRE(obj->getFlatBufferPtr() == obj->getFlatBufferContainerPtr());
+  REQUIRE((char*)obj->values() > image->data());
+  REQUIRE((char*)obj->values() < image->data() + image->size());
+  REQUIRE(obj->values()[4999] == 4999 * 4999);
+
+  // another process maps the same image and relocates its own copy
+  pid_t pid = fork();
+  if (pid == 0) {
+    bool ok = false;
+    {
+      auto [other, otherImage] = SharedObjectStore::getFlatObject<TestFlatObject>(key, build);
+      ok = other && otherImage && nBuilds == 1 && other->nValues == 5000 && other->values()[77] == 77 * 77 &&
+           (char*)other->values() > otherImage->data() && (char*)other->values() < otherImage->data() + otherImage->size();
+    }
+    _exit(ok ? 0 : 1);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  REQUIRE(WIFEXITED(status));
+  REQUIRE(WEXITSTATUS(status) == 0);
+  REQUIRE(obj->values()[77] == 77 * 77);
+  image.reset();
+  REQUIRE(!regionExists(key + "/" + typeid(TestFlatObject).name()));
+}
+
+TEST_CASE("SharedObjectStoreDeadUsers")
+{
+  std::string key = "test-dead-" + std::to_string(getpid());
+  auto runChild = [&key](bool create) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      // exit without releasing the image, as if the process crashed
+      auto image = create ? SharedObjectStore::create(key, 100, [](char*) { return true; }) : SharedObjectStore::open(key);
+      _exit(image ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  };
+
+  // the registration of a dead user does not keep the region alive
+  auto image = SharedObjectStore::create(key, 100, [](char*) { return true; });
+  REQUIRE(image);
+  REQUIRE(runChild(false));
+  image.reset();
+  REQUIRE(!regionExists(key));
+
+  // a region whose users all died is removed by the cleanup
+  REQUIRE(runChild(true));
+  REQUIRE(regionExists(key));
+  REQUIRE(SharedObjectStore::cleanup() >= 1);
+  REQUIRE(!regionExists(key));
+}
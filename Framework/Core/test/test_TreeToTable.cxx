@@ -235,3 +235,53 @@ TEST_CASE("VariableLists")
     ++i;
   }
 }
+
+TEST_CASE("ProjectedColumns")
+{
+  TFile f1("tree2table_projected.root", "RECREATE");
+  TTree t1("t1", "a tree with an index column");
+  Float_t px, py;
+  Int_t index;
+  t1.Branch("px", &px, "px/F");
+  t1.Branch("py", &py, "py/F");
+  t1.Branch("fIndexCollisions", &index, "fIndexCollisions/I");
+  int ndp = 100;
+  for (int i = 0; i < ndp; i++) {
+    px = i;
+    py = -i;
+    index = i / 10;
+    t1.Fill();
+  }
+  t1.Write();
+
+  TreeToTable all;
+  all.addAllColumns(&t1);
+  auto allBytes = all.readBytes(&t1);
+
+  TreeToTable tr2ta;
+  auto skipped = tr2ta.addProjectedColumns(&t1, {"px"});
+  REQUIRE(skipped == std::vector<std::string>{"py"});
+  auto projectedBytes = tr2ta.readBytes(&t1);
+  tr2ta.fill(&t1);
+  auto table = tr2ta.finalize();
+  f1.Close();
+
+  REQUIRE(projectedBytes.first < allBytes.first);
+  REQUIRE(projectedBytes.second < allBytes.second);
+
+  REQUIRE(table->Validate().ok());
+  REQUIRE(table->num_rows() == ndp);
+  REQUIRE(table->num_columns() == 3);
+  // skipped columns keep their type, but are null
+  REQUIRE(table->GetColumnByName("py")->type()->Equals(arrow::float32()));
+  REQUIRE(table->GetColumnByName("py")->null_count() == ndp);
+  REQUIRE(table->GetColumnByName("px")->null_count() == 0);
+  REQUIRE(table->GetColumnByName("fIndexCollisions")->null_count() == 0);
+
+  auto pxs = std::static_pointer_cast<arrow::FloatArray>(table->GetColumnByName("px")->chunk(0));
+  auto indices = std::static_pointer_cast<arrow::Int32Array>(table->GetColumnByName("fIndexCollisions")->chunk(0));
+  for (int i = 0; i < ndp; i++) {
+    REQUIRE(pxs->Value(i) == i);
+    REQUIRE(indices->Value(i) == i / 10);
+  }
+}
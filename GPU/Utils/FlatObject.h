@@ -258,6 +258,9 @@ class FlatObject
   /// Gives pointer to the flat buffer
   const char* getFlatBufferPtr() const { return mFlatBufferPtr; }
 
+  /// Gives pointer to the internal container of the flat buffer (set also before the buffer address, e.g. after ROOT I/O)
+  const char* getFlatBufferContainerPtr() const { return mFlatBufferContainer; }
+
   /// Tells if the object is constructed
   bool isConstructed() const { return (mConstructionMask & (uint32_t)ConstructionState::Constructed); }
 
@@ -327,6 +330,15 @@ class FlatObject
   ClassDefNV(FlatObject, 1);
 };
 
+/// Trait to be specialized with value = true by the flat objects which keep no pointers or owned resources
+/// outside of their flat buffer: a bitwise copy of such an object together with its buffer, relocated with
+/// setActualBufferAddress, is complete in any process. Only these objects may be shared between processes
+/// (o2::framework::SharedObjectStore).
+template <class T>
+struct FlatObjectSelfContained {
+  static constexpr bool value = false;
+};
+
 /// ========================================================================================================
 ///
 ///       Inline implementations of methods
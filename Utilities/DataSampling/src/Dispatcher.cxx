@@ -172,8 +172,8 @@ header::Stack Dispatcher::extractAdditionalHeaders(const char* inputHeaderStack)
 
 void Dispatcher::send(DataAllocator& dataAllocator, const DataRef& inputData, const Output& output) const
 {
-  const auto* inputHeader = DataRefUtils::getHeader<header::DataHeader*>(inputData);
-  dataAllocator.snapshot(output, inputData.payload, DataRefUtils::getPayloadSize(inputData), inputHeader->payloadSerializationMethod);
+  // the payload is shared with the input message, it is copied only if the output uses another transport
+  dataAllocator.forward(output, inputData);
 }
 
 void Dispatcher::registerPolicy(std::unique_ptr<DataSamplingPolicy>&& policy)
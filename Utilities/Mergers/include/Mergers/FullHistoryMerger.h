@@ -17,6 +17,7 @@
 ///
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
+#include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerConfig.h"
 #include "Mergers/ObjectStore.h"
 
@@ -58,6 +59,7 @@ class FullHistoryMerger : public framework::Task
 
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
+  std::unique_ptr<algorithm::ParallelMerging> mParallelMerging;
   int mCyclesSinceReset = 0;
 
   // stats
@@ -17,6 +17,7 @@
 ///
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
+#include "Mergers/MergerAlgorithm.h"
 #include "Mergers/MergerConfig.h"
 #include "Mergers/MergeInterface.h"
 #include "Mergers/ObjectStore.h"
@@ -58,7 +59,7 @@ class IntegratingMerger : public framework::Task
   void finishCycle(framework::DataAllocator& outputs);
   void publishIntegral(framework::DataAllocator& allocator);
   void publishMovingWindow(framework::DataAllocator& allocator);
-  static void merge(ObjectStore& mMergedDelta, ObjectStore&& other);
+  void merge(ObjectStore& mMergedDelta, ObjectStore&& other);
   void clear();
   bool shouldFinishCycle(const framework::InputRecord&) const;
 
@@ -70,6 +71,7 @@ class IntegratingMerger : public framework::Task
   ObjectStore mMergedObjectIntegral = std::monostate{};
   MergerConfig mConfig;
   std::unique_ptr<monitoring::Monitoring> mCollector;
+  std::unique_ptr<algorithm::ParallelMerging> mParallelMerging;
   int mCyclesSinceReset = 0;
 
   // stats
@@ -19,19 +19,55 @@
 
 #include "ObjectStore.h"
 
+#include <cstddef>
+#include <functional>
+#include <memory>
+
 class TObject;
+class TH1;
 
 namespace o2::mergers::algorithm
 {
 
+/// \brief Threads merging the independent entries of collections in parallel.
+///
+/// The calling thread takes part in the work, so a pool of N threads starts N - 1 workers.
+class ParallelMerging
+{
+ public:
+  /// \brief Starts (threads - 1) workers and enables ROOT thread safety if there is any.
+  explicit ParallelMerging(size_t threads);
+  ~ParallelMerging();
+
+  size_t threads() const;
+
+  /// \brief Calls f for all indices in [0, n) on the workers and the calling thread.
+  ///
+  /// The first exception thrown by f stops the processing and is rethrown once all threads are done.
+  void run(size_t n, std::function<void(size_t)> const& f);
+
+ private:
+  class Workers;
+  std::unique_ptr<Workers> mWorkers;
+};
+
 /// \brief A function which merges TObjects
-void merge(TObject* const target, TObject* const other);
+///
+/// If a pool is provided, the entries of a TCollection are merged in parallel. Nested collections are merged serially.
+void merge(TObject* const target, TObject* const other, ParallelMerging* pool = nullptr);
 /// \brief A function which merges two vectors of TObjects
 ///
 /// Iterates through others vector and searches for the object with the same name in targets vector.
 /// If such item exists it is merged into the target object. If not than the item is pushed to the end
-/// of targets vector.
-void merge(VectorOfTObjectPtrs& targets, const VectorOfTObjectPtrs& others);
+/// of targets vector. If a pool is provided, the matched items are merged in parallel.
+void merge(VectorOfTObjectPtrs& targets, const VectorOfTObjectPtrs& others, ParallelMerging* pool = nullptr);
+
+/// \brief Adds the bins of other to target if both are histograms of the same class with identical binning.
+///
+/// This bypasses the axis compatibility checks of TH1::Merge by adding the bin contents and sumw2 arrays
+/// directly. Returns false and leaves target untouched if the histograms do not qualify, i.e. they differ
+/// in class or binning, have labels, are profiles or averages, or have unfilled buffers.
+bool addIdenticalBinning(TH1* target, const TH1* other);
 
 void deleteTCollections(TObject* obj);
 
@@ -17,6 +17,7 @@
 ///
 /// \author Piotr Konopka, piotr.jan.konopka@cern.ch
 
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <variant>
@@ -98,6 +99,8 @@ struct MergerConfig {
   std::string monitoringUrl = "infologger:///debug?qc";
   std::string detectorName = "TST";
   ConfigEntry<ParallelismType> parallelismType = {ParallelismType::SplitInputs};
+  // Number of threads merging the independent objects of a collection or a vector of objects in each Merger, 1 merges serially.
+  size_t mergingThreads = 1;
   std::vector<o2::framework::DataProcessorLabel> labels;
 };
 
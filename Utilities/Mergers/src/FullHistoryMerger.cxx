@@ -51,6 +51,9 @@ void FullHistoryMerger::init(framework::InitContext& ictx)
   mCyclesSinceReset = 0;
   mCollector = monitoring::MonitoringFactory::Get(mConfig.monitoringUrl);
   mCollector->addGlobalTag(monitoring::tags::Key::Subsystem, monitoring::tags::Value::Mergers);
+  if (mConfig.mergingThreads > 1) {
+    mParallelMerging = std::make_unique<algorithm::ParallelMerging>(mConfig.mergingThreads);
+  }
 
   // clear the state before starting the run, especially important for START->STOP->START sequence
   ictx.services().get<CallbackService>().set<CallbackService::Id::Start>([this]() { clear(); });
@@ -175,7 +178,7 @@ void FullHistoryMerger::mergeCache()
     for (auto& [name, entry] : mCache) {
       (void)name;
       auto other = std::get<TObjectPtr>(entry);
-      algorithm::merge(target.get(), other.get());
+      algorithm::merge(target.get(), other.get(), mParallelMerging.get());
       mObjectsMerged++;
     }
 
@@ -192,7 +195,7 @@ void FullHistoryMerger::mergeCache()
     auto target = std::get<VectorOfTObjectPtrs>(mMergedObject);
     for (auto& [_, entry] : mCache) {
       auto other = std::get<VectorOfTObjectPtrs>(entry);
-      algorithm::merge(target, other);
+      algorithm::merge(target, other, mParallelMerging.get());
       mObjectsMerged += target.size();
     }
   }
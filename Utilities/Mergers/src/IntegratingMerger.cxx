@@ -42,6 +42,9 @@ void IntegratingMerger::init(framework::InitContext& ictx)
   mCyclesSinceReset = 0;
   mCollector = monitoring::MonitoringFactory::Get(mConfig.monitoringUrl);
   mCollector->addGlobalTag(monitoring::tags::Key::Subsystem, monitoring::tags::Value::Mergers);
+  if (mConfig.mergingThreads > 1) {
+    mParallelMerging = std::make_unique<algorithm::ParallelMerging>(mConfig.mergingThreads);
+  }
 
   // clear the state before starting the run, especially important for START->STOP->START sequence
   ictx.services().get<CallbackService>().set<CallbackService::Id::Start>([this]() { clear(); });
@@ -121,7 +124,7 @@ void IntegratingMerger::merge(ObjectStore& target, ObjectStore&& other)
     // We expect that if the first object was TObject, then all should.
     auto targetAsTObject = std::get<TObjectPtr>(target);
     auto otherAsTObject = std::get<TObjectPtr>(other);
-    algorithm::merge(targetAsTObject.get(), otherAsTObject.get());
+    algorithm::merge(targetAsTObject.get(), otherAsTObject.get(), mParallelMerging.get());
   } else if (std::holds_alternative<MergeInterfacePtr>(target)) {
     // We expect that if the first object inherited MergeInterface, then all should.
     auto otherAsMergeInterface = std::get<MergeInterfacePtr>(other);
@@ -130,7 +133,7 @@ void IntegratingMerger::merge(ObjectStore& target, ObjectStore&& other)
     // We expect that if the first object was Vector of TObjects, then all should.
     auto targetAsVector = std::get<VectorOfTObjectPtrs>(target);
     const auto otherAsVector = std::get<VectorOfTObjectPtrs>(other);
-    algorithm::merge(targetAsVector, otherAsVector);
+    algorithm::merge(targetAsVector, otherAsVector, mParallelMerging.get());
   } else {
     LOG(error) << "The target variant has an unrecognized value";
   }
@@ -29,11 +29,27 @@
 #include <THnSparse.h>
 #include <TObjArray.h>
 #include <TObject.h>
+#include <TProfile.h>
+#include <TProfile2D.h>
+#include <TProfile3D.h>
+#include <TROOT.h>
 #include <TTree.h>
 #include <TPad.h>
 #include <TCanvas.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <condition_variable>
+#include <exception>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace o2::mergers::algorithm
 {
@@ -95,7 +111,260 @@ auto matchCollectedToPairs(const std::vector<TObject*>& targetObjects, const std
   return matchedObjects;
 }
 
-void merge(TObject* const target, TObject* const other)
+/// Threads waiting for the jobs of ParallelMerging::run. All of them take part in every
+/// job, taking the indices one by one until none is left.
+class ParallelMerging::Workers
+{
+ public:
+  explicit Workers(size_t nWorkers)
+  {
+    for (size_t i = 0; i < nWorkers; ++i) {
+      mThreads.emplace_back([this]() { work(); });
+    }
+  }
+
+  ~Workers()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mStop = true;
+    }
+    mStart.notify_all();
+    for (auto& t : mThreads) {
+      t.join();
+    }
+  }
+
+  size_t size() const
+  {
+    return mThreads.size();
+  }
+
+  void run(size_t n, std::function<void(size_t)> const& f)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mMutex);
+      mJob = &f;
+      mN = n;
+      mNext = 0;
+      mFinished = 0;
+      mError = nullptr;
+      ++mGeneration;
+    }
+    mStart.notify_all();
+    process(f, n);
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() { return mFinished == mThreads.size(); });
+    mJob = nullptr;
+    if (mError) {
+      std::rethrow_exception(mError);
+    }
+  }
+
+ private:
+  void work()
+  {
+    uint64_t seen = 0;
+    while (true) {
+      std::function<void(size_t)> const* job = nullptr;
+      size_t n = 0;
+      {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mStart.wait(lock, [this, seen]() { return mStop || mGeneration != seen; });
+        if (mStop) {
+          return;
+        }
+        seen = mGeneration;
+        job = mJob;
+        n = mN;
+      }
+      process(*job, n);
+      {
+        std::lock_guard<std::mutex> lock(mMutex);
+        ++mFinished;
+      }
+      mDone.notify_one();
+    }
+  }
+
+  void process(std::function<void(size_t)> const& f, size_t n)
+  {
+    for (size_t i = mNext++; i < n; i = mNext++) {
+      try {
+        f(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mError) {
+          mError = std::current_exception();
+        }
+        mNext = n; // nothing else to start
+      }
+    }
+  }
+
+  std::vector<std::thread> mThreads;
+  std::mutex mMutex;
+  std::condition_variable mStart;
+  std::condition_variable mDone;
+  std::function<void(size_t)> const* mJob = nullptr;
+  size_t mN = 0;
+  std::atomic<size_t> mNext{0};
+  size_t mFinished = 0;
+  uint64_t mGeneration = 0;
+  bool mStop = false;
+  std::exception_ptr mError;
+};
+
+ParallelMerging::ParallelMerging(size_t threads)
+{
+  if (threads > 1) {
+    // TH1::Merge and friends create temporary objects, which must not be registered in shared directories
+    ROOT::EnableThreadSafety();
+  }
+  mWorkers = std::make_unique<Workers>(threads > 1 ? threads - 1 : 0);
+}
+
+ParallelMerging::~ParallelMerging() = default;
+
+size_t ParallelMerging::threads() const
+{
+  return mWorkers->size() + 1;
+}
+
+void ParallelMerging::run(size_t n, std::function<void(size_t)> const& f)
+{
+  mWorkers->run(n, f);
+}
+
+bool sameBinning(const TAxis* a, const TAxis* b)
+{
+  if (a->GetNbins() != b->GetNbins() || a->GetXmin() != b->GetXmin() || a->GetXmax() != b->GetXmax()) {
+    return false;
+  }
+  // bins with labels might be ordered differently, TH1::Merge matches them by name
+  if (a->GetLabels() != nullptr || b->GetLabels() != nullptr) {
+    return false;
+  }
+  const auto* aEdges = a->GetXbins();
+  const auto* bEdges = b->GetXbins();
+  return aEdges->GetSize() == bEdges->GetSize() && std::equal(aEdges->GetArray(), aEdges->GetArray() + aEdges->GetSize(), bEdges->GetArray());
+}
+
+// Adds the bin contents of other to target, integer contents saturate like in TH1::AddBinContent.
+// If target keeps sumw2, these are added as well, taking |content| when other has none.
+template <typename Storage>
+void addBins(Storage& target, const Storage& other, TArrayD* targetSumw2, const TArrayD* otherSumw2)
+{
+  using value_type = std::remove_cvref_t<decltype(*target.GetArray())>;
+  const auto n = target.GetSize();
+  auto* t = target.GetArray();
+  const auto* o = other.GetArray();
+
+  if (targetSumw2 != nullptr) {
+    auto* tw2 = targetSumw2->GetArray();
+    if (otherSumw2 != nullptr) {
+      const auto* ow2 = otherSumw2->GetArray();
+      for (Int_t i = 0; i < n; ++i) {
+        tw2[i] += ow2[i];
+      }
+    } else {
+      for (Int_t i = 0; i < n; ++i) {
+        tw2[i] += std::abs(static_cast<Double_t>(o[i]));
+      }
+    }
+  }
+
+  if constexpr (std::is_floating_point_v<value_type>) {
+    for (Int_t i = 0; i < n; ++i) {
+      t[i] += o[i];
+    }
+  } else {
+    constexpr Long64_t limit = std::numeric_limits<std::make_signed_t<value_type>>::max();
+    for (Int_t i = 0; i < n; ++i) {
+      t[i] = static_cast<value_type>(std::clamp<Long64_t>(static_cast<Long64_t>(t[i]) + o[i], -limit, limit));
+    }
+  }
+}
+
+template <typename Storage>
+bool addIdenticalStorage(TH1* target, const TH1* other)
+{
+  auto* targetStorage = dynamic_cast<Storage*>(target);
+  const auto* otherStorage = dynamic_cast<const Storage*>(other);
+  if (targetStorage == nullptr || otherStorage == nullptr || targetStorage->GetSize() != otherStorage->GetSize()) {
+    return false;
+  }
+  const bool otherHasSumw2 = other->GetSumw2N() > 0;
+  if ((target->GetSumw2N() > 0 && target->GetSumw2N() != targetStorage->GetSize()) ||
+      (otherHasSumw2 && other->GetSumw2N() != otherStorage->GetSize())) {
+    return false;
+  }
+
+  // the statistics may be computed from the bin contents, thus we retrieve them before adding
+  std::array<Double_t, TH1::kNstat> targetStats{};
+  std::array<Double_t, TH1::kNstat> otherStats{};
+  target->GetStats(targetStats.data());
+  other->GetStats(otherStats.data());
+  const auto entries = target->GetEntries() + other->GetEntries();
+
+  if (otherHasSumw2 && target->GetSumw2N() == 0) {
+    target->Sumw2();
+  }
+  addBins(*targetStorage, *otherStorage, target->GetSumw2N() > 0 ? target->GetSumw2() : nullptr, otherHasSumw2 ? other->GetSumw2() : nullptr);
+
+  for (size_t i = 0; i < targetStats.size(); ++i) {
+    targetStats[i] += otherStats[i];
+  }
+  target->PutStats(targetStats.data());
+  target->SetEntries(entries);
+  return true;
+}
+
+bool addIdenticalBinning(TH1* target, const TH1* other)
+{
+  if (target->IsA() != other->IsA() || target->GetDimension() != other->GetDimension()) {
+    return false;
+  }
+  // profiles keep additional per-bin arrays, averages are not sums
+  if (target->InheritsFrom(TProfile::Class()) || target->InheritsFrom(TProfile2D::Class()) || target->InheritsFrom(TProfile3D::Class()) ||
+      target->TestBit(TH1::kIsAverage) || other->TestBit(TH1::kIsAverage)) {
+    return false;
+  }
+  if (target->GetBuffer() != nullptr || other->GetBuffer() != nullptr) {
+    return false;
+  }
+  if (!sameBinning(target->GetXaxis(), other->GetXaxis()) ||
+      (target->GetDimension() > 1 && !sameBinning(target->GetYaxis(), other->GetYaxis())) ||
+      (target->GetDimension() > 2 && !sameBinning(target->GetZaxis(), other->GetZaxis()))) {
+    return false;
+  }
+  return addIdenticalStorage<TArrayD>(target, other) ||
+         addIdenticalStorage<TArrayF>(target, other) ||
+         addIdenticalStorage<TArrayI>(target, other) ||
+         addIdenticalStorage<TArrayS>(target, other) ||
+         addIdenticalStorage<TArrayC>(target, other);
+}
+
+// Merges the matched objects, in parallel if a pool is provided and each target appears only once.
+// The objects merged in parallel are merged serially inside, so that there is at most one job at a time.
+void mergePairs(const std::vector<MatchedCollectedObjects>& pairs, ParallelMerging* pool)
+{
+  bool parallel = pool != nullptr && pool->threads() > 1 && pairs.size() > 1;
+  if (parallel) {
+    std::unordered_set<TObject*> targets;
+    targets.reserve(pairs.size());
+    parallel = std::ranges::all_of(pairs, [&targets](const auto& pair) { return targets.insert(pair.target).second; });
+  }
+  if (parallel) {
+    pool->run(pairs.size(), [&pairs](size_t i) { merge(pairs[i].target, pairs[i].other); });
+  } else {
+    for (const auto& [targetObject, otherObject] : pairs) {
+      merge(targetObject, otherObject, pool);
+    }
+  }
+}
+
+void merge(TObject* const target, TObject* const other, ParallelMerging* pool)
 {
   if (target == nullptr) {
     throw std::runtime_error("Merging target is nullptr");
@@ -122,18 +391,31 @@ void merge(TObject* const target, TObject* const other)
                                "' is a TCollection, while the other object '" + other->GetName() + "' is not.");
     }
 
+    // FindObject() is a linear search in most collections, so we index the target entries by name once.
+    // As FindObject(), we match the first entry with a given name.
+    std::unordered_map<std::string_view, TObject*> targetObjects;
+    targetObjects.reserve(targetCollection->GetSize());
+    auto targetIterator = targetCollection->MakeIterator();
+    while (auto targetObject = targetIterator->Next()) {
+      targetObjects.emplace(targetObject->GetName(), targetObject);
+    }
+    delete targetIterator;
+
+    std::vector<MatchedCollectedObjects> matched;
     auto otherIterator = otherCollection->MakeIterator();
     while (auto otherObject = otherIterator->Next()) {
-      TObject* targetObject = targetCollection->FindObject(otherObject->GetName());
-      if (targetObject) {
+      if (auto found = targetObjects.find(otherObject->GetName()); found != targetObjects.end()) {
         // That might be another collection or a concrete object to be merged, we walk on the collection recursively.
-        merge(targetObject, otherObject);
+        matched.emplace_back(found->second, otherObject);
       } else {
         // We prefer to clone instead of passing the pointer in order to simplify deleting the `other`.
-        targetCollection->Add(otherObject->Clone());
+        auto clone = otherObject->Clone();
+        targetCollection->Add(clone);
+        targetObjects.emplace(clone->GetName(), clone);
       }
     }
     delete otherIterator;
+    mergePairs(matched, pool);
   } else if (auto targetCanvas = dynamic_cast<TCanvas*>(target)) {
 
     auto otherCanvas = dynamic_cast<TCanvas*>(other);
@@ -166,7 +448,9 @@ void merge(TObject* const target, TObject* const other)
     if (target->InheritsFrom(TH1::Class())) {
       // this includes TH1, TH2, TH3
       auto targetTH1 = reinterpret_cast<TH1*>(target);
-      if (targetTH1->TestBit(TH1::kIsAverage)) {
+      if (auto otherTH1 = dynamic_cast<TH1*>(other); otherTH1 != nullptr && addIdenticalBinning(targetTH1, otherTH1)) {
+        // the most common case, histograms with identical binning, are added directly
+      } else if (targetTH1->TestBit(TH1::kIsAverage)) {
         // Merge() does not support averages, we have to use Add()
         // this will break if collection.size != 1
         if (auto otherTH1 = dynamic_cast<TH1*>(otherCollection.First())) {
@@ -204,18 +488,25 @@ void merge(TObject* const target, TObject* const other)
   }
 }
 
-void merge(VectorOfTObjectPtrs& targets, const VectorOfTObjectPtrs& others)
+void merge(VectorOfTObjectPtrs& targets, const VectorOfTObjectPtrs& others, ParallelMerging* pool)
 {
+  std::unordered_map<std::string_view, TObject*> targetsByName;
+  targetsByName.reserve(targets.size() + others.size());
+  for (const auto& target : targets) {
+    targetsByName.emplace(target->GetName(), target.get());
+  }
+
+  std::vector<MatchedCollectedObjects> matched;
+  matched.reserve(others.size());
   for (const auto& other : others) {
-    if (const auto targetSameName = std::find_if(targets.begin(), targets.end(), [&other](const auto& target) {
-          return std::string_view{other->GetName()} == std::string_view{target->GetName()};
-        });
-        targetSameName != targets.end()) {
-      merge(targetSameName->get(), other.get());
+    if (const auto targetSameName = targetsByName.find(other->GetName()); targetSameName != targetsByName.end()) {
+      matched.emplace_back(targetSameName->second, other.get());
     } else {
       targets.push_back(std::shared_ptr<TObject>(other->Clone(), deleteTCollections));
+      targetsByName.emplace(targets.back()->GetName(), targets.back().get());
     }
   }
+  mergePairs(matched, pool);
 }
 
 void deleteRecursive(TCollection* Coll)
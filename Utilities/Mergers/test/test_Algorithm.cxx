@@ -17,6 +17,7 @@
 #include <gsl/span>
 #include <memory>
 #include <stdexcept>
+#include <string>
 #define BOOST_TEST_MODULE Test Utilities MergerAlgorithm
 #define BOOST_TEST_MAIN
 #define BOOST_TEST_DYN_LINK
@@ -40,6 +41,7 @@
 #include <TGraph.h>
 #include <TProfile.h>
 #include <TCanvas.h>
+#include <TList.h>
 
 // using namespace o2::framework;
 using namespace o2::mergers;
@@ -464,6 +466,120 @@ BOOST_AUTO_TEST_CASE(AverageHisto)
   delete other;
 }
 
+BOOST_AUTO_TEST_CASE(IdenticalBinningHisto)
+{
+  // the direct addition has to give the same result as TH1::Merge
+  auto check = [](TH1* target, TH1* other) {
+    std::unique_ptr<TH1> reference(dynamic_cast<TH1*>(target->Clone("reference")));
+    TObjArray others;
+    others.Add(other);
+    reference->Merge(&others);
+
+    BOOST_REQUIRE(algorithm::addIdenticalBinning(target, other));
+    for (Int_t bin = 0; bin < target->GetNcells(); ++bin) {
+      BOOST_CHECK_EQUAL(target->GetBinContent(bin), reference->GetBinContent(bin));
+      BOOST_CHECK_CLOSE(target->GetBinError(bin), reference->GetBinError(bin), 0.001);
+    }
+    BOOST_CHECK_EQUAL(target->GetEntries(), reference->GetEntries());
+    BOOST_CHECK_CLOSE(target->GetMean(), reference->GetMean(), 0.001);
+    BOOST_CHECK_CLOSE(target->GetStdDev(), reference->GetStdDev(), 0.001);
+  };
+  {
+    TH1D target("histo 1d", "histo 1d", bins, min, max);
+    TH1D other("histo 1d", "histo 1d", bins, min, max);
+    target.Fill(5);
+    target.Fill(-1);
+    other.Fill(2, 0.5);
+    other.Fill(12);
+    BOOST_REQUIRE(other.GetSumw2N() > 0);
+    check(&target, &other);
+  }
+  {
+    const Double_t edges[] = {0, 1, 2, 5, 10};
+    TH2F target("histo 2d", "histo 2d", 4, edges, bins, min, max);
+    TH2F other("histo 2d", "histo 2d", 4, edges, bins, min, max);
+    target.Fill(0.5, 5);
+    other.Fill(3, 2);
+    other.Fill(7, 7);
+    check(&target, &other);
+  }
+  {
+    TH3I target("histo 3d", "histo 3d", bins, min, max, bins, min, max, bins, min, max);
+    TH3I other("histo 3d", "histo 3d", bins, min, max, bins, min, max, bins, min, max);
+    target.Fill(5, 5, 5);
+    other.Fill(2, 2, 2);
+    other.Fill(2, 2, 2);
+    check(&target, &other);
+  }
+  {
+    // different binning, labels or profiles are left to TH1::Merge
+    TH1D target("histo 1d", "histo 1d", bins, min, max);
+    TH1D otherBinning("histo 1d", "histo 1d", bins * 2, min, max);
+    TH1F otherClass("histo 1d", "histo 1d", bins, min, max);
+    TH1D otherLabels("histo 1d", "histo 1d", bins, min, max);
+    otherLabels.Fill("a", 1);
+    TProfile targetProfile("profile", "profile", bins, min, max);
+    TProfile otherProfile("profile", "profile", bins, min, max);
+    target.Fill(5);
+    BOOST_CHECK(!algorithm::addIdenticalBinning(&target, &otherBinning));
+    BOOST_CHECK(!algorithm::addIdenticalBinning(&target, &otherClass));
+    BOOST_CHECK(!algorithm::addIdenticalBinning(&target, &otherLabels));
+    BOOST_CHECK(!algorithm::addIdenticalBinning(&targetProfile, &otherProfile));
+    BOOST_CHECK_EQUAL(target.GetEntries(), 1);
+    BOOST_CHECK_EQUAL(target.GetBinContent(target.FindBin(5)), 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ParallelCollection)
+{
+  constexpr size_t nHistos = 100;
+  algorithm::ParallelMerging pool(4);
+  BOOST_CHECK_EQUAL(pool.threads(), 4);
+
+  auto makeCollection = [](size_t fills) {
+    auto collection = new TObjArray();
+    collection->SetOwner(true);
+    for (size_t i = 0; i < nHistos; ++i) {
+      auto name = "histo " + std::to_string(i);
+      auto histo = new TH1I(name.c_str(), name.c_str(), bins, min, max);
+      for (size_t f = 0; f < fills; ++f) {
+        histo->Fill(i % max);
+      }
+      collection->Add(histo);
+    }
+    auto nested = new TList();
+    nested->SetOwner(true);
+    nested->SetName("nested");
+    nested->Add(new TH1I("nested histo", "nested histo", bins, min, max));
+    dynamic_cast<TH1I*>(nested->First())->Fill(5, fills);
+    collection->Add(nested);
+    return collection;
+  };
+  TObjArray* target = makeCollection(1);
+  TObjArray* other = makeCollection(2);
+  other->Add(new TH1I("histo only in other", "histo only in other", bins, min, max));
+
+  BOOST_CHECK_NO_THROW(algorithm::merge(target, other, &pool));
+  delete other;
+
+  BOOST_REQUIRE_EQUAL(target->GetEntries(), nHistos + 2);
+  for (size_t i = 0; i < nHistos; ++i) {
+    auto histo = dynamic_cast<TH1I*>(target->At(i));
+    BOOST_REQUIRE(histo != nullptr);
+    BOOST_CHECK_EQUAL(histo->GetBinContent(histo->FindBin(i % max)), 3);
+    BOOST_CHECK_EQUAL(histo->GetEntries(), 3);
+  }
+  auto nested = dynamic_cast<TList*>(target->FindObject("nested"));
+  BOOST_REQUIRE(nested != nullptr);
+  BOOST_CHECK_EQUAL(dynamic_cast<TH1I*>(nested->First())->GetBinContent(6), 3);
+  BOOST_CHECK(target->FindObject("histo only in other") != nullptr);
+
+  // exceptions thrown while merging in parallel reach the caller
+  BOOST_CHECK_THROW(pool.run(10, [](size_t i) { if (i == 7) { throw std::runtime_error("failed"); } }), std::runtime_error);
+
+  algorithm::deleteTCollections(target);
+}
+
 BOOST_AUTO_TEST_SUITE(VectorOfHistos)
 
 gsl::span<float> to_span(std::shared_ptr<TH1F>& histo)
@@ -0,0 +1,147 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   bench_ransDecodeBackends.cxx
+/// @brief  compares the decoding throughput of the runtime selectable SIMD backends.
+///
+/// By default the sources are drawn from distributions mimicking typical CTF columns. If the library is
+/// built with JSON support, RANS_BENCH_TPC_FILE can point to a dump of TPC compressed clusters
+/// (as used by bench_ransTPC) to benchmark on the dictionaries of real data instead.
+
+#include "rANS/internal/common/defines.h"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <cstdlib>
+#include <functional>
+
+#include <benchmark/benchmark.h>
+
+#include "rANS/factory.h"
+#include "rANS/histogram.h"
+#include "rANS/internal/common/simdBackend.h"
+
+#include "helpers.h"
+
+using namespace o2::rans;
+using namespace o2::rans::internal::simd;
+
+inline constexpr size_t MessageSize = 1ull << 22;
+inline constexpr size_t NStreams = 16;
+
+template <typename source_T>
+struct Dataset {
+  std::string name{};
+  std::vector<source_T> data{};
+};
+
+template <typename source_T, typename distribution_T>
+Dataset<source_T> makeDataset(std::string name, distribution_T dist)
+{
+  std::mt19937 mt(0); // same seed we want always the same distrubution of random numbers;
+  Dataset<source_T> dataset{std::move(name), std::vector<source_T>(MessageSize / sizeof(source_T))};
+  for (auto& sample : dataset.data) {
+    sample = static_cast<source_T>(dist(mt));
+  }
+  return dataset;
+}
+
+template <typename source_T>
+void ransDecodeBackendBenchmark(benchmark::State& st, SIMDBackend backend, const std::vector<source_T>& inputData)
+{
+  using source_type = source_T;
+
+  EncodeBuffer<source_type> encodeBuffer{inputData.size()};
+  encodeBuffer.literals.resize(inputData.size());
+  DecodeBuffer<source_type> decodeBuffer{inputData.size()};
+
+  const auto histogram = makeDenseHistogram::fromSamples(gsl::span<const source_type>(inputData));
+  Metrics<source_type> metrics{histogram};
+  const auto renormedHistogram = renorm(histogram, metrics, RenormingPolicy::Auto, 10);
+
+  // the stream layout does not depend on the SIMD instructions used by the encoder
+  auto encoder = makeDenseEncoder<CoderTag::Compat, NStreams>::fromRenormed(renormedHistogram);
+  std::tie(encodeBuffer.encodeBufferEnd, encodeBuffer.literalsEnd) = encoder.process(inputData.data(), inputData.data() + inputData.size(), encodeBuffer.buffer.data(), encodeBuffer.literals.data());
+
+  auto decoder = makeDecoder<>::fromRenormed(renormedHistogram);
+  decoder.setSIMDBackend(backend);
+  const uint32_t* encodeBufferEnd = encodeBuffer.encodeBufferEnd;
+#ifdef ENABLE_VTUNE_PROFILER
+  __itt_resume();
+#endif
+  for (auto _ : st) {
+    decoder.process(encodeBufferEnd, decodeBuffer.buffer.data(), inputData.size(), encoder.getNStreams(), encodeBuffer.literalsEnd);
+  }
+#ifdef ENABLE_VTUNE_PROFILER
+  __itt_pause();
+#endif
+
+  if (!(decodeBuffer == inputData)) {
+    st.SkipWithError("Missmatch between encoded and decoded Message");
+  }
+
+  const auto& datasetProperties = metrics.getDatasetProperties();
+  st.SetItemsProcessed(static_cast<int64_t>(inputData.size()) * static_cast<int64_t>(st.iterations()));
+  st.SetBytesProcessed(static_cast<int64_t>(inputData.size()) * sizeof(source_type) * static_cast<int64_t>(st.iterations()));
+  st.counters["AlphabetRangeBits"] = datasetProperties.alphabetRangeBits;
+  st.counters["SymbolTablePrecision"] = renormedHistogram.getRenormingBits();
+  st.counters["Entropy"] = datasetProperties.entropy;
+};
+
+template <typename source_T>
+void registerBenchmarks(const Dataset<source_T>& dataset)
+{
+  for (auto backend : AllSIMDBackends) {
+    if (isSupported(backend)) {
+      const std::string name = fmt::format("decode_{}/{}", dataset.name, toString(backend));
+      benchmark::RegisterBenchmark(name.c_str(), ransDecodeBackendBenchmark<source_T>, backend, std::cref(dataset.data));
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  benchmark::Initialize(&argc, argv);
+
+  // narrow, medium and wide alphabets similar to e.g. flags, charges and time increments
+  static const auto narrow8 = makeDataset<uint8_t>("binomial_8", std::binomial_distribution<uint32_t>(64, 0.3));
+  static const auto medium16 = makeDataset<uint16_t>("geometric_16", std::geometric_distribution<uint32_t>(0.01));
+  static const auto wide32 = makeDataset<uint32_t>("geometric_32", std::geometric_distribution<uint32_t>(0.0001));
+  registerBenchmarks(narrow8);
+  registerBenchmarks(medium16);
+  registerBenchmarks(wide32);
+
+#ifdef RANS_ENABLE_JSON
+  static std::vector<Dataset<uint8_t>> tpc8{};
+  static std::vector<Dataset<uint16_t>> tpc16{};
+  static std::vector<Dataset<uint32_t>> tpc32{};
+  if (const char* file = std::getenv("RANS_BENCH_TPC_FILE"); file != nullptr) {
+    auto clusters = readFile(file);
+    tpc8 = {{"tpc_flagsA", std::move(clusters.flagsA)}, {"tpc_rowDiffA", std::move(clusters.rowDiffA)}, {"tpc_sigmaPadA", std::move(clusters.sigmaPadA)}};
+    tpc16 = {{"tpc_qTotA", std::move(clusters.qTotA)}, {"tpc_qMaxA", std::move(clusters.qMaxA)}, {"tpc_padResA", std::move(clusters.padResA)}};
+    tpc32 = {{"tpc_timeResA", std::move(clusters.timeResA)}, {"tpc_timeDiffU", std::move(clusters.timeDiffU)}};
+    for (const auto& dataset : tpc8) {
+      registerBenchmarks(dataset);
+    }
+    for (const auto& dataset : tpc16) {
+      registerBenchmarks(dataset);
+    }
+    for (const auto& dataset : tpc32) {
+      registerBenchmarks(dataset);
+    }
+  }
+#endif /* RANS_ENABLE_JSON */
+
+  benchmark::RunSpecifiedBenchmarks();
+  benchmark::Shutdown();
+  return 0;
+}
@@ -0,0 +1,26 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   chunked.h
+/// @brief  public interface for chunked encoding and decoding.
+
+#ifndef RANS_CHUNKED_H_
+#define RANS_CHUNKED_H_
+
+#ifdef __CLING__
+#error rANS should not be exposed to root
+#endif
+
+#include "rANS/internal/common/chunking.h"
+#include "rANS/internal/encode/ChunkedEncoder.h"
+#include "rANS/internal/decode/ChunkedDecoder.h"
+
+#endif /* RANS_CHUNKED_H_ */
@@ -0,0 +1,116 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   chunking.h
+/// @brief  layout of chunked rANS streams and helpers to process their chunks concurrently
+
+#ifndef RANS_INTERNAL_COMMON_CHUNKING_H_
+#define RANS_INTERNAL_COMMON_CHUNKING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <algorithm>
+
+#include <fmt/format.h>
+
+#include "rANS/internal/common/exceptions.h"
+
+namespace o2::rans
+{
+
+// A chunked stream splits a message into chunks of a fixed number of source symbols, every chunk is encoded
+// into an independent rANS stream using the same symbol table. All entries are stored in units of stream_T:
+//
+// [nChunks][chunkSize][streamEnd_0][literalsEnd_0]...[streamEnd_n-1][literalsEnd_n-1][stream_0]...[stream_n-1]
+//
+// streamEnd_i is the end of the stream of chunk i relative to the beginning of stream_0, literalsEnd_i is the end of
+// the incompressible symbols of chunk i in the literals buffer, which holds the literals of all chunks in chunk order.
+template <typename stream_T>
+class ChunkIndexView
+{
+ public:
+  using stream_type = stream_T;
+  using size_type = std::size_t;
+
+  static_assert(sizeof(stream_type) >= sizeof(uint32_t), "chunk index entries require at least 32 bit wide streams");
+
+  static constexpr size_type HeaderSize = 2;
+  static constexpr size_type EntrySize = 2;
+
+  [[nodiscard]] inline static constexpr size_type getIndexSize(size_type nChunks) noexcept { return HeaderSize + EntrySize * nChunks; };
+
+  [[nodiscard]] inline static constexpr size_type getNChunks(size_type messageLength, size_type chunkSize) noexcept
+  {
+    return chunkSize ? (messageLength + chunkSize - 1) / chunkSize : 0;
+  };
+
+  ChunkIndexView() = default;
+  explicit ChunkIndexView(const stream_type* begin) : mBegin{begin} {};
+
+  [[nodiscard]] inline size_type getNChunks() const noexcept { return mBegin[0]; };
+  [[nodiscard]] inline size_type getChunkSize() const noexcept { return mBegin[1]; };
+  [[nodiscard]] inline size_type getIndexSize() const noexcept { return getIndexSize(getNChunks()); };
+
+  [[nodiscard]] inline const stream_type* getStreamBegin() const noexcept { return mBegin + getIndexSize(); };
+  [[nodiscard]] inline const stream_type* getChunkStreamEnd(size_type chunk) const noexcept { return getStreamBegin() + mBegin[HeaderSize + EntrySize * chunk]; };
+  [[nodiscard]] inline size_type getChunkLiteralsEnd(size_type chunk) const noexcept { return mBegin[HeaderSize + EntrySize * chunk + 1]; };
+
+  [[nodiscard]] inline size_type getChunkOffset(size_type chunk) const noexcept { return chunk * getChunkSize(); };
+  [[nodiscard]] inline size_type getChunkMessageLength(size_type chunk, size_type messageLength) const noexcept
+  {
+    return std::min(getChunkSize(), messageLength - getChunkOffset(chunk));
+  };
+
+  void checkConsistency(size_type messageLength) const
+  {
+    const size_type nChunks = getNChunks();
+    if (nChunks != getNChunks(messageLength, getChunkSize())) {
+      throw DecodingError(fmt::format("Chunk index with {} chunks of {} symbols does not match message length {}", nChunks, getChunkSize(), messageLength));
+    }
+  };
+
+ private:
+  const stream_type* mBegin{};
+};
+
+namespace internal
+{
+
+/// call f(i) for every chunk i, concurrently on nThreads threads if compiled with OpenMP; rethrows the 1st caught exception
+template <typename F>
+void forEachChunk(size_t nChunks, size_t nThreads, F&& f)
+{
+  std::exception_ptr error{};
+#ifdef RANS_OPENMP
+#pragma omp parallel for num_threads(static_cast<int>(std::max<size_t>(1, std::min(nThreads, nChunks)))) schedule(dynamic)
+#endif
+  for (size_t i = 0; i < nChunks; ++i) {
+    try {
+      f(i);
+    } catch (...) {
+#ifdef RANS_OPENMP
+#pragma omp critical(rans_forEachChunk)
+#endif
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+};
+
+} // namespace internal
+} // namespace o2::rans
+
+#endif /* RANS_INTERNAL_COMMON_CHUNKING_H_ */
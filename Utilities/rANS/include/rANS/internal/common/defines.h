@@ -39,6 +39,12 @@
 #ifdef RANS_FMA
 #error RANS_FMA cannot be directly set
 #endif
+#ifdef RANS_DISPATCH_X86
+#error RANS_DISPATCH_X86 cannot be directly set
+#endif
+#ifdef RANS_NEON
+#error RANS_NEON cannot be directly set
+#endif
 
 #if (defined(__x86_64__) || defined(__aarch64__))
 #define RANS_COMPAT
@@ -68,6 +74,15 @@
 #define RANS_FMA
 #endif
 
+// kernels for x86 SIMD extensions are compiled independent of -march and selected at runtime
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define RANS_DISPATCH_X86
+#endif
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+#define RANS_NEON
+#endif
+
 #if defined(RANS_ENABLE_PARALLEL_STL) && defined(__cpp_lib_execution)
 #define RANS_PARALLEL_STL
 #endif
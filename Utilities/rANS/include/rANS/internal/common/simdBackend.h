@@ -0,0 +1,154 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   simdBackend.h
+/// @brief  runtime detection and selection of the SIMD instruction set used by the rANS decoder kernels
+
+#ifndef RANS_INTERNAL_COMMON_SIMDBACKEND_H_
+#define RANS_INTERNAL_COMMON_SIMDBACKEND_H_
+
+#include "rANS/internal/common/defines.h"
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <string_view>
+
+#include <fairlogger/Logger.h>
+
+#include "rANS/internal/common/exceptions.h"
+
+#ifdef RANS_DISPATCH_X86
+#define RANS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define RANS_TARGET_AVX2 __attribute__((target("avx2")))
+#define RANS_TARGET_AVX512 __attribute__((target("avx512f,avx512vl")))
+#endif /* RANS_DISPATCH_X86 */
+
+namespace o2::rans::internal::simd
+{
+
+enum class SIMDBackend : uint8_t { Portable,
+                                   SSE41,
+                                   AVX2,
+                                   AVX512,
+                                   NEON };
+
+inline constexpr std::array<SIMDBackend, 5> AllSIMDBackends{SIMDBackend::Portable, SIMDBackend::SSE41, SIMDBackend::AVX2, SIMDBackend::AVX512, SIMDBackend::NEON};
+
+[[nodiscard]] inline constexpr std::string_view toString(SIMDBackend backend) noexcept
+{
+  switch (backend) {
+    case SIMDBackend::SSE41:
+      return "SSE4.1";
+    case SIMDBackend::AVX2:
+      return "AVX2";
+    case SIMDBackend::AVX512:
+      return "AVX512";
+    case SIMDBackend::NEON:
+      return "NEON";
+    default:
+      return "Portable";
+  }
+};
+
+// number of 64 bit rANS states processed by one instruction
+[[nodiscard]] inline constexpr size_t getNLanes(SIMDBackend backend) noexcept
+{
+  switch (backend) {
+    case SIMDBackend::SSE41:
+    case SIMDBackend::NEON:
+      return 2;
+    case SIMDBackend::AVX2:
+      return 4;
+    case SIMDBackend::AVX512:
+      return 8;
+    default:
+      return 1;
+  }
+};
+
+[[nodiscard]] inline bool isSupported(SIMDBackend backend) noexcept
+{
+  switch (backend) {
+    case SIMDBackend::Portable:
+      return true;
+#ifdef RANS_DISPATCH_X86
+    case SIMDBackend::SSE41:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("sse4.1");
+    case SIMDBackend::AVX2:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx2");
+    case SIMDBackend::AVX512:
+      __builtin_cpu_init();
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl");
+#endif /* RANS_DISPATCH_X86 */
+#ifdef RANS_NEON
+    case SIMDBackend::NEON:
+      return true;
+#endif /* RANS_NEON */
+    default:
+      return false;
+  }
+};
+
+// widest instruction set supported by the CPU we are running on
+[[nodiscard]] inline SIMDBackend detectSIMDBackend() noexcept
+{
+  SIMDBackend best = SIMDBackend::Portable;
+  for (auto backend : AllSIMDBackends) {
+    if (isSupported(backend) && getNLanes(backend) > getNLanes(best)) {
+      best = backend;
+    }
+  }
+  return best;
+};
+
+[[nodiscard]] inline SIMDBackend parseSIMDBackend(std::string_view name)
+{
+  for (auto backend : AllSIMDBackends) {
+    if (name == toString(backend)) {
+      return backend;
+    }
+  }
+  throw ValueError(std::string{"unknown SIMD backend "} + std::string{name});
+};
+
+// backend used by default: the detected one, unless overridden by the RANS_SIMD_BACKEND environment variable
+[[nodiscard]] inline SIMDBackend getDefaultSIMDBackend()
+{
+  static const SIMDBackend backend = []() {
+    SIMDBackend backend = detectSIMDBackend();
+    if (const char* env = std::getenv("RANS_SIMD_BACKEND"); env != nullptr) {
+      const SIMDBackend requested = parseSIMDBackend(env);
+      if (isSupported(requested)) {
+        backend = requested;
+      } else {
+        LOGP(warning, "SIMD backend {} requested by RANS_SIMD_BACKEND is not supported by this CPU, using {}", env, toString(backend));
+      }
+    }
+    return backend;
+  }();
+  return backend;
+};
+
+// narrowest fallback if the streams can not be split into full registers of the requested backend
+[[nodiscard]] inline SIMDBackend getCompatibleSIMDBackend(SIMDBackend backend, size_t nStreams) noexcept
+{
+  while (backend != SIMDBackend::Portable && (nStreams % getNLanes(backend) != 0)) {
+    backend = backend == SIMDBackend::AVX512 ? SIMDBackend::AVX2 : (backend == SIMDBackend::AVX2 ? SIMDBackend::SSE41 : SIMDBackend::Portable);
+  }
+  return backend;
+};
+
+} // namespace o2::rans::internal::simd
+
+#endif /* RANS_INTERNAL_COMMON_SIMDBACKEND_H_ */
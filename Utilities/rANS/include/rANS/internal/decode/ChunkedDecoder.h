@@ -0,0 +1,103 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   ChunkedDecoder.h
+/// @brief  ChunkedDecoder - decodes all or individual chunks of a message encoded by the ChunkedEncoder.
+
+#ifndef RANS_INTERNAL_DECODE_CHUNKEDDECODER_H_
+#define RANS_INTERNAL_DECODE_CHUNKEDDECODER_H_
+
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+
+#include "rANS/internal/common/chunking.h"
+#include "rANS/internal/common/utils.h"
+
+namespace o2::rans
+{
+
+template <class decoder_T>
+class ChunkedDecoder
+{
+ public:
+  using decoder_type = decoder_T;
+  using source_type = typename decoder_type::source_type;
+  using stream_type = typename decoder_type::stream_type;
+  using index_type = ChunkIndexView<stream_type>;
+  using size_type = std::size_t;
+
+  ChunkedDecoder(const decoder_type& decoder, size_type nThreads = 1) : mDecoder{&decoder}, mNThreads{std::max<size_type>(nThreads, 1)} {};
+
+  [[nodiscard]] inline const decoder_type& getDecoder() const noexcept { return *mDecoder; };
+  [[nodiscard]] inline size_type getNThreads() const noexcept { return mNThreads; };
+
+  /// decode the complete message, chunks are decoded concurrently if the output iterator allows random access
+  template <typename source_IT, typename literals_IT = std::nullptr_t>
+  void process(const stream_type* inputBegin, source_IT outputBegin, size_type messageLength, size_type nStreams, literals_IT literalsBegin = nullptr) const;
+
+  /// decode a single chunk to chunkOutputBegin, which must provide space for index_type::getChunkMessageLength symbols
+  template <typename source_IT, typename literals_IT = std::nullptr_t>
+  void processChunk(const stream_type* inputBegin, size_type chunk, source_IT chunkOutputBegin, size_type messageLength, size_type nStreams, literals_IT literalsBegin = nullptr) const;
+
+ private:
+  template <typename source_IT, typename literals_IT>
+  void processChunkImpl(const index_type& index, size_type chunk, source_IT chunkOutputBegin, size_type messageLength, size_type nStreams, literals_IT literalsBegin) const
+  {
+    const size_type chunkLength = index.getChunkMessageLength(chunk, messageLength);
+    if constexpr (std::is_null_pointer_v<literals_IT>) {
+      mDecoder->process(index.getChunkStreamEnd(chunk), chunkOutputBegin, chunkLength, nStreams);
+    } else {
+      mDecoder->process(index.getChunkStreamEnd(chunk), chunkOutputBegin, chunkLength, nStreams, utils::advanceIter(literalsBegin, index.getChunkLiteralsEnd(chunk)));
+    }
+  };
+
+  const decoder_type* mDecoder{};
+  size_type mNThreads{1};
+};
+
+template <class decoder_T>
+template <typename source_IT, typename literals_IT>
+void ChunkedDecoder<decoder_T>::process(const stream_type* inputBegin, source_IT outputBegin, size_type messageLength, size_type nStreams, literals_IT literalsBegin) const
+{
+  const index_type index{inputBegin};
+  index.checkConsistency(messageLength);
+  const size_type nChunks = index.getNChunks();
+
+  using iterator_category = typename std::iterator_traits<source_IT>::iterator_category;
+  if constexpr (std::is_base_of_v<std::random_access_iterator_tag, iterator_category>) {
+    internal::forEachChunk(nChunks, mNThreads, [&, this](size_type chunk) {
+      processChunkImpl(index, chunk, outputBegin + index.getChunkOffset(chunk), messageLength, nStreams, literalsBegin);
+    });
+  } else {
+    source_IT chunkOutputBegin = outputBegin;
+    for (size_type chunk = 0; chunk < nChunks; ++chunk) {
+      processChunkImpl(index, chunk, chunkOutputBegin, messageLength, nStreams, literalsBegin);
+      std::advance(chunkOutputBegin, index.getChunkMessageLength(chunk, messageLength));
+    }
+  }
+};
+
+template <class decoder_T>
+template <typename source_IT, typename literals_IT>
+void ChunkedDecoder<decoder_T>::processChunk(const stream_type* inputBegin, size_type chunk, source_IT chunkOutputBegin, size_type messageLength, size_type nStreams, literals_IT literalsBegin) const
+{
+  const index_type index{inputBegin};
+  index.checkConsistency(messageLength);
+  if (chunk >= index.getNChunks()) {
+    throw DecodingError(fmt::format("Requested chunk {} exceeds number of chunks {}", chunk, index.getNChunks()));
+  }
+  processChunkImpl(index, chunk, chunkOutputBegin, messageLength, nStreams, literalsBegin);
+};
+
+} // namespace o2::rans
+
+#endif /* RANS_INTERNAL_DECODE_CHUNKEDDECODER_H_ */
@@ -77,6 +77,17 @@ class Decoder
     return precision;
   };
 
+  [[nodiscard]] inline internal::simd::SIMDBackend getSIMDBackend() const noexcept
+  {
+    return std::visit([](auto&& decoder) { return decoder.getSIMDBackend(); }, mImpl);
+  };
+
+  /// select the instruction set used for decoding, throws if it is not supported by the CPU
+  inline void setSIMDBackend(internal::simd::SIMDBackend backend)
+  {
+    std::visit([backend](auto&& decoder) { decoder.setSIMDBackend(backend); }, mImpl);
+  };
+
   template <typename stream_IT, typename source_IT, typename literals_IT = std::nullptr_t>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd = nullptr) const
   {
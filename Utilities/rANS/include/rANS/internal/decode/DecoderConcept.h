@@ -19,9 +19,13 @@
 #include <fairlogger/Logger.h>
 #include <gsl/span>
 #include <stdexcept>
+#include <type_traits>
+#include <vector>
 
 #include "rANS/internal/common/utils.h"
+#include "rANS/internal/common/simdBackend.h"
 #include "rANS/internal/containers/RenormedHistogram.h"
+#include "rANS/internal/decode/simdKernel.h"
 
 namespace o2::rans
 {
@@ -49,6 +53,16 @@ class DecoderConcept
 
   [[nodiscard]] inline const symbolTable_type& getSymbolTable() const noexcept { return this->mSymbolTable; };
 
+  [[nodiscard]] inline internal::simd::SIMDBackend getSIMDBackend() const noexcept { return this->mSIMDBackend; };
+
+  inline void setSIMDBackend(internal::simd::SIMDBackend backend)
+  {
+    if (!internal::simd::isSupported(backend)) {
+      throw RuntimeError(fmt::format("SIMD backend {} is not supported by this CPU", internal::simd::toString(backend)));
+    }
+    this->mSIMDBackend = backend;
+  };
+
   template <typename stream_IT, typename source_IT, typename literals_IT = std::nullptr_t, std::enable_if_t<utils::isCompatibleIter_v<typename symbolTable_T::source_type, source_IT>, bool> = true>
   void process(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd = nullptr) const
   {
@@ -63,26 +77,38 @@ class DecoderConcept
         throw DecodingError(fmt::format("Invalid number of decoder streams {}", nStreams));
       }
 
+      if constexpr (isBatchable_v<stream_IT>) {
+        using namespace internal::simd;
+        switch (getCompatibleSIMDBackend(mSIMDBackend, nStreams)) {
+#ifdef RANS_DISPATCH_X86
+          case SIMDBackend::AVX512:
+            processBatched<DecoderKernel<SIMDBackend::AVX512>>(inputEnd, outputBegin, messageLength, nStreams, literalsEnd);
+            return;
+          case SIMDBackend::AVX2:
+            processBatched<DecoderKernel<SIMDBackend::AVX2>>(inputEnd, outputBegin, messageLength, nStreams, literalsEnd);
+            return;
+          case SIMDBackend::SSE41:
+            processBatched<DecoderKernel<SIMDBackend::SSE41>>(inputEnd, outputBegin, messageLength, nStreams, literalsEnd);
+            return;
+#endif /* RANS_DISPATCH_X86 */
+#ifdef RANS_NEON
+          case SIMDBackend::NEON:
+            processBatched<DecoderKernel<SIMDBackend::NEON>>(inputEnd, outputBegin, messageLength, nStreams, literalsEnd);
+            return;
+#endif /* RANS_NEON */
+          default:
+            break;
+        }
+      }
+
       stream_IT inputIter = inputEnd;
       --inputIter;
       source_IT outputIter = outputBegin;
       literals_IT literalsIter = literalsEnd;
 
-      auto lookupSymbol = [&literalsIter, this](uint32_t cumulativeFrequency) -> value_type {
-        if constexpr (!std::is_null_pointer_v<literals_IT>) {
-          if (this->mSymbolTable.isEscapeSymbol(cumulativeFrequency)) {
-            return value_type{*(--literalsIter), this->mSymbolTable.getEscapeSymbol()};
-          } else {
-            return this->mSymbolTable[cumulativeFrequency];
-          }
-        } else {
-          return this->mSymbolTable[cumulativeFrequency];
-        }
-      };
-
       auto decode = [&, this](coder_type& decoder) {
         const auto cumul = decoder.get();
-        const value_type symbol = lookupSymbol(cumul);
+        const value_type symbol = lookupSymbol(cumul, literalsIter);
 #ifdef RANS_LOG_PROCESSED_DATA
         arrayLogger << symbol.first;
 #endif
@@ -123,7 +149,73 @@ class DecoderConcept
   };
 
  protected:
+  // the SIMD kernels operate on raw 32 bit streams and 64 bit states
+  template <typename stream_IT>
+  static constexpr bool isBatchable_v = std::is_pointer_v<stream_IT> &&
+                                        std::is_same_v<std::remove_cv_t<std::remove_pointer_t<stream_IT>>, uint32_t> &&
+                                        std::is_same_v<stream_type, uint32_t> &&
+                                        std::is_same_v<typename coder_type::state_type, uint64_t>;
+
+  template <typename literals_IT>
+  inline value_type lookupSymbol(uint32_t cumulativeFrequency, literals_IT& literalsIter) const
+  {
+    if constexpr (!std::is_null_pointer_v<literals_IT>) {
+      if (this->mSymbolTable.isEscapeSymbol(cumulativeFrequency)) {
+        return value_type{*(--literalsIter), this->mSymbolTable.getEscapeSymbol()};
+      } else {
+        return this->mSymbolTable[cumulativeFrequency];
+      }
+    } else {
+      return this->mSymbolTable[cumulativeFrequency];
+    }
+  };
+
+  // Decodes one symbol of every stream per iteration: symbol lookup and renormalization are done in stream order,
+  // the state update of all streams is vectorized by the kernel.
+  template <class kernel_T, typename stream_IT, typename source_IT, typename literals_IT>
+  void processBatched(stream_IT inputEnd, source_IT outputBegin, size_t messageLength, size_t nStreams, literals_IT literalsEnd) const
+  {
+    const uint32_t* inputIter = inputEnd;
+    --inputIter;
+    source_IT outputIter = outputBegin;
+    literals_IT literalsIter = literalsEnd;
+
+    const uint32_t precision = this->mSymbolTable.getPrecision();
+    const uint64_t mask = utils::pow2(precision) - 1;
+    constexpr uint64_t lowerBound = coder_type::getLowerBound();
+
+    std::vector<uint64_t> states(nStreams);
+    std::vector<const symbol_type*> symbols(nStreams);
+    for (auto& state : states) {
+      coder_type decoder{precision};
+      inputIter = decoder.init(inputIter);
+      state = decoder.getState();
+    }
+
+    auto lookupSymbols = [&, this](size_t nLanes) {
+      for (size_t i = 0; i < nLanes; ++i) {
+        const value_type symbol = lookupSymbol(static_cast<uint32_t>(states[i] & mask), literalsIter);
+        *outputIter++ = symbol.first;
+        symbols[i] = &symbol.second;
+      }
+    };
+
+    const size_t nLoops = messageLength / nStreams;
+    const size_t nLoopRemainder = messageLength % nStreams;
+
+    for (size_t i = 0; i < nLoops; ++i) {
+      lookupSymbols(nStreams);
+      kernel_T::advance(states.data(), symbols.data(), precision, nStreams);
+      inputIter = kernel_T::renorm(states.data(), nStreams, lowerBound, inputIter);
+    }
+
+    lookupSymbols(nLoopRemainder);
+    internal::simd::advanceStatesScalar(states.data(), symbols.data(), precision, nLoopRemainder);
+    internal::simd::renormStatesScalar(states.data(), nLoopRemainder, lowerBound, inputIter);
+  };
+
   symbolTable_type mSymbolTable{};
+  internal::simd::SIMDBackend mSIMDBackend{internal::simd::getDefaultSIMDBackend()};
 
   static_assert(coder_type::getNstreams() == 1, "implementation supports only single stream encoders");
 };
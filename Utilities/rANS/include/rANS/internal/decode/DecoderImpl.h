@@ -51,6 +51,10 @@ class DecoderImpl
 
   [[nodiscard]] inline static constexpr size_type getNstreams() noexcept { return N_STREAMS; };
 
+  [[nodiscard]] inline state_type getState() const noexcept { return mState; };
+
+  [[nodiscard]] inline static constexpr state_type getLowerBound() noexcept { return LOWER_BOUND; };
+
  private:
   state_type mState{};
   size_type mSymbolTablePrecission{};
@@ -0,0 +1,232 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   simdKernel.h
+/// @brief  Kernels advancing all interleaved rANS decoder streams at once using SSE4.1, AVX2, AVX512 or NEON.
+///
+/// The kernels are compiled with function level target attributes independent of the -march flags
+/// and must only be called if simd::isSupported() returns true for their backend.
+
+#ifndef RANS_INTERNAL_DECODE_SIMDKERNEL_H_
+#define RANS_INTERNAL_DECODE_SIMDKERNEL_H_
+
+#include "rANS/internal/common/defines.h"
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef RANS_DISPATCH_X86
+#include <immintrin.h>
+#endif
+#ifdef RANS_NEON
+#include <arm_neon.h>
+#endif
+
+#include "rANS/internal/common/simdBackend.h"
+#include "rANS/internal/containers/Symbol.h"
+
+namespace o2::rans::internal::simd
+{
+
+static_assert(sizeof(Symbol) == sizeof(uint64_t), "decoder kernels load frequency and cumulative frequency of a symbol as one 64 bit word");
+
+// x = frequency * (x >> precision) + (x & mask) - cumulative
+inline void advanceStatesScalar(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+{
+  const uint64_t mask = (uint64_t{1} << precision) - 1;
+  for (size_t i = 0; i < nLanes; ++i) {
+    const uint64_t x = states[i];
+    states[i] = symbols[i]->getFrequency() * (x >> precision) + (x & mask) - symbols[i]->getCumulative();
+  }
+};
+
+// streams are renormalized in stream order, each one consuming the next 32 bit word of the backward read input
+inline const uint32_t* renormStatesScalar(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+{
+  for (size_t i = 0; i < nLanes; ++i) {
+    if (states[i] < lowerBound) {
+      states[i] = (states[i] << 32) | *inputIter;
+      --inputIter;
+    }
+  }
+  return inputIter;
+};
+
+template <SIMDBackend backend_V>
+struct DecoderKernel;
+
+template <>
+struct DecoderKernel<SIMDBackend::Portable> {
+  static constexpr SIMDBackend Backend = SIMDBackend::Portable;
+
+  inline static void advance(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+  {
+    advanceStatesScalar(states, symbols, precision, nLanes);
+  };
+
+  inline static const uint32_t* renorm(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+  {
+    return renormStatesScalar(states, nLanes, lowerBound, inputIter);
+  };
+};
+
+#ifdef RANS_DISPATCH_X86
+
+template <>
+struct DecoderKernel<SIMDBackend::SSE41> {
+  static constexpr SIMDBackend Backend = SIMDBackend::SSE41;
+
+  RANS_TARGET_SSE41 static void advance(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+  {
+    const __m128i shift = _mm_cvtsi32_si128(precision);
+    const __m128i mask = _mm_set1_epi64x((int64_t{1} << precision) - 1);
+    for (size_t i = 0; i < nLanes; i += 2) {
+      uint64_t sym[2];
+      std::memcpy(&sym[0], symbols[i]->data(), sizeof(uint64_t));
+      std::memcpy(&sym[1], symbols[i + 1]->data(), sizeof(uint64_t));
+      // low 32 bits: frequency, high 32 bits: cumulative frequency
+      const __m128i symbol = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sym));
+      const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(states + i));
+      const __m128i quotient = _mm_srl_epi64(x, shift);
+      // 64 x 32 bit multiplication composed of two 32 x 32 -> 64 bit multiplications
+      __m128i product = _mm_slli_epi64(_mm_mul_epu32(_mm_srli_epi64(quotient, 32), symbol), 32);
+      product = _mm_add_epi64(product, _mm_mul_epu32(quotient, symbol));
+      const __m128i newState = _mm_sub_epi64(_mm_add_epi64(product, _mm_and_si128(x, mask)), _mm_srli_epi64(symbol, 32));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(states + i), newState);
+    }
+  };
+
+  inline static const uint32_t* renorm(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+  {
+    return renormStatesScalar(states, nLanes, lowerBound, inputIter);
+  };
+};
+
+template <>
+struct DecoderKernel<SIMDBackend::AVX2> {
+  static constexpr SIMDBackend Backend = SIMDBackend::AVX2;
+
+  RANS_TARGET_AVX2 static void advance(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+  {
+    const __m128i shift = _mm_cvtsi32_si128(precision);
+    const __m256i mask = _mm256_set1_epi64x((int64_t{1} << precision) - 1);
+    for (size_t i = 0; i < nLanes; i += 4) {
+      // gather frequency (low 32 bits) and cumulative frequency (high 32 bits) through the symbol pointers
+      const __m256i symbolPtrs = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(symbols + i));
+      const __m256i symbol = _mm256_i64gather_epi64(static_cast<const long long*>(nullptr), symbolPtrs, 1);
+      const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(states + i));
+      const __m256i quotient = _mm256_srl_epi64(x, shift);
+      __m256i product = _mm256_slli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(quotient, 32), symbol), 32);
+      product = _mm256_add_epi64(product, _mm256_mul_epu32(quotient, symbol));
+      const __m256i newState = _mm256_sub_epi64(_mm256_add_epi64(product, _mm256_and_si256(x, mask)), _mm256_srli_epi64(symbol, 32));
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(states + i), newState);
+    }
+  };
+
+  inline static const uint32_t* renorm(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+  {
+    return renormStatesScalar(states, nLanes, lowerBound, inputIter);
+  };
+};
+
+template <>
+struct DecoderKernel<SIMDBackend::AVX512> {
+  static constexpr SIMDBackend Backend = SIMDBackend::AVX512;
+
+  RANS_TARGET_AVX512 static void advance(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+  {
+    const __m128i shift = _mm_cvtsi32_si128(precision);
+    const __m512i mask = _mm512_set1_epi64((int64_t{1} << precision) - 1);
+    for (size_t i = 0; i < nLanes; i += 8) {
+      const __m512i symbolPtrs = _mm512_loadu_si512(symbols + i);
+      const __m512i symbol = _mm512_i64gather_epi64(symbolPtrs, nullptr, 1);
+      const __m512i x = _mm512_loadu_si512(states + i);
+      const __m512i quotient = _mm512_srl_epi64(x, shift);
+      __m512i product = _mm512_slli_epi64(_mm512_mul_epu32(_mm512_srli_epi64(quotient, 32), symbol), 32);
+      product = _mm512_add_epi64(product, _mm512_mul_epu32(quotient, symbol));
+      const __m512i newState = _mm512_sub_epi64(_mm512_add_epi64(product, _mm512_and_si512(x, mask)), _mm512_srli_epi64(symbol, 32));
+      _mm512_storeu_si512(states + i, newState);
+    }
+  };
+
+  // The i-th stream requiring renormalization reads the word i positions below the current input position.
+  // Expand-loading into lanes in reverse order hands the lowest address to the last stream, reversing the
+  // loaded words restores stream order.
+  RANS_TARGET_AVX512 static const uint32_t* renorm(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+  {
+    const __m512i lowerBoundVec = _mm512_set1_epi64(lowerBound);
+    const __m512i reverse = _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7);
+    for (size_t i = 0; i < nLanes; i += 8) {
+      const __m512i x = _mm512_loadu_si512(states + i);
+      const __mmask8 renormMask = _mm512_cmplt_epu64_mask(x, lowerBoundVec);
+      if (renormMask) {
+        const uint32_t nWords = __builtin_popcount(renormMask);
+        const __mmask8 reversedMask = reverseBits(renormMask);
+        const __m256i words = _mm256_maskz_expandloadu_epi32(reversedMask, inputIter - nWords + 1);
+        const __m512i wordsInStreamOrder = _mm512_permutexvar_epi64(reverse, _mm512_cvtepu32_epi64(words));
+        const __m512i newState = _mm512_mask_or_epi64(x, renormMask, _mm512_slli_epi64(x, 32), wordsInStreamOrder);
+        _mm512_storeu_si512(states + i, newState);
+        inputIter -= nWords;
+      }
+    }
+    return inputIter;
+  };
+
+ private:
+  [[nodiscard]] inline static constexpr uint8_t reverseBits(uint8_t v) noexcept
+  {
+    v = static_cast<uint8_t>((v & 0xF0u) >> 4 | (v & 0x0Fu) << 4);
+    v = static_cast<uint8_t>((v & 0xCCu) >> 2 | (v & 0x33u) << 2);
+    v = static_cast<uint8_t>((v & 0xAAu) >> 1 | (v & 0x55u) << 1);
+    return v;
+  };
+};
+
+#endif /* RANS_DISPATCH_X86 */
+
+#ifdef RANS_NEON
+
+template <>
+struct DecoderKernel<SIMDBackend::NEON> {
+  static constexpr SIMDBackend Backend = SIMDBackend::NEON;
+
+  inline static void advance(uint64_t* __restrict__ states, const Symbol* const* __restrict__ symbols, uint32_t precision, size_t nLanes) noexcept
+  {
+    const int64x2_t shift = vdupq_n_s64(-static_cast<int64_t>(precision));
+    const uint64x2_t mask = vdupq_n_u64((uint64_t{1} << precision) - 1);
+    for (size_t i = 0; i < nLanes; i += 2) {
+      // de-interleave into frequencies and cumulative frequencies of both lanes
+      const uint32x2_t symbol0 = vld1_u32(symbols[i]->data());
+      const uint32x2_t symbol1 = vld1_u32(symbols[i + 1]->data());
+      const uint32x2x2_t symbol = vzip_u32(symbol0, symbol1);
+      const uint32x2_t frequency = symbol.val[0];
+      const uint64x2_t cumulative = vmovl_u32(symbol.val[1]);
+
+      const uint64x2_t x = vld1q_u64(states + i);
+      const uint64x2_t quotient = vshlq_u64(x, shift);
+      uint64x2_t product = vshlq_n_u64(vmull_u32(vshrn_n_u64(quotient, 32), frequency), 32);
+      product = vaddq_u64(product, vmull_u32(vmovn_u64(quotient), frequency));
+      const uint64x2_t newState = vsubq_u64(vaddq_u64(product, vandq_u64(x, mask)), cumulative);
+      vst1q_u64(states + i, newState);
+    }
+  };
+
+  inline static const uint32_t* renorm(uint64_t* __restrict__ states, size_t nLanes, uint64_t lowerBound, const uint32_t* inputIter) noexcept
+  {
+    return renormStatesScalar(states, nLanes, lowerBound, inputIter);
+  };
+};
+
+#endif /* RANS_NEON */
+
+} // namespace o2::rans::internal::simd
+
+#endif /* RANS_INTERNAL_DECODE_SIMDKERNEL_H_ */
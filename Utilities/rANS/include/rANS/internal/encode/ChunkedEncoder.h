@@ -0,0 +1,140 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   ChunkedEncoder.h
+/// @brief  ChunkedEncoder - encodes fixed size chunks of a message into independent rANS streams sharing one symbol table.
+
+#ifndef RANS_INTERNAL_ENCODE_CHUNKEDENCODER_H_
+#define RANS_INTERNAL_ENCODE_CHUNKEDENCODER_H_
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "rANS/internal/common/chunking.h"
+#include "rANS/internal/common/utils.h"
+#include "rANS/internal/encode/Encoder.h"
+
+namespace o2::rans
+{
+
+template <class encoder_T>
+class ChunkedEncoder
+{
+ public:
+  using encoder_type = encoder_T;
+  using source_type = typename encoder_type::source_type;
+  using stream_type = typename encoder_type::stream_type;
+  using index_type = ChunkIndexView<stream_type>;
+  using size_type = std::size_t;
+
+  ChunkedEncoder(const encoder_type& encoder, size_type chunkSize, size_type nThreads = 1) : mEncoder{&encoder}, mChunkSize{chunkSize}, mNThreads{std::max<size_type>(nThreads, 1)}
+  {
+    if (mChunkSize == 0) {
+      throw EncodingError("Chunk size of chunked encoder must be positive");
+    }
+  };
+
+  [[nodiscard]] inline const encoder_type& getEncoder() const noexcept { return *mEncoder; };
+  [[nodiscard]] inline size_type getChunkSize() const noexcept { return mChunkSize; };
+  [[nodiscard]] inline size_type getNThreads() const noexcept { return mNThreads; };
+  [[nodiscard]] inline static constexpr size_type getNStreams() noexcept { return encoder_type::getNStreams(); };
+
+  /// upper bound of the number of stream_type words written for a chunk of chunkLength symbols
+  [[nodiscard]] inline static constexpr size_type getMaxChunkSize(size_type chunkLength) noexcept
+  {
+    // rANS states are renormalized at most once per symbol, flushing the 64bit state of a stream costs 2 words
+    return chunkLength + 2 * getNStreams() + 1;
+  };
+
+  /// overhead in stream_type words with respect to unchunked encoding of the message
+  [[nodiscard]] inline size_type getChunkingOverhead(size_type messageLength) const noexcept
+  {
+    const size_type nChunks = index_type::getNChunks(messageLength, mChunkSize);
+    return index_type::getIndexSize(nChunks) + nChunks * 2 * getNStreams();
+  };
+
+  template <typename stream_IT, typename source_IT, typename literals_IT = std::nullptr_t, std::enable_if_t<utils::isCompatibleIter_v<typename encoder_T::source_type, source_IT>, bool> = true>
+  decltype(auto) process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, literals_IT literalsBegin = nullptr) const;
+
+ private:
+  const encoder_type* mEncoder{};
+  size_type mChunkSize{};
+  size_type mNThreads{1};
+};
+
+template <class encoder_T>
+template <typename stream_IT, typename source_IT, typename literals_IT, std::enable_if_t<utils::isCompatibleIter_v<typename encoder_T::source_type, source_IT>, bool>>
+decltype(auto) ChunkedEncoder<encoder_T>::process(source_IT inputBegin, source_IT inputEnd, stream_IT outputBegin, literals_IT literalsBegin) const
+{
+  constexpr bool hasLiterals = !std::is_null_pointer_v<literals_IT>;
+
+  if (!hasLiterals && mEncoder->getSymbolTable().hasEscapeSymbol()) {
+    throw HistogramError("The Symbol table used requires you to pass a literals iterator");
+  }
+
+  const size_type messageLength = std::distance(inputBegin, inputEnd);
+  const size_type nChunks = index_type::getNChunks(messageLength, mChunkSize);
+
+  std::vector<source_IT> chunkBegin(nChunks + 1, inputBegin);
+  for (size_type i = 1; i < nChunks; ++i) {
+    chunkBegin[i] = utils::advanceIter(chunkBegin[i - 1], mChunkSize);
+  }
+  chunkBegin[nChunks] = inputEnd;
+
+  // every chunk is encoded into its own buffer, the buffers are concatenated after all chunks are done
+  std::vector<std::vector<stream_type>> streams(nChunks);
+  std::vector<std::vector<source_type>> literals(hasLiterals ? nChunks : 0);
+
+  internal::forEachChunk(nChunks, mNThreads, [&, this](size_type chunk) {
+    const size_type chunkLength = std::distance(chunkBegin[chunk], chunkBegin[chunk + 1]);
+    auto& stream = streams[chunk];
+    stream.resize(getMaxChunkSize(chunkLength));
+    auto streamEnd = stream.begin();
+    if constexpr (hasLiterals) {
+      std::tie(streamEnd, std::ignore) = mEncoder->process(chunkBegin[chunk], chunkBegin[chunk + 1], stream.begin(), std::back_inserter(literals[chunk]));
+    } else {
+      streamEnd = mEncoder->process(chunkBegin[chunk], chunkBegin[chunk + 1], stream.begin());
+    }
+    utils::checkBounds(streamEnd, stream.end());
+    stream.resize(std::distance(stream.begin(), streamEnd));
+    stream.shrink_to_fit();
+  });
+
+  // write the index
+  stream_IT outputIter = outputBegin;
+  *outputIter++ = static_cast<stream_type>(nChunks);
+  *outputIter++ = static_cast<stream_type>(mChunkSize);
+  size_type streamEnd = 0;
+  size_type literalsEnd = 0;
+  for (size_type i = 0; i < nChunks; ++i) {
+    streamEnd += streams[i].size();
+    literalsEnd += hasLiterals ? literals[i].size() : 0;
+    *outputIter++ = static_cast<stream_type>(streamEnd);
+    *outputIter++ = static_cast<stream_type>(literalsEnd);
+  }
+
+  // and the streams and literals in chunk order
+  for (const auto& stream : streams) {
+    outputIter = std::copy(stream.begin(), stream.end(), outputIter);
+  }
+  if constexpr (hasLiterals) {
+    for (const auto& chunkLiterals : literals) {
+      literalsBegin = std::copy(chunkLiterals.begin(), chunkLiterals.end(), literalsBegin);
+    }
+  }
+
+  return encoderImpl::makeReturn(outputIter, literalsBegin);
+};
+
+} // namespace o2::rans
+
+#endif /* RANS_INTERNAL_ENCODE_CHUNKEDENCODER_H_ */
@@ -0,0 +1,119 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   test_ransChunked.cxx
+/// @brief  Test chunked rANS encoder/ decoder
+
+#define BOOST_TEST_MODULE Utility test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#undef NDEBUG
+#include <cassert>
+
+#include <vector>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mp11.hpp>
+
+#include "rANS/factory.h"
+#include "rANS/histogram.h"
+#include "rANS/encode.h"
+#include "rANS/decode.h"
+#include "rANS/chunked.h"
+
+using namespace o2::rans;
+
+using source_types = boost::mp11::mp_list<int8_t, int16_t, int32_t>;
+
+inline constexpr size_t RansRenormingPrecision = 16;
+inline constexpr size_t MessageLength = 10000;
+inline constexpr size_t ChunkSize = 1000;
+
+template <typename source_T>
+std::vector<source_T> makeMessage(size_t length)
+{
+  std::mt19937 mt(0);
+  std::binomial_distribution<int> dist(100, 0.5);
+  std::vector<source_T> message(length);
+  for (auto& symbol : message) {
+    symbol = static_cast<source_T>(dist(mt) - 50);
+  }
+  return message;
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_chunkedEncodeDecode, source_type, source_types)
+{
+  using stream_type = uint32_t;
+
+  const auto message = makeMessage<source_type>(MessageLength + ChunkSize / 2); // last chunk is incomplete
+  // build the dictionary from a subset only to get incompressible symbols
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.begin() + ChunkSize / 4), RansRenormingPrecision, RenormingPolicy::ForceIncompressible);
+  auto encoder = makeDenseEncoder<>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+
+  for (size_t nThreads : {1, 4}) {
+    ChunkedEncoder chunkedEncoder{encoder, ChunkSize, nThreads};
+    const size_t nChunks = ChunkIndexView<stream_type>::getNChunks(message.size(), ChunkSize);
+    BOOST_CHECK_EQUAL(nChunks, MessageLength / ChunkSize + 1);
+
+    std::vector<stream_type> encodeBuffer(ChunkIndexView<stream_type>::getIndexSize(nChunks) + nChunks * chunkedEncoder.getMaxChunkSize(ChunkSize));
+    std::vector<source_type> literals(message.size());
+    auto [encodeBufferEnd, literalsEnd] = chunkedEncoder.process(message.begin(), message.end(), encodeBuffer.begin(), literals.begin());
+    BOOST_CHECK(literalsEnd != literals.begin());
+
+    ChunkIndexView<stream_type> index{encodeBuffer.data()};
+    BOOST_CHECK_EQUAL(index.getNChunks(), nChunks);
+    BOOST_CHECK_EQUAL(index.getChunkSize(), ChunkSize);
+    BOOST_CHECK(index.getChunkStreamEnd(nChunks - 1) == encodeBuffer.data() + std::distance(encodeBuffer.begin(), encodeBufferEnd));
+    BOOST_CHECK_EQUAL(index.getChunkLiteralsEnd(nChunks - 1), std::distance(literals.begin(), literalsEnd));
+
+    // decode everything
+    ChunkedDecoder chunkedDecoder{decoder, nThreads};
+    std::vector<source_type> decodeBuffer(message.size());
+    chunkedDecoder.process(encodeBuffer.data(), decodeBuffer.begin(), message.size(), encoder.getNStreams(), literals.begin());
+    BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+
+    // decode every chunk on its own
+    for (size_t chunk = 0; chunk < nChunks; ++chunk) {
+      const size_t chunkLength = index.getChunkMessageLength(chunk, message.size());
+      std::vector<source_type> chunkBuffer(chunkLength);
+      chunkedDecoder.processChunk(encodeBuffer.data(), chunk, chunkBuffer.begin(), message.size(), encoder.getNStreams(), literals.begin());
+      auto chunkBegin = message.begin() + index.getChunkOffset(chunk);
+      BOOST_CHECK_EQUAL_COLLECTIONS(chunkBuffer.begin(), chunkBuffer.end(), chunkBegin, chunkBegin + chunkLength);
+    }
+    BOOST_CHECK_THROW(chunkedDecoder.processChunk(encodeBuffer.data(), nChunks, decodeBuffer.begin(), message.size(), encoder.getNStreams(), literals.begin()), DecodingError);
+    BOOST_CHECK_THROW(chunkedDecoder.process(encodeBuffer.data(), decodeBuffer.begin(), message.size() + ChunkSize, encoder.getNStreams(), literals.begin()), DecodingError);
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_chunkedEncodeDecodeNoLiterals)
+{
+  using source_type = int16_t;
+  using stream_type = uint32_t;
+
+  const auto message = makeMessage<source_type>(MessageLength);
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.end()), RansRenormingPrecision);
+  auto encoder = makeDenseEncoder<>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+
+  ChunkedEncoder chunkedEncoder{encoder, ChunkSize};
+  const size_t nChunks = ChunkIndexView<stream_type>::getNChunks(message.size(), ChunkSize);
+  std::vector<stream_type> encodeBuffer(ChunkIndexView<stream_type>::getIndexSize(nChunks) + nChunks * chunkedEncoder.getMaxChunkSize(ChunkSize));
+  std::vector<source_type> literals(message.size());
+  auto [encodeBufferEnd, literalsEnd] = chunkedEncoder.process(message.begin(), message.end(), encodeBuffer.begin(), literals.begin());
+  BOOST_CHECK(literalsEnd == literals.begin());
+
+  std::vector<source_type> decodeBuffer(message.size());
+  ChunkedDecoder{decoder}.process(encodeBuffer.data(), decodeBuffer.begin(), message.size(), encoder.getNStreams(), literals.begin());
+  BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+};
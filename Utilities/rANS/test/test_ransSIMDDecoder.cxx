@@ -0,0 +1,195 @@
+// Copyright 2019-2023 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// @file   test_ransSIMDDecoder.cxx
+/// @brief  Test runtime dispatched SIMD decoder kernels against the portable decoder
+
+#define BOOST_TEST_MODULE Utility test
+#define BOOST_TEST_MAIN
+#define BOOST_TEST_DYN_LINK
+
+#undef NDEBUG
+#include <cassert>
+
+#include <vector>
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/mp11.hpp>
+
+#include "rANS/factory.h"
+#include "rANS/histogram.h"
+#include "rANS/encode.h"
+#include "rANS/decode.h"
+#include "rANS/internal/common/simdBackend.h"
+#include "rANS/internal/decode/simdKernel.h"
+
+using namespace o2::rans;
+using namespace o2::rans::internal::simd;
+
+using source_types = boost::mp11::mp_list<int8_t, int16_t, int32_t>;
+
+inline constexpr size_t RansRenormingPrecision = 16;
+inline constexpr size_t NStreams = 16;
+inline constexpr size_t MessageLength = 10000 + NStreams / 2 + 1; // last iteration does not use all streams
+
+template <typename source_T>
+std::vector<source_T> makeMessage(size_t length)
+{
+  std::mt19937 mt(0);
+  std::binomial_distribution<int> dist(200, 0.5);
+  std::vector<source_T> message(length);
+  for (auto& symbol : message) {
+    symbol = static_cast<source_T>(dist(mt) - 100);
+  }
+  return message;
+}
+
+std::vector<SIMDBackend> getSupportedBackends()
+{
+  std::vector<SIMDBackend> backends;
+  for (auto backend : AllSIMDBackends) {
+    if (isSupported(backend)) {
+      backends.push_back(backend);
+    }
+  }
+  return backends;
+}
+
+BOOST_AUTO_TEST_CASE(test_backendSelection)
+{
+  BOOST_CHECK(isSupported(SIMDBackend::Portable));
+  BOOST_CHECK(isSupported(detectSIMDBackend()));
+  BOOST_CHECK(isSupported(getDefaultSIMDBackend()));
+  for (auto backend : AllSIMDBackends) {
+    BOOST_CHECK(parseSIMDBackend(toString(backend)) == backend);
+  }
+  BOOST_CHECK_THROW((void)parseSIMDBackend("MMX"), ValueError);
+
+  BOOST_CHECK(getCompatibleSIMDBackend(SIMDBackend::AVX512, 16) == SIMDBackend::AVX512);
+  BOOST_CHECK(getCompatibleSIMDBackend(SIMDBackend::AVX512, 4) == SIMDBackend::AVX2);
+  BOOST_CHECK(getCompatibleSIMDBackend(SIMDBackend::AVX512, 2) == SIMDBackend::SSE41);
+  BOOST_CHECK(getCompatibleSIMDBackend(SIMDBackend::NEON, 2) == SIMDBackend::NEON);
+  BOOST_CHECK(getCompatibleSIMDBackend(SIMDBackend::SSE41, 1) == SIMDBackend::Portable);
+}
+
+BOOST_AUTO_TEST_CASE_TEMPLATE(test_simdDecode, source_type, source_types)
+{
+  using stream_type = uint32_t;
+
+  const auto message = makeMessage<source_type>(MessageLength);
+  // build the dictionary from a subset only to get incompressible symbols
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.begin() + MessageLength / 20), RansRenormingPrecision, RenormingPolicy::ForceIncompressible);
+  auto encoder = makeDenseEncoder<CoderTag::Compat, NStreams>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+
+  std::vector<stream_type> encodeBuffer(2 * MessageLength);
+  std::vector<source_type> literals(MessageLength);
+  auto [encodeBufferEnd, literalsEnd] = encoder.process(message.data(), message.data() + message.size(), encodeBuffer.data(), literals.data());
+  BOOST_CHECK(literalsEnd != literals.data());
+
+  for (auto backend : getSupportedBackends()) {
+    BOOST_TEST_CONTEXT("backend " << toString(backend))
+    {
+      decoder.setSIMDBackend(backend);
+      BOOST_CHECK(decoder.getSIMDBackend() == backend);
+      std::vector<source_type> decodeBuffer(MessageLength);
+      decoder.process(static_cast<const stream_type*>(encodeBufferEnd), decodeBuffer.begin(), message.size(), encoder.getNStreams(), literalsEnd);
+      BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+    }
+  }
+};
+
+BOOST_AUTO_TEST_CASE(test_simdDecodeTwoStreams)
+{
+  using source_type = int16_t;
+  using stream_type = uint32_t;
+
+  const auto message = makeMessage<source_type>(MessageLength);
+  auto renormed = renorm(makeDenseHistogram::fromSamples(message.begin(), message.end()), RansRenormingPrecision);
+  auto encoder = makeDenseEncoder<CoderTag::Compat, 2>::fromRenormed(renormed);
+  auto decoder = makeDecoder<>::fromRenormed(renormed);
+
+  std::vector<stream_type> encodeBuffer(2 * MessageLength);
+  auto encodeBufferEnd = encoder.process(message.data(), message.data() + message.size(), encodeBuffer.data());
+
+  for (auto backend : getSupportedBackends()) {
+    BOOST_TEST_CONTEXT("backend " << toString(backend))
+    {
+      decoder.setSIMDBackend(backend);
+      std::vector<source_type> decodeBuffer(MessageLength);
+      decoder.process(encodeBufferEnd, decodeBuffer.data(), message.size(), encoder.getNStreams());
+      BOOST_CHECK_EQUAL_COLLECTIONS(decodeBuffer.begin(), decodeBuffer.end(), message.begin(), message.end());
+    }
+  }
+};
+
+template <SIMDBackend backend_V>
+void checkKernel()
+{
+  using kernel_type = DecoderKernel<backend_V>;
+  constexpr uint32_t Precision = 14;
+  constexpr uint64_t LowerBound = uint64_t{1} << 20;
+
+  std::mt19937 mt(0);
+  std::uniform_int_distribution<uint64_t> stateDist(LowerBound, (LowerBound << 32) - 1);
+  std::uniform_int_distribution<uint32_t> wordDist{};
+
+  std::vector<internal::Symbol> symbolPool;
+  for (uint32_t i = 0; i < 64; ++i) {
+    symbolPool.emplace_back(1 + i * 7, i * 100);
+  }
+
+  for (size_t iteration = 0; iteration < 100; ++iteration) {
+    std::vector<uint64_t> states(NStreams);
+    std::vector<const internal::Symbol*> symbols(NStreams);
+    for (size_t i = 0; i < NStreams; ++i) {
+      // only states that stay positive after subtracting the cumulative frequency are valid
+      symbols[i] = &symbolPool[wordDist(mt) % symbolPool.size()];
+      states[i] = stateDist(mt) | (uint64_t{1} << 40);
+    }
+    std::vector<uint32_t> stream(NStreams);
+    for (auto& word : stream) {
+      word = wordDist(mt);
+    }
+
+    auto expected = states;
+    advanceStatesScalar(expected.data(), symbols.data(), Precision, NStreams);
+    auto expectedEnd = renormStatesScalar(expected.data(), NStreams, LowerBound << 18, stream.data() + stream.size() - 1);
+
+    kernel_type::advance(states.data(), symbols.data(), Precision, NStreams);
+    auto end = kernel_type::renorm(states.data(), NStreams, LowerBound << 18, stream.data() + stream.size() - 1);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(states.begin(), states.end(), expected.begin(), expected.end());
+    BOOST_CHECK(end == expectedEnd);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_simdDecoderKernels)
+{
+  checkKernel<SIMDBackend::Portable>();
+#ifdef RANS_DISPATCH_X86
+  if (isSupported(SIMDBackend::SSE41)) {
+    checkKernel<SIMDBackend::SSE41>();
+  }
+  if (isSupported(SIMDBackend::AVX2)) {
+    checkKernel<SIMDBackend::AVX2>();
+  }
+  if (isSupported(SIMDBackend::AVX512)) {
+    checkKernel<SIMDBackend::AVX512>();
+  } else {
+    BOOST_TEST_WARN("CPU does not support AVX512, cannot run all tests");
+  }
+#endif /* RANS_DISPATCH_X86 */
+#ifdef RANS_NEON
+  checkKernel<SIMDBackend::NEON>();
+#endif /* RANS_NEON */
+}